@@ -69,6 +69,11 @@ void ATOMIC_INTEGER::set(int value)
   value_rep = value;
 }
 
+int ATOMIC_INTEGER::add(int value)
+{
+  return __sync_add_and_fetch(&value_rep, value);
+}
+
 KVU_GUARD_LOCK::KVU_GUARD_LOCK(pthread_mutex_t* lock_arg)
 {
   lock_repp = lock_arg;
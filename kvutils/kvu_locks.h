@@ -11,9 +11,8 @@
  *
  * On supported platforms, atomicity is guaranteed for 
  * both single- and multiprocessor concurrency. Ordering of 
- * concurrent reads and writes is however not guaranteed.
- *
- * Note! Atomic test-and-modify operations are not provided.
+ * concurrent reads and writes is however not guaranteed,
+ * except for add() which acts as a full memory barrier.
  */
 class ATOMIC_INTEGER {
 
@@ -37,6 +36,15 @@ class ATOMIC_INTEGER {
    */
   void set(int value);
 
+  /**
+   * Atomically adds 'value' to the stored integer and
+   * returns the resulting new value.
+   *
+   * Non-blocking. Safe to call from multiple threads
+   * concurrently. Acts as a full memory barrier.
+   */
+  int add(int value);
+
   ATOMIC_INTEGER(int value = 0);
   ~ATOMIC_INTEGER(void);
 
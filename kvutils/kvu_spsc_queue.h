@@ -0,0 +1,386 @@
+// ------------------------------------------------------------------------
+// kvu_spsc_queue.h: Bounded lock-free queues for RT msg passing
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDE_KVU_SPSC_QUEUE_H
+#define INCLUDE_KVU_SPSC_QUEUE_H
+
+#include <vector>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "kvu_timestamp.h"
+
+/**
+ * Default capacity of the queues.
+ */
+static const size_t spsc_queue_default_size_const = 1024;
+
+/**
+ * A bounded queue for passing items from one producer
+ * thread to one consumer thread.
+ *
+ * Items are stored in a preallocated ring buffer. Both
+ * producer and consumer operations are wait-free, i.e.
+ * they never block and have bounded execution time.
+ * Items are copied with the assignment operator, so
+ * real-time safety of push and pop also depends on 'T'.
+ *
+ * The consumer can access the front item in place with
+ * front(), so that items need not be copied out of
+ * the queue.
+ *
+ * Only one thread may act as the producer and one
+ * thread as the consumer at a time.
+ */
+template<class T>
+class SPSC_QUEUE_RT_C {
+
+public:
+
+  /**
+   * Class constructor. Capacity is rounded up to the
+   * next power of two.
+   *
+   * Execution note: may allocate memory
+   */
+  SPSC_QUEUE_RT_C(size_t capacity = spsc_queue_default_size_const)
+    : write_rep(0),
+      read_rep(0) {
+    size_t size = 1;
+    while(size < capacity)
+      size <<= 1;
+    items_rep.resize(size);
+    mask_rep = size - 1;
+  }
+
+  /**
+   * Adds a new item to the end of the queue.
+   *
+   * Execution note: producer only, wait-free
+   *
+   * @return true on success, false if queue is full
+   */
+  bool push_back(const T& arg) {
+    size_t w = write_rep;
+    if (w - read_rep > mask_rep)
+      return false;
+
+    items_rep[w & mask_rep] = arg;
+
+    /* note: item must be visible before the index */
+    __sync_synchronize();
+    write_rep = w + 1;
+    return true;
+  }
+
+  /**
+   * Returns pointer to the front item in the queue, or
+   * 0 if the queue is empty. The item stays valid until
+   * pop_front() is called.
+   *
+   * Execution note: consumer only, wait-free
+   */
+  T* front(void) {
+    size_t r = read_rep;
+    if (write_rep == r)
+      return 0;
+
+    /* note: index must be read before the item */
+    __sync_synchronize();
+    return &items_rep[r & mask_rep];
+  }
+
+  /**
+   * Fetches, and removes, the front item in the queue.
+   * If 'front_msg' is zero, the item is discarded
+   * without copying.
+   *
+   * Execution note: consumer only, wait-free
+   *
+   * @return 1 on success, 0 if empty
+   */
+  int pop_front(T* front_msg) {
+    T* item = front();
+    if (item == 0)
+      return 0;
+
+    if (front_msg != 0)
+      *front_msg = *item;
+
+    /* note: item must be read before the slot is released */
+    __sync_synchronize();
+    read_rep = read_rep + 1;
+    return 1;
+  }
+
+  /**
+   * Removes all items.
+   *
+   * Execution note: consumer only
+   */
+  void clear(void) {
+    while(pop_front(0) > 0)
+      ;
+  }
+
+  /**
+   * Is queue empty?
+   *
+   * Execution note: wait-free
+   */
+  bool is_empty(void) const { return write_rep == read_rep; }
+
+  /**
+   * Number of items in the queue.
+   *
+   * Execution note: wait-free
+   */
+  size_t size(void) const { return write_rep - read_rep; }
+
+  /**
+   * Maximum number of items in the queue.
+   */
+  size_t capacity(void) const { return mask_rep + 1; }
+
+private:
+
+  /* note: free-running counters, slot is 'counter & mask_rep' */
+  volatile size_t write_rep;  // only modified by the producer
+  volatile size_t read_rep;   // only modified by the consumer
+
+  size_t mask_rep;            // only modified in constructor
+  std::vector<T> items_rep;
+
+  SPSC_QUEUE_RT_C& operator=(const SPSC_QUEUE_RT_C& x) { return *this; }
+  SPSC_QUEUE_RT_C(const SPSC_QUEUE_RT_C& x) { }
+};
+
+/**
+ * A bounded queue for passing items from multiple producer
+ * threads to one real-time consumer thread.
+ *
+ * Each slot of the ring buffer carries a sequence number
+ * that tells whether the slot is free for the current lap
+ * of the producers, or holds an item for the consumer.
+ * Producers reserve slots by advancing the write index
+ * with compare-and-swap, so they never wait for each 
+ * other, and push_back() fails immediately if the queue
+ * is full. Consumer operations are wait-free.
+ *
+ * After adding an item, the producer signals the consumer
+ * under a mutex, so that poll() does not miss the wake-up.
+ * The consumer takes this mutex only in poll().
+ */
+template<class T>
+class MPSC_QUEUE_RT_C {
+
+public:
+
+  /**
+   * Class constructor. Capacity is rounded up to the
+   * next power of two.
+   *
+   * Execution note: may allocate memory
+   */
+  MPSC_QUEUE_RT_C(size_t capacity = spsc_queue_default_size_const)
+    : write_rep(0),
+      read_rep(0) {
+    size_t size = 1;
+    while(size < capacity)
+      size <<= 1;
+    slots_rep.resize(size);
+    for(size_t n = 0; n < size; n++)
+      slots_rep[n].seq = n;
+    mask_rep = size - 1;
+    pthread_mutex_init(&lock_rep, NULL);
+    pthread_cond_init(&cond_rep, NULL);
+  }
+
+  ~MPSC_QUEUE_RT_C(void) {
+    pthread_cond_destroy(&cond_rep);
+    pthread_mutex_destroy(&lock_rep);
+  }
+
+  /**
+   * Adds a new item to the end of the queue.
+   *
+   * Execution note: lock-free slot reservation, takes
+   *                 a mutex to wake up poll()
+   *
+   * @return true on success, false if queue is full
+   */
+  bool push_back(const T& arg) {
+    size_t w = write_rep;
+    SLOT_T* slot;
+    for(;;) {
+      slot = &slots_rep[w & mask_rep];
+      size_t seq = slot->seq;
+      /* note: sequence must be read before the slot is 
+       *       reserved and written */
+      __sync_synchronize();
+      long int diff = static_cast<long int>(seq - w);
+      if (diff == 0) {
+	size_t prev = __sync_val_compare_and_swap(&write_rep, w, w + 1);
+	if (prev == w)
+	  break;
+	w = prev;
+      }
+      else if (diff < 0) {
+	/* note: consumer has not yet released the slot 
+	 *       from the previous lap */
+	return false;
+      }
+      else {
+	/* note: another producer reserved the slot */
+	w = write_rep;
+      }
+    }
+
+    slot->item = arg;
+
+    /* note: item must be visible before the sequence */
+    __sync_synchronize();
+    slot->seq = w + 1;
+
+    pthread_mutex_lock(&lock_rep);
+    pthread_cond_broadcast(&cond_rep);
+    pthread_mutex_unlock(&lock_rep);
+    return true;
+  }
+
+  /**
+   * Returns pointer to the front item in the queue, or
+   * 0 if the queue is empty. The item stays valid until
+   * pop_front() is called.
+   *
+   * Execution note: consumer only, wait-free
+   */
+  T* front(void) {
+    SLOT_T* slot = &slots_rep[read_rep & mask_rep];
+    if (slot->seq != read_rep + 1)
+      return 0;
+
+    /* note: sequence must be read before the item */
+    __sync_synchronize();
+    return &slot->item;
+  }
+
+  /**
+   * Fetches, and removes, the front item in the queue.
+   * If 'front_msg' is zero, the item is discarded
+   * without copying.
+   *
+   * Execution note: consumer only, wait-free
+   *
+   * @return 1 on success, 0 if empty
+   */
+  int pop_front(T* front_msg) {
+    T* item = front();
+    if (item == 0)
+      return 0;
+
+    if (front_msg != 0)
+      *front_msg = *item;
+
+    /* note: item must be read before the slot is released
+     *       for the next lap */
+    __sync_synchronize();
+    size_t r = read_rep;
+    slots_rep[r & mask_rep].seq = r + mask_rep + 1;
+    read_rep = r + 1;
+    return 1;
+  }
+
+  /**
+   * Removes all items.
+   *
+   * Execution note: consumer only, wait-free
+   */
+  void clear(void) {
+    while(pop_front(0) > 0)
+      ;
+  }
+
+  /**
+   * Blocks until 'is_empty() != true'. 'timeout_sec' and
+   * 'timeout_usec' specify the upper time limit for blocking.
+   *
+   * Execution note: consumer only, may block
+   */
+  void poll(int timeout_sec, long int timeout_usec) {
+    struct timeval nowtmp;
+    struct timespec now, timeout;
+    int retcode = 0;
+
+    gettimeofday(&nowtmp, NULL);
+
+    now.tv_sec = nowtmp.tv_sec;
+    now.tv_nsec = nowtmp.tv_usec * 1000;
+    timeout.tv_sec = timeout_sec;
+    timeout.tv_nsec = timeout_usec * 1000;
+    kvu_timespec_add(&now, &timeout, &timeout);
+
+    pthread_mutex_lock(&lock_rep);
+    while (is_empty() == true && retcode != ETIMEDOUT) {
+      retcode = pthread_cond_timedwait(&cond_rep, &lock_rep, &timeout);
+    }
+    pthread_mutex_unlock(&lock_rep);
+  }
+
+  /**
+   * Is queue empty? An item that is being added 
+   * is not yet visible.
+   *
+   * Execution note: wait-free
+   */
+  bool is_empty(void) const { return slots_rep[read_rep & mask_rep].seq != read_rep + 1; }
+
+  /**
+   * Maximum number of items in the queue.
+   */
+  size_t capacity(void) const { return mask_rep + 1; }
+
+private:
+
+  struct SLOT_T {
+    /* note: 'n' when free for the producer writing item 'n', 
+     *       'n + 1' when item 'n' is ready for the consumer */
+    volatile size_t seq;
+    T item;
+  };
+
+  /* note: free-running counters, slot is 'counter & mask_rep' */
+  volatile size_t write_rep;  // modified by producers with CAS
+  volatile size_t read_rep;   // only modified by the consumer
+
+  size_t mask_rep;            // only modified in constructor
+  std::vector<SLOT_T> slots_rep;
+
+  pthread_mutex_t lock_rep;   // protects poll() wake-ups
+  pthread_cond_t cond_rep;    // signaled when items are added
+
+  MPSC_QUEUE_RT_C& operator=(const MPSC_QUEUE_RT_C& x) { return *this; }
+  MPSC_QUEUE_RT_C(const MPSC_QUEUE_RT_C& x) { }
+};
+
+#endif /* INCLUDE_KVU_SPSC_QUEUE_H */
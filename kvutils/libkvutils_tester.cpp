@@ -32,6 +32,7 @@
 #include <stddef.h>  /* ANSI-C: size_t */
 #include <stdio.h>   /* for AIX */
 #include <time.h>    /* ANSI-C: clock() */
+#include <sched.h>   /* sched_yield() */
 
 #include "kvu_dbc.h"
 #include "kvu_locks.h"
@@ -41,6 +42,7 @@
 #include "kvu_utils.h"
 #include "kvu_value_queue.h"
 #include "kvu_message_queue.h"
+#include "kvu_spsc_queue.h"
 
 using namespace std;
 
@@ -82,6 +84,8 @@ static int kvu_test_3(void);
 static int kvu_test_4(void);
 static int kvu_test_5_timestamp(void);
 static int kvu_test_6_msgqueue(void);
+static int kvu_test_7_atomic_add(void);
+static int kvu_test_8_spsc_queue(void);
 
 static kvu_test_t kvu_funcs[] = { 
   kvu_test_1,  /* kvu_locks.h: ATOMIC_INTEGER */
@@ -90,6 +94,8 @@ static kvu_test_t kvu_funcs[] = {
   kvu_test_4,  /* kvu_value_queue.h */
   kvu_test_5_timestamp, /* kvu_timestamp.h */
   kvu_test_6_msgqueue,  /* kvu_message_queue.h */
+  kvu_test_7_atomic_add, /* kvu_locks.h: ATOMIC_INTEGER::add() */
+  kvu_test_8_spsc_queue, /* kvu_spsc_queue.h */
   NULL 
 };
 
@@ -600,3 +606,173 @@ static void* kvu_test_6_helper(void* ptr)
   /* never reached */
   return 0;
 }
+
+static const int kvu_test_7_iterations_const = 1000000;
+
+static void* kvu_test_7_helper(void* ptr)
+{
+  ATOMIC_INTEGER* i = (ATOMIC_INTEGER*)ptr;
+
+  for(int n = 0; n < kvu_test_7_iterations_const; n++) {
+    i->add(1);
+  }
+
+  return 0;
+}
+
+/**
+ * Tests the ATOMIC_INTEGER::add() function
+ * defined in kvu_locks.h.
+ */
+static int kvu_test_7_atomic_add(void)
+{
+  ECA_TEST_ENTRY();
+
+  ATOMIC_INTEGER i (0);
+
+  pthread_t thread;
+  pthread_create(&thread, NULL, kvu_test_7_helper, (void*)&i);
+
+  for(int n = 0; n < kvu_test_7_iterations_const; n++) {
+    i.add(-1);
+  }
+
+  pthread_join(thread, 0);
+
+  if (i.get() != 0) {
+    ECA_TEST_FAIL(1, "kvu_test_7 lost updates");
+  }
+
+  if (i.add(5) != 5) {
+    ECA_TEST_FAIL(1, "kvu_test_7 return value");
+  }
+
+  ECA_TEST_SUCCESS();
+}
+
+static const int kvu_test_8_producers_const = 3;
+static const int kvu_test_8_items_const = 5000;
+
+static MPSC_QUEUE_RT_C<int>* kvu_test_8_queue = 0;
+
+/**
+ * Producer thread, pushes items tagged with
+ * the producer index.
+ */
+static void* kvu_test_8_helper(void* ptr)
+{
+  int producer = *static_cast<int*>(ptr);
+
+  for(int n = 0; n < kvu_test_8_items_const; n++) {
+    while(kvu_test_8_queue->push_back(producer * kvu_test_8_items_const + n) != true)
+      sched_yield();
+  }
+
+  return 0;
+}
+
+/**
+ * Tests the SPSC_QUEUE_RT_C and MPSC_QUEUE_RT_C 
+ * classes defined in kvu_spsc_queue.h.
+ */
+static int kvu_test_8_spsc_queue(void)
+{
+  ECA_TEST_ENTRY();
+
+  SPSC_QUEUE_RT_C<int> squeue (5);
+  if (squeue.capacity() != 8) {
+    ECA_TEST_FAIL(1, "kvu_test_8 capacity");
+  }
+
+  /* note: wrap around the ring a few times */
+  int next_push = 0, next_pop = 0;
+  for(int round = 0; round < 5; round++) {
+    while(squeue.push_back(next_push) == true)
+      ++next_push;
+    if (squeue.size() != squeue.capacity()) {
+      ECA_TEST_FAIL(1, "kvu_test_8 full");
+    }
+    for(int n = 0; n < 5; n++) {
+      int* front = squeue.front();
+      int item = -1;
+      if (front == 0 || *front != next_pop ||
+	  squeue.pop_front(&item) != 1 || item != next_pop) {
+	ECA_TEST_FAIL(1, "kvu_test_8 order");
+      }
+      ++next_pop;
+    }
+  }
+  squeue.clear();
+  if (squeue.is_empty() != true ||
+      squeue.front() != 0 ||
+      squeue.pop_front(0) != 0) {
+    ECA_TEST_FAIL(1, "kvu_test_8 clear");
+  }
+
+  MPSC_QUEUE_RT_C<int> fqueue (4);
+  for(int n = 0; n < 4; n++) {
+    if (fqueue.push_back(n) != true) {
+      ECA_TEST_FAIL(1, "kvu_test_8 mpsc push");
+    }
+  }
+  if (fqueue.push_back(4) == true) {
+    ECA_TEST_FAIL(1, "kvu_test_8 mpsc full");
+  }
+  if (fqueue.pop_front(0) != 1 ||
+      fqueue.push_back(4) != true ||
+      fqueue.front() == 0 || *fqueue.front() != 1) {
+    ECA_TEST_FAIL(1, "kvu_test_8 mpsc wrap");
+  }
+
+  ECA_TEST_NOTE("multiple-producers");
+
+  /* note: small queue to exercise the full-queue case */
+  MPSC_QUEUE_RT_C<int> mqueue (16);
+  kvu_test_8_queue = &mqueue;
+
+  pthread_t threads[kvu_test_8_producers_const];
+  int producers[kvu_test_8_producers_const];
+  int expected[kvu_test_8_producers_const];
+  for(int n = 0; n < kvu_test_8_producers_const; n++) {
+    producers[n] = n;
+    expected[n] = 0;
+    pthread_create(&threads[n], NULL, kvu_test_8_helper, (void*)&producers[n]);
+  }
+
+  int received = 0;
+  int result = 0;
+  while(received < kvu_test_8_producers_const * kvu_test_8_items_const) {
+    int item;
+    if (mqueue.pop_front(&item) != 1) {
+      mqueue.poll(1, 0);
+      continue;
+    }
+    int producer = item / kvu_test_8_items_const;
+    if (producer < 0 || producer >= kvu_test_8_producers_const ||
+	item % kvu_test_8_items_const != expected[producer]) {
+      result = 1;
+      break;
+    }
+    ++expected[producer];
+    ++received;
+  }
+
+  /* note: drain so that producers can finish on error */
+  while(received < kvu_test_8_producers_const * kvu_test_8_items_const) {
+    if (mqueue.pop_front(0) == 1)
+      ++received;
+    else
+      mqueue.poll(1, 0);
+  }
+
+  for(int n = 0; n < kvu_test_8_producers_const; n++) {
+    pthread_join(threads[n], 0);
+  }
+  kvu_test_8_queue = 0;
+
+  if (result != 0) {
+    ECA_TEST_FAIL(1, "kvu_test_8 multiple producers order");
+  }
+
+  ECA_TEST_SUCCESS();
+}
@@ -264,21 +264,23 @@ CHAIN_OPERATOR::parameter_t EFFECT_AMPLIFY_CLIPCOUNT::get_parameter(int param) c
   return 0.0f;
 }
 
-void EFFECT_AMPLIFY_CLIPCOUNT::init(SAMPLE_BUFFER* sbuf) { i.init(sbuf); }
+void EFFECT_AMPLIFY_CLIPCOUNT::init(SAMPLE_BUFFER* sbuf) { cur_sbuf_repp = sbuf; }
 
 void EFFECT_AMPLIFY_CLIPCOUNT::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    *i.current() = *i.current() *  gain;
-    if (*i.current() > SAMPLE_SPECS::impl_max_value ||
-	*i.current() < SAMPLE_SPECS::impl_min_value) {
-      num_of_clipped++;
-    }
-    else {
-      num_of_clipped = 0;
+  for(int c = 0; c < cur_sbuf_repp->number_of_channels(); c++) {
+    SAMPLE_BUFFER::channel_span_t span = cur_sbuf_repp->channel_span(c);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      SAMPLE_SPECS::sample_t value = span.data[n] * gain;
+      span.data[n] = value;
+      if (value > SAMPLE_SPECS::impl_max_value ||
+	  value < SAMPLE_SPECS::impl_min_value) {
+	num_of_clipped++;
+      }
+      else {
+	num_of_clipped = 0;
+      }
     }
-    i.next();
   }
 
   if (num_of_clipped > maxnum_of_clipped && maxnum_of_clipped != 0) {
@@ -415,21 +417,22 @@ void EFFECT_LIMITER::parameter_description(int param, struct PARAM_DESCRIPTION *
   OPERATOR::parameter_description(param, pd);
 }
 
-void EFFECT_LIMITER::init(SAMPLE_BUFFER* sbuf) { i.init(sbuf); }
+void EFFECT_LIMITER::init(SAMPLE_BUFFER* sbuf) { cur_sbuf_repp = sbuf; }
 
 void EFFECT_LIMITER::process(void) {
-  i.begin();
-  while(!i.end()) {
-    if (*i.current() < 0) {
-      if ((-(*i.current())) > limit_rep) 
-	*i.current() = -limit_rep;
-    }
-    else {
-      if (*i.current() > limit_rep)
-	*i.current() = limit_rep;
-     
+  SAMPLE_SPECS::sample_t limit = limit_rep;
+  for(int c = 0; c < cur_sbuf_repp->number_of_channels(); c++) {
+    SAMPLE_BUFFER::channel_span_t span = cur_sbuf_repp->channel_span(c);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      if (span.data[n] < 0) {
+	if (-span.data[n] > limit) 
+	  span.data[n] = -limit;
+      }
+      else {
+	if (span.data[n] > limit)
+	  span.data[n] = limit;
+      }
     }
-    i.next();
   }
 }
 
@@ -443,8 +446,6 @@ EFFECT_COMPRESS::EFFECT_COMPRESS (parameter_t compress_rate, parameter_t thold)
 EFFECT_COMPRESS::EFFECT_COMPRESS (const EFFECT_COMPRESS& x) {
   crate = x.crate;
   threshold = x.threshold;
-  delta = x.delta;
-  ratio = x.ratio;
   first_time = x.first_time;
 
   lastin = x.lastin;
@@ -509,7 +510,7 @@ void EFFECT_COMPRESS::parameter_description(int param, struct PARAM_DESCRIPTION
 
 void EFFECT_COMPRESS::init(SAMPLE_BUFFER *insample)
 {
-  i.init(insample);
+  cur_sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
   set_samples_per_second(samples_per_second());
@@ -520,31 +521,41 @@ void EFFECT_COMPRESS::init(SAMPLE_BUFFER *insample)
 
 void EFFECT_COMPRESS::process(void)
 {
-  i.begin();
-  while(!i.end()) {
+  for(int c = 0; c < cur_sbuf_repp->number_of_channels(); c++) {
+    SAMPLE_BUFFER::channel_span_t span = cur_sbuf_repp->channel_span(c);
+    if (span.length == 0)
+      continue;
+
+    SAMPLE_BUFFER::buf_size_t n = 0;
     if (first_time) {
       first_time = false;
-      lastin[i.channel()] = lastout[i.channel()] = *i.current();
+      lastin[c] = lastout[c] = span.data[0];
+      n = 1;
     }
-    else {
-      if (fabs(*i.current()) > threshold) {
-	delta = *i.current() - lastin[i.channel()];
+
+    /* note: filter state kept in local variables */
+    SAMPLE_SPECS::sample_t in = lastin[c];
+    SAMPLE_SPECS::sample_t out = lastout[c];
+    for(; n < span.length; n++) {
+      if (fabs(span.data[n]) > threshold) {
+	parameter_t delta = span.data[n] - in;
 	delta /= crate;
-	new_value = lastin[i.channel()] + delta;
-	ratio = new_value / lastin[i.channel()];
-	new_value = lastout[i.channel()] * ratio;
+	parameter_t new_value = in + delta;
+	parameter_t ratio = new_value / in;
+	new_value = out * ratio;
 
 	if (new_value > SAMPLE_SPECS::impl_max_value) new_value = SAMPLE_SPECS::impl_max_value;
 	else if (new_value < SAMPLE_SPECS::impl_min_value) new_value = SAMPLE_SPECS::impl_min_value;
 
-	lastin[i.channel()] = *i.current();
-	*i.current() = lastout[i.channel()] = new_value;
+	in = span.data[n];
+	span.data[n] = out = new_value;
       }
       else {
-	lastin[i.channel()] = lastout[i.channel()] = *i.current();
+	in = out = span.data[n];
       }
     }
-    i.next();
+    lastin[c] = in;
+    lastout[c] = out;
   }
 }
 
@@ -610,7 +621,7 @@ void EFFECT_NOISEGATE::parameter_description(int param, struct PARAM_DESCRIPTION
 
 void EFFECT_NOISEGATE::init(SAMPLE_BUFFER *insample)
 {
-  i.init(insample);
+  cur_sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
   set_samples_per_second(samples_per_second());
@@ -628,103 +639,119 @@ void EFFECT_NOISEGATE::init(SAMPLE_BUFFER *insample)
 
 void EFFECT_NOISEGATE::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    bool below = fabs(*i.current()) <= th_level;
-
-    switch(ng_status[i.channel()]) 
-      {
-      case ng_waiting: 
-	// ---
-	// phase 1 - waiting
-	// ---
+  for(int c = 0; c < cur_sbuf_repp->number_of_channels(); c++) {
+    SAMPLE_BUFFER::channel_span_t span = cur_sbuf_repp->channel_span(c);
+
+    /* note: gate state kept in local variables */
+    int status = ng_status[c];
+    parameter_t th_time_count = th_time_lask[c];
+    parameter_t attack_count = attack_lask[c];
+    parameter_t hold_count = hold_lask[c];
+    parameter_t release_count = release_lask[c];
+    parameter_t ch_gain = gain[c];
+
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      bool below = fabs(span.data[n]) <= th_level;
+
+      switch(status) 
 	{
-	  if (below) {
-	    th_time_lask[i.channel()]++;
-	    if (th_time_lask[i.channel()] >= th_time) {
-	      th_time_lask[i.channel()] = 0.0;
-	      ng_status[i.channel()] = ng_attacking;
-	      ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from waiting to attacking");
+	case ng_waiting: 
+	  // ---
+	  // phase 1 - waiting
+	  // ---
+	  {
+	    if (below) {
+	      th_time_count++;
+	      if (th_time_count >= th_time) {
+		th_time_count = 0.0;
+		status = ng_attacking;
+		ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from waiting to attacking");
+	      }
 	    }
+	    else {
+	      th_time_count = 0;
+	    }
+	    break;
 	  }
-	  else {
-	    th_time_lask[i.channel()] = 0;
-	  }
-	  break;
-	}
 
-      case ng_attacking: 
-	// ---
-	// phase 2 - attack
-	// ---
-	{
-	  if (below) {
-	    attack_lask[i.channel()]++;
-	    gain[i.channel()] = (1.0 - (attack_lask[i.channel()] / atime));
-	    if (attack_lask[i.channel()] >= atime) {
-	      attack_lask[i.channel()] = 0.0;
-	      ng_status[i.channel()] = ng_active;
-	      gain[i.channel()] = 0.0;
-	      ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from attack to active");
+	case ng_attacking: 
+	  // ---
+	  // phase 2 - attack
+	  // ---
+	  {
+	    if (below) {
+	      attack_count++;
+	      ch_gain = (1.0 - (attack_count / atime));
+	      if (attack_count >= atime) {
+		attack_count = 0.0;
+		status = ng_active;
+		ch_gain = 0.0;
+		ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from attack to active");
+	      }
+	      span.data[n] = span.data[n] * ch_gain;
 	    }
-	    *i.current() = *i.current() * gain[i.channel()];
-	  }
-	  else {
-	    attack_lask[i.channel()] = 0;
-	    ng_status[i.channel()] = ng_waiting;
-	    ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from attack to waiting");
+	    else {
+	      attack_count = 0;
+	      status = ng_waiting;
+	      ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from attack to waiting");
+	    }
+	    break;
 	  }
-	  break;
-	}
 
-      case ng_active: 
-	// ---
-	// phase 3 - active
-	// ---
-	{
-	  if (below == false) {
-	    ng_status[i.channel()] = ng_holding;
-	    ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from active to holding");
+	case ng_active: 
+	  // ---
+	  // phase 3 - active
+	  // ---
+	  {
+	    if (below == false) {
+	      status = ng_holding;
+	      ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from active to holding");
+	    }
+	    span.data[n] = span.data[n] * 0.0;
+	    break;
 	  }
-	  *i.current() = *i.current() * 0.0;
-	  break;
-	}
 
-      case ng_holding: 
-	// ---
-	// phase 4 - holding
-	// ---
-	{
-	  if (!below) {
-	    hold_lask[i.channel()]++;
-	    if (hold_lask[i.channel()] >= htime) {
-	      hold_lask[i.channel()] = 0.0;
-	      ng_status[i.channel()] = ng_releasing;
-	      ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from holding to release");
+	case ng_holding: 
+	  // ---
+	  // phase 4 - holding
+	  // ---
+	  {
+	    if (!below) {
+	      hold_count++;
+	      if (hold_count >= htime) {
+		hold_count = 0.0;
+		status = ng_releasing;
+		ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from holding to release");
+	      }
 	    }
+	    span.data[n] = span.data[n] * 0.0;
+	    break;
 	  }
-	  *i.current() = *i.current() * 0.0;
-	  break;
-	}
 
-      case ng_releasing: 
-	// ---
-	// phase 5 - releasing
-	// ---
-	{
-	  release_lask[i.channel()]++;
-	  gain[i.channel()] = release_lask[i.channel()] / rtime;
-	  if (release_lask[i.channel()] >= rtime) {
-	    release_lask[i.channel()] = 0.0;
-	    ng_status[i.channel()] = ng_waiting;
-	    ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from releasing to waiting");
+	case ng_releasing: 
+	  // ---
+	  // phase 5 - releasing
+	  // ---
+	  {
+	    release_count++;
+	    ch_gain = release_count / rtime;
+	    if (release_count >= rtime) {
+	      release_count = 0.0;
+	      status = ng_waiting;
+	      ECA_LOG_MSG(ECA_LOGGER::user_objects,"(audiofx) noisegate - from releasing to waiting");
+	    }
+	    span.data[n] = span.data[n] * ch_gain;
+	    break;
 	  }
-	  *i.current() = *i.current() * gain[i.channel()];
-	  break;
 	}
-      }
+    }
 
-    i.next();
+    ng_status[c] = status;
+    th_time_lask[c] = th_time_count;
+    attack_lask[c] = attack_count;
+    hold_lask[c] = hold_count;
+    release_lask[c] = release_count;
+    gain[c] = ch_gain;
   }
 }
 
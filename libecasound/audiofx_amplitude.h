@@ -19,6 +19,7 @@ class EFFECT_AMPLITUDE : public EFFECT_BASE {
 
   virtual void init(SAMPLE_BUFFER *insample);
   virtual void release(void);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
   virtual ~EFFECT_AMPLITUDE(void);
 
 protected:
@@ -51,6 +52,7 @@ class EFFECT_AMPLIFY: public EFFECT_AMPLITUDE {
   virtual void init(SAMPLE_BUFFER *insample);
   virtual void release(void);
   virtual void process(void);
+  virtual bool silent_for_silent_input(void) const { return(true); }
   virtual void process_ref(void);
 
   EFFECT_AMPLIFY (parameter_t multiplier_percent = 100.0);
@@ -85,9 +87,12 @@ class EFFECT_AMPLIFY_DB: public EFFECT_AMPLITUDE {
   virtual void init(SAMPLE_BUFFER *insample);
   virtual void release(void);
   virtual void process(void);
+  virtual bool silent_for_silent_input(void) const { return(true); }
   virtual void process_ref(void);
 
   virtual int output_channels(int i_channels) const;
+  /* note: changing the channel reinitializes the operator */
+  virtual bool realtime_safe_set_parameter(int param) const { return(param != 2); }
 
   EFFECT_AMPLIFY_DB(parameter_t gain = 0.0f, int channel = 0);
   virtual ~EFFECT_AMPLIFY_DB(void);
@@ -103,7 +108,6 @@ class EFFECT_AMPLIFY_CLIPCOUNT : public EFFECT_AMPLITUDE {
 
   parameter_t gain;
   int nm, num_of_clipped, maxnum_of_clipped;
-  SAMPLE_ITERATOR i;
 
  public:
 
@@ -145,6 +149,7 @@ class EFFECT_AMPLIFY_CHANNEL: public EFFECT_AMPLITUDE {
 
   virtual void init(SAMPLE_BUFFER *insample);
   virtual void process(void);
+  virtual bool silent_for_silent_input(void) const { return(true); }
   virtual void process_ref(void);
 
   EFFECT_AMPLIFY_CHANNEL* clone(void) const { return new EFFECT_AMPLIFY_CHANNEL(*this); }
@@ -159,7 +164,6 @@ class EFFECT_AMPLIFY_CHANNEL: public EFFECT_AMPLITUDE {
 class EFFECT_LIMITER: public EFFECT_AMPLITUDE {
 
   parameter_t limit_rep;
-  SAMPLE_ITERATOR i;
 
  public:
 
@@ -172,6 +176,7 @@ class EFFECT_LIMITER: public EFFECT_AMPLITUDE {
 
   virtual void init(SAMPLE_BUFFER *insample);
   virtual void process(void);
+  virtual bool silent_for_silent_input(void) const { return(true); }
 
   EFFECT_LIMITER (parameter_t multiplier_percent = 100.0);
   virtual ~EFFECT_LIMITER(void);
@@ -187,9 +192,6 @@ class EFFECT_COMPRESS : public EFFECT_AMPLITUDE {
 
   parameter_t crate;
   parameter_t threshold;
-  SAMPLE_ITERATOR_CHANNELS i;
-
-  parameter_t delta, ratio, new_value;
   bool first_time;
 
   std::vector<SAMPLE_SPECS::sample_t> lastin, lastout;
@@ -218,8 +220,6 @@ class EFFECT_COMPRESS : public EFFECT_AMPLITUDE {
  */
 class EFFECT_NOISEGATE : public EFFECT_AMPLITUDE {
 
-  SAMPLE_ITERATOR_CHANNELS i;
-
   parameter_t th_level;
   parameter_t th_time;
   parameter_t atime, htime, rtime;
@@ -27,7 +27,6 @@
 #include <kvu_message_item.h>
 #include <kvu_numtostr.h>
 
-#include "samplebuffer_iterators.h"
 #include "audiofx_analysis.h"
 #include "audiofx_amplitude.h"
 
@@ -236,7 +235,7 @@ void EFFECT_VOLUME_BUCKETS::init(SAMPLE_BUFFER* insample)
   int res = pthread_mutex_lock(&lock_rep);
   DBC_CHECK(res == 0);
   
-  i.init(insample);
+  sbuf_repp = insample;
   set_channels(insample->number_of_channels());
   DBC_CHECK(channels() == insample->number_of_channels());
   num_of_samples.resize(insample->number_of_channels(), 0);
@@ -260,33 +259,35 @@ void EFFECT_VOLUME_BUCKETS::process(void)
 
   int res = pthread_mutex_trylock(&lock_rep);
   if (res == 0) {
-    i.begin();
-    while(!i.end()) {
-
-      DBC_CHECK(num_of_samples.size() > static_cast<unsigned>(i.channel()));
-      num_of_samples[i.channel()]++;
-
-      if (*i.current() >= 0) {
-	if (*i.current() > max_pos) max_pos = *i.current();
-
-	for(unsigned j = 0; j < pos_samples_db.size(); j++) {
-	  if (*i.current() > bucket_table[j].threshold) {
-	    pos_samples_db[j][i.channel()]++;
-	    break;
+    for(int c = 0; c < sbuf_repp->number_of_channels(); c++) {
+      SAMPLE_BUFFER::const_channel_span_t span = sbuf_repp->const_channel_span(c);
+
+      DBC_CHECK(num_of_samples.size() > static_cast<unsigned>(c));
+      num_of_samples[c] += span.length;
+
+      for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+	SAMPLE_SPECS::sample_t value = span.data[n];
+	if (value >= 0) {
+	  if (value > max_pos) max_pos = value;
+
+	  for(unsigned j = 0; j < pos_samples_db.size(); j++) {
+	    if (value > bucket_table[j].threshold) {
+	      pos_samples_db[j][c]++;
+	      break;
+	    }
 	  }
 	}
-      }
-      else {
-	if (-(*i.current()) > max_neg) max_neg = -(*i.current());
-
-	for(unsigned j = 0; j < neg_samples_db.size(); j++) {
-	  if (*i.current() < -bucket_table[j].threshold) {
-	    neg_samples_db[j][i.channel()]++;
-	    break;
+	else {
+	  if (-value > max_neg) max_neg = -value;
+
+	  for(unsigned j = 0; j < neg_samples_db.size(); j++) {
+	    if (value < -bucket_table[j].threshold) {
+	      neg_samples_db[j][c]++;
+	      break;
+	    }
 	  }
 	}
       }
-      i.next();
     }
 
     res = pthread_mutex_unlock(&lock_rep);
@@ -350,7 +351,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_VOLUME_PEAK::get_parameter(int param) const
 
 void EFFECT_VOLUME_PEAK::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
   if (max_amplitude_repp != 0) {
     delete[] max_amplitude_repp;
     max_amplitude_repp = 0;
@@ -361,15 +362,21 @@ void EFFECT_VOLUME_PEAK::init(SAMPLE_BUFFER* insample)
 
 void EFFECT_VOLUME_PEAK::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    SAMPLE_SPECS::sample_t abscurrent = std::fabs(*i.current());
-    DBC_CHECK(i.channel() >= 0);
-    DBC_CHECK(i.channel() < channels());
-    if (abscurrent > max_amplitude_repp[i.channel()]) {
-      max_amplitude_repp[i.channel()] = std::fabs(*i.current());
+  for(int c = 0; c < sbuf_repp->number_of_channels(); c++) {
+    SAMPLE_BUFFER::const_channel_span_t span = sbuf_repp->const_channel_span(c);
+    DBC_CHECK(c < channels());
+
+    /* note: peak of the block is calculated first, so that
+     *       the shared peak value is updated only once */
+    SAMPLE_SPECS::sample_t peak = 0.0f;
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      SAMPLE_SPECS::sample_t abscurrent = std::fabs(span.data[n]);
+      if (abscurrent > peak)
+	peak = abscurrent;
+    }
+    if (peak > max_amplitude_repp[c]) {
+      max_amplitude_repp[c] = peak;
     }
-    i.next();
   }
 }
 
@@ -437,7 +444,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_DCFIND::get_parameter(int param) const
 
 void EFFECT_DCFIND::init(SAMPLE_BUFFER *insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
   set_channels(insample->number_of_channels());
   pos_sum.resize(channels());
   neg_sum.resize(channels());
@@ -446,14 +453,19 @@ void EFFECT_DCFIND::init(SAMPLE_BUFFER *insample)
 
 void EFFECT_DCFIND::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    tempval = *i.current();
-    if (tempval > SAMPLE_SPECS::silent_value)
-      pos_sum[i.channel()] += tempval;
-    else
-      neg_sum[i.channel()] += fabs(tempval);
-    num_of_samples[i.channel()]++;
-    i.next();
+  for(int c = 0; c < sbuf_repp->number_of_channels(); c++) {
+    SAMPLE_BUFFER::const_channel_span_t span = sbuf_repp->const_channel_span(c);
+    parameter_t pos = pos_sum[c];
+    parameter_t neg = neg_sum[c];
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      SAMPLE_SPECS::sample_t tempval = span.data[n];
+      if (tempval > SAMPLE_SPECS::silent_value)
+	pos += tempval;
+      else
+	neg += fabs(tempval);
+    }
+    pos_sum[c] = pos;
+    neg_sum[c] = neg;
+    num_of_samples[c] += span.length;
   }
 }
@@ -6,7 +6,7 @@
 
 #include <pthread.h>
 
-#include "samplebuffer_iterators.h"
+#include "samplebuffer.h"
 #include "audiofx.h"
 
 class MESSAGE_ITEM;
@@ -23,6 +23,7 @@ class EFFECT_ANALYSIS : public EFFECT_BASE {
   virtual parameter_t get_parameter(int param) const { return(0.0); }
 
   virtual std::string parameter_names(void) const { return(""); }
+  virtual bool modifies_buffer(void) const { return(false); }
 
   virtual ~EFFECT_ANALYSIS(void);
 };
@@ -43,7 +44,7 @@ private:
   SAMPLE_SPECS::sample_t max_pos, max_neg;
 
   mutable pthread_mutex_t lock_rep;
-  SAMPLE_ITERATOR_CHANNELS i;
+  const SAMPLE_BUFFER* sbuf_repp;
 
   void reset_all_stats(void);
   void reset_period_stats(void);
@@ -102,7 +103,7 @@ class EFFECT_VOLUME_PEAK : public EFFECT_ANALYSIS {
 
   mutable std::string status_rep;
 
-  SAMPLE_ITERATOR_CHANNELS i;
+  const SAMPLE_BUFFER* sbuf_repp;
 };
 
 /**
@@ -118,8 +119,7 @@ private:
   std::vector<parameter_t> neg_sum;
   std::vector<parameter_t> num_of_samples;
 
-  SAMPLE_SPECS::sample_t tempval;
-  SAMPLE_ITERATOR_CHANNELS i;
+  const SAMPLE_BUFFER* sbuf_repp;
 
 public:
 
@@ -43,7 +43,6 @@
 #include <kvu_dbc.h>
 #include <kvu_message_item.h>
 
-#include "samplebuffer_iterators.h"
 
 #include "audiofx_amplitude.h"
 
@@ -234,20 +233,22 @@ double ADVANCED_COMPRESSOR::hardlimit(double value, double knee, double limit)
 }
 
 void ADVANCED_COMPRESSOR::init(SAMPLE_BUFFER* insample) {
-  iter.init(insample);
+  cur_sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
   set_samples_per_second(samples_per_second());
 }
 
 void ADVANCED_COMPRESSOR::process(void) {
-  iter.begin();
-  while(!iter.end()) {
+  SAMPLE_BUFFER::channel_span_t lspan = cur_sbuf_repp->channel_span(SAMPLE_SPECS::ch_left);
+  SAMPLE_BUFFER::channel_span_t rspan = cur_sbuf_repp->channel_span(SAMPLE_SPECS::ch_right);
+
+  for(SAMPLE_BUFFER::buf_size_t n = 0; n < lspan.length; n++) {
     //  right = insample->get_right() * 32767.0;
     //  left = insample->get_left() * 32767.0;
       
-    left = (*iter.current(0));
-    right = (*iter.current(1));
+    left = lspan.data[n];
+    right = rspan.data[n];
 
     rightdelay[ndelayptr] = right;
     leftdelay[ndelayptr] = left;
@@ -431,13 +432,13 @@ void ADVANCED_COMPRESSOR::process(void) {
     
     right = newright * sqrtrpeakgain;
     
-    *iter.current(1) = right;
+    rspan.data[n] = right;
     //insample->put_left(left / 32767.0);
     //  *righta = hardlimit(right, 32200, 32767);
     // cerr << "5.l:" << newleft << "\n";
     
     left = newleft * sqrtrpeakgain;
-    *iter.current(0) = left;
+    lspan.data[n] = left;
     //  insample->put_left(left / 32767.0);
     
     // cerr << "6.l:" << left << "\n";
@@ -456,8 +457,6 @@ void ADVANCED_COMPRESSOR::process(void) {
       extra_maxlevel = right;
     if (left > extra_maxlevel)
       extra_maxlevel = left;
-    
-    iter.next();
   }
   //  cerr << "post:" << insample->get_left() << "\n";
 }
@@ -10,8 +10,6 @@
  */
 class ADVANCED_COMPRESSOR : public EFFECT_AMPLITUDE {
 
-  SAMPLE_ITERATOR_INTERLEAVED iter;
-
  public:
 
  static const int NFILT = 12;
@@ -31,11 +31,11 @@
 //
 // ------------------------------------------------------------------------
 
+#include <algorithm> /* std::min(), std::max() */
 #include <cmath>
 
 #include <kvu_message_item.h>
 
-#include "samplebuffer_iterators.h"
 #include "audiofx_envelope_modulation.h"
 
 #include "eca-logger.h"
@@ -115,26 +115,28 @@ CHAIN_OPERATOR::parameter_t EFFECT_PULSE_GATE::get_parameter(int param) const
 
 void EFFECT_PULSE_GATE::init(SAMPLE_BUFFER* sbuf)
 { 
-  i.init(sbuf); 
+  sbuf_repp = sbuf;
   set_channels(sbuf->number_of_channels());
   EFFECT_ENV_MOD::init(sbuf);
 }
 
 void EFFECT_PULSE_GATE::process(void)
 {
-  i.begin(); // iterate through all samples, one sample-frame at a
-             // time (interleaved)
-  while(!i.end()) {
-    ++current_rep;
-    if (current_rep >= period_rep) {
+  /* note: each channel is processed starting from the same
+   *       gate position */
+  long int start = current_rep;
+  for(int ch = 0; ch < channels() && ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    current_rep = start;
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      ++current_rep;
+      if (current_rep >= period_rep) {
 	current_rep = 0;
-    }
-    if (current_rep > on_from_rep) {
-      for(int n = 0; n < channels(); n++) {
-	*i.current(n) = 0.0;
+      }
+      if (current_rep > on_from_rep) {
+	span.data[n] = 0.0;
       }
     }
-    i.next();
   }
 }
 
@@ -235,28 +237,40 @@ CHAIN_OPERATOR::parameter_t EFFECT_TREMOLO::get_parameter(int param) const
 
 void EFFECT_TREMOLO::init(SAMPLE_BUFFER* sbuf)
 {
-  i.init(sbuf);
+  sbuf_repp = sbuf;
   set_channels(sbuf->number_of_channels());
+  /* note: process() works in blocks of at most this size, so
+   *       no memory is allocated even if the buffer grows */
+  envelope_rep.resize(std::max<SAMPLE_BUFFER::buf_size_t>(sbuf->length_in_samples(), 1));
   incrTime = 1.0/samples_per_second();
   EFFECT_ENV_MOD::init(sbuf);
 }
 
 void EFFECT_TREMOLO::process(void)
 {
-  i.begin(); // iterate through all samples, one sample-frame at a
-             // time (interleaved)
-  while(!i.end())
-  {
-    currentTime += incrTime;
-    double envelope = (1-depth)+depth*fabs(sin(2*3.1416*currentTime*freq));
-    if (envelope < 0)
-    {
-       envelope = 0;
+  SAMPLE_BUFFER::buf_size_t len = sbuf_repp->length_in_samples();
+  SAMPLE_BUFFER::buf_size_t block = static_cast<SAMPLE_BUFFER::buf_size_t>(envelope_rep.size());
+
+  for(SAMPLE_BUFFER::buf_size_t offset = 0; offset < len; offset += block) {
+    SAMPLE_BUFFER::buf_size_t count = std::min(block, len - offset);
+
+    /* step: calculate the envelope once for all channels */
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < count; n++) {
+      currentTime += incrTime;
+      double envelope = (1-depth)+depth*fabs(sin(2*3.1416*currentTime*freq));
+      if (envelope < 0) {
+        envelope = 0;
+      }
+      envelope_rep[n] = envelope;
     }
-  	for(int n = 0; n < channels(); n++)
-  	{
-	    *i.current(n) *= envelope;
+
+    /* step: apply it to each channel */
+    for(int ch = 0; ch < channels() && ch < sbuf_repp->number_of_channels(); ch++) {
+      SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+      SAMPLE_SPECS::sample_t* data = span.data + offset;
+      for(SAMPLE_BUFFER::buf_size_t n = 0; n < count; n++) {
+        data[n] *= envelope_rep[n];
+      }
     }
-    i.next();
   }
 }
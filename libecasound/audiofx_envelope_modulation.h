@@ -2,8 +2,9 @@
 #define INCLUDED_AUDIOFX_ENVELOPE_MODULATION_H
 
 #include <string>
+#include <vector>
 
-#include "samplebuffer_iterators.h"
+#include "samplebuffer.h"
 #include "audiofx.h"
 
 /**
@@ -22,7 +23,7 @@ class EFFECT_ENV_MOD : public EFFECT_BASE {
  */
 class EFFECT_PULSE_GATE: public EFFECT_ENV_MOD {
 
-  SAMPLE_ITERATOR_INTERLEAVED i;
+  SAMPLE_BUFFER* sbuf_repp;
   parameter_t freq_rep;
   parameter_t on_time_rep;
   long int period_rep;
@@ -95,7 +96,8 @@ class EFFECT_PULSE_GATE_BPM : public EFFECT_ENV_MOD {
  */
 class EFFECT_TREMOLO: public EFFECT_ENV_MOD {
 
-  SAMPLE_ITERATOR_INTERLEAVED i;
+  SAMPLE_BUFFER* sbuf_repp;
+  std::vector<double> envelope_rep;
   parameter_t freq;
   parameter_t depth;
   parameter_t currentTime;
@@ -24,7 +24,6 @@
 
 #include <kvu_utils.h>
 
-#include "samplebuffer_iterators.h"
 #include "sample-ops_impl.h"
 #include "eca-logger.h"
 #include "audiofx_filter.h"
@@ -125,7 +124,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_BANDREJECT::get_parameter(int param) const
 
 void EFFECT_BW_FILTER::init(SAMPLE_BUFFER *insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -144,21 +143,28 @@ void EFFECT_BW_FILTER::init(SAMPLE_BUFFER *insample)
 
 void EFFECT_BW_FILTER::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    outputSample = ecaops_flush_to_zero(a[0] * (*i.current()) + 
-					a[1] * sin[i.channel()][0] + 
-					a[2] * sin[i.channel()][1] - 
-					b[0] * sout[i.channel()][0] - 
-					b[1] * sout[i.channel()][1]);
-    sin[i.channel()][1] = sin[i.channel()][0];
-    sin[i.channel()][0] = *i.current();
-
-    sout[i.channel()][1] = sout[i.channel()][0];
-    sout[i.channel()][0] = outputSample;
-
-    *i.current() = outputSample;
-    i.next();
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    SAMPLE_SPECS::sample_t sin0 = sin[ch][0], sin1 = sin[ch][1];
+    SAMPLE_SPECS::sample_t sout0 = sout[ch][0], sout1 = sout[ch][1];
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      outputSample = ecaops_flush_to_zero(a[0] * span.data[n] + 
+					  a[1] * sin0 + 
+					  a[2] * sin1 - 
+					  b[0] * sout0 - 
+					  b[1] * sout1);
+      sin1 = sin0;
+      sin0 = span.data[n];
+
+      sout1 = sout0;
+      sout0 = outputSample;
+
+      span.data[n] = outputSample;
+    }
+    sin[ch][0] = sin0;
+    sin[ch][1] = sin1;
+    sout[ch][0] = sout0;
+    sout[ch][1] = sout1;
   }
 }
 
@@ -259,7 +265,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_ALLPASS_FILTER::get_parameter(int param) cons
 
 void EFFECT_ALLPASS_FILTER::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -270,32 +276,33 @@ void EFFECT_ALLPASS_FILTER::init(SAMPLE_BUFFER* insample)
 
 void EFFECT_ALLPASS_FILTER::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    if (inbuf[i.channel()].size() >= D) {
-      inbuf[i.channel()].push_back(*i.current());
-
-      //      *i.current() = -feedback_gain * (*i.current()) +
-      //	             inbuf[i.channel()].front() +
-      //	             feedback_gain * outbuf[i.channel()].front();
-
-      *i.current() = ecaops_flush_to_zero(-feedback_gain * (*i.current()) +
-					  (feedback_gain * inbuf[i.channel()].front() +
-					   *i.current()) * 
-					  (1.0 - feedback_gain * feedback_gain));
-
-      //      feedback_gain * outbuf[i.channel()].front();
-      //      outbuf[i.channel()].push_back(*i.current());
-
-      inbuf[i.channel()].pop_front();
-      // outbuf[i.channel()].pop_front();
-    } 
-    else {
-      inbuf[i.channel()].push_back(*i.current());
-      *i.current() = ecaops_flush_to_zero(*i.current() * (1.0 - feedback_gain));
-      // outbuf[i.channel()].push_back(*i.current());
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      if (inbuf[ch].size() >= D) {
+	inbuf[ch].push_back(span.data[n]);
+
+	//      span.data[n] = -feedback_gain * span.data[n] +
+	//	             inbuf[ch].front() +
+	//	             feedback_gain * outbuf[ch].front();
+
+	span.data[n] = ecaops_flush_to_zero(-feedback_gain * span.data[n] +
+					    (feedback_gain * inbuf[ch].front() +
+					     span.data[n]) * 
+					    (1.0 - feedback_gain * feedback_gain));
+
+	//      feedback_gain * outbuf[ch].front();
+	//      outbuf[ch].push_back(span.data[n]);
+
+	inbuf[ch].pop_front();
+	// outbuf[ch].pop_front();
+      } 
+      else {
+	inbuf[ch].push_back(span.data[n]);
+	span.data[n] = ecaops_flush_to_zero(span.data[n] * (1.0 - feedback_gain));
+	// outbuf[ch].push_back(span.data[n]);
+      }
     }
-    i.next();
   }
 }
 
@@ -340,7 +347,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_COMB_FILTER::get_parameter(int param) const
 
 void EFFECT_COMB_FILTER::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -352,18 +359,19 @@ void EFFECT_COMB_FILTER::init(SAMPLE_BUFFER* insample)
 
 void EFFECT_COMB_FILTER::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    if (buffer[i.channel()].size() >= C) {
-      *i.current() = (*i.current())  + (pow(D, C) *
-					buffer[i.channel()].front());
-      buffer[i.channel()].push_back(*i.current());
-      buffer[i.channel()].pop_front();
-    } 
-    else {
-      buffer[i.channel()].push_back(*i.current());
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      if (buffer[ch].size() >= C) {
+	span.data[n] = span.data[n]  + (pow(D, C) *
+					  buffer[ch].front());
+	buffer[ch].push_back(span.data[n]);
+	buffer[ch].pop_front();
+      } 
+      else {
+	buffer[ch].push_back(span.data[n]);
+      }
     }
-    i.next();
   }
 }
 
@@ -402,7 +410,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_INVERSE_COMB_FILTER::get_parameter(int param)
 
 void EFFECT_INVERSE_COMB_FILTER::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -415,19 +423,20 @@ void EFFECT_INVERSE_COMB_FILTER::init(SAMPLE_BUFFER* insample)
 
 void EFFECT_INVERSE_COMB_FILTER::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    buffer[i.channel()].push_back(*i.current());
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      buffer[ch].push_back(span.data[n]);
     
-    if (laskuri[i.channel()] >= C) {
-      *i.current() = (*i.current())  - (pow(D, C) *
-					buffer[i.channel()].front());
-      buffer[i.channel()].pop_front();
-    } 
-    else {
-      laskuri[i.channel()]++;
+      if (laskuri[ch] >= C) {
+	span.data[n] = span.data[n]  - (pow(D, C) *
+					  buffer[ch].front());
+	buffer[ch].pop_front();
+      } 
+      else {
+	laskuri[ch]++;
+      }
     }
-    i.next();
   }
 }
 
@@ -491,7 +500,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_LOWPASS_SIMPLE::get_parameter(int param) cons
 
 void EFFECT_LOWPASS_SIMPLE::init(SAMPLE_BUFFER *insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -502,18 +511,18 @@ void EFFECT_LOWPASS_SIMPLE::init(SAMPLE_BUFFER *insample)
 
 void EFFECT_LOWPASS_SIMPLE::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    tempin[i.channel()] = *i.current();
-    temphist[i.channel()] = outhist[i.channel()];
-    outhist[i.channel()] = tempin[i.channel()];
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      tempin[ch] = span.data[n];
+      temphist[ch] = outhist[ch];
+      outhist[ch] = tempin[ch];
     
-    tempin[i.channel()] *= A * 0.5;
-    temphist[i.channel()] *= B * 0.5;
-
-    *i.current() = ecaops_flush_to_zero(tempin[i.channel()] + temphist[i.channel()]);
+      tempin[ch] *= A * 0.5;
+      temphist[ch] *= B * 0.5;
 
-    i.next();
+      span.data[n] = ecaops_flush_to_zero(tempin[ch] + temphist[ch]);
+    }
   }
 }
 
@@ -563,7 +572,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_RESONANT_BANDPASS::get_parameter(int param) c
 
 void EFFECT_RESONANT_BANDPASS::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -573,16 +582,16 @@ void EFFECT_RESONANT_BANDPASS::init(SAMPLE_BUFFER* insample)
 
 void EFFECT_RESONANT_BANDPASS::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    *i.current() = ecaops_flush_to_zero(a * (*i.current()) +
-					b * outhist1[i.channel()] -
-					c * outhist2[i.channel()]);
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      span.data[n] = ecaops_flush_to_zero(a * span.data[n] +
+					  b * outhist1[ch] -
+					  c * outhist2[ch]);
   
-    outhist2[i.channel()] = outhist1[i.channel()];
-    outhist1[i.channel()] = *i.current();
-
-    i.next();
+      outhist2[ch] = outhist1[ch];
+      outhist1[ch] = span.data[n];
+    }
   }
 }
 
@@ -725,7 +734,7 @@ void EFFECT_RESONANT_LOWPASS::szxform(int section)
 
 void EFFECT_RESONANT_LOWPASS::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -739,39 +748,39 @@ void EFFECT_RESONANT_LOWPASS::init(SAMPLE_BUFFER* insample)
 
 void EFFECT_RESONANT_LOWPASS::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    *i.current() = (*i.current()) * gain;
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      span.data[n] = span.data[n] * gain;
 
-    // first section:
-    // --------------
+      // first section:
+      // --------------
     
-    // poles:
-    *i.current() =  (*i.current()) - outhist0[i.channel()] * Coef[0].A;
-    newhist0[i.channel()] = ecaops_flush_to_zero((*i.current()) - outhist1[i.channel()] * Coef[0].B);
+      // poles:
+      span.data[n] =  span.data[n] - outhist0[ch] * Coef[0].A;
+      newhist0[ch] = ecaops_flush_to_zero(span.data[n] - outhist1[ch] * Coef[0].B);
         
-    // zeros:
-    *i.current() = newhist0[i.channel()] + outhist0[i.channel()] * Coef[0].C;
-    *i.current() = (*i.current()) +  outhist1[i.channel()] * Coef[0].D;
+      // zeros:
+      span.data[n] = newhist0[ch] + outhist0[ch] * Coef[0].C;
+      span.data[n] = span.data[n] +  outhist1[ch] * Coef[0].D;
     
-    outhist1[i.channel()] = outhist0[i.channel()];
-    outhist0[i.channel()] = newhist0[i.channel()];
+      outhist1[ch] = outhist0[ch];
+      outhist0[ch] = newhist0[ch];
         
-    // second section:
-    // --------------
+      // second section:
+      // --------------
     
-    // poles:
-    *i.current() =  (*i.current()) - outhist2[i.channel()] * Coef[1].A;
-    newhist1[i.channel()] = ecaops_flush_to_zero((*i.current()) - outhist3[i.channel()] * Coef[1].B);
+      // poles:
+      span.data[n] =  span.data[n] - outhist2[ch] * Coef[1].A;
+      newhist1[ch] = ecaops_flush_to_zero(span.data[n] - outhist3[ch] * Coef[1].B);
        
-    // zeros:
-    *i.current() = newhist1[i.channel()] + outhist2[i.channel()] * Coef[1].C;
-    *i.current() = (*i.current()) +  outhist3[i.channel()] * Coef[1].D;
+      // zeros:
+      span.data[n] = newhist1[ch] + outhist2[ch] * Coef[1].C;
+      span.data[n] = span.data[n] +  outhist3[ch] * Coef[1].D;
     
-    outhist3[i.channel()] = outhist2[i.channel()];
-    outhist2[i.channel()] = newhist1[i.channel()];
-
-    i.next();
+      outhist3[ch] = outhist2[ch];
+      outhist2[ch] = newhist1[ch];
+    }
   }
 }
 
@@ -846,7 +855,7 @@ CHAIN_OPERATOR::parameter_t EFFECT_RESONATOR::get_parameter(int param) const {
 }
 
 void EFFECT_RESONATOR::init(SAMPLE_BUFFER* insample) {
-  i.init(insample);
+  sbuf_repp = insample;
 
   set_channels(insample->number_of_channels());
 
@@ -856,15 +865,15 @@ void EFFECT_RESONATOR::init(SAMPLE_BUFFER* insample) {
 
 void EFFECT_RESONATOR::process(void)
 {
-  i.begin();
-  while(!i.end()) {
-    *i.current() = cona[0] * (*i.current()) -
-                   conb[0] * saout0[i.channel()] -
-		   conb[1] * saout1[i.channel()];
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      span.data[n] = cona[0] * span.data[n] -
+		     conb[0] * saout0[ch] -
+		     conb[1] * saout1[ch];
     
-    saout1[i.channel()] = saout0[i.channel()];
-    saout0[i.channel()] = ecaops_flush_to_zero(*i.current());
-				 
-    i.next();
+      saout1[ch] = saout0[ch];
+      saout0[ch] = ecaops_flush_to_zero(span.data[n]);
+    }
   }
 }
@@ -6,7 +6,7 @@
 #include <vector>
 
 #include "audiofx.h"
-#include "samplebuffer_iterators.h"
+#include "samplebuffer.h"
 
 /**
  * Virtual base for filter effects.
@@ -29,7 +29,7 @@ class EFFECT_BW_FILTER : public EFFECT_FILTER {
 private:
   
   SAMPLE_SPECS::sample_t outputSample;
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
 
   std::vector<std::vector<SAMPLE_SPECS::sample_t> > sin;
   std::vector<std::vector<SAMPLE_SPECS::sample_t> > sout;
@@ -46,6 +46,7 @@ public:
   void process_notused(SAMPLE_BUFFER* sbuf);
   virtual void init(SAMPLE_BUFFER *insample);
   virtual void process(void);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
 
   virtual EFFECT_BW_FILTER* clone(void) const = 0;
 
@@ -146,7 +147,7 @@ public:
 class EFFECT_ALLPASS_FILTER : public EFFECT_FILTER {
 
   std::vector<std::deque<SAMPLE_SPECS::sample_t> > inbuf, outbuf;
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
 
   parameter_t feedback_gain;
   parameter_t D;
@@ -178,7 +179,7 @@ class EFFECT_COMB_FILTER : public EFFECT_FILTER {
 
   std::vector<std::deque<SAMPLE_SPECS::sample_t> > buffer;
   std::vector<SAMPLE_SPECS::sample_t> temp;
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
 
   parameter_t C;
   parameter_t D;
@@ -210,7 +211,7 @@ class EFFECT_INVERSE_COMB_FILTER : public EFFECT_FILTER {
   std::vector<parameter_t> laskuri;
   std::vector<std::deque<SAMPLE_SPECS::sample_t> > buffer;
   std::vector<SAMPLE_SPECS::sample_t> temp;
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
 
   parameter_t C;
   parameter_t D;
@@ -221,6 +222,7 @@ public:
   virtual std::string parameter_names(void) const { return("delay-samples,radius"); }
 
   virtual void set_parameter(int param, parameter_t value);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
   virtual parameter_t get_parameter(int param) const;
 
   virtual void init(SAMPLE_BUFFER *insample);
@@ -278,7 +280,7 @@ private:
   parameter_t cutOffFreq;
   parameter_t A, B;
   std::vector<SAMPLE_SPECS::sample_t> outhist, tempin, temphist;
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
 
 public:
 
@@ -289,6 +291,7 @@ public:
   virtual void process(void);
 
   virtual void set_parameter(int param, parameter_t value);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
   virtual parameter_t get_parameter(int param) const;
 
   EFFECT_LOWPASS_SIMPLE* clone(void) const { return new EFFECT_LOWPASS_SIMPLE(*this); }
@@ -311,7 +314,7 @@ private:
   parameter_t a, b, c, R;
   parameter_t pole_angle;
 
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
 
 public:
 
@@ -319,6 +322,7 @@ public:
   virtual std::string parameter_names(void) const { return("center-freq,width"); }
 
   virtual void set_parameter(int param, parameter_t value);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
   virtual parameter_t get_parameter(int param) const;
 
   virtual void init(SAMPLE_BUFFER *insample);
@@ -336,7 +340,7 @@ public:
  */
 class EFFECT_RESONANT_LOWPASS : public EFFECT_FILTER {
 
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
     
   std::vector<SAMPLE_SPECS::sample_t> outhist0, outhist1, outhist2, outhist3;
   std::vector<SAMPLE_SPECS::sample_t> newhist0, newhist1;
@@ -371,6 +375,7 @@ public:
   virtual std::string parameter_names(void) const { return("cutoff-freq,resonance,gain"); }
 
   virtual void set_parameter(int param, parameter_t value);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
   virtual parameter_t get_parameter(int param) const;
 
   virtual void init(SAMPLE_BUFFER *insample);
@@ -393,7 +398,7 @@ class EFFECT_RESONATOR : public EFFECT_FILTER {
 
 private:
 
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
     
   parameter_t center;
   parameter_t width;
@@ -409,6 +414,7 @@ public:
   virtual std::string parameter_names(void) const { return("center-freq,width"); }
 
   virtual void set_parameter(int param, parameter_t value);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
   virtual parameter_t get_parameter(int param) const;
 
   virtual void init(SAMPLE_BUFFER *insample);
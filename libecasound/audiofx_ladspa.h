@@ -53,6 +53,7 @@ public:
 
   virtual void parameter_description(int param, struct PARAM_DESCRIPTION *pd) const;
   virtual void set_parameter(int param, parameter_t value);
+  virtual bool realtime_safe_set_parameter(int param) const { return(true); }
   virtual parameter_t get_parameter(int param) const;
 
   virtual void init(SAMPLE_BUFFER *insample);
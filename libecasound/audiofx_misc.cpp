@@ -27,7 +27,6 @@
 #include <kvu_numtostr.h>
 #include <kvu_utils.h>
 
-#include "samplebuffer_iterators.h"
 #include "eca-operator.h"
 #include "audiofx_misc.h"
 #include "eca-logger.h"
@@ -40,7 +39,7 @@ EFFECT_DCFIX::EFFECT_DCFIX (void)
 EFFECT_DCFIX::EFFECT_DCFIX (const EFFECT_DCFIX& x)
 {
   deltafixes_rep = x.deltafixes_rep;
-  i_rep = x.i_rep;
+  sbuf_repp = x.sbuf_repp;
 }
 
 void EFFECT_DCFIX::set_parameter(int param, CHAIN_OPERATOR::parameter_t value)
@@ -87,7 +86,7 @@ void EFFECT_DCFIX::parameter_description(int param, struct PARAM_DESCRIPTION *pd
 
 void EFFECT_DCFIX::init(SAMPLE_BUFFER *insample)
 {
-  i_rep.init(insample);
+  sbuf_repp = insample;
   set_channels(insample->number_of_channels());
   if (channels() > static_cast<int>(deltafixes_rep.size())) {
     deltafixes_rep.resize(channels());
@@ -96,11 +95,11 @@ void EFFECT_DCFIX::init(SAMPLE_BUFFER *insample)
 
 void EFFECT_DCFIX::process(void)
 {
-  for(int n = 0; n < channels(); n++) {
-    i_rep.begin(n);
-    while(!i_rep.end()) {
-      *i_rep.current() = *i_rep.current() + deltafixes_rep[n];
-      i_rep.next();
+  for(int ch = 0; ch < channels() && ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    parameter_t deltafix = deltafixes_rep[ch];
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      span.data[n] = span.data[n] + deltafix;
     }
   }
 }
@@ -3,7 +3,7 @@
 
 #include <vector>
 #include "sample-specs.h"
-#include "samplebuffer_iterators.h"
+#include "samplebuffer.h"
 #include "audio-stamp.h"
 #include "audiofx.h"
 
@@ -16,7 +16,7 @@ class EFFECT_DCFIX : public EFFECT_BASE {
 private:
 
   std::vector<parameter_t> deltafixes_rep;
-  SAMPLE_ITERATOR_CHANNEL i_rep;
+  SAMPLE_BUFFER* sbuf_repp;
 
 public:
 
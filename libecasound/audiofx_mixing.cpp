@@ -20,10 +20,11 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 // ------------------------------------------------------------------------
 
+#include <algorithm> /* std::min(), std::max() */
+
 #include <kvu_dbc.h>
 #include <kvu_numtostr.h>
 
-#include "samplebuffer_iterators.h"
 #include "audiofx_mixing.h"
 
 static EFFECT_MIXING::ch_type priv_from_make_sane(EFFECT_MIXING::ch_type channel, SAMPLE_BUFFER *insample)
@@ -109,20 +110,21 @@ CHAIN_OPERATOR::parameter_t EFFECT_CHANNEL_COPY::get_parameter(int param) const
 
 void EFFECT_CHANNEL_COPY::init(SAMPLE_BUFFER *insample)
 {
-  f_iter.init(insample);
-  t_iter.init(insample);
+  sbuf_repp = insample;
   from_channel = priv_from_make_sane(from_channel, insample);
   to_channel = priv_to_make_sane(to_channel, insample);
 }
 
 void EFFECT_CHANNEL_COPY::process(void)
 {
-  f_iter.begin(from_channel);
-  t_iter.begin(to_channel);
-  while(!f_iter.end() && !t_iter.end()) {
-    *t_iter.current() = *f_iter.current();
-    f_iter.next();
-    t_iter.next();
+  ch_type channels = static_cast<ch_type>(sbuf_repp->number_of_channels());
+  if (from_channel >= channels || to_channel >= channels)
+    return;
+
+  SAMPLE_BUFFER::channel_span_t from = sbuf_repp->channel_span(from_channel);
+  SAMPLE_BUFFER::channel_span_t to = sbuf_repp->channel_span(to_channel);
+  for(SAMPLE_BUFFER::buf_size_t n = 0; n < to.length; n++) {
+    to.data[n] = from.data[n];
   }
 }
 
@@ -184,22 +186,23 @@ CHAIN_OPERATOR::parameter_t EFFECT_CHANNEL_MOVE::get_parameter(int param) const
 
 void EFFECT_CHANNEL_MOVE::init(SAMPLE_BUFFER *insample)
 {
-  f_iter.init(insample);
-  t_iter.init(insample);
+  sbuf_repp = insample;
   from_channel = priv_from_make_sane(from_channel, insample);
   to_channel = priv_to_make_sane(to_channel, insample);
 }
 
 void EFFECT_CHANNEL_MOVE::process(void)
 {
-  f_iter.begin(from_channel);
-  t_iter.begin(to_channel);
-  while(!f_iter.end() && !t_iter.end()) {
-    *t_iter.current() = *f_iter.current();
+  ch_type channels = static_cast<ch_type>(sbuf_repp->number_of_channels());
+  if (from_channel >= channels || to_channel >= channels)
+    return;
+
+  SAMPLE_BUFFER::channel_span_t from = sbuf_repp->channel_span(from_channel);
+  SAMPLE_BUFFER::channel_span_t to = sbuf_repp->channel_span(to_channel);
+  for(SAMPLE_BUFFER::buf_size_t n = 0; n < to.length; n++) {
+    to.data[n] = from.data[n];
     if (from_channel != to_channel)
-      *f_iter.current() = SAMPLE_SPECS::silent_value;
-    f_iter.next();
-    t_iter.next();
+      from.data[n] = SAMPLE_SPECS::silent_value;
   }
 }
 
@@ -292,25 +295,38 @@ CHAIN_OPERATOR::parameter_t EFFECT_MIX_TO_CHANNEL::get_parameter(int param) cons
 
 void EFFECT_MIX_TO_CHANNEL::init(SAMPLE_BUFFER *insample)
 {
-  i.init(insample);
-  t_iter.init(insample);
+  sbuf_repp = insample;
   channels = insample->number_of_channels();
   to_channel = priv_to_make_sane(to_channel, insample);
+  /* note: process() works in blocks of at most this size, so
+   *       no memory is allocated even if the buffer grows */
+  sum_rep.resize(std::max<SAMPLE_BUFFER::buf_size_t>(insample->length_in_samples(), 1));
 }
 
 void EFFECT_MIX_TO_CHANNEL::process(void)
 {
-  i.begin();
-  t_iter.begin(to_channel);
-  while(!t_iter.end() && !i.end()) {
-    sum = SAMPLE_SPECS::silent_value;
-    for (int n = 0; n < channels; n++) {
-      if (i.end()) break;
-      sum += (*i.current(n));
+  if (to_channel >= static_cast<ch_type>(sbuf_repp->number_of_channels()))
+    return;
+
+  SAMPLE_BUFFER::channel_span_t to = sbuf_repp->channel_span(to_channel);
+  SAMPLE_BUFFER::buf_size_t block = static_cast<SAMPLE_BUFFER::buf_size_t>(sum_rep.size());
+
+  for(SAMPLE_BUFFER::buf_size_t offset = 0; offset < to.length; offset += block) {
+    SAMPLE_BUFFER::buf_size_t count = std::min(block, to.length - offset);
+
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < count; n++)
+      sum_rep[n] = SAMPLE_SPECS::silent_value;
+
+    /* note: channels are summed one at a time, in the same
+     *       order for each sample frame */
+    for(int c = 0; c < channels && c < sbuf_repp->number_of_channels(); c++) {
+      const SAMPLE_SPECS::sample_t* from = sbuf_repp->const_channel_span(c).data + offset;
+      for(SAMPLE_BUFFER::buf_size_t n = 0; n < count; n++)
+        sum_rep[n] += from[n];
     }
-    *t_iter.current() = sum / channels;
-    i.next();
-    t_iter.next();
+
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < count; n++)
+      to.data[offset + n] = sum_rep[n] / channels;
   }
 }
 
@@ -409,8 +425,6 @@ void EFFECT_CHANNEL_ORDER::init(SAMPLE_BUFFER *insample)
   bouncebuf_rep.number_of_channels(sbuf_repp->number_of_channels());
   bouncebuf_rep.length_in_samples(sbuf_repp->length_in_samples());
 
-  f_iter.init(&bouncebuf_rep);
-  t_iter.init(insample);
 }
 
 void EFFECT_CHANNEL_ORDER::release(void)
@@ -437,12 +451,12 @@ void EFFECT_CHANNEL_ORDER::process(void)
 #endif
 
     if (src_ch >= 0 && src_ch < bouncebuf_rep.number_of_channels()) {
-      f_iter.begin(src_ch);
-      t_iter.begin(dst_ch);
-      while(!f_iter.end() && !t_iter.end()) {
-	*t_iter.current() = *f_iter.current();
-	f_iter.next();
-	t_iter.next();
+      if (dst_ch < sbuf_repp->number_of_channels()) {
+	SAMPLE_BUFFER::const_channel_span_t from = bouncebuf_rep.const_channel_span(src_ch);
+	SAMPLE_BUFFER::channel_span_t to = sbuf_repp->channel_span(dst_ch);
+	for(SAMPLE_BUFFER::buf_size_t n = 0; n < to.length && n < from.length; n++) {
+	  to.data[n] = from.data[n];
+	}
       }
     }
     else {
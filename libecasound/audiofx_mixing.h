@@ -3,7 +3,7 @@
 
 #include <vector>
 
-#include "samplebuffer_iterators.h"
+#include "samplebuffer.h"
 #include "audiofx.h"
 #include "audiofx_amplitude.h"
 
@@ -27,7 +27,7 @@ class EFFECT_CHANNEL_COPY : public EFFECT_MIXING {
 private:
 
   ch_type from_channel, to_channel;
-  SAMPLE_ITERATOR_CHANNEL f_iter, t_iter;
+  SAMPLE_BUFFER* sbuf_repp;
 
 public:
 
@@ -42,6 +42,7 @@ public:
 
   virtual void init(SAMPLE_BUFFER *insample);
   virtual void process(void);
+  virtual bool silent_for_silent_input(void) const { return(true); }
 
   EFFECT_CHANNEL_COPY* clone(void) const { return new EFFECT_CHANNEL_COPY(*this); }
   EFFECT_CHANNEL_COPY* new_expr(void) const { return new EFFECT_CHANNEL_COPY(); }
@@ -57,7 +58,7 @@ class EFFECT_CHANNEL_MOVE : public EFFECT_MIXING {
 private:
 
   ch_type from_channel, to_channel;
-  SAMPLE_ITERATOR_CHANNEL f_iter, t_iter;
+  SAMPLE_BUFFER* sbuf_repp;
 
 public:
 
@@ -72,6 +73,7 @@ public:
 
   void init(SAMPLE_BUFFER *insample);
   void process(void);
+  virtual bool silent_for_silent_input(void) const { return(true); }
 
   EFFECT_CHANNEL_MOVE* clone(void) const { return new EFFECT_CHANNEL_MOVE(*this); }
   EFFECT_CHANNEL_MOVE* new_expr(void) const { return new EFFECT_CHANNEL_MOVE(); }
@@ -110,10 +112,8 @@ private:
 
   int channels;
   ch_type to_channel;
-  parameter_t sum;
-
-  SAMPLE_ITERATOR_CHANNEL t_iter;
-  SAMPLE_ITERATOR_INTERLEAVED i;
+  std::vector<parameter_t> sum_rep;
+  SAMPLE_BUFFER* sbuf_repp;
 
 public:
 
@@ -128,6 +128,7 @@ public:
 
   void init(SAMPLE_BUFFER *insample);
   void process(void);
+  virtual bool silent_for_silent_input(void) const { return(true); }
 
   EFFECT_MIX_TO_CHANNEL* clone(void) const { return new EFFECT_MIX_TO_CHANNEL(*this); }
   EFFECT_MIX_TO_CHANNEL* new_expr(void) const { return new EFFECT_MIX_TO_CHANNEL(); }
@@ -142,7 +143,6 @@ class EFFECT_CHANNEL_ORDER : public EFFECT_MIXING {
 
 private:
 
-  SAMPLE_ITERATOR_CHANNEL f_iter, t_iter;
   SAMPLE_BUFFER *sbuf_repp;
   SAMPLE_BUFFER bouncebuf_rep;
   std::string param_names_rep;
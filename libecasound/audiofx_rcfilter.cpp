@@ -21,7 +21,6 @@
 #include <cmath>
 #include <kvu_utils.h>
 
-#include "samplebuffer_iterators.h"
 #include "eca-logger.h"
 #include "audiofx_rcfilter.h"
 
@@ -60,7 +59,7 @@ static void priv_resize_buffer(std::vector<SAMPLE_SPECS::sample_t> *buffer, int
 }
 
 void EFFECT_RC_LOWPASS_FILTER::init(SAMPLE_BUFFER *insample) {
-  i.init(insample);
+  sbuf_repp = insample;
 
   priv_resize_buffer(&lp1_old, insample->number_of_channels(), 0.0015);
   priv_resize_buffer(&lp2_old, insample->number_of_channels(), -0.00067);
@@ -70,48 +69,49 @@ void EFFECT_RC_LOWPASS_FILTER::init(SAMPLE_BUFFER *insample) {
 }
 
 void EFFECT_RC_LOWPASS_FILTER::process(void) {
-  i.begin();
-  while(!i.end()) {
-    output_temp = *i.current();
-    output_temp += (feedback[i.channel()] * resonance_rep);
-
-    // --
-    // The two lines above prevent the filter from clipping if it is 
-    // self-oscillating. This is necessary for a good simulation because 
-    // real analouge RC-filters can't clip when oscillating, too. Clipping
-    // used to simulate saturation of an amp (as many TB-303-emulators do)
-    // is dissatisfying ! We should use an Amp-simulation instead to avoid
-    // digital clipping ...
-
-    if (output_temp > SAMPLE_SPECS::impl_max_value)
-      output_temp = SAMPLE_SPECS::impl_max_value;
-    else if (output_temp < SAMPLE_SPECS::impl_min_value) 
-      output_temp = SAMPLE_SPECS::impl_min_value;
-
-    // --
-    // Ok, this is the first step of the filter. We simulate an simple
-    // non-active RC-lowpass ... 
-
-    lp1_old[i.channel()] = output_temp * cutoff_rep + lp1_old[i.channel()] * (1.0 - cutoff_rep);
-    lp2_old[i.channel()] = lp1_old[i.channel()] * cutoff_rep + lp2_old[i.channel()] * (1.0 - cutoff_rep);
-    lp3_old[i.channel()] = lp2_old[i.channel()] * cutoff_rep + lp3_old[i.channel()] * (1.0 - cutoff_rep);
-
-    // --
-    // A simple non-active highpass
-
-    hp1_old[i.channel()] = output_temp - lp3_old[i.channel()];
-
-    // --
-    // Now we add a feedback of this bandpass-filtered signal to the
-    // input of the filter again. (Look some lines above for that!)
-
-    feedback[i.channel()] = hp1_old[i.channel()];
-
-    // --
-    // We catch the out-value of the filter after the second lp-filter
-    // this provides 24-db filtering even with moderate resonance.
-
-    *i.current() = lp3_old[i.channel()];
-    i.next();
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      output_temp = span.data[n];
+      output_temp += (feedback[ch] * resonance_rep);
+
+      // --
+      // The two lines above prevent the filter from clipping if it is 
+      // self-oscillating. This is necessary for a good simulation because 
+      // real analouge RC-filters can't clip when oscillating, too. Clipping
+      // used to simulate saturation of an amp (as many TB-303-emulators do)
+      // is dissatisfying ! We should use an Amp-simulation instead to avoid
+      // digital clipping ...
+
+      if (output_temp > SAMPLE_SPECS::impl_max_value)
+	output_temp = SAMPLE_SPECS::impl_max_value;
+      else if (output_temp < SAMPLE_SPECS::impl_min_value) 
+	output_temp = SAMPLE_SPECS::impl_min_value;
+
+      // --
+      // Ok, this is the first step of the filter. We simulate an simple
+      // non-active RC-lowpass ... 
+
+      lp1_old[ch] = output_temp * cutoff_rep + lp1_old[ch] * (1.0 - cutoff_rep);
+      lp2_old[ch] = lp1_old[ch] * cutoff_rep + lp2_old[ch] * (1.0 - cutoff_rep);
+      lp3_old[ch] = lp2_old[ch] * cutoff_rep + lp3_old[ch] * (1.0 - cutoff_rep);
+
+      // --
+      // A simple non-active highpass
+
+      hp1_old[ch] = output_temp - lp3_old[ch];
+
+      // --
+      // Now we add a feedback of this bandpass-filtered signal to the
+      // input of the filter again. (Look some lines above for that!)
+
+      feedback[ch] = hp1_old[ch];
+
+      // --
+      // We catch the out-value of the filter after the second lp-filter
+      // this provides 24-db filtering even with moderate resonance.
+
+      span.data[n] = lp3_old[ch];
+    }
   }
 }
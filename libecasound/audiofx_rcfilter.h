@@ -5,7 +5,7 @@
 #include <deque>
 
 #include "audiofx_filter.h"
-#include "samplebuffer_iterators.h"
+#include "samplebuffer.h"
 
 /**
  * Simulation of an 3rd-order 36dB active RC-lowpass
@@ -26,7 +26,7 @@
  */
 class EFFECT_RC_LOWPASS_FILTER : public EFFECT_FILTER {
 
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
   SAMPLE_SPECS::sample_t output_temp;
   std::vector<SAMPLE_SPECS::sample_t> lp1_old, lp2_old, lp3_old, hp1_old, feedback;
     
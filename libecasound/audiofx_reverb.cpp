@@ -37,7 +37,6 @@
 #include <cstdlib>
 
 #include "sample-ops_impl.h"
-#include "samplebuffer_iterators.h"
 #include "sample-specs.h"
 #include "audiofx_reverb.h"
 
@@ -143,7 +142,7 @@ void ADVANCED_REVERB::set_parameter(int param, CHAIN_OPERATOR::parameter_t value
 
 void ADVANCED_REVERB::init(SAMPLE_BUFFER *insample)
 {
-  i_channels.init(insample);
+  sbuf_repp = insample;
   cdata.resize(insample->number_of_channels());
   std::vector<CHANNEL_DATA>::iterator p = cdata.begin();
   while(p != cdata.end()) {
@@ -164,40 +163,39 @@ void ADVANCED_REVERB::init(SAMPLE_BUFFER *insample)
 
 void ADVANCED_REVERB::process(void)
 {
-  i_channels.begin();
-  while(!i_channels.end()) {
-    int ch = i_channels.channel();
-
-    cdata[ch].bufferpos_rep++;
-    cdata[ch].bufferpos_rep &= 65535;
-
-    double old_value = cdata[ch].oldvalue;
-    cdata[ch].buffer[cdata[ch].bufferpos_rep] = 
-      ecaops_flush_to_zero(*i_channels.current() + old_value);
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      cdata[ch].bufferpos_rep++;
+      cdata[ch].bufferpos_rep &= 65535;
+
+      double old_value = cdata[ch].oldvalue;
+      cdata[ch].buffer[cdata[ch].bufferpos_rep] = 
+	ecaops_flush_to_zero(span.data[n] + old_value);
+
+      old_value = 0.0;
+      for(int i = 0; i < 64; i++) {
+	old_value +=
+	  static_cast<float>(cdata[ch].buffer[(cdata[ch].bufferpos_rep - cdata[ch].dpos[i]) & 65535] * cdata[ch].mul[i]);
+      }
 
-    old_value = 0.0;
-    for(int i = 0; i < 64; i++) {
-      old_value +=
-	static_cast<float>(cdata[ch].buffer[(cdata[ch].bufferpos_rep - cdata[ch].dpos[i]) & 65535] * cdata[ch].mul[i]);
+      /**
+       * This is just a very simple high-pass-filter to remove offsets
+       * which can accour during calculation of the echos
+       */
+      cdata[ch].lpvalue = 
+	ecaops_flush_to_zero(cdata[ch].lpvalue * 0.99 + old_value * 0.01);
+      old_value = old_value - cdata[ch].lpvalue;
+
+      /**
+       * This is a simple lowpass to make the apearence of the reverb 
+       * more realistic... (Walls do not reflect high frequencies very
+       * well at all...) 
+       */
+      cdata[ch].oldvalue = 
+	ecaops_flush_to_zero(cdata[ch].oldvalue * 0.75 + old_value * 0.25);
+
+      span.data[n] = cdata[ch].oldvalue * wet_rep + span.data[n] * (1 - wet_rep);
     }
-
-    /**
-     * This is just a very simple high-pass-filter to remove offsets
-     * which can accour during calculation of the echos
-     */
-    cdata[ch].lpvalue = 
-      ecaops_flush_to_zero(cdata[ch].lpvalue * 0.99 + old_value * 0.01);
-    old_value = old_value - cdata[ch].lpvalue;
-
-    /**
-     * This is a simple lowpass to make the apearence of the reverb 
-     * more realistic... (Walls do not reflect high frequencies very
-     * well at all...) 
-     */
-    cdata[ch].oldvalue = 
-      ecaops_flush_to_zero(cdata[ch].oldvalue * 0.75 + old_value * 0.25);
-
-    *i_channels.current() = cdata[ch].oldvalue * wet_rep + *i_channels.current() * (1 - wet_rep);
-    i_channels.next();
   }
 }
@@ -12,7 +12,7 @@
 class ADVANCED_REVERB : public EFFECT_TIME_BASED {
  private:
 
-  SAMPLE_ITERATOR_CHANNELS i_channels;
+  SAMPLE_BUFFER* sbuf_repp;
   parameter_t roomsize_rep;
   parameter_t feedback_rep;
   parameter_t wet_rep;
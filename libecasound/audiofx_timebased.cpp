@@ -21,6 +21,7 @@
 // ------------------------------------------------------------------------
 
 #include <assert.h>
+#include <limits>
 #include <string>
 
 #include <kvu_dbc.h>
@@ -28,7 +29,6 @@
 
 #include "eca-logger.h"
 
-#include "samplebuffer_iterators.h"
 #include "sample-ops_impl.h"
 #include "audiofx_timebased.h"
 
@@ -47,6 +47,7 @@ EFFECT_DELAY::EFFECT_DELAY (CHAIN_OPERATOR::parameter_t delay_time, int surround
 			    CHAIN_OPERATOR::parameter_t feedback_percent) 
 {
   laskuri = 0.0;
+  silent_samples = 0;
 
   set_parameter(1, delay_time);
   set_parameter(2, surround_mode);
@@ -151,8 +152,10 @@ void EFFECT_DELAY::set_parameter(int param, CHAIN_OPERATOR::parameter_t value)
 	std::vector<SINGLE_BUFFER>::iterator q = p->begin();
 	while(q != p->end()) {
 	  if (q->size() > static_cast<size_t>(dtime)) {
+	    /* note: newest samples are dropped */
 	    q->resize(static_cast<size_t>(dtime));
 	    laskuri = dtime;
+	    silent_samples = 0;
 	  }
 	  ++q;
 	}
@@ -175,6 +178,7 @@ void EFFECT_DELAY::set_parameter(int param, CHAIN_OPERATOR::parameter_t value)
 	++p;
       }
       laskuri = 0;
+      silent_samples = 0;
       break;
     }
 
@@ -194,8 +198,7 @@ void EFFECT_DELAY::set_parameter(int param, CHAIN_OPERATOR::parameter_t value)
 
 void EFFECT_DELAY::init(SAMPLE_BUFFER* insample)
 {
-  l.init(insample);
-  r.init(insample);
+  sbuf_repp = insample;
 
   EFFECT_BASE::init(insample);
 
@@ -207,17 +210,47 @@ void EFFECT_DELAY::init(SAMPLE_BUFFER* insample)
       buffer[i].clear();
     }
   }
+
+  silent_samples = 0;
+}
+
+/**
+ * Processing can be skipped once the delay lines are
+ * full and contain only silence.
+ */
+bool EFFECT_DELAY::silent_for_silent_input(void) const
+{
+  /* note: while the delay lines are being filled, skipping
+   *       would change the timing of later output */
+  if (laskuri < dtime * dnum)
+    return false;
+
+  for(size_t i = 0; i < buffer.size(); i++) {
+    for(size_t j = 0; j < buffer[i].size(); j++) {
+      if (buffer[i][j].size() > static_cast<size_t>(silent_samples))
+	return false;
+    }
+  }
+  return true;
 }
 
 void EFFECT_DELAY::process(void)
 {
-  l.begin(SAMPLE_SPECS::ch_left);
-  r.begin(SAMPLE_SPECS::ch_right);
+  if (sbuf_repp->number_of_channels() <= SAMPLE_SPECS::ch_right)
+    return;
 
-  while(!l.end() && !r.end()) {
+  SAMPLE_BUFFER::channel_span_t left = sbuf_repp->channel_span(SAMPLE_SPECS::ch_left);
+  SAMPLE_BUFFER::channel_span_t right = sbuf_repp->channel_span(SAMPLE_SPECS::ch_right);
+  for(SAMPLE_BUFFER::buf_size_t n = 0; n < left.length; n++) {
     SAMPLE_SPECS::sample_t temp2_left = 0.0;
     SAMPLE_SPECS::sample_t temp2_right = 0.0;
 
+    if (left.data[n] != SAMPLE_SPECS::silent_value ||
+	right.data[n] != SAMPLE_SPECS::silent_value)
+      silent_samples = 0;
+    else if (silent_samples < std::numeric_limits<long int>::max())
+      silent_samples++;
+
     // Initializing the feedback factor to one. (x*1 = x)
     SAMPLE_SPECS::sample_t feedfact = 1;
 
@@ -273,18 +306,16 @@ void EFFECT_DELAY::process(void)
 	buffer[SAMPLE_SPECS::ch_left][nm2].pop_front();
 	buffer[SAMPLE_SPECS::ch_right][nm2].pop_front();
       }
-      buffer[SAMPLE_SPECS::ch_left][nm2].push_back(*l.current());
-      buffer[SAMPLE_SPECS::ch_right][nm2].push_back(*r.current());
+      buffer[SAMPLE_SPECS::ch_left][nm2].push_back(left.data[n]);
+      buffer[SAMPLE_SPECS::ch_right][nm2].push_back(right.data[n]);
 
       temp2_left += temp_left / dnum;
       temp2_right += temp_right / dnum;
 
     }
-    *l.current() = (*l.current() * (1.0 - mix)) + (temp2_left * mix);
-    *r.current() = (*r.current() * (1.0 - mix)) + (temp2_right * mix);
+    left.data[n] = (left.data[n] * (1.0 - mix)) + (temp2_left * mix);
+    right.data[n] = (right.data[n] * (1.0 - mix)) + (temp2_right * mix);
 
-    l.next();
-    r.next();
 
     if (laskuri < dtime * dnum) laskuri++;
   }
@@ -404,7 +435,7 @@ void EFFECT_MULTITAP_DELAY::set_parameter(int param, CHAIN_OPERATOR::parameter_t
 
 void EFFECT_MULTITAP_DELAY::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
 
   EFFECT_BASE::init(insample);
 
@@ -428,27 +459,26 @@ void EFFECT_MULTITAP_DELAY::process(void)
 {
   long int len = dtime * dnum;
 
-  i.begin();
-  while(!i.end()) {
-    for(int n = 0; n < channels(); n++) {
+  for(int ch = 0; ch < channels() && ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
       SAMPLE_SPECS::sample_t temp1 = 0.0;
       for(int nm2 = 0; nm2 < dnum; nm2++) {
-	if (filled[n][nm2] == true) {
-	  DBC_CHECK((delay_index[n] + nm2 * dtime) % len >= 0);
-	  DBC_CHECK((delay_index[n] + nm2 * dtime) % len < len);
-	  temp1 += buffer[n][(delay_index[n] + nm2 * dtime) % len];
+	if (filled[ch][nm2] == true) {
+	  DBC_CHECK((delay_index[ch] + nm2 * dtime) % len >= 0);
+	  DBC_CHECK((delay_index[ch] + nm2 * dtime) % len < len);
+	  temp1 += buffer[ch][(delay_index[ch] + nm2 * dtime) % len];
 	}
       }
-      buffer[n][delay_index[n]] = *i.current(n);
-      *i.current(n) = (*i.current(n) * (1.0 - mix)) + (temp1 * mix / dnum);
+      buffer[ch][delay_index[ch]] = span.data[n];
+      span.data[n] = (span.data[n] * (1.0 - mix)) + (temp1 * mix / dnum);
     
-      --(delay_index[n]);
+      --(delay_index[ch]);
       for(int nm2 = 0; nm2 < dnum; nm2++) {
-	if (delay_index[n] < len - dtime * nm2) filled[n][nm2] = true;
+	if (delay_index[ch] < len - dtime * nm2) filled[ch][nm2] = true;
       }
-      if (delay_index[n] == -1) delay_index[n] = len - 1;
+      if (delay_index[ch] == -1) delay_index[ch] = len - 1;
     }
-    i.next();
   }
 }
 
@@ -504,8 +534,7 @@ void EFFECT_FAKE_STEREO::set_parameter(int param, CHAIN_OPERATOR::parameter_t va
 
 void EFFECT_FAKE_STEREO::init(SAMPLE_BUFFER* insample)
 {
-  l.init(insample);
-  r.init(insample);
+  sbuf_repp = insample;
 
   EFFECT_BASE::init(insample);
 
@@ -520,9 +549,12 @@ void EFFECT_FAKE_STEREO::init(SAMPLE_BUFFER* insample)
 
 void EFFECT_FAKE_STEREO::process(void)
 {
-  l.begin(SAMPLE_SPECS::ch_left);
-  r.begin(SAMPLE_SPECS::ch_right);
-  while(!l.end() && !r.end()) {
+  if (sbuf_repp->number_of_channels() <= SAMPLE_SPECS::ch_right)
+    return;
+
+  SAMPLE_BUFFER::channel_span_t left = sbuf_repp->channel_span(SAMPLE_SPECS::ch_left);
+  SAMPLE_BUFFER::channel_span_t right = sbuf_repp->channel_span(SAMPLE_SPECS::ch_right);
+  for(SAMPLE_BUFFER::buf_size_t n = 0; n < left.length; n++) {
     SAMPLE_SPECS::sample_t temp_left = 0;
     SAMPLE_SPECS::sample_t temp_right = 0;
     if (buffer[SAMPLE_SPECS::ch_left].size() >= static_cast<size_t>(dtime)) {
@@ -530,28 +562,27 @@ void EFFECT_FAKE_STEREO::process(void)
       temp_right = buffer[SAMPLE_SPECS::ch_right].front();
 
       temp_right = (temp_left + temp_right) / 2.0;
-      temp_left = (*l.current() + *r.current()) / 2.0;
+      temp_left = (left.data[n] + right.data[n]) / 2.0;
 
       buffer[SAMPLE_SPECS::ch_left].pop_front();
       buffer[SAMPLE_SPECS::ch_right].pop_front();
     }
     else {
-      temp_left = (*l.current() + *r.current()) / 2.0;
+      temp_left = (left.data[n] + right.data[n]) / 2.0;
       temp_right = 0.0;
     }
-    buffer[SAMPLE_SPECS::ch_left].push_back(*l.current());
-    buffer[SAMPLE_SPECS::ch_right].push_back(*r.current());
+    buffer[SAMPLE_SPECS::ch_left].push_back(left.data[n]);
+    buffer[SAMPLE_SPECS::ch_right].push_back(right.data[n]);
 
-    *l.current() = temp_left;
-    *r.current() = temp_right;
+    left.data[n] = temp_left;
+    right.data[n] = temp_right;
 
-    l.next();
-    r.next();
   }
 }
 
 EFFECT_REVERB::EFFECT_REVERB (CHAIN_OPERATOR::parameter_t delay_time, int surround_mode, 
 			      CHAIN_OPERATOR::parameter_t feedback_percent) 
+  : silent_samples(0)
 {
   set_parameter(1, delay_time);
   set_parameter(2, surround_mode);
@@ -625,7 +656,9 @@ void EFFECT_REVERB::set_parameter(int param, CHAIN_OPERATOR::parameter_t value)
       std::vector<std::deque<SAMPLE_SPECS::sample_t> >::iterator p = buffer.begin();
       while(p != buffer.end()) {
         if (p->size() > static_cast<size_t>(dtime)) {
+          /* note: newest samples are dropped */
           p->resize(static_cast<size_t>(dtime));
+          silent_samples = 0;
         }
         ++p;
       }
@@ -644,8 +677,7 @@ void EFFECT_REVERB::set_parameter(int param, CHAIN_OPERATOR::parameter_t value)
 
 void EFFECT_REVERB::init(SAMPLE_BUFFER* insample)
 {
-  l.init(insample);
-  r.init(insample);
+  sbuf_repp = insample;
 
   EFFECT_BASE::init(insample);
 
@@ -657,13 +689,32 @@ void EFFECT_REVERB::init(SAMPLE_BUFFER* insample)
       buffer[i].clear();
     }
   }
+
+  silent_samples = 0;
+}
+
+/**
+ * Processing can be skipped once the tail has decayed,
+ * i.e. the delay line is full and contains only silence.
+ */
+bool EFFECT_REVERB::silent_for_silent_input(void) const
+{
+  for(size_t i = 0; i < buffer.size(); i++) {
+    if (buffer[i].size() < static_cast<size_t>(dtime) ||
+	buffer[i].size() > static_cast<size_t>(silent_samples))
+      return false;
+  }
+  return true;
 }
 
 void EFFECT_REVERB::process(void)
 {
-  l.begin(SAMPLE_SPECS::ch_left);
-  r.begin(SAMPLE_SPECS::ch_right);
-  while(!l.end() && !r.end()) {
+  if (sbuf_repp->number_of_channels() <= SAMPLE_SPECS::ch_right)
+    return;
+
+  SAMPLE_BUFFER::channel_span_t left = sbuf_repp->channel_span(SAMPLE_SPECS::ch_left);
+  SAMPLE_BUFFER::channel_span_t right = sbuf_repp->channel_span(SAMPLE_SPECS::ch_right);
+  for(SAMPLE_BUFFER::buf_size_t n = 0; n < left.length; n++) {
     SAMPLE_SPECS::sample_t temp_left = 0.0;
     SAMPLE_SPECS::sample_t temp_right = 0.0;
     if (buffer[SAMPLE_SPECS::ch_left].size() >= static_cast<size_t>(dtime)) {
@@ -671,26 +722,30 @@ void EFFECT_REVERB::process(void)
       temp_right = buffer[SAMPLE_SPECS::ch_right].front();
       
       if (surround == 0) {
-	*l.current() = (*l.current() * (1 - feedback)) + (temp_left *  feedback);
-	*r.current() = (*r.current() * (1 - feedback)) + (temp_right * feedback);
+	left.data[n] = (left.data[n] * (1 - feedback)) + (temp_left *  feedback);
+	right.data[n] = (right.data[n] * (1 - feedback)) + (temp_right * feedback);
       }
       else {
-	*l.current() = (*l.current() * (1 - feedback)) + (temp_right *  feedback);
-	*r.current() = (*r.current() * (1 - feedback)) + (temp_left * feedback);
+	left.data[n] = (left.data[n] * (1 - feedback)) + (temp_right *  feedback);
+	right.data[n] = (right.data[n] * (1 - feedback)) + (temp_left * feedback);
       }
       buffer[SAMPLE_SPECS::ch_left].pop_front();
       buffer[SAMPLE_SPECS::ch_right].pop_front();
     }
     else {
-	*l.current() = (*l.current() * (1 - feedback));
-	*r.current() = (*r.current() * (1 - feedback));
+	left.data[n] = (left.data[n] * (1 - feedback));
+	right.data[n] = (right.data[n] * (1 - feedback));
     }
-    *l.current() = ecaops_flush_to_zero(*l.current());
-    *r.current() = ecaops_flush_to_zero(*r.current());
-    buffer[SAMPLE_SPECS::ch_left].push_back(*l.current());
-    buffer[SAMPLE_SPECS::ch_right].push_back(*r.current());
-    l.next();
-    r.next();
+    left.data[n] = ecaops_flush_to_zero(left.data[n]);
+    right.data[n] = ecaops_flush_to_zero(right.data[n]);
+    buffer[SAMPLE_SPECS::ch_left].push_back(left.data[n]);
+    buffer[SAMPLE_SPECS::ch_right].push_back(right.data[n]);
+
+    if (left.data[n] != SAMPLE_SPECS::silent_value ||
+	right.data[n] != SAMPLE_SPECS::silent_value)
+      silent_samples = 0;
+    else if (silent_samples < std::numeric_limits<long int>::max())
+      silent_samples++;
   }
 }
 
@@ -813,7 +868,7 @@ void EFFECT_MODULATING_DELAY::set_parameter(int param, CHAIN_OPERATOR::parameter
 
 void EFFECT_MODULATING_DELAY::init(SAMPLE_BUFFER* insample)
 {
-  i.init(insample);
+  sbuf_repp = insample;
   lfo.init();
 
   if (samples_per_second() > 0)
@@ -846,24 +901,27 @@ void EFFECT_FLANGER::process(void)
 {
   EFFECT_MODULATING_DELAY::process();
 
-  i.begin();
-  while(!i.end()) {
-    SAMPLE_SPECS::sample_t temp1 = 0.0;
-    parameter_t p = vartime * lfo.value(lfo_pos_secs_rep);
-    if (filled[i.channel()] == true) {
-      DBC_CHECK((dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2) >= 0);
-      DBC_CHECK((dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2) < static_cast<long int>(buffer[i.channel()].size()));
-      temp1 = buffer[i.channel()][(dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2)];
-    }
-    *i.current() = ecaops_flush_to_zero((*i.current() * (1.0 - feedback)) + (temp1 * feedback));
-    buffer[i.channel()][delay_index[i.channel()]] = *i.current();
+  /* note: LFO position is advanced once per buffer */
+  parameter_t p = vartime * lfo.value(lfo_pos_secs_rep);
+
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      SAMPLE_SPECS::sample_t temp1 = 0.0;
+      if (filled[ch] == true) {
+	DBC_CHECK((dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2) >= 0);
+	DBC_CHECK((dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2) < static_cast<long int>(buffer[ch].size()));
+	temp1 = buffer[ch][(dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2)];
+      }
+      span.data[n] = ecaops_flush_to_zero((span.data[n] * (1.0 - feedback)) + (temp1 * feedback));
+      buffer[ch][delay_index[ch]] = span.data[n];
 
-    ++(delay_index[i.channel()]);
-    if (delay_index[i.channel()] == 2 * dtime) {
-      delay_index[i.channel()] = 0;
-      filled[i.channel()] = true;
+      ++(delay_index[ch]);
+      if (delay_index[ch] == 2 * dtime) {
+	delay_index[ch] = 0;
+	filled[ch] = true;
+      }
     }
-    i.next();
   }
 }
 
@@ -871,24 +929,27 @@ void EFFECT_CHORUS::process(void)
 {
   EFFECT_MODULATING_DELAY::process();
 
-  i.begin();
-  while(!i.end()) {
-    SAMPLE_SPECS::sample_t temp1 = 0.0;
-    parameter_t p = vartime * lfo.value(lfo_pos_secs_rep);
-    if (filled[i.channel()] == true) {
-      DBC_CHECK((dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2) >= 0);
-      DBC_CHECK((dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2) < static_cast<long int>(buffer[i.channel()].size()));
-      temp1 = buffer[i.channel()][(dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2)];
-    }
-    buffer[i.channel()][delay_index[i.channel()]] = *i.current();
-    *i.current() = (*i.current() * (1.0 - feedback)) + (temp1 * feedback);
+  /* note: LFO position is advanced once per buffer */
+  parameter_t p = vartime * lfo.value(lfo_pos_secs_rep);
+
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      SAMPLE_SPECS::sample_t temp1 = 0.0;
+      if (filled[ch] == true) {
+	DBC_CHECK((dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2) >= 0);
+	DBC_CHECK((dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2) < static_cast<long int>(buffer[ch].size()));
+	temp1 = buffer[ch][(dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2)];
+      }
+      buffer[ch][delay_index[ch]] = span.data[n];
+      span.data[n] = (span.data[n] * (1.0 - feedback)) + (temp1 * feedback);
 
-    ++(delay_index[i.channel()]);
-    if (delay_index[i.channel()] == 2 * dtime) {
-      delay_index[i.channel()] = 0;
-      filled[i.channel()] = true;
+      ++(delay_index[ch]);
+      if (delay_index[ch] == 2 * dtime) {
+	delay_index[ch] = 0;
+	filled[ch] = true;
+      }
     }
-    i.next();
   }
 }
 
@@ -896,26 +957,29 @@ void EFFECT_PHASER::process(void)
 {
   EFFECT_MODULATING_DELAY::process();
 
-  i.begin();
-  while(!i.end()) {
-    SAMPLE_SPECS::sample_t temp1 = 0.0;
-    parameter_t p = vartime * lfo.value(lfo_pos_secs_rep);
-    if (filled[i.channel()] == true) {
-      DBC_CHECK((dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2) >= 0);
-      DBC_CHECK((dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2) < static_cast<long int>(buffer[i.channel()].size()));
-      temp1 = buffer[i.channel()][(dtime + delay_index[i.channel()] + static_cast<long int>(p)) % (dtime * 2)];
-      //          cerr << "b: "
-      //    	   << (delay_index[i.channel()] + static_cast<long int>(p)) % dtime
-      //    	   << "," << p << ".\n";
-    }
-    *i.current() = ecaops_flush_to_zero(*i.current() * (1.0 - feedback) + (-1.0 * temp1 * feedback));
-    buffer[i.channel()][delay_index[i.channel()]] = *i.current();
+  /* note: LFO position is advanced once per buffer */
+  parameter_t p = vartime * lfo.value(lfo_pos_secs_rep);
 
-    ++(delay_index[i.channel()]);
-    if (delay_index[i.channel()] == 2 * dtime) {
-      delay_index[i.channel()] = 0;
-      filled[i.channel()] = true;
+  for(int ch = 0; ch < sbuf_repp->number_of_channels(); ch++) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf_repp->channel_span(ch);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+      SAMPLE_SPECS::sample_t temp1 = 0.0;
+      if (filled[ch] == true) {
+	DBC_CHECK((dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2) >= 0);
+	DBC_CHECK((dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2) < static_cast<long int>(buffer[ch].size()));
+	temp1 = buffer[ch][(dtime + delay_index[ch] + static_cast<long int>(p)) % (dtime * 2)];
+	//          cerr << "b: "
+	//    	   << (delay_index[ch] + static_cast<long int>(p)) % dtime
+	//    	   << "," << p << ".\n";
+      }
+      span.data[n] = ecaops_flush_to_zero(span.data[n] * (1.0 - feedback) + (-1.0 * temp1 * feedback));
+      buffer[ch][delay_index[ch]] = span.data[n];
+
+      ++(delay_index[ch]);
+      if (delay_index[ch] == 2 * dtime) {
+	delay_index[ch] = 0;
+	filled[ch] = true;
+      }
     }
-    i.next();
   }
 }
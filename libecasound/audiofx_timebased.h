@@ -28,7 +28,7 @@ class EFFECT_DELAY : public EFFECT_TIME_BASED {
 
  private:
 
-  SAMPLE_ITERATOR_CHANNEL l,r;
+  SAMPLE_BUFFER* sbuf_repp;
 
   parameter_t surround;
   parameter_t dnum;
@@ -40,6 +40,9 @@ class EFFECT_DELAY : public EFFECT_TIME_BASED {
   parameter_t laskuri;
   std::vector<std::vector<SINGLE_BUFFER> > buffer;
 
+  /* note: number of latest input frames that were silent */
+  long int silent_samples;
+
  public:
 
   virtual std::string name(void) const { return("Delay"); }
@@ -52,6 +55,7 @@ class EFFECT_DELAY : public EFFECT_TIME_BASED {
   virtual void init(SAMPLE_BUFFER* insample);
   virtual void process(void);
   virtual int output_channels(int i_channels) const { return(2); }
+  virtual bool silent_for_silent_input(void) const;
 
   parameter_t get_delta_in_samples(void) { return(dnum * dtime); }
 
@@ -67,7 +71,7 @@ class EFFECT_MULTITAP_DELAY : public EFFECT_TIME_BASED {
 
  private:
 
-  SAMPLE_ITERATOR_INTERLEAVED i;
+  SAMPLE_BUFFER* sbuf_repp;
 
   parameter_t surround;
   parameter_t mix;
@@ -103,7 +107,7 @@ class EFFECT_MULTITAP_DELAY : public EFFECT_TIME_BASED {
 class EFFECT_FAKE_STEREO : public EFFECT_TIME_BASED {
 
   std::vector<std::deque<SAMPLE_SPECS::sample_t> > buffer;
-  SAMPLE_ITERATOR_CHANNEL l,r;
+  SAMPLE_BUFFER* sbuf_repp;
   long int dtime;
   parameter_t dtime_msec;
 
@@ -133,13 +137,16 @@ class EFFECT_REVERB : public EFFECT_TIME_BASED {
  private:
     
   std::vector<std::deque<SAMPLE_SPECS::sample_t>  > buffer;
-  SAMPLE_ITERATOR_CHANNEL l,r;
+  SAMPLE_BUFFER* sbuf_repp;
 
   parameter_t surround;
   parameter_t feedback;
   long int dtime;
   parameter_t dtime_msec;
 
+  /* note: number of latest output frames that were silent */
+  long int silent_samples;
+
  public:
 
   virtual std::string name(void) const { return("Reverb"); }
@@ -152,6 +159,7 @@ class EFFECT_REVERB : public EFFECT_TIME_BASED {
   virtual void init(SAMPLE_BUFFER* insample);
   virtual void process(void);
   virtual int output_channels(int i_channels) const { return(2); }
+  virtual bool silent_for_silent_input(void) const;
 
   parameter_t get_delta_in_samples(void) { return(dtime); }
 
@@ -168,7 +176,7 @@ class EFFECT_MODULATING_DELAY : public EFFECT_TIME_BASED {
  protected:
 
   std::vector<std::vector<SAMPLE_SPECS::sample_t> > buffer;
-  SAMPLE_ITERATOR_CHANNELS i;
+  SAMPLE_BUFFER* sbuf_repp;
   double advance_len_secs_rep, lfo_pos_secs_rep;
   long int dtime;
   parameter_t dtime_msec;
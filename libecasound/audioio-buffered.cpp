@@ -18,21 +18,44 @@
 // ------------------------------------------------------------------------
 
 #include <cmath> /* ceil() */
+#include <sys/stat.h> /* stat() */
 #include <kvu_dbc.h>
+#include <kvu_numtostr.h>
 
 #include "eca-logger.h"
 #include "samplebuffer.h"
+#include "samplebuffer_cache.h"
 #include "audioio-buffered.h"
 
+/**
+ * Returns a string identifying the regular file 
+ * 'filename', or an empty string if 'filename' is 
+ * not a regular file.
+ */
+static std::string priv_cache_file_id(const std::string& filename)
+{
+  struct stat st;
+  if (::stat(filename.c_str(), &st) != 0 ||
+      S_ISREG(st.st_mode) == 0)
+    return "";
+
+  return kvu_numtostr(static_cast<long int>(st.st_dev)) + ":" +
+    kvu_numtostr(static_cast<long int>(st.st_ino)) + ":";
+}
+
 AUDIO_IO_BUFFERED::AUDIO_IO_BUFFERED(void) 
   : buffersize_rep(0),
     iobuf_uchar_repp(0),
-    iobuf_size_rep(0)
+    iobuf_size_rep(0),
+    cache_next_pos_rep(0),
+    cache_seek_rep(false),
+    cache_store_rep(false)
 {
 }
 
 AUDIO_IO_BUFFERED::~AUDIO_IO_BUFFERED(void)
 { 
+  disable_cache();
   if (iobuf_uchar_repp != 0) { 
     delete[] iobuf_uchar_repp; 
     iobuf_uchar_repp = 0;
@@ -63,6 +86,74 @@ void AUDIO_IO_BUFFERED::set_buffersize(long int samples)
   }
 }
 
+/**
+ * Enables caching of audio decoded from 'filename'. Must be
+ * called from open(), once the audio format and length are
+ * known.
+ *
+ * The cache is only used when enabled (see -z:cache), for
+ * inputs that support sample accurate seeking, and whose
+ * decoded audio fits into half of the cache. Blocks are
+ * stored after the object has seeked, or when other 
+ * objects read the same source, so material that is read
+ * just once is never copied to the cache. When a file is
+ * opened for writing, its blocks are dropped from the 
+ * cache.
+ *
+ * @see disable_cache()
+ */
+void AUDIO_IO_BUFFERED::enable_cache(const std::string& filename)
+{
+  disable_cache();
+  cache_next_pos_rep = 0;
+  cache_seek_rep = false;
+  cache_store_rep = false;
+
+  std::string id = priv_cache_file_id(filename);
+  if (id.size() == 0)
+    return;
+
+  SAMPLE_BUFFER_CACHE& cache = SAMPLE_BUFFER_CACHE::instance();
+  if (io_mode() != io_read) {
+    cache.forget(id);
+    return;
+  }
+
+  if (cache.size_limit() == 0 ||
+      supports_seeking_sample_accurate() != true ||
+      length_set() != true ||
+      length_in_samples() * channels() * sizeof(SAMPLE_BUFFER::sample_t) > cache.size_limit() / 2)
+    return;
+
+  /* note: the file size and modification time are 
+   *       part of the source, so blocks of a file that
+   *       has been modified are not used */
+  struct stat st;
+  ::stat(filename.c_str(), &st);
+  cache_source_rep = id + 
+    kvu_numtostr(static_cast<long int>(st.st_size)) + ":" +
+    kvu_numtostr(static_cast<long int>(st.st_mtime)) + ":" +
+    format_string() + "," +
+    kvu_numtostr(channels()) + "," +
+    kvu_numtostr(samples_per_second()) + 
+    (interleaved_channels() == true ? ",i" : ",n");
+  cache.add_reader(cache_source_rep);
+
+  ECA_LOG_MSG(ECA_LOGGER::user_objects, "caching decoded audio of '" + filename + "'");
+}
+
+/**
+ * Stops using the cache enabled with enable_cache().
+ * Must be called from close().
+ */
+void AUDIO_IO_BUFFERED::disable_cache(void)
+{
+  if (cache_source_rep.size() > 0) {
+    SAMPLE_BUFFER_CACHE::instance().remove_reader(cache_source_rep);
+    cache_source_rep = "";
+  }
+}
+
 void AUDIO_IO_BUFFERED::read_buffer(SAMPLE_BUFFER* sbuf)
 {
   // --------
@@ -70,6 +161,27 @@ void AUDIO_IO_BUFFERED::read_buffer(SAMPLE_BUFFER* sbuf)
   DBC_REQUIRE(static_cast<long int>(iobuf_size_rep) >= buffersize_rep * frame_size());
   // --------
 
+  SAMPLE_SPECS::sample_pos_t pos = position_in_samples();
+
+  if (cache_source_rep.size() > 0) {
+    /* note: material is read again after a seek */
+    if (pos != cache_next_pos_rep)
+      cache_store_rep = true;
+
+    if (SAMPLE_BUFFER_CACHE::instance().lookup(cache_source_rep, pos, buffersize_rep, sbuf) == true) {
+      /* note: file position is updated only when data is
+       *       next read from the file */
+      cache_seek_rep = true;
+      change_position_in_samples(sbuf->length_in_samples());
+      cache_next_pos_rep = position_in_samples();
+      return;
+    }
+    if (cache_seek_rep == true) {
+      seek_position(pos);
+      cache_seek_rep = false;
+    }
+  }
+
   if (interleaved_channels() == true) {
     sbuf->import_interleaved(iobuf_uchar_repp,
 			     read_samples(iobuf_uchar_repp, buffersize_rep),
@@ -88,8 +200,17 @@ void AUDIO_IO_BUFFERED::read_buffer(SAMPLE_BUFFER* sbuf)
 		+ description() + "'");
     sbuf->event_tag_set(SAMPLE_BUFFER::tag_end_of_stream);
   }
+  else if (cache_source_rep.size() > 0) {
+    /* note: only full buffers are cached, so the end of
+     *       stream is always read from the file */
+    SAMPLE_BUFFER_CACHE& cache = SAMPLE_BUFFER_CACHE::instance();
+    if (cache_store_rep == true ||
+	cache.readers(cache_source_rep) > 1)
+      cache.store(cache_source_rep, pos, *sbuf);
+  }
 
   change_position_in_samples(sbuf->length_in_samples());
+  cache_next_pos_rep = position_in_samples();
 
   // --------
   DBC_ENSURE(sbuf->number_of_channels() == channels());
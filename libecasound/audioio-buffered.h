@@ -1,6 +1,8 @@
 #ifndef INCLUDED_AUDIOIO_BUFFERED_H
 #define INCLUDED_AUDIOIO_BUFFERED_H
 
+#include <string>
+
 #include "audioio.h"
 
 class SAMPLE_BUFFER;
@@ -8,6 +10,13 @@ class SAMPLE_BUFFER;
 /**
  * A lower level interface for audio I/O objects. Derived classes 
  * must implement routines for reading and/or writing buffers of raw data.
+ *
+ * File-based subclasses can enable caching of decoded 
+ * audio with enable_cache(). Full buffers read from the 
+ * file are then stored to the process-wide 
+ * SAMPLE_BUFFER_CACHE when the data is likely to be read
+ * again, and later reads of the same data, by any
+ * object, are served from the cache.
  */
 class AUDIO_IO_BUFFERED : public AUDIO_IO {
 
@@ -47,12 +56,19 @@ class AUDIO_IO_BUFFERED : public AUDIO_IO {
   void reserve_buffer_space(long int bytes);
   unsigned char* get_iobuf(void) const { return(iobuf_uchar_repp); }
   size_t get_iobuf_size(void) const { return(iobuf_size_rep); }
+  void enable_cache(const std::string& filename);
+  void disable_cache(void);
 
  private:
 
   long int buffersize_rep;
   unsigned char* iobuf_uchar_repp;  // buffer for raw-I/O
   size_t iobuf_size_rep;
+
+  std::string cache_source_rep;
+  SAMPLE_SPECS::sample_pos_t cache_next_pos_rep;
+  bool cache_seek_rep;
+  bool cache_store_rep;
 };
 
 #endif // INCLUDED_AUDIO_IO_BUFFERED
@@ -36,6 +36,13 @@ AUDIO_IO_DB_BUFFER::AUDIO_IO_DB_BUFFER(int number_of_buffers,
     sbufs_rep[n] = new SAMPLE_BUFFER(buffersize, channels);
   }
 
+  /* note: server is woken up when half of the 
+   *       buffers need servicing */
+  watermark_rep = number_of_buffers / 2;
+  if (watermark_rep < 1) watermark_rep = 1;
+
+  io_thread_rep = 0;
+
   // std::cerr << "Created a new client buffer with "  << sbufs_rep.size() << " buffers." << std::endl;
 }
 
@@ -70,6 +77,9 @@ int AUDIO_IO_DB_BUFFER::read_space(void)
   int write = writeptr_rep.get();
   int read = readptr_rep.get();
 
+  /* note: pointers must be read before buffer contents */
+  __sync_synchronize();
+
   if (write >= read)
     return(write - read);
   else
@@ -89,6 +99,9 @@ int AUDIO_IO_DB_BUFFER::write_space(void)
 {
   int write = writeptr_rep.get();
   int read = readptr_rep.get();
+
+  /* note: pointers must be read before buffer contents */
+  __sync_synchronize();
   
   if (write > read)
     return(((read - write + sbufs_rep.size()) % sbufs_rep.size()) - 1);
@@ -106,6 +119,8 @@ int AUDIO_IO_DB_BUFFER::write_space(void)
  **/
 void AUDIO_IO_DB_BUFFER::advance_read_pointer(void)
 {
+  /* note: buffer must be read before the slot is released */
+  __sync_synchronize();
   readptr_rep.set((readptr_rep.get() + 1) % sbufs_rep.size());
 }
 
@@ -117,5 +132,7 @@ void AUDIO_IO_DB_BUFFER::advance_read_pointer(void)
  **/
 void AUDIO_IO_DB_BUFFER::advance_write_pointer(void)
 {
+  /* note: buffer contents must be visible before the pointer */
+  __sync_synchronize();
   writeptr_rep.set((writeptr_rep.get() + 1) % sbufs_rep.size());
 }
@@ -7,17 +7,31 @@
 class SAMPLE_BUFFER;
 
 /**
- * Buffer used between db server and client
+ * Buffer used between db server and client.
+ *
+ * A ring of sample buffers with one producer and one
+ * consumer, accessed without locks. The client wakes up 
+ * the server only when at least 'watermark_rep' buffers are 
+ * waiting to be refilled (reading) or written (writing).
+ *
+ * The buffer is serviced by the server i/o thread
+ * 'io_thread_rep', assigned when the server is started.
  */
 class AUDIO_IO_DB_BUFFER {
 
  public:
 
+  /* note: pointers are modified by different threads, 
+   *       so they are kept on separate cache lines */
   ATOMIC_INTEGER readptr_rep;
+  char readptr_pad_rep[64];
   ATOMIC_INTEGER writeptr_rep;
+  char writeptr_pad_rep[64];
   ATOMIC_INTEGER finished_rep;
   std::vector<SAMPLE_BUFFER*> sbufs_rep;
   AUDIO_IO::Io_mode io_mode_rep;
+  int watermark_rep;
+  int io_thread_rep;
 
   void reset(void);
   int read_space(void);
@@ -135,7 +135,11 @@ void AUDIO_IO_DB_CLIENT::read_buffer(SAMPLE_BUFFER* sbuf)
     SAMPLE_BUFFER* source = pbuffer_repp->sbufs_rep[pbuffer_repp->readptr_rep.get()];
     sbuf->copy_all_content(*source);
     pbuffer_repp->advance_read_pointer();
-    pserver_repp->signal_client_activity();
+    /* note: server is woken up only once the refill
+     *       watermark has been reached; an exact match
+     *       could be missed after an xrun */
+    if (pbuffer_repp->write_space() >= pbuffer_repp->watermark_rep)
+      pserver_repp->signal_client_activity(pbuffer_repp);
     change_position_in_samples(sbuf->length_in_samples());
   }
   else {
@@ -172,7 +176,8 @@ void AUDIO_IO_DB_CLIENT::write_buffer(SAMPLE_BUFFER* sbuf)
     target->copy_all_content(*sbuf);
     target->number_of_channels(channels());
     pbuffer_repp->advance_write_pointer();
-    pserver_repp->signal_client_activity();
+    if (pbuffer_repp->read_space() >= pbuffer_repp->watermark_rep)
+      pserver_repp->signal_client_activity(pbuffer_repp);
     change_position_in_samples(sbuf->length_in_samples());
     extend_position();
   }
@@ -69,7 +69,7 @@ const long int AUDIO_IO_DB_SERVER::buffersize_default = 1024;
 // --
 // Initialization of static, global functions
 
-static int timed_wait(pthread_mutex_t* mutex, pthread_cond_t* cond, long int usecs);
+static int timed_wait(pthread_mutex_t* mutex, pthread_cond_t* cond, long int msecs);
 static void timed_wait_print_result(int result, const char* tag, bool verbose);
 
 /**
@@ -82,9 +82,9 @@ void* start_db_server_io_thread(void *ptr)
   sigaddset(&sigset, SIGINT);
   sigprocmask(SIG_BLOCK, &sigset, 0);
 
-  AUDIO_IO_DB_SERVER* pserver =
-    static_cast<AUDIO_IO_DB_SERVER*>(ptr);
-  pserver->io_thread();
+  AUDIO_IO_DB_SERVER_impl::io_thread_t* thread =
+    static_cast<AUDIO_IO_DB_SERVER_impl::io_thread_t*>(ptr);
+  thread->server->io_thread(thread->index);
 
   return 0;
 }
@@ -97,13 +97,10 @@ AUDIO_IO_DB_SERVER::AUDIO_IO_DB_SERVER (void)
   ECA_LOG_MSG(ECA_LOGGER::system_objects, "constructor");
   buffercount_rep = buffercount_default;
   buffersize_rep = buffersize_default;
+  io_threads_rep = 1;
 
   impl_repp = new AUDIO_IO_DB_SERVER_impl;
 
-  thread_running_rep = false;
-
-  pthread_cond_init(&impl_repp->client_cond_rep, NULL);
-  pthread_mutex_init(&impl_repp->client_mutex_rep, NULL);
   pthread_cond_init(&impl_repp->data_cond_rep, NULL);
   pthread_mutex_init(&impl_repp->data_mutex_rep, NULL);
   pthread_cond_init(&impl_repp->full_cond_rep, NULL);
@@ -118,6 +115,8 @@ AUDIO_IO_DB_SERVER::AUDIO_IO_DB_SERVER (void)
   stop_request_rep.set(0);
   exit_request_rep.set(0);
   exit_ok_rep.set(0);
+  threads_stopped_rep.set(0);
+  threads_exited_rep.set(0);
 
   impl_repp->profile_full_rep = 0;
   impl_repp->profile_no_processing_rep = 0;
@@ -135,11 +134,7 @@ AUDIO_IO_DB_SERVER::~AUDIO_IO_DB_SERVER(void)
 {
   ECA_LOG_MSG(ECA_LOGGER::system_objects, "destructor");
   stop_request_rep.set(1);
-  exit_request_rep.set(1);
-  exit_ok_rep.set(0);
-  if (thread_running_rep == true) {
-    pthread_join(impl_repp->io_thread_rep, 0);
-  }
+  destroy_io_threads();
   for(unsigned int p = 0; p < buffers_rep.size(); p++) {
     delete buffers_rep[p];
   }
@@ -163,22 +158,87 @@ void AUDIO_IO_DB_SERVER::start(void)
   // --
 
   ECA_LOG_MSG(ECA_LOGGER::system_objects, "start");
-  if (thread_running_rep != true) {
-    int ret = pthread_create(&impl_repp->io_thread_rep,
+
+  int count = io_threads_rep;
+  if (count == 0) count = static_cast<int>(clients_rep.size());
+  if (count < 1) count = 1;
+
+  if (static_cast<int>(impl_repp->io_threads_rep.size()) != count) {
+    destroy_io_threads();
+    create_io_threads(count);
+  }
+
+  /* note: threads are idle while the server is stopped, 
+   *       so clients can be reassigned safely */
+  for(unsigned int p = 0; p < buffers_rep.size(); p++) {
+    if (buffers_rep[p] != 0) 
+      buffers_rep[p]->io_thread_rep = p % count;
+  }
+  for(int n = 0; n < count; n++) {
+    impl_repp->io_threads_rep[n]->stopped.set(0);
+    impl_repp->io_threads_rep[n]->full.set(0);
+  }
+  threads_stopped_rep.set(0);
+
+  stop_request_rep.set(0);
+  running_rep.set(1);
+  signal_client_activity();
+  ECA_LOG_MSG(ECA_LOGGER::system_objects, "starting processing");
+}
+
+/**
+ * Creates 'count' i/o threads. 
+ */
+void AUDIO_IO_DB_SERVER::create_io_threads(int count)
+{
+  DBC_CHECK(impl_repp->io_threads_rep.size() == 0);
+
+  exit_request_rep.set(0);
+  exit_ok_rep.set(0);
+  threads_exited_rep.set(0);
+
+  for(int n = 0; n < count; n++) {
+    AUDIO_IO_DB_SERVER_impl::io_thread_t* thread = 
+      new AUDIO_IO_DB_SERVER_impl::io_thread_t;
+    thread->server = this;
+    thread->index = n;
+    sem_init(&thread->wakeup_sem, 0, 0);
+    impl_repp->io_threads_rep.push_back(thread);
+  }
+
+  /* note: threads are started only after the thread table
+   *       is complete, as they look up their own entries */
+  for(int n = 0; n < count; n++) {
+    int ret = pthread_create(&impl_repp->io_threads_rep[n]->thread,
 			     0,
 			     start_db_server_io_thread,
-			     static_cast<void *>(this));
+			     static_cast<void *>(impl_repp->io_threads_rep[n]));
     if (ret != 0) {
       ECA_LOG_MSG(ECA_LOGGER::info, "pthread_create failed, exiting");
       exit(1);
     }
-    
-    thread_running_rep = true;
   }
 
-  stop_request_rep.set(0);
-  running_rep.set(1);
-  ECA_LOG_MSG(ECA_LOGGER::system_objects, "starting processing");
+  ECA_LOG_MSG(ECA_LOGGER::system_objects, 
+	      "created " + kvu_numtostr(count) + " i/o threads");
+}
+
+/**
+ * Makes all i/o threads exit, and waits until they 
+ * have flushed their clients.
+ */
+void AUDIO_IO_DB_SERVER::destroy_io_threads(void)
+{
+  exit_request_rep.set(1);
+  signal_client_activity();
+  for(unsigned int n = 0; n < impl_repp->io_threads_rep.size(); n++) {
+    pthread_join(impl_repp->io_threads_rep[n]->thread, 0);
+  }
+  for(unsigned int n = 0; n < impl_repp->io_threads_rep.size(); n++) {
+    sem_destroy(&impl_repp->io_threads_rep[n]->wakeup_sem);
+    delete impl_repp->io_threads_rep[n];
+  }
+  impl_repp->io_threads_rep.clear();
 }
 
 /**
@@ -188,6 +248,7 @@ void AUDIO_IO_DB_SERVER::stop(void)
 { 
   ECA_LOG_MSG(ECA_LOGGER::system_objects, "stop requested");
   stop_request_rep.set(1);
+  signal_client_activity();
 }
 
 /**
@@ -209,10 +270,11 @@ bool AUDIO_IO_DB_SERVER::is_full(void) const
 }
 
 /**
- * Waits for condition to occur.
+ * Waits for condition to occur. Caller must hold
+ * 'mutex'.
  *
  * @return 0 on success, 
- *         -ETIMEDOUT if timeout occured, 
+ *         ETIMEDOUT if timeout occured, 
  *	   other nonzero value on other errors
  */
 static int timed_wait(pthread_mutex_t* mutex, 
@@ -230,15 +292,9 @@ static int timed_wait(pthread_mutex_t* mutex,
      sleepcount.tv_nsec -= 1000000000;
    }
 
-   int ret = 0;
-    
-   pthread_mutex_lock(mutex);
-   ret = pthread_cond_timedwait(cond, 
-				mutex,
-				&sleepcount);
-   pthread_mutex_unlock(mutex);
-
-   return ret;
+   return pthread_cond_timedwait(cond, 
+				 mutex,
+				 &sleepcount);
 }
 
 /**
@@ -252,7 +308,7 @@ static void timed_wait_print_result(int result, const char* tag, bool verbose)
     level = ECA_LOGGER::continuous;
 
   if (result != 0) {
-    if (result == -ETIMEDOUT)
+    if (result == ETIMEDOUT)
       ECA_LOG_MSG(level, std::string(tag) + " failed; timeout");
     else
       ECA_LOG_MSG(level, std::string(tag) + " failed");
@@ -260,42 +316,61 @@ static void timed_wait_print_result(int result, const char* tag, bool verbose)
 }
 
 /**
- * Signals the server that one of its client has
- * processed data from the db buffers. This 
- * function helps server to keep its buffers 
- * full without resorting to polling.
+ * Wakes up all server threads.
  *
- * Called by both db clients and the db server.
+ * Realtime-safe (does not lock).
  */
 void AUDIO_IO_DB_SERVER::signal_client_activity(void)
 {
-  pthread_mutex_lock(&impl_repp->client_mutex_rep);
-  pthread_cond_broadcast(&impl_repp->client_cond_rep);
-  pthread_mutex_unlock(&impl_repp->client_mutex_rep);
+  for(unsigned int n = 0; n < impl_repp->io_threads_rep.size(); n++) {
+    impl_repp->io_threads_rep[n]->full.set(0);
+    sem_post(&impl_repp->io_threads_rep[n]->wakeup_sem);
+  }
+}
+
+/**
+ * Wakes up the server thread serving 'buffer'. Clients 
+ * call this when they cross the refill watermark of 
+ * their db buffer, i.e. when the server has enough work 
+ * to do. Wakeups are counted, so they are never lost.
+ * The thread is also marked as not full, so that
+ * signal_full() is not sent before it has run again.
+ *
+ * Realtime-safe (does not lock).
+ *
+ * @see AUDIO_IO_DB_BUFFER::watermark_rep
+ */
+void AUDIO_IO_DB_SERVER::signal_client_activity(const AUDIO_IO_DB_BUFFER* buffer)
+{
+  if (buffer->io_thread_rep < static_cast<int>(impl_repp->io_threads_rep.size())) {
+    AUDIO_IO_DB_SERVER_impl::io_thread_t* thread = 
+      impl_repp->io_threads_rep[buffer->io_thread_rep];
+    thread->full.set(0);
+    sem_post(&thread->wakeup_sem);
+  }
 }
 
 /**
- * Function that blocks until some client
- * activity occurs.
+ * Function that blocks until server thread 'index'
+ * is woken up.
  *
  * Only called by db server.
  *
  * @see signal_client_activity()
- *
- * @pre is_running() != true
  */
-void AUDIO_IO_DB_SERVER::wait_for_client_activity(void)
+void AUDIO_IO_DB_SERVER::wait_for_client_activity(int index)
 {
-  // --
-  DBC_REQUIRE(is_running() == true);
-  // --
+  sem_t* sem = &impl_repp->io_threads_rep[index]->wakeup_sem;
+
+  while(sem_wait(sem) != 0 &&
+	errno == EINTR)
+    ;
 
-  /* note! we only wait for 100msec in case no clients
-   *       clients signal activity but there's still
-   *       room for new data 
-   */
-  int res = timed_wait(&impl_repp->client_mutex_rep, &impl_repp->client_cond_rep, 100);
-  timed_wait_print_result(res, "wait_for_client_activity", false);
+  /* note: the buffers are checked after this, so 
+   *       wakeups that are already pending can be 
+   *       discarded */
+  while(sem_trywait(sem) == 0)
+    ;
 }
 
 /**
@@ -308,9 +383,14 @@ void AUDIO_IO_DB_SERVER::wait_for_full(void)
       clients_rep.size() > 0) {
 
     /* note! we wait until we get a signal_full() even though 
-     *       full_rep could already be set */
+     *       full_rep could already be set; the server is
+     *       woken up while holding the mutex, so that the 
+     *       signal cannot be missed */
 
+    pthread_mutex_lock(&impl_repp->full_mutex_rep);
+    signal_client_activity();
     int res = timed_wait(&impl_repp->full_mutex_rep, &impl_repp->full_cond_rep, 5000);
+    pthread_mutex_unlock(&impl_repp->full_mutex_rep);
     timed_wait_print_result(res, "wait_for_full", true);
   }
   else {
@@ -324,10 +404,17 @@ void AUDIO_IO_DB_SERVER::wait_for_full(void)
  */
 void AUDIO_IO_DB_SERVER::wait_for_stop(void)
 {
+  int res = 0;
+  pthread_mutex_lock(&impl_repp->stop_mutex_rep);
+  /* note: server clears running status before 
+   *       signaling, so checking it with the mutex 
+   *       held ensures the signal is not missed */
   if (is_running() == true) {
-    int res = timed_wait(&impl_repp->stop_mutex_rep, &impl_repp->stop_cond_rep, 5000);
-    timed_wait_print_result(res, "wait_for_stop", true);
+    signal_client_activity();
+    res = timed_wait(&impl_repp->stop_mutex_rep, &impl_repp->stop_cond_rep, 5000);
   }
+  pthread_mutex_unlock(&impl_repp->stop_mutex_rep);
+  timed_wait_print_result(res, "wait_for_stop", true);
 }
 
 /**
@@ -338,11 +425,13 @@ void AUDIO_IO_DB_SERVER::wait_for_stop(void)
 void AUDIO_IO_DB_SERVER::wait_for_flush(void)
 {
   if (is_running() == true) {
+    pthread_mutex_lock(&impl_repp->flush_mutex_rep);
     if (exit_ok_rep.get() == 0) {
       signal_client_activity();
       int res = timed_wait(&impl_repp->flush_mutex_rep, &impl_repp->flush_cond_rep, 5000);
       timed_wait_print_result(res, "wait_for_flush", true);
     }
+    pthread_mutex_unlock(&impl_repp->flush_mutex_rep);
   }
   else {
     ECA_LOG_MSG(ECA_LOGGER::system_objects, "wait_for_flush failed; not running");
@@ -405,6 +494,25 @@ void AUDIO_IO_DB_SERVER::set_buffer_defaults(int buffers,
   buffersize_rep = buffersize;
 }
 
+/**
+ * Sets the number of i/o threads used to serve 
+ * clients. If 'count' is zero, one thread is used
+ * per client. Takes effect when the server is
+ * next started.
+ * 
+ * @pre count >= 0
+ * @pre is_running() != true
+ */
+void AUDIO_IO_DB_SERVER::set_io_threads(int count)
+{ 
+  // --
+  DBC_REQUIRE(count >= 0);
+  DBC_REQUIRE(is_running() != true);
+  // --
+
+  io_threads_rep = count;
+}
+
 /**
  * Registers a new client object.
  *
@@ -473,135 +581,158 @@ AUDIO_IO_DB_BUFFER* AUDIO_IO_DB_SERVER::get_client_buffer(AUDIO_IO* aobject)
 }
 
 /**
- * Slave thread.
+ * Returns the number of buffers of client 'p' waiting 
+ * to be refilled (reading) or written (writing). Returns
+ * zero for finished clients.
  */
-void AUDIO_IO_DB_SERVER::io_thread(void)
+int AUDIO_IO_DB_SERVER::client_free_space(int p)
 {
-  ECA_LOG_MSG(ECA_LOGGER::system_objects, "Hey, in the I/O loop!");
-
-  int processed = 0;
-  int passive_rounds = 0;
-  DB_PROFILING_STATEMENT(bool one_time_full = false);
+  if (clients_rep[p] == 0 ||
+      buffers_rep[p]->finished_rep.get()) {
+    return 0;
+  }
+  else if (clients_rep[p]->finished() == true) {
+    buffers_rep[p]->finished_rep.set(1);
+    return 0;
+  }
 
-  /* set idle timeout to ~10% of total buffersize (using 44.1Hz as a reference) */
-  long int sleeplen = buffersize_rep * buffercount_rep * 1000 / 44100 / 10 * 1000000;
+  if (buffers_rep[p]->io_mode_rep == AUDIO_IO::io_read)
+    return buffers_rep[p]->write_space();
 
-  ECA_LOG_MSG(ECA_LOGGER::system_objects, 
-		"Using idle timeout of " +
-		kvu_numtostr(sleeplen) + 
-		" nsecs.");
+  return buffers_rep[p]->read_space();
+}
 
-  while(true) {
-    if (running_rep.get() == 0) {
-      kvu_sleep(0, sleeplen);
-      if (exit_request_rep.get() == 1) break;
-      continue;
+/**
+ * Returns the client of thread 'index' (serving every
+ * 'step'th client) that is closest to an underrun, i.e. 
+ * has the most buffers waiting to be refilled (reading) 
+ * or written (writing). Returns -1 if no client needs
+ * servicing.
+ */
+int AUDIO_IO_DB_SERVER::select_client(int index, int step)
+{
+  int selected = -1;
+  int max_free_space = 0;
+
+  for(unsigned int p = index; p < clients_rep.size(); p += step) {
+    int free_space = client_free_space(p);
+    if (free_space > max_free_space) {
+      max_free_space = free_space;
+      selected = p;
     }
+  }
 
-    DB_PROFILING_INC(impl_repp->profile_rounds_total_rep);
-
-    processed = 0;
-
-    int min_free_space = buffercount_rep;
-
-    DB_PROFILING_STATEMENT(impl_repp->looptimer_rep.start());
-
-    for(unsigned int p = 0; p < clients_rep.size(); p++) {
+  return selected;
+}
 
-      if (clients_rep[p] == 0 ||
-	  buffers_rep[p]->finished_rep.get()) {
-	continue;
-      }
-      else if (clients_rep[p]->finished() == true) {
-	buffers_rep[p]->finished_rep.set(1);
-      }
+/**
+ * Reads or writes one buffer of data for client 'p'.
+ */
+void AUDIO_IO_DB_SERVER::service_client(int p)
+{
+  if (buffers_rep[p]->io_mode_rep == AUDIO_IO::io_read) {
+    clients_rep[p]->read_buffer(buffers_rep[p]->sbufs_rep[buffers_rep[p]->writeptr_rep.get()]);
+    if (clients_rep[p]->finished() == true) buffers_rep[p]->finished_rep.set(1);
+    buffers_rep[p]->advance_write_pointer();
+  }
+  else {
+    clients_rep[p]->write_buffer(buffers_rep[p]->sbufs_rep[buffers_rep[p]->readptr_rep.get()]);
+    if (clients_rep[p]->finished() == true) buffers_rep[p]->finished_rep.set(1);
+    buffers_rep[p]->advance_read_pointer();
+  }
+}
 
-      int free_space = 0;
+/**
+ * Whether all i/o threads have found their clients' 
+ * buffers full?
+ */
+bool AUDIO_IO_DB_SERVER::all_threads_full(void) const
+{
+  for(unsigned int n = 0; n < impl_repp->io_threads_rep.size(); n++) {
+    if (impl_repp->io_threads_rep[n]->full.get() == 0) return false;
+  }
+  return true;
+}
 
-      if (buffers_rep[p]->io_mode_rep == AUDIO_IO::io_read) {
-	free_space = buffers_rep[p]->write_space();
-	if (free_space > 0) {
-	  /* room available, so we can read at least one buffer of data */
+/**
+ * Slave thread 'index'.
+ */
+void AUDIO_IO_DB_SERVER::io_thread(int index)
+{
+  ECA_LOG_MSG(ECA_LOGGER::system_objects, "Hey, in the I/O loop!");
 
-	  if (clients_rep[p]->finished() != true) {
-	    clients_rep[p]->read_buffer(buffers_rep[p]->sbufs_rep[buffers_rep[p]->writeptr_rep.get()]);
-	    if (clients_rep[p]->finished() == true) buffers_rep[p]->finished_rep.set(1);
-	    buffers_rep[p]->advance_write_pointer();
-	    ++processed;
-	  }
+  AUDIO_IO_DB_SERVER_impl::io_thread_t* self = impl_repp->io_threads_rep[index];
+  int count = static_cast<int>(impl_repp->io_threads_rep.size());
 
-#ifdef DB_PROFILING
-	  if (buffers_rep[p]->write_space() > 16 && one_time_full == true) {
-	    DB_PROFILING_INC(impl_repp->profile_read_xrun_danger_rep);
-	  }
-#endif
+  while(true) {
+    if (running_rep.get() == 0 || self->stopped.get() == 1) {
+      if (exit_request_rep.get() == 1) break;
+      /* note: woken up by start() and destroy_io_threads() */
+      wait_for_client_activity(index);
+      continue;
+    }
 
-	}
+    if (stop_request_rep.get() == 1) {
+      /* note: each client is serviced once more before 
+       *       stopping; the last thread to stop completes 
+       *       the stop */
+      for(unsigned int p = index; p < clients_rep.size(); p += count) {
+	if (client_free_space(p) > 0) service_client(p);
       }
-      else {
-	free_space = buffers_rep[p]->read_space();
-	if (free_space > 0) {
-	  /* room available, so we can write at least one buffer of data */
-
-	  if (clients_rep[p]->finished() != true) {
-	    clients_rep[p]->write_buffer(buffers_rep[p]->sbufs_rep[buffers_rep[p]->readptr_rep.get()]);
-	    if (clients_rep[p]->finished() == true) buffers_rep[p]->finished_rep.set(1);
-	    buffers_rep[p]->advance_read_pointer();
-	    ++processed;
-	  }
-
-#ifdef DB_PROFILING
-	  if (buffers_rep[p]->read_space() < 16  && one_time_full == true) {
-	    DB_PROFILING_INC(impl_repp->profile_write_xrun_danger_rep);
-	  }
-#endif
-	}
+      self->stopped.set(1);
+      if (threads_stopped_rep.add(1) == count) {
+	stop_request_rep.set(0);
+	running_rep.set(0);
+	full_rep.set(0);
+	ECA_LOG_MSG(ECA_LOGGER::system_objects, "stop complete");
+	signal_stop();
       }
-
-      if (free_space < min_free_space) min_free_space = free_space;
+      continue;
     }
 
+    DB_PROFILING_INC(impl_repp->profile_rounds_total_rep);
+
+    DB_PROFILING_STATEMENT(impl_repp->looptimer_rep.start());
+    int p = select_client(index, count);
+    if (p >= 0) service_client(p);
     DB_PROFILING_STATEMENT(impl_repp->looptimer_rep.stop());
 
-    if (stop_request_rep.get() == 1) {
-      stop_request_rep.set(0);
-      running_rep.set(0);
-      full_rep.set(0);
-      ECA_LOG_MSG(ECA_LOGGER::system_objects, "stop complete");
-      signal_stop();
-    }
-    else {
-      if (processed == 0) passive_rounds++;
-      else passive_rounds = 0;
-
-      if (processed == 0) {
-	if (passive_rounds > 1) {
-	  /* case 1: nothing processed during the last two rounds ==> signal_full, wait_for_client_activity */
-	  DB_PROFILING_INC(impl_repp->profile_full_rep);
-	  full_rep.set(1);
-	  DB_PROFILING_STATEMENT(if (one_time_full != true) one_time_full = true);
-	  signal_full();
-	  DBC_CHECK(running_rep.get() == 1);
-	}
-	else {
-	  /* case 2: nothing processed during the last round ==> wait_for_client_activity */
-	  DB_PROFILING_INC(impl_repp->profile_no_processing_rep);
-	}
-	
-	wait_for_client_activity();
-      }
-      else {
-	/* case 3: something processed; business as usual */
-	DB_PROFILING_INC(impl_repp->profile_processing_rep);
+    if (p < 0) {
+      /* case 1: nothing to process, so all buffers of this
+       *         thread are full (or finished) ==> signal_full 
+       *         if the other threads are full as well, 
+       *         wait_for_client_activity */
+      DB_PROFILING_INC(impl_repp->profile_full_rep);
+      self->full.set(1);
+      /* note: full barrier between setting our flag and reading
+       *       the others; without it, two threads becoming full
+       *       at the same time could each miss the other's flag
+       *       and neither would send signal_full() */
+      __sync_synchronize();
+      if (all_threads_full() == true) {
+	full_rep.set(1);
+	signal_full();
       }
 
-      /* case X: something processed; room in the buffers ==> data available */
-      // DB_PROFILING_INC(impl_repp->profile_not_full_anymore_rep);
+      /* note: clients wake up the server when they cross
+       *       their refill watermark */
+      wait_for_client_activity(index);
     }
+    else {
+      /* case 2: something processed; business as usual */
+      DB_PROFILING_INC(impl_repp->profile_processing_rep);
+      self->full.set(0);
+    }
+  }
+
+  flush_clients(index, count);
+
+  /* note: exit_ok_rep is set before signaling, so
+   *       wait_for_flush() cannot miss the signal */
+  if (threads_exited_rep.add(1) == count) {
+    exit_ok_rep.set(1);
+    signal_flush();
   }
-  flush();
-  exit_ok_rep.set(1);
-  // std::cerr << "Exiting db server thread." << std::endl;
 }
 
 void AUDIO_IO_DB_SERVER::dump_profile_counters(void)
@@ -628,11 +759,22 @@ void AUDIO_IO_DB_SERVER::dump_profile_counters(void)
  * Flushes all data in the buffers to disk.
  */
 void AUDIO_IO_DB_SERVER::flush(void)
+{
+  flush_clients(0, 1);
+  signal_flush();
+}
+
+/**
+ * Flushes all data in the buffers of every 'step'th 
+ * client, starting from client 'first', and resets
+ * the buffers.
+ */
+void AUDIO_IO_DB_SERVER::flush_clients(int first, int step)
 {
   int not_finished = 1;
   while(not_finished != 0) {
     not_finished = 0;
-    for(unsigned int p = 0; p < clients_rep.size(); p++) {
+    for(unsigned int p = first; p < clients_rep.size(); p += step) {
       if (clients_rep[p] == 0 ||
 	  buffers_rep[p]->finished_rep.get()) continue;
       if (buffers_rep[p]->io_mode_rep != AUDIO_IO::io_read) {
@@ -655,10 +797,9 @@ void AUDIO_IO_DB_SERVER::flush(void)
       }
     }
   }
-  for(unsigned int p = 0; p < buffers_rep.size(); p++) {
+  for(unsigned int p = first; p < buffers_rep.size(); p += step) {
     if (buffers_rep[p] != 0) {
       buffers_rep[p]->reset();
     }
   }
-  signal_flush();
 }
@@ -11,6 +11,12 @@ class AUDIO_IO_DB_SERVER_impl;
  * Audio i/o engine. Meant for serving all double-buffered client
  * audio objects (AUDIO_IO_DB_CLIENT). 
  *
+ * Clients are divided between a pool of i/o threads 
+ * (see set_io_threads()), so that a client blocking in 
+ * read or write only delays the other clients served by
+ * the same thread. Each thread first services the client
+ * that is closest to an underrun (or overrun).
+ *
  * @author Kai Vehmanen
  */
 class AUDIO_IO_DB_SERVER {
@@ -48,6 +54,7 @@ class AUDIO_IO_DB_SERVER {
   /*@{*/
 
   void signal_client_activity(void);
+  void signal_client_activity(const AUDIO_IO_DB_BUFFER* buffer);
 
   /*@}*/
 
@@ -64,6 +71,8 @@ class AUDIO_IO_DB_SERVER {
   /*@{*/
 
   void set_buffer_defaults(int buffers, long int buffersize);
+  void set_io_threads(int count);
+  int io_threads(void) const { return io_threads_rep; }
   void register_client(AUDIO_IO* abject);
   void unregister_client(AUDIO_IO* abject);
   AUDIO_IO_DB_BUFFER* get_client_buffer(AUDIO_IO* abject);
@@ -82,8 +91,8 @@ class AUDIO_IO_DB_SERVER {
 
   AUDIO_IO_DB_SERVER_impl* impl_repp;
 
-  bool thread_running_rep;
-
+  ATOMIC_INTEGER threads_stopped_rep;
+  ATOMIC_INTEGER threads_exited_rep;
   ATOMIC_INTEGER exit_ok_rep;
   ATOMIC_INTEGER exit_request_rep;
   ATOMIC_INTEGER stop_request_rep;
@@ -92,14 +101,22 @@ class AUDIO_IO_DB_SERVER {
   
   int buffercount_rep;
   long int buffersize_rep;
+  int io_threads_rep;
   int schedpriority_rep;
 
   AUDIO_IO_DB_SERVER& operator=(const AUDIO_IO_DB_SERVER& x) { return *this; }
   AUDIO_IO_DB_SERVER (const AUDIO_IO_DB_SERVER& x) { }
 
-  void io_thread(void);
+  void io_thread(int index);
+  void create_io_threads(int count);
+  void destroy_io_threads(void);
+  int client_free_space(int p);
+  int select_client(int index, int step);
+  void service_client(int p);
+  bool all_threads_full(void) const;
 
-  void wait_for_client_activity(void);
+  void wait_for_client_activity(int index);
+  void flush_clients(int first, int step);
 
   void signal_full(void);
   void signal_stop(void);
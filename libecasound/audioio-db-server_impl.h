@@ -2,19 +2,36 @@
 #define INCLUDED_AUDIOIO_DB_SERVER_IMPL_H
 
 #include <pthread.h>
+#include <semaphore.h>
+#include <vector>
+#include <kvu_locks.h>
 #include <kvu_procedure_timer.h>
 
+class AUDIO_IO_DB_SERVER;
+
 class AUDIO_IO_DB_SERVER_impl {
 
  public:
 
   friend class AUDIO_IO_DB_SERVER;
 
+  /**
+   * State of one server i/o thread. Thread 'index' 
+   * services clients index, index + n, index + 2n, ...,
+   * where n is the number of threads.
+   */
+  struct io_thread_t {
+    AUDIO_IO_DB_SERVER* server;
+    int index;
+    pthread_t thread;
+    sem_t wakeup_sem;
+    ATOMIC_INTEGER stopped;
+    ATOMIC_INTEGER full;
+  };
+
  private:
 
-  pthread_t io_thread_rep;
-  pthread_cond_t client_cond_rep;
-  pthread_mutex_t client_mutex_rep;
+  std::vector<io_thread_t*> io_threads_rep;
   pthread_cond_t data_cond_rep;
   pthread_mutex_t data_mutex_rep;
   pthread_cond_t full_cond_rep;
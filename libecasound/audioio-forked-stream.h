@@ -1,6 +1,7 @@
 #ifndef INCLUDED_AUDIOIO_FORKED_STREAM_H
 #define INCLUDED_AUDIOIO_FORKED_STREAM_H
 
+#include <cstdio>
 #include <string>
 #include <kvu_temporary_file_directory.h>
 
@@ -56,6 +57,7 @@ public:
   void fork_child_for_read(void);
   void fork_child_for_write(void);
   void clean_child(bool force = false);
+  FILE* fdopen_for_read(int fd);
 
   const std::string& fork_command(void) const { return(command_rep); }
 
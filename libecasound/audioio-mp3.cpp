@@ -610,7 +610,7 @@ void MP3FILE::fork_input_process(void)
     /* NOTE: the file description will be closed by 
      *       AUDIO_IO_FORKED_STREAM::clean_child() */
     filedes_rep = file_descriptor();
-    filehandle_rep = fdopen(filedes_rep, "r"); /* not part of <cstdio> */
+    filehandle_rep = fdopen_for_read(filedes_rep);
     if (filehandle_rep == 0) {
       finished_rep = true;
       triggered_rep = false;
@@ -213,7 +213,7 @@ void OGG_VORBIS_INTERFACE::fork_input_process(void)
     /* NOTE: the file description will be closed by 
      *       AUDIO_IO_FORKED_STREAM::clean_child() */
     filedes_rep = file_descriptor();
-    f1_rep = fdopen(filedes_rep, "r"); /* not part of <cstdio> */
+    f1_rep = fdopen_for_read(filedes_rep);
     if (f1_rep == 0) {
       finished_rep = true;
       triggered_rep = false;
@@ -34,7 +34,7 @@ RAWFILE::RAWFILE(const std::string& name)
 {
   set_label(name);
   fio_repp = 0;
-  mmaptoggle_rep = "0";
+  mmaptoggle_rep = "auto";
 }
 
 RAWFILE::~RAWFILE(void)
@@ -69,12 +69,23 @@ void RAWFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
 	fio_repp->open_stdin();
       }
       else {
-	if (mmaptoggle_rep == "1") {
-	  ECA_LOG_MSG(ECA_LOGGER::user_objects, "(audioio-wave) using mmap() mode for file access");
+	if (mmaptoggle_rep == "1" || mmaptoggle_rep == "auto") {
+	  ECA_LOG_MSG(ECA_LOGGER::user_objects, "(audioio-raw) using mmap() mode for file access");
 	  fio_repp = new ECA_FILE_IO_MMAP();
 	}
+	else if (mmaptoggle_rep == "uring") {
+	  ECA_LOG_MSG(ECA_LOGGER::user_objects, "(audioio-raw) using io_uring mode for file access");
+	  fio_repp = new ECA_FILE_IO_URING();
+	}
 	else fio_repp = new ECA_FILE_IO_STREAM();
 	fio_repp->open_file(label(),"rb");
+	if (fio_repp->is_file_ready() != true &&
+	    mmaptoggle_rep == "auto") {
+	  /* note: not a regular file, or mmap() failed */
+	  delete fio_repp;
+	  fio_repp = new ECA_FILE_IO_STREAM();
+	  fio_repp->open_file(label(),"rb");
+	}
 	if (fio_repp->is_file_ready() != true) {
 	  throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-RAW: Couldn't open file " + label() + " for reading."));
 	}
@@ -83,15 +94,21 @@ void RAWFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
     }
   case io_write: 
     {
-      fio_repp = new ECA_FILE_IO_STREAM();
       if (label() == "stdout" || label().at(0) == '-') {
 	std::cerr << "(audioio-raw) Outputting to standard output [w].\n";
+	fio_repp = new ECA_FILE_IO_STREAM();
 	fio_repp->open_stdout();
       }
       else if (label() == "stderr" || label().at(0) == '-') {
+	fio_repp = new ECA_FILE_IO_STREAM();
 	fio_repp->open_stderr();
       }
       else {
+	if (mmaptoggle_rep == "uring") {
+	  ECA_LOG_MSG(ECA_LOGGER::user_objects, "(audioio-raw) using io_uring mode for file access");
+	  fio_repp = new ECA_FILE_IO_URING();
+	}
+	else fio_repp = new ECA_FILE_IO_STREAM();
 	fio_repp->open_file(label(),"wb");
 	if (fio_repp->is_file_ready() != true) {
 	  throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-RAW: Couldn't open file " + label() + " for writing."));
@@ -119,6 +136,10 @@ void RAWFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
   }
   set_length_in_bytes();
 
+  if (io_mode() != io_read || 
+      (label() != "stdin" && label().at(0) != '-'))
+    enable_cache(label());
+
   AUDIO_IO::open();
 }
 
@@ -130,6 +151,7 @@ void RAWFILE::close(void)
     fio_repp = 0;
   }
 
+  disable_cache();
   AUDIO_IO::close();
 }
 
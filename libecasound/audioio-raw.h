@@ -7,6 +7,7 @@
 #include "eca-fileio.h"
 #include "eca-fileio-mmap.h"
 #include "eca-fileio-stream.h"
+#include "eca-fileio-uring.h"
 
 /**
  * Class for handling raw/headerless audio files
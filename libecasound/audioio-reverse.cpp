@@ -39,6 +39,9 @@ AUDIO_IO_REVERSE::AUDIO_IO_REVERSE (void)
 {
   
   tempbuf_repp = new SAMPLE_BUFFER();
+  chunkbuf_repp = new SAMPLE_BUFFER();
+  chunk_start_rep = 0;
+  chunk_length_rep = 0;
   init_rep = false;
   finished_rep = false;
 }
@@ -48,6 +51,8 @@ AUDIO_IO_REVERSE::AUDIO_IO_REVERSE (void)
  */
 AUDIO_IO_REVERSE::~AUDIO_IO_REVERSE (void)
 {
+  delete tempbuf_repp;
+  delete chunkbuf_repp;
 }
 
 AUDIO_IO_REVERSE* AUDIO_IO_REVERSE::clone(void) const
@@ -113,6 +118,16 @@ void AUDIO_IO_REVERSE::open(void) throw(AUDIO_IO::SETUP_ERROR&)
     throw(SETUP_ERROR(SETUP_ERROR::dynamic_params, "AUDIOIO-REVERSE: Unable to reverse audio object types that don't support seek (" + child()->label() + ")."));
   }
 
+  /* note: chunk length is a multiple of buffersize(), so 
+   *       that engine blocks never span two chunks */
+  long int bsize = buffersize() > 0 ? buffersize() : 1;
+  chunk_length_rep = 
+    (samples_per_second() * chunk_seconds + bsize - 1) / bsize * bsize;
+  chunkbuf_repp->number_of_channels(channels());
+  chunkbuf_repp->reserve_length_in_samples(chunk_length_rep);
+  chunkbuf_repp->length_in_samples(0);
+  chunk_start_rep = 0;
+
   AUDIO_IO::open();
 }
 
@@ -177,69 +192,85 @@ SAMPLE_SPECS::sample_pos_t AUDIO_IO_REVERSE::seek_position(SAMPLE_SPECS::sample_
   return AUDIO_IO_PROXY::seek_position(pos);
 }
 
-void AUDIO_IO_REVERSE::read_buffer(SAMPLE_BUFFER* sbuf)
+/**
+ * Reads the child data preceding child position 'end',
+ * up to chunk_length_rep samples, to chunkbuf_repp.
+ */
+void AUDIO_IO_REVERSE::read_chunk(SAMPLE_SPECS::sample_pos_t end)
 {
-  tempbuf_repp->number_of_channels(channels());
-  sbuf->number_of_channels(channels());
+  SAMPLE_SPECS::sample_pos_t start = end - chunk_length_rep;
+  if (start < 0) start = 0;
 
-  SAMPLE_BUFFER::buf_size_t read_count = buffersize();
+  ECA_LOG_MSG(ECA_LOGGER::user_objects, 
+	      "reading chunk " + kvu_numtostr(start) + 
+	      "-" + kvu_numtostr(end) + ".");
 
-  /* phase 1: Seek to correct position and read one buffer */
-  SAMPLE_SPECS::sample_pos_t curpos = position_in_samples();
-  SAMPLE_SPECS::sample_pos_t newpos = child()->length_in_samples() - curpos - buffersize();
-  if (newpos <= 0) {
-    child()->seek_position_in_samples(0);
-    read_count = -newpos;
-    finished_rep = true;
-  }
-  else {
-    child()->seek_position_in_samples(newpos);
-  }
+  child()->seek_position_in_samples(start);
 
-  /* phase 2: Copy the data in reversed order from tempbuf
-   *          to sbuf. As we cannot have any gaps between 
-   *          the blocks before reversing, we try to read
-   *          multiple times until we get the full block 
-   *          of data (at least buffersize() worth of samples).
-   */
+  tempbuf_repp->number_of_channels(channels());
+  chunkbuf_repp->number_of_channels(channels());
+  chunkbuf_repp->length_in_samples(end - start);
 
-  const int max_loops = 3;
   SAMPLE_BUFFER::buf_size_t read_sofar = 0;
-
-  /* this is how much reverse samples we will produce */
-  sbuf->length_in_samples(read_count);
-
-  for(int i = 0; i < max_loops; i++) {
+  while(read_sofar < end - start &&
+	child()->finished() != true) {
     child()->read_buffer(tempbuf_repp);
+    if (tempbuf_repp->length_in_samples() == 0)
+      break;
+    chunkbuf_repp->copy_range(*tempbuf_repp, 
+			      0, 
+			      tempbuf_repp->length_in_samples(), 
+			      read_sofar);
+    read_sofar += tempbuf_repp->length_in_samples();
+  }
 
-    if (tempbuf_repp->length_in_samples() + read_sofar > read_count)
-      tempbuf_repp->length_in_samples(read_count - read_sofar);
+  /* note: if the child ends early, the rest is left silent */
+  if (read_sofar < end - start)
+    chunkbuf_repp->make_silent_range(read_sofar, end - start);
 
-    for(int c = 0; c < sbuf->number_of_channels(); c++) {
+  chunk_start_rep = start;
+}
 
-      SAMPLE_BUFFER::buf_size_t src = 0;
-      SAMPLE_BUFFER::buf_size_t dst = 
-	(read_count - read_sofar - tempbuf_repp->length_in_samples());
+void AUDIO_IO_REVERSE::read_buffer(SAMPLE_BUFFER* sbuf)
+{
+  sbuf->number_of_channels(channels());
 
-      for(; src < tempbuf_repp->length_in_samples(); src++, dst++) {
+  /* phase 1: Find the range of child data [start, end) 
+   *          matching the current position, and make sure
+   *          it is in chunkbuf_repp.
+   */
+  SAMPLE_SPECS::sample_pos_t curpos = position_in_samples();
+  SAMPLE_SPECS::sample_pos_t end = child()->length_in_samples() - curpos;
+  SAMPLE_SPECS::sample_pos_t start = end - buffersize();
+  if (end < 0) 
+    end = 0;
+  if (start <= 0) {
+    start = 0;
+    finished_rep = true;
+  }
 
-	sbuf->buffer[c][dst] = 
-	  tempbuf_repp->buffer[c][tempbuf_repp->length_in_samples() - src - 1];
+  if (start < chunk_start_rep || 
+      end > chunk_start_rep + chunkbuf_repp->length_in_samples())
+    read_chunk(end);
 
-      }
-    }
+  /* phase 2: Copy the data in reversed order from 
+   *          chunkbuf_repp to sbuf. 
+   */
+  SAMPLE_BUFFER::buf_size_t read_count = end - start;
+  SAMPLE_BUFFER::buf_size_t offset = end - chunk_start_rep - 1;
 
-    read_sofar += tempbuf_repp->length_in_samples();
+  sbuf->length_in_samples(read_count);
 
-    if (read_sofar >= read_count)
-      break;
+  for(int c = 0; c < sbuf->number_of_channels(); c++) {
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < read_count; n++) {
+      sbuf->buffer[c][n] = chunkbuf_repp->buffer[c][offset - n];
+    }
   }
 
-  DBC_CHECK(read_sofar <= buffersize());
+  DBC_CHECK(read_count <= buffersize());
   DBC_CHECK(sbuf->length_in_samples() == read_count);
 
-  curpos += read_sofar;
-  set_position_in_samples(curpos);
+  set_position_in_samples(curpos + read_count);
 
   DBC_ENSURE(sbuf->number_of_channels() == channels());
 }
@@ -13,6 +13,11 @@ class SAMPLE_BUFFER;
  * A proxy class that reverts the child 
  * object's data.
  *
+ * Child data is read in chunks of 'chunk_seconds' seconds,
+ * starting from the end of the child object. Each chunk
+ * is read with one seek followed by sequential reads,
+ * and engine blocks are then served from memory.
+ *
  * Related design patterns:
  *     - Proxy (GoF207
  *
@@ -91,8 +96,14 @@ class AUDIO_IO_REVERSE : public AUDIO_IO_PROXY {
   bool init_rep;
   bool finished_rep;
   SAMPLE_BUFFER* tempbuf_repp;
+  SAMPLE_BUFFER* chunkbuf_repp;
+  SAMPLE_SPECS::sample_pos_t chunk_start_rep;
+  long int chunk_length_rep;
 
   static const int child_parameter_offset = 1;
+  static const int chunk_seconds = 2;
+
+  void read_chunk(SAMPLE_SPECS::sample_pos_t end);
 
   AUDIO_IO_REVERSE& operator=(const AUDIO_IO_REVERSE& x) { return *this; }
   AUDIO_IO_REVERSE (const AUDIO_IO_REVERSE& x) { }
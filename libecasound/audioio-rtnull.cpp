@@ -9,23 +9,31 @@
 // it under the terms of the GNU General Public License as published by
 // the Free Software Foundation; either version 2 of the License, or
 // (at your option) any later version.
-// 
+//
 // This program is distributed in the hope that it will be useful,
 // but WITHOUT ANY WARRANTY; without even the implied warranty of
 // MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
 // GNU General Public License for more details.
-// 
+//
 // You should have received a copy of the GNU General Public License
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 // ------------------------------------------------------------------------
 
-#include <cmath>
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib> /* rand_r() */
+#include <cstring> /* memset() */
 #include <iostream>
 #include <string>
-#include <sys/time.h> /* gettimeofday() */
+#include <time.h> /* clock_gettime(), clock_nanosleep() */
 
 #include <kvu_dbc.h>
+#include <kvu_numtostr.h>
+#include <kvu_timestamp.h>
 #include <kvu_utils.h>
 
 #include "audioio-device.h"
@@ -37,45 +45,50 @@
 using std::cerr;
 using std::endl;
 
-/** 
- * Definitions from glibc's sys/time.h (LGPL 2.1)
- */
-
-#ifndef timerclear
-#define	timerclear(tvp)		((tvp)->tv_sec = (tvp)->tv_usec = 0)
+#if defined(HAVE_CLOCK_NANOSLEEP) && defined(CLOCK_MONOTONIC)
+#define RTNULL_ABSOLUTE_SLEEP 1
 #endif
 
-#ifndef timeradd
-#define	timeradd(a, b, result)						      \
-  do {									      \
-    (result)->tv_sec = (a)->tv_sec + (b)->tv_sec;			      \
-    (result)->tv_usec = (a)->tv_usec + (b)->tv_usec;			      \
-    if ((result)->tv_usec >= 1000000)					      \
-      {									      \
-	++(result)->tv_sec;						      \
-	(result)->tv_usec -= 1000000;					      \
-      }									      \
-  } while (0)
-#endif
+/**
+ * Helper functions
+ */
 
-#ifndef timercmp
-#define	timercmp(a, b, CMP) 						      \
-  (((a)->tv_sec == (b)->tv_sec) ? 					      \
-   ((a)->tv_usec CMP (b)->tv_usec) : 					      \
-   ((a)->tv_sec CMP (b)->tv_sec))
+static void rtnull_gettime(struct timespec* now)
+{
+#ifdef RTNULL_ABSOLUTE_SLEEP
+  clock_gettime(CLOCK_MONOTONIC, now);
+#else
+  kvu_clock_gettime(now);
 #endif
+}
 
-#ifndef timersub
-#define	timersub(a, b, result) \
-do { \
-	(result)->tv_sec = (a)->tv_sec - (b)->tv_sec; \
-	(result)->tv_usec = (a)->tv_usec - (b)->tv_usec; \
-	if ((result)->tv_usec < 0) { \
-		--(result)->tv_sec; \
-		(result)->tv_usec += 1000000; \
-	} \
-} while (0)
+/**
+ * Sleeps until time 'wakeup' of the clock used by
+ * rtnull_gettime().
+ */
+static void rtnull_sleep_until(const struct timespec* wakeup)
+{
+#ifdef RTNULL_ABSOLUTE_SLEEP
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, wakeup, NULL) == EINTR)
+    ;
+#else
+  struct timespec now, delay;
+  rtnull_gettime(&now);
+  if (kvu_timespec_cmp_lt(&now, wakeup)) {
+    kvu_timespec_sub(wakeup, &now, &delay);
+    kvu_sleep(delay.tv_sec, delay.tv_nsec);
+  }
 #endif
+}
+
+/**
+ * Returns 'a - b' in seconds.
+ */
+static double rtnull_time_diff(const struct timespec* a, const struct timespec* b)
+{
+  return (a->tv_sec - b->tv_sec) +
+    (static_cast<double>(a->tv_nsec - b->tv_nsec) / 1000000000.0);
+}
 
 /**
  * Function definitions
@@ -83,11 +96,23 @@ do { \
 
 REALTIME_NULL::REALTIME_NULL(const std::string& name)
 {
+  total_buffers_rep = 3;
   xruns_rep = 0;
+  jitter_usec_rep = 0;
+  jitter_seed_rep = 1;
+  kvu_timespec_clear(&start_time_rep);
+  processed_frames_rep = 0;
+  periods_rep = 0;
+  late_periods_rep = 0;
+  waited_periods_rep = 0;
+  lateness_sum_rep = 0.0;
+  lateness_max_rep = 0.0;
+  headroom_sum_rep = 0.0;
+  headroom_min_rep = 0.0;
 }
 
 REALTIME_NULL::~REALTIME_NULL(void)
-{ 
+{
   if (is_open() == true && is_running()) stop();
 
   if (is_open() == true) {
@@ -105,21 +130,40 @@ REALTIME_NULL::~REALTIME_NULL(void)
   }
 }
 
-void REALTIME_NULL::open(void) throw (AUDIO_IO::SETUP_ERROR &)
+void REALTIME_NULL::set_parameter(int param, std::string value)
 {
-  ECA_LOG_MSG(ECA_LOGGER::user_objects, "open");
+  switch (param) {
+  case 1:
+    AUDIO_IO::set_parameter(param, value);
+    break;
+
+  case 2:
+    jitter_usec_rep = atol(value.c_str());
+    if (jitter_usec_rep < 0) jitter_usec_rep = 0;
+    break;
+  }
+}
+
+std::string REALTIME_NULL::get_parameter(int param) const
+{
+  switch (param) {
+  case 1:
+    return AUDIO_IO::get_parameter(param);
 
-  double t = static_cast<double>(buffersize()) / samples_per_second();
+  case 2:
+    return kvu_numtostr(jitter_usec_rep);
+  }
+  return "";
+}
 
-  buffer_length_rep.tv_sec = static_cast<time_t>(floor(t));
-  buffer_length_rep.tv_usec = static_cast<long>((t - buffer_length_rep.tv_sec) * 1000000.0);
+void REALTIME_NULL::open(void) throw (AUDIO_IO::SETUP_ERROR &)
+{
+  ECA_LOG_MSG(ECA_LOGGER::user_objects, "open");
 
   total_buffers_rep = 3;
-  if (max_buffers() == true) { 
+  if (max_buffers() == true) {
     total_buffers_rep = 8;
   }
-  total_buffer_length_rep.tv_sec = total_buffers_rep * buffer_length_rep.tv_sec;
-  total_buffer_length_rep.tv_usec = total_buffers_rep * buffer_length_rep.tv_usec;
 
   AUDIO_IO_DEVICE::open();
 }
@@ -133,7 +177,15 @@ void REALTIME_NULL::prepare(void)
 {
   ECA_LOG_MSG(ECA_LOGGER::user_objects, "prepare");
 
-  timerclear(&data_processed_rep);
+  processed_frames_rep = 0;
+
+  periods_rep = 0;
+  late_periods_rep = 0;
+  waited_periods_rep = 0;
+  lateness_sum_rep = 0.0;
+  lateness_max_rep = 0.0;
+  headroom_sum_rep = 0.0;
+  headroom_min_rep = 0.0;
 
   AUDIO_IO_DEVICE::prepare();
 }
@@ -142,66 +194,187 @@ void REALTIME_NULL::start(void)
 {
   ECA_LOG_MSG(ECA_LOGGER::user_objects, "start");
 
-  gettimeofday(&start_time_rep, NULL);
+  rtnull_gettime(&start_time_rep);
 
   AUDIO_IO_DEVICE::start();
 }
 
-void REALTIME_NULL::stop(void)
+void REALTIME_NULL::stop(bool drain)
 {
   ECA_LOG_MSG(ECA_LOGGER::user_objects, "stop");
 
-  AUDIO_IO_DEVICE::stop();
+  report_statistics();
+
+  AUDIO_IO_DEVICE::stop(drain);
 }
 
 /**
- * Calculates 'time_since_start_rep'.
+ * Returns the average time, in seconds, between a period
+ * deadline and the actual wake-up, over periods that
+ * had to wait for the device.
  */
-void REALTIME_NULL::calculate_device_position(void)
+double REALTIME_NULL::average_lateness(void) const
 {
-  struct timeval now;
-  gettimeofday(&now, NULL);
+  if (waited_periods_rep > 0) return lateness_sum_rep / waited_periods_rep;
+  return 0.0;
+}
 
-  timersub(&now, &start_time_rep, &time_since_start_rep);
+/**
+ * Returns the average headroom, in seconds, when data was
+ * requested. For capture, this is the time until the
+ * next period of data is available. For playback, it is
+ * the time until the device runs out of written data.
+ * Periods with no headroom are counted as late.
+ */
+double REALTIME_NULL::average_headroom(void) const
+{
+  if (periods_rep > 0) return headroom_sum_rep / periods_rep;
+  return 0.0;
+}
+
+void REALTIME_NULL::report_statistics(void) const
+{
+  if (periods_rep == 0) return;
+
+  ECA_LOG_MSG(ECA_LOGGER::info,
+	      "'" + label() + "' timing: " +
+	      kvu_numtostr(periods_rep) + " periods, " +
+	      kvu_numtostr(late_periods_rep) + " late, " +
+	      kvu_numtostr(xruns_rep) + " xruns; wake-up lateness avg " +
+	      kvu_numtostr(average_lateness() * 1000000.0, 1) + "us, max " +
+	      kvu_numtostr(max_lateness() * 1000000.0, 1) + "us; headroom avg " +
+	      kvu_numtostr(average_headroom() * 1000000.0, 1) + "us, min " +
+	      kvu_numtostr(min_headroom() * 1000000.0, 1) + "us");
 }
 
 /**
- * Calculates 'avail_data_rep'.
+ * Returns the device position, in sample frames, at time
+ * 'now'.
  */
-void REALTIME_NULL::calculate_available_data(void) const
-{ 
+SAMPLE_SPECS::sample_pos_t REALTIME_NULL::device_position(const struct timespec* now) const
+{
+  struct timespec elapsed;
+  kvu_timespec_sub(now, &start_time_rep, &elapsed);
+  if (elapsed.tv_sec < 0) return 0;
+
+  SAMPLE_SPECS::sample_pos_t srate = samples_per_second();
+  return static_cast<SAMPLE_SPECS::sample_pos_t>(elapsed.tv_sec) * srate +
+    static_cast<SAMPLE_SPECS::sample_pos_t>(elapsed.tv_nsec) * srate / 1000000000;
+}
+
+/**
+ * Calculates the time when device reaches position
+ * 'frames'. The result is exact to the nanosecond, so
+ * successive deadlines do not accumulate rounding
+ * errors.
+ */
+void REALTIME_NULL::device_time(SAMPLE_SPECS::sample_pos_t frames, struct timespec* result) const
+{
+  SAMPLE_SPECS::sample_pos_t srate = samples_per_second();
+  struct timespec offset;
+
+  if (frames < 0) frames = 0;
+  offset.tv_sec = static_cast<time_t>(frames / srate);
+  offset.tv_nsec = static_cast<long>((frames % srate) * 1000000000 / srate);
+
+  kvu_timespec_add(&start_time_rep, &offset, result);
+}
+
+/**
+ * Returns the amount of data, in sample frames, that can be
+ * read (capture) or written (playback) when device is at
+ * position 'devpos'.
+ */
+SAMPLE_SPECS::sample_pos_t REALTIME_NULL::available_data(SAMPLE_SPECS::sample_pos_t devpos) const
+{
   if (io_mode() == io_read) {
     /* capture: device is always ahead */
-    timersub(&time_since_start_rep, &data_processed_rep, &avail_data_rep);
+    return devpos - processed_frames_rep;
   }
-  else {
-    /* playback: device is always behind */
-    struct timeval diff;
-    timersub(&data_processed_rep, &time_since_start_rep, &diff);
-    timersub(&total_buffer_length_rep, &diff, &avail_data_rep);
-  }
-  if (timercmp(&avail_data_rep, &total_buffer_length_rep, >)) {
-    ++xruns_rep;
-    // cerr << "(audioio-rtnull) xrun occured!" << endl;
-  }
-} 
 
-void REALTIME_NULL::block_until_data_available(void) 
+  /* playback: device is always behind */
+  return static_cast<SAMPLE_SPECS::sample_pos_t>(total_buffers_rep) * buffersize() -
+    (processed_frames_rep - devpos);
+}
+
+/**
+ * Returns a random wake-up delay of at most 'jitter'
+ * microseconds. A fixed seed is used so that runs
+ * are reproducible.
+ */
+long int REALTIME_NULL::jitter_nsec(void)
 {
-  calculate_device_position();
-  calculate_available_data();
+  if (jitter_usec_rep <= 0) return 0;
+  return (rand_r(&jitter_seed_rep) % (jitter_usec_rep + 1)) * 1000;
+}
 
-  while (timercmp(&avail_data_rep, &buffer_length_rep, <)) {
-    struct timeval delay;
+void REALTIME_NULL::block_until_data_available(void)
+{
+  SAMPLE_SPECS::sample_pos_t total_frames =
+    static_cast<SAMPLE_SPECS::sample_pos_t>(total_buffers_rep) * buffersize();
 
-    timersub(&buffer_length_rep, &avail_data_rep, &delay);
+  struct timespec now;
+  rtnull_gettime(&now);
 
-    // cerr << "(audioio-rtnull) sleeping for: " << ndelay.tv_sec << " sec, " << ndelay.tv_nsec << " nanoseconds.\n";
-    kvu_sleep(delay.tv_sec, delay.tv_usec * 1000);
+  SAMPLE_SPECS::sample_pos_t devpos = device_position(&now);
+  if (available_data(devpos) > total_frames) {
+    /* xrun: resync to the device position */
+    ++xruns_rep;
+    if (io_mode() == io_read)
+      processed_frames_rep = devpos - buffersize();
+    else
+      processed_frames_rep = devpos;
+  }
 
-    calculate_device_position();
-    calculate_available_data();
+  SAMPLE_SPECS::sample_pos_t target = processed_frames_rep + buffersize();
+  if (io_mode() != io_read)
+    target -= total_frames;
+
+  struct timespec deadline;
+  device_time(target, &deadline);
+
+  double headroom;
+  if (io_mode() == io_read) {
+    /* capture: time until the period is captured */
+    headroom = rtnull_time_diff(&deadline, &now);
+  }
+  else {
+    /* playback: time until written data runs out */
+    headroom = static_cast<double>(processed_frames_rep - devpos) / samples_per_second();
+  }
+  if (periods_rep == 0 || headroom < headroom_min_rep)
+    headroom_min_rep = headroom;
+  headroom_sum_rep += headroom;
+  ++periods_rep;
+
+  if (headroom <= 0.0) {
+    /* engine is behind the device */
+    ++late_periods_rep;
   }
+
+  if (kvu_timespec_cmp_gt(&deadline, &now) == 0) {
+    /* data or write space already available */
+    return;
+  }
+  ++waited_periods_rep;
+
+  struct timespec wakeup = deadline;
+  long int jitter = jitter_nsec();
+  if (jitter > 0) {
+    struct timespec extra;
+    extra.tv_sec = jitter / 1000000000;
+    extra.tv_nsec = jitter % 1000000000;
+    kvu_timespec_add(&deadline, &extra, &wakeup);
+  }
+
+  rtnull_sleep_until(&wakeup);
+
+  rtnull_gettime(&now);
+  double lateness = rtnull_time_diff(&now, &deadline);
+  if (lateness < 0.0) lateness = 0.0;
+  if (lateness > lateness_max_rep)
+    lateness_max_rep = lateness;
+  lateness_sum_rep += lateness;
 }
 
 long int REALTIME_NULL::read_samples(void* target_buffer,
@@ -209,32 +382,27 @@ long int REALTIME_NULL::read_samples(void* target_buffer,
 {
   DBC_CHECK(is_running() == true);
 
-  for(int n = 0; n < samples * frame_size(); n++) ((char*)target_buffer)[n] = 0;
+  std::memset(target_buffer, 0, samples * frame_size());
 
   block_until_data_available();
 
   /* read one buffer of audio */
-  timeradd(&data_processed_rep, &buffer_length_rep, &data_processed_rep);
+  processed_frames_rep += buffersize();
 
   return buffersize();
 }
 
-void REALTIME_NULL::write_samples(void* target_buffer, 
+void REALTIME_NULL::write_samples(void* target_buffer,
 				  long int samples)
-{ 
-  if (is_running() != true) {
-    /* prefill phase */
-
-    /* write one buffer of audio */
-    timeradd(&data_processed_rep, &buffer_length_rep, &data_processed_rep);
-  }
-  else {
+{
+  if (is_running() == true) {
     /* block until write space available */
     block_until_data_available();
-  
-    /* write one buffer of audio */
-    timeradd(&data_processed_rep, &buffer_length_rep, &data_processed_rep);
   }
+  /* else: prefill phase */
+
+  /* write one buffer of audio */
+  processed_frames_rep += buffersize();
 }
 
 long int REALTIME_NULL::prefill_space(void) const
@@ -244,15 +412,23 @@ long int REALTIME_NULL::prefill_space(void) const
 }
 
 long int REALTIME_NULL::delay(void) const
-{ 
+{
   long int delay = 0;
 
   if (is_running() == true) {
-    calculate_available_data();
-    
-    double time = avail_data_rep.tv_sec * 1000000.0 + avail_data_rep.tv_usec;
-    delay = static_cast<SAMPLE_SPECS::sample_pos_t>
-      (time * samples_per_second() / 1000000.0);
+    struct timespec now;
+    rtnull_gettime(&now);
+    SAMPLE_SPECS::sample_pos_t devpos = device_position(&now);
+
+    if (io_mode() == io_read) {
+      /* capture: frames captured but not yet read */
+      delay = static_cast<long int>(devpos - processed_frames_rep);
+    }
+    else {
+      /* playback: frames written but not yet played */
+      delay = static_cast<long int>(processed_frames_rep - devpos);
+    }
+    if (delay < 0) delay = 0;
   }
 
   DBC_CHECK(delay >= 0);
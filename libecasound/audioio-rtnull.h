@@ -1,16 +1,34 @@
 #ifndef INCLUDED_AUDIOIO_RTNULL_H
 #define INCLUDED_AUDIOIO_RTNULL_H
 
-#include <sys/time.h>
+#include <string>
+#include <time.h>
+
 #include "audioio-device.h"
+#include "sample-specs.h"
 
 /**
  * Null audio object with realtime behaviour
+ *
+ * Device time is derived from a monotonic clock. The
+ * object sleeps until absolute deadlines calculated from
+ * the number of processed sample frames, so timing does
+ * not drift over time. A random delay of up to 'jitter'
+ * microseconds can be added to each wake-up to simulate
+ * scheduling jitter of a real device.
+ *
+ * Wake-up lateness and processing headroom are recorded
+ * for each period and reported when the object is
+ * stopped.
  */
 class REALTIME_NULL : public AUDIO_IO_DEVICE {
  public:
 
   virtual std::string name(void) const { return("Realtime null device"); }
+  virtual std::string parameter_names(void) const { return("label,jitter"); }
+
+  virtual void set_parameter(int param, std::string value);
+  virtual std::string get_parameter(int param) const;
 
   /** @name Function reimplemented from AUDIO_IO */
   /*@{*/
@@ -27,7 +45,7 @@ class REALTIME_NULL : public AUDIO_IO_DEVICE {
   /*@{*/
 
   virtual void prepare(void);
-  virtual void stop(void);
+  virtual void stop(bool drain = false);
   virtual void start(void);
 
   virtual long int delay(void) const;
@@ -35,6 +53,19 @@ class REALTIME_NULL : public AUDIO_IO_DEVICE {
 
   /*@}*/
 
+  /** @name Timing statistics, reset in prepare() */
+  /*@{*/
+
+  long int periods(void) const { return periods_rep; }
+  long int late_periods(void) const { return late_periods_rep; }
+  int xruns(void) const { return xruns_rep; }
+  double average_lateness(void) const;
+  double max_lateness(void) const { return lateness_max_rep; }
+  double average_headroom(void) const;
+  double min_headroom(void) const { return headroom_min_rep; }
+
+  /*@}*/
+
   REALTIME_NULL(const std::string& name = "realtime null");
   virtual ~REALTIME_NULL(void);
   REALTIME_NULL* clone(void) const { return new REALTIME_NULL(*this); }
@@ -42,21 +73,28 @@ class REALTIME_NULL : public AUDIO_IO_DEVICE {
 
  private:
 
-  void calculate_device_position(void);
-  void calculate_available_data(void) const;
+  SAMPLE_SPECS::sample_pos_t device_position(const struct timespec* now) const;
+  void device_time(SAMPLE_SPECS::sample_pos_t frames, struct timespec* result) const;
+  SAMPLE_SPECS::sample_pos_t available_data(SAMPLE_SPECS::sample_pos_t devpos) const;
   void block_until_data_available(void);
+  long int jitter_nsec(void);
+  void report_statistics(void) const;
 
   int total_buffers_rep;
-  mutable int xruns_rep;
-
-  struct timeval start_time_rep;
-  struct timeval time_since_start_rep;
-
-  struct timeval buffer_length_rep;
-  struct timeval total_buffer_length_rep;
-
-  struct timeval data_processed_rep;
-  mutable struct timeval avail_data_rep;
+  int xruns_rep;
+  long int jitter_usec_rep;
+  unsigned int jitter_seed_rep;
+
+  struct timespec start_time_rep;
+  SAMPLE_SPECS::sample_pos_t processed_frames_rep;
+
+  long int periods_rep;
+  long int late_periods_rep;
+  long int waited_periods_rep;
+  double lateness_sum_rep;
+  double lateness_max_rep;
+  double headroom_sum_rep;
+  double headroom_min_rep;
 };
 
 #endif
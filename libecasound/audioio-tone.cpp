@@ -175,22 +175,28 @@ void AUDIO_IO_TONE::read_buffer(SAMPLE_BUFFER* sbuf)
   else
     sbuf->length_in_samples(buffersize());
   
-  i.init(sbuf);
-  i.begin();
-
-  while(!i.end()) {
-    for(int n = 0; n < channels(); n++) {
-      if (i.end()) 
-	break;
-
-      *(i.current(n)) 
-	= g_pfSineTable[m_lPhase >> SINE_TABLE_SHIFT];
-
+  SAMPLE_BUFFER::buf_size_t len = sbuf->length_in_samples();
+  int chcount = std::min(channels(), static_cast<int>(sbuf->number_of_channels()));
+
+  /* note: phase is advanced even if there are no channels */
+  unsigned long phase = m_lPhase;
+  m_lPhase += m_lPhaseStep * len;
+
+  /* step: generate the tone to first channel and copy 
+   *       it to the others */
+  if (chcount > 0) {
+    SAMPLE_BUFFER::channel_span_t first = sbuf->channel_span(0);
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < first.length; n++) {
+      first.data[n] = g_pfSineTable[phase >> SINE_TABLE_SHIFT];
+      phase += m_lPhaseStep;
     }
 
-    m_lPhase += m_lPhaseStep;
-
-    i.next();
+    for(int ch = 1; ch < chcount; ch++) {
+      SAMPLE_BUFFER::channel_span_t span = sbuf->channel_span(ch);
+      for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++) {
+	span.data[n] = first.data[n];
+      }
+    }
   }
 
   change_position_in_samples(sbuf->length_in_samples());
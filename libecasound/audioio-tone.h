@@ -4,7 +4,6 @@
 #include <string>
 #include "audioio.h"
 #include "samplebuffer.h"
-#include "samplebuffer_iterators.h"
 #include "sample-specs.h"
 #include "eca-audio-time.h"
 
@@ -84,7 +83,6 @@ class AUDIO_IO_TONE : public AUDIO_IO {
 private:
 
   SAMPLE_BUFFER buffer_rep;
-  SAMPLE_ITERATOR_INTERLEAVED i;
   long int buffersize_rep;
   bool finished_rep;
 
@@ -45,6 +45,7 @@
 
 #include "eca-fileio-mmap.h"
 #include "eca-fileio-stream.h"
+#include "eca-fileio-uring.h"
 
 #include "eca-logger.h"
 
@@ -56,6 +57,18 @@
 #define UINT32_MAX 4294967295U
 #endif
 
+/**
+ * Size of the chunks in which space is preallocated
+ * when writing
+ */
+static const off_t wave_prealloc_bytes = 32 * 1024 * 1024;
+
+/**
+ * Interval, in bytes of audio data written, for updating
+ * the header length fields while writing
+ */
+static const off_t wave_header_update_bytes = 8 * 1024 * 1024;
+
 #ifdef WORDS_BIGENDIAN
 static const bool is_system_littleendian = false;
 #else
@@ -106,7 +119,11 @@ WAVEFILE::WAVEFILE (const std::string& name)
 {
   set_label(name);
   fio_repp = 0;
-  mmaptoggle_rep = "0";
+  data_start_position_rep = 0;
+  ds64_position_rep = 0;
+  data_end_rep = 0;
+  header_update_rep = 0;
+  mmaptoggle_rep = "auto";
 }
 
 WAVEFILE::~WAVEFILE(void)
@@ -158,15 +175,26 @@ void WAVEFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
   switch(io_mode()) {
   case io_read:
     {
-      if (mmaptoggle_rep == "1") {
+      if (mmaptoggle_rep == "1" || mmaptoggle_rep == "auto") {
 	ECA_LOG_MSG(ECA_LOGGER::user_objects, "using mmap() mode for file access");
 	fio_repp = new ECA_FILE_IO_MMAP();
       }
+      else if (mmaptoggle_rep == "uring") {
+	ECA_LOG_MSG(ECA_LOGGER::user_objects, "using io_uring mode for file access");
+	fio_repp = new ECA_FILE_IO_URING();
+      }
       else  fio_repp = new ECA_FILE_IO_STREAM();
       if (fio_repp == 0) {
 	throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-WAVE: Critical error when opening file \"" + label() + "\" for reading."));
       }
       fio_repp->open_file(label(), "rb");
+      if (fio_repp->is_file_ready() != true &&
+	  mmaptoggle_rep == "auto") {
+	/* note: not a regular file, or mmap() failed */
+	delete fio_repp;
+	fio_repp = new ECA_FILE_IO_STREAM();
+	fio_repp->open_file(label(), "rb");
+      }
       if (fio_repp->is_file_ready() != true) {
 	throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-WAVE: Couldn't open file \"" + label() + "\" for reading."));
       }
@@ -178,7 +206,11 @@ void WAVEFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
     }
   case io_write:
     {
-      fio_repp = new ECA_FILE_IO_STREAM();
+      if (mmaptoggle_rep == "uring") {
+	ECA_LOG_MSG(ECA_LOGGER::user_objects, "using io_uring mode for file access");
+	fio_repp = new ECA_FILE_IO_URING();
+      }
+      else fio_repp = new ECA_FILE_IO_STREAM();
       if (fio_repp == 0) {
 	throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-WAVE: Critical error when opening file \"" + label() + "\" for writing."));
       }
@@ -187,14 +219,21 @@ void WAVEFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
 	throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-WAVE: Couldn't open file \"" + label() + "\" for writing."));
       }
       write_riff_header();
+      write_riff_ds64();
       write_riff_fmt();
       write_riff_datablock();
+      data_end_rep = data_start_position_rep;
+      fio_repp->set_preallocation(wave_prealloc_bytes);
       break;
     }
 
   case io_readwrite:
     {
-      fio_repp = new ECA_FILE_IO_STREAM();
+      if (mmaptoggle_rep == "uring") {
+	ECA_LOG_MSG(ECA_LOGGER::user_objects, "using io_uring mode for file access");
+	fio_repp = new ECA_FILE_IO_URING();
+      }
+      else fio_repp = new ECA_FILE_IO_STREAM();
       if (fio_repp == 0) {
 	throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-WAVE: Critical error when opening file \"" + label() + "\" for read&write."));
       }
@@ -202,7 +241,9 @@ void WAVEFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
       if (fio_repp->file_mode() != "") {
 	set_length_in_bytes();
 	read_riff_fmt();     // also sets format()
+	find_riff_ds64();
 	find_riff_datablock();
+	data_end_rep = fio_repp->get_file_length();
       }
       else {
 	fio_repp->open_file(label(), "w+b");
@@ -210,9 +251,12 @@ void WAVEFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
 	  throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-WAVE: Couldn't open file \"" + label() + "\" for read&write."));
 
 	write_riff_header();
+	write_riff_ds64();
 	write_riff_fmt();
 	write_riff_datablock();
+	data_end_rep = data_start_position_rep;
       }
+      fio_repp->set_preallocation(wave_prealloc_bytes);
       if (fio_repp->is_file_ready() != true) {
 	throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-WAVE: Couldn't open file \"" + label() + "\" for read&write."));
       }
@@ -233,6 +277,10 @@ void WAVEFILE::open(void) throw (AUDIO_IO::SETUP_ERROR &)
     DBC_CHECK(format_string().size() > 4 && format_string()[4] != 'b');
   }
 
+  header_update_rep = data_end_rep;
+
+  enable_cache(label());
+
   AUDIO_IO::open();
 }
 
@@ -246,14 +294,15 @@ void WAVEFILE::close(void)
     fio_repp = 0;
   }
 
+  disable_cache();
   AUDIO_IO::close();
 }
 
 void WAVEFILE::update (void)
 {
   if (io_mode() != io_read) {
-    update_riff_datablock();
-    write_riff_header();
+    fio_repp->set_file_position_end();
+    update_riff_sizes(fio_repp->get_file_position());
     set_length_in_bytes();
   }
 }
@@ -273,7 +322,8 @@ void WAVEFILE::read_riff_header (void) throw(AUDIO_IO::SETUP_ERROR&)
   fio_repp->read_to_buffer(&riff_header_rep, sizeof(riff_header_rep));
 
   //  fread(&riff_header_rep,1,sizeof(riff_header_rep),fobject);
-  if ((memcmp("RIFF",riff_header_rep.id,4) == 0  &&
+  if (((memcmp("RIFF",riff_header_rep.id,4) == 0 ||
+	memcmp("RF64",riff_header_rep.id,4) == 0) &&
        memcmp("WAVE",riff_header_rep.wname,4) == 0) != true) {
     throw(SETUP_ERROR(SETUP_ERROR::unexpected, "AUDIOIO-WAVE: invalid RIFF-header (read)"));
   }
@@ -283,34 +333,35 @@ void WAVEFILE::write_riff_header (void) throw(AUDIO_IO::SETUP_ERROR&)
 {
   ECA_LOG_MSG(ECA_LOGGER::user_objects, "write_riff_header()");
 
-  off_t savetemp = fio_repp->get_file_position();
-    
   memcpy(riff_header_rep.id,"RIFF",4);
   memcpy(riff_header_rep.wname,"WAVE",4);
-
-  /* hack for 64bit wav files */
-#if _FILE_OFFSET_BITS == 64
-  if (fio_repp->get_file_length() > static_cast<off_t>(UINT32_MAX))
-    riff_header_rep.size = little_endian_uint32(UINT32_MAX);
-  else 
-#endif
-    if (fio_repp->get_file_length() > static_cast<off_t>(sizeof(riff_header_rep)))
-      riff_header_rep.size = little_endian_uint32(fio_repp->get_file_length() - 8);
-  else
-    riff_header_rep.size = little_endian_uint32(0);
+  riff_header_rep.size = little_endian_uint32(0);
 
   fio_repp->set_file_position(0);
-  //  fseek(fobject,0,SEEK_SET);
-
   fio_repp->write_from_buffer(&riff_header_rep, sizeof(riff_header_rep));
-  //  fwrite(&riff_header_rep,1,sizeof(riff_header_rep),fobject);
-  if (memcmp("RIFF",riff_header_rep.id,4) != 0 || 
-      memcmp("WAVE",riff_header_rep.wname,4) != 0)
+  if (fio_repp->file_bytes_processed() != sizeof(riff_header_rep))
     throw(SETUP_ERROR(SETUP_ERROR::unexpected, "AUDIOIO-WAVE: invalid RIFF-header (write)"));
+}
 
-  ECA_LOG_MSG(ECA_LOGGER::user_objects, "Wave data size " + kvu_numtostr(little_endian_uint32(riff_header_rep.size)));
+/**
+ * Reserves space for a RF64 "ds64" chunk with a "JUNK" chunk
+ * right after the RIFF header. The chunk is turned into
+ * "ds64" by update_riff_sizes() if needed.
+ */
+void WAVEFILE::write_riff_ds64(void)
+{
+  RB fblock;
+  DS ds;
 
-  fio_repp->set_file_position(savetemp);
+  fio_repp->set_file_position_end();
+  ds64_position_rep = fio_repp->get_file_position();
+
+  memcpy(fblock.sig, "JUNK", 4);
+  fblock.bsize = little_endian_uint32(sizeof(ds));
+  memset(&ds, 0, sizeof(ds));
+
+  fio_repp->write_from_buffer(&fblock, sizeof(fblock));
+  fio_repp->write_from_buffer(&ds, sizeof(ds));
 }
 
 void WAVEFILE::read_riff_fmt(void) throw(AUDIO_IO::SETUP_ERROR&)
@@ -424,36 +475,108 @@ void WAVEFILE::write_riff_datablock(void)
   data_start_position_rep = fio_repp->get_file_position();
 }
 
-void WAVEFILE::update_riff_datablock(void)
+/**
+ * Updates the length fields of the RIFF header and the
+ * "data" chunk, assuming the file ends at 'end'. If the
+ * file has grown past 4GiB, and space for a "ds64" chunk
+ * was reserved, the file is turned into a RF64 file.
+ * Otherwise the lengths are clamped to 2^32-1 bytes.
+ */
+void WAVEFILE::update_riff_sizes(off_t end)
 {
-  ECA_LOG_MSG(ECA_LOGGER::user_objects, "update_riff_datablock()");
-
+  off_t savetemp = fio_repp->get_file_position();
+  uint64_t riffsize = end - 8;
+  uint64_t datasize = end - data_start_position_rep;
   RB fblock;
-    
+
+  memcpy(riff_header_rep.wname,"WAVE",4);
   memcpy(fblock.sig,"data",4);
 
-  find_block("data", 0);
+  if (riffsize > UINT32_MAX && ds64_position_rep > 0) {
+    RB dsblock;
+    DS ds;
+    uint64_t samples = datasize / frame_size();
+
+    memcpy(dsblock.sig, "ds64", 4);
+    dsblock.bsize = little_endian_uint32(sizeof(ds));
+    ds.riff_size_low = little_endian_uint32(riffsize & 0xffffffff);
+    ds.riff_size_high = little_endian_uint32(riffsize >> 32);
+    ds.data_size_low = little_endian_uint32(datasize & 0xffffffff);
+    ds.data_size_high = little_endian_uint32(datasize >> 32);
+    ds.sample_count_low = little_endian_uint32(samples & 0xffffffff);
+    ds.sample_count_high = little_endian_uint32(samples >> 32);
+    ds.table_length = little_endian_uint32(0);
+
+    fio_repp->set_file_position(ds64_position_rep);
+    fio_repp->write_from_buffer(&dsblock, sizeof(dsblock));
+    fio_repp->write_from_buffer(&ds, sizeof(ds));
+
+    memcpy(riff_header_rep.id,"RF64",4);
+    riff_header_rep.size = little_endian_uint32(UINT32_MAX);
+    fblock.bsize = little_endian_uint32(UINT32_MAX);
+  }
+  else {
+    /* note: without a "ds64" chunk, lengths over 2^32-1
+     *       bytes are clamped (see set_length_in_bytes()) */
+    memcpy(riff_header_rep.id,"RIFF",4);
+    riff_header_rep.size = 
+      little_endian_uint32(riffsize > UINT32_MAX ? UINT32_MAX : riffsize);
+    fblock.bsize = 
+      little_endian_uint32(datasize > UINT32_MAX ? UINT32_MAX : datasize);
+  }
+
+  ECA_LOG_MSG(ECA_LOGGER::user_objects, 
+	      "updating header, data length " + kvu_numtostr(datasize) + " bytes");
+
+  fio_repp->set_file_position(0);
+  fio_repp->write_from_buffer(&riff_header_rep, sizeof(riff_header_rep));
+  fio_repp->set_file_position(data_start_position_rep - sizeof(fblock));
+  fio_repp->write_from_buffer(&fblock, sizeof(fblock));
+
+  fio_repp->set_file_position(savetemp);
+}
+
+/**
+ * Locates the "ds64" chunk, or a "JUNK" chunk reserved 
+ * for it, of an existing file.
+ */
+void WAVEFILE::find_riff_ds64(void)
+{
   off_t savetemp = fio_repp->get_file_position();
+  uint32_t blksize = 0;
 
-  fio_repp->set_file_position_end();
+  ds64_position_rep = 0;
 
-  /* hack for wav files with length over 2^32-1 bytes */
-#if _FILE_OFFSET_BITS == 64
-  if (fio_repp->get_file_position() - savetemp > static_cast<off_t>(UINT32_MAX))
-    fblock.bsize = little_endian_uint32(UINT32_MAX);
-  else
-#endif
-    fblock.bsize = little_endian_uint32(fio_repp->get_file_position() - savetemp);
+  /* note: must be the first chunk after the RIFF header */
+  if (find_block("ds64", &blksize) == true ||
+      (find_block("JUNK", &blksize) == true &&
+       blksize >= sizeof(DS))) {
+    off_t pos = fio_repp->get_file_position() - sizeof(RB);
+    if (pos == static_cast<off_t>(sizeof(riff_header_rep)))
+      ds64_position_rep = pos;
+  }
 
-  ECA_LOG_MSG(ECA_LOGGER::user_objects, 
-	      "updating data block header length to " + 
-	      kvu_numtostr(little_endian_uint32(fblock.bsize)));
+  fio_repp->set_file_position(savetemp);
+}
+
+/**
+ * Reads the contents of the "ds64" chunk to 'ds'.
+ * 
+ * @return true if the file has a "ds64" chunk
+ */
+bool WAVEFILE::read_riff_ds64(DS* ds)
+{
+  off_t savetemp = fio_repp->get_file_position();
+  bool res = false;
 
-  savetemp = savetemp - sizeof(fblock);
-  if (savetemp > 0) {
-    fio_repp->set_file_position(savetemp);
-    fio_repp->write_from_buffer(&fblock, sizeof(fblock));
+  if (find_block("ds64", 0) == true) {
+    fio_repp->read_to_buffer(ds, sizeof(DS));
+    if (fio_repp->file_bytes_processed() == sizeof(DS))
+      res = true;
   }
+
+  fio_repp->set_file_position(savetemp);
+  return res;
 }
 
 bool WAVEFILE::next_riff_block(RB *t, off_t *offtmp)
@@ -536,6 +659,15 @@ void WAVEFILE::write_samples(void* target_buffer, long int samples)
    */
 
   fio_repp->write_from_buffer(target_buffer, frame_size() * samples);
+
+  /* note: header is updated periodically, so that a recording 
+   *       interrupted before close() is still usable */
+  off_t pos = fio_repp->get_file_position();
+  if (pos > data_end_rep) data_end_rep = pos;
+  if (data_end_rep - header_update_rep >= wave_header_update_bytes) {
+    update_riff_sizes(data_end_rep);
+    header_update_rep = data_end_rep;
+  }
 }
 
 SAMPLE_SPECS::sample_pos_t WAVEFILE::seek_position(SAMPLE_SPECS::sample_pos_t pos)
@@ -558,6 +690,14 @@ void WAVEFILE::set_length_in_bytes(void)
   fio_repp->set_file_position_end();
   off_t datalen = fio_repp->get_file_position() - datastart;
 
+  /* note: length of RF64 files is stored in the "ds64" chunk */
+  uint64_t datasize = blksize;
+  DS ds;
+  if (blksize == UINT32_MAX && read_riff_ds64(&ds) == true) {
+    datasize = (static_cast<uint64_t>(little_endian_uint32(ds.data_size_high)) << 32) |
+      little_endian_uint32(ds.data_size_low);
+  }
+
   /* note: If the audio stream length defined in "data" header
    *       block is zero (not updated), or it's set to maximum
    *       value, set the length according to actual file length.
@@ -566,16 +706,16 @@ void WAVEFILE::set_length_in_bytes(void)
    *       but allows to handle RIFF WAVE files with a broken 
    *       header, as well as files with size exceeding the 2GiB
    *       limit. */
-  if (blksize != 0 &&
-      blksize != UINT32_MAX) {
-    set_length_in_samples(blksize / frame_size());
+  if (datasize != 0 &&
+      datasize != UINT32_MAX) {
+    set_length_in_samples(datasize / frame_size());
   }
   else 
     set_length_in_samples(datalen / frame_size());
 
   ECA_LOG_MSG(ECA_LOGGER::user_objects, 
 	      "data block length in header " + 
-	      kvu_numtostr(blksize) + 
+	      kvu_numtostr(datasize) + 
 	      ", file length after data block " +
 	      kvu_numtostr(datalen) + 
 	      ", length set to " +
@@ -25,6 +25,10 @@
  * 
  * - if more than 8 bits, least significant byte first as specified
  *   in the stantard
+ *
+ * - new files are written with a reserved "JUNK" chunk, which
+ *   is turned into a "ds64" chunk if the file grows past 4GiB
+ *   (RF64, EBU Tech 3306); RF64 files can also be read
  */
 class WAVEFILE : public AUDIO_IO_BUFFERED {
 
@@ -50,6 +54,16 @@ class WAVEFILE : public AUDIO_IO_BUFFERED {
     uint8_t wname[4];
   } RH;
 
+  typedef struct {
+    uint32_t riff_size_low;
+    uint32_t riff_size_high;
+    uint32_t data_size_low;
+    uint32_t data_size_high;
+    uint32_t sample_count_low;
+    uint32_t sample_count_high;
+    uint32_t table_length;
+  } DS;
+
  private:
 
   ECA_FILE_IO* fio_repp;
@@ -58,6 +72,9 @@ class WAVEFILE : public AUDIO_IO_BUFFERED {
   RF riff_format_rep;
 
   long int data_start_position_rep;
+  off_t ds64_position_rep;
+  off_t data_end_rep;
+  off_t header_update_rep;
   std::string mmaptoggle_rep;
 
   /**
@@ -130,9 +147,12 @@ class WAVEFILE : public AUDIO_IO_BUFFERED {
   bool next_riff_block(RB *t, off_t *offtmp);
   void read_riff_fmt(void) throw(AUDIO_IO::SETUP_ERROR&);
   void write_riff_header (void) throw(AUDIO_IO::SETUP_ERROR&);
+  void write_riff_ds64(void);
   void write_riff_fmt(void);
   void write_riff_datablock(void);
-  void update_riff_datablock(void);
+  void update_riff_sizes(off_t end);
+  void find_riff_ds64(void);
+  bool read_riff_ds64(DS* ds);
   void find_riff_datablock (void) throw(AUDIO_IO::SETUP_ERROR&);
   bool find_block(const char* fblock, uint32_t *blksize);
 };
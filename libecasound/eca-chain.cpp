@@ -765,7 +765,19 @@ void CHAIN::init(SAMPLE_BUFFER* sbuf, int in_channels, int out_channels)
   if (in_channels != 0) in_channels_rep = in_channels;
   if (out_channels != 0) out_channels_rep = out_channels;
 
+  /* note: reserve space for all channels before initializing
+   *       the chainops, so that audio data is not moved after
+   *       a chainop has taken a pointer reflock */
   int channels_next = in_channels_rep;
+  int channels_max = in_channels_rep;
+  for(size_t p = 0; p != chainops_rep.size(); p++) {
+    channels_next = chainops_rep[p].cop->output_channels(channels_next);
+    if (channels_next > channels_max)
+      channels_max = channels_next;
+  }
+  audioslot_repp->reserve_channels(channels_max);
+
+  channels_next = in_channels_rep;
   for(size_t p = 0; p != chainops_rep.size(); p++) {
     /* note: buffer must have room to store both input and 
      *       output channels (processing in-place) */
@@ -786,6 +798,17 @@ void CHAIN::init(SAMPLE_BUFFER* sbuf, int in_channels, int out_channels)
   }
 
   refresh_parameters();
+
+  /* note: profiles measure processing time relative to
+   *       the length of one buffer */
+  double period = 0.0;
+  if (samples_per_second() > 0)
+    period = static_cast<double>(audioslot_repp->length_in_samples()) / samples_per_second();
+  profile_rep.set_period(period);
+  for(size_t p = 0; p != chainops_rep.size(); p++) {
+    chainops_rep[p].profile.set_period(period);
+  }
+
   initialized_rep = true;
 
   ECA_LOG_MSG(ECA_LOGGER::system_objects, 
@@ -830,6 +853,8 @@ void CHAIN::process(void)
   DBC_REQUIRE(is_initialized() == true);
   // --------
 
+  double chain_start = ECA_PROCESSING_PROFILE::now();
+
   /* step: update operator parameters */
   controller_update();
 
@@ -847,8 +872,28 @@ void CHAIN::process(void)
 	int out_ch = chainops_rep[p].cop->output_channels(audioslot_repp->number_of_channels());
 	if (out_ch > audioslot_repp->number_of_channels())
 	  audioslot_repp->number_of_channels(out_ch);
-	
+
+	/* note: added channels are silent, so the tag is
+	 *       still valid */
+	if (audioslot_repp->event_tag_test(SAMPLE_BUFFER::tag_silent) == true &&
+	    chainops_rep[p].cop->silent_for_silent_input() == true) {
+	  /* note: skipped buffers count as zero load */
+	  chainops_rep[p].profile.record(0.0);
+	  continue;
+	}
+
+	/* note: input data may be shared with other chains, so
+	 *       make a private copy before it is modified */
+	bool modifies = chainops_rep[p].cop->modifies_buffer();
+	if (modifies == true)
+	  audioslot_repp->unshare_content();
+
+	double op_start = ECA_PROCESSING_PROFILE::now();
 	chainops_rep[p].cop->process();
+	chainops_rep[p].profile.record(ECA_PROCESSING_PROFILE::now() - op_start);
+
+	if (modifies == true)
+	  audioslot_repp->event_tag_set(SAMPLE_BUFFER::tag_silent, false);
       }
     }
   }
@@ -858,6 +903,22 @@ void CHAIN::process(void)
 
   /* step: update chain position */
   change_position_in_samples(audioslot_repp->length_in_samples());
+
+  profile_rep.record(ECA_PROCESSING_PROFILE::now() - chain_start);
+}
+
+/**
+ * Discards processing time statistics of the chain
+ * and all its chain operators.
+ *
+ * Can be called while the chain is being processed.
+ */
+void CHAIN::reset_profiles(void)
+{
+  profile_rep.request_reset();
+  for(size_t p = 0; p != chainops_rep.size(); p++) {
+    chainops_rep[p].profile.request_reset();
+  }
 }
 
 /**
@@ -28,6 +28,7 @@
 
 #include "eca-chainop.h"
 #include "eca-audio-position.h"
+#include "eca-processing-profile.h"
 
 class GENERIC_CONTROLLER;
 class OPERATOR;
@@ -194,6 +195,26 @@ class CHAIN : public ECA_AUDIO_POSITION {
 
   // -------------------------------------------------------------------
 
+  /** @name Processing profiles */
+  /*@{*/
+
+  /**
+   * Returns processing time statistics of the whole chain.
+   */
+  const ECA_PROCESSING_PROFILE& profile(void) const { return profile_rep; }
+
+  /**
+   * Returns processing time statistics of chain operator
+   * 'index' (0...N-1).
+   */
+  const ECA_PROCESSING_PROFILE& chain_operator_profile(int index) const { return chainops_rep[index].profile; }
+
+  void reset_profiles(void);
+
+  /*@}*/
+
+  // -------------------------------------------------------------------
+
   /** @name Functions implemented from ECA_SAMPLERATE_AWARE */
   /*@{*/
 
@@ -220,6 +241,7 @@ class CHAIN : public ECA_AUDIO_POSITION {
   public:
     CHAIN_OPERATOR* cop;
     bool bypassed;
+    ECA_PROCESSING_PROFILE profile;
   };
 
   bool initialized_rep;
@@ -245,6 +267,7 @@ class CHAIN : public ECA_AUDIO_POSITION {
 
   SAMPLE_BUFFER* audioslot_repp;
 
+  ECA_PROCESSING_PROFILE profile_rep;
 };
 
 #endif
@@ -96,6 +96,52 @@ class CHAIN_OPERATOR : public OPERATOR {
    * @see process()
    */
   virtual int output_channels(int i_channels) const { return(i_channels); }
+
+  /**
+   * Whether process() modifies the sample buffer
+   * passed to init().
+   *
+   * Chain operators that only read the sample data
+   * (for instance signal analyzers) should reimplement
+   * this function and return false. This allows 
+   * chains to share input data with other chains 
+   * without copying it.
+   *
+   * @see SAMPLE_BUFFER::share_content()
+   */
+  virtual bool modifies_buffer(void) const { return(true); }
+
+  /**
+   * Whether process() can be skipped when all samples
+   * of the buffer are zero. This is the case if processing
+   * silence would produce silence and leave the operator's
+   * state unchanged.
+   *
+   * Stateless operators that map zero to zero should
+   * reimplement this function and return true. Operators
+   * with state, such as delays and reverbs, can return
+   * true once their state has decayed to silence.
+   *
+   * Called before each process() call, so the result
+   * may change from one buffer to another.
+   *
+   * @see SAMPLE_BUFFER::tag_silent
+   */
+  virtual bool silent_for_silent_input(void) const { return(false); }
+
+  /**
+   * Whether set_parameter() can be called for parameter
+   * 'param' from a realtime context, i.e. while process()
+   * may run in another thread between calls. This requires
+   * that set_parameter() does not allocate or free memory,
+   * log messages, take locks or block.
+   *
+   * Chain operators whose parameter changes only update
+   * member variables should reimplement this function and
+   * return true for those parameters. Parameter changes to
+   * other operators are executed with processing suspended.
+   */
+  virtual bool realtime_safe_set_parameter(int param) const { return(false); }
 };
 
 #endif
@@ -44,6 +44,7 @@
 #include "eca-logger.h"
 #include "eca-object-factory.h"
 #include "eca-preset-map.h"
+#include "samplebuffer_cache.h"
 
 #include "eca-chainsetup.h"
 #include "eca-chainsetup-parser.h"
@@ -437,6 +438,56 @@ void ECA_CHAINSETUP_PARSER::interpret_general_option (const string& argu)
 	ECA_LOG_MSG(ECA_LOGGER::info, "Ignoring xruns during processing.");
 	csetup_repp->toggle_ignore_xruns(true);
       }
+      else if (first_arg == "threads") {
+	int threads = atoi(kvu_get_argument_number(2, argu).c_str());
+	if (threads < 0) threads = 1;
+	if (threads == 0)
+	  ECA_LOG_MSG(ECA_LOGGER::info, "Processing chains in parallel (one thread per CPU).");
+	else
+	  ECA_LOG_MSG(ECA_LOGGER::info, "Processing chains with " +
+		      kvu_numtostr(threads) + " threads.");
+	csetup_repp->set_chain_threads(threads);
+      }
+      else if (first_arg == "nothreads") {
+	ECA_LOG_MSG(ECA_LOGGER::info, "Processing chains in a single thread.");
+	csetup_repp->set_chain_threads(1);
+      }
+      else if (first_arg == "pipeline") {
+	int frames = 2;
+	if (kvu_get_number_of_arguments(argu) > 1)
+	  frames = atoi(kvu_get_argument_number(2, argu).c_str());
+	if (frames < 2) frames = 2;
+	ECA_LOG_MSG(ECA_LOGGER::info, "Enabling pipelined batch processing (" +
+		    kvu_numtostr(frames) + " frames).");
+	csetup_repp->set_pipeline_frames(frames);
+      }
+      else if (first_arg == "nopipeline") {
+	ECA_LOG_MSG(ECA_LOGGER::info, "Disabling pipelined batch processing.");
+	csetup_repp->set_pipeline_frames(0);
+      }
+      else if (first_arg == "dbthreads") {
+	int threads = atoi(kvu_get_argument_number(2, argu).c_str());
+	if (threads < 0) threads = 1;
+	if (threads == 0)
+	  ECA_LOG_MSG(ECA_LOGGER::info, "Serving double-buffered objects with one i/o thread per object.");
+	else
+	  ECA_LOG_MSG(ECA_LOGGER::info, "Serving double-buffered objects with " +
+		      kvu_numtostr(threads) + " i/o threads.");
+	csetup_repp->set_db_threads(threads);
+      }
+      else if (first_arg == "cache") {
+	int mbytes = SAMPLE_BUFFER_CACHE::default_size_limit / (1024 * 1024);
+	if (kvu_get_argument_number(2, argu).size() > 0)
+	  mbytes = atoi(kvu_get_argument_number(2, argu).c_str());
+	if (mbytes < 0) mbytes = 0;
+	ECA_LOG_MSG(ECA_LOGGER::info, "Caching up to " +
+		    kvu_numtostr(mbytes) + " MiB of decoded audio.");
+	csetup_repp->set_audio_cache_size(mbytes);
+      }
+      else if (first_arg == "nocache") {
+	ECA_LOG_MSG(ECA_LOGGER::info, "Disabling cache of decoded audio.");
+	csetup_repp->set_audio_cache_size(0);
+      }
       else if (first_arg == "mixmode") {
 	if (kvu_get_argument_number(2, argu) == "sum") {
 	  ECA_LOG_MSG(ECA_LOGGER::info, "Enabling 'sum' mixmode.");
@@ -1134,6 +1185,18 @@ string ECA_CHAINSETUP_PARSER::general_options_to_string(void) const
   else
     t << " -z:mixmode,sum";
 
+  if (csetup_repp->chain_threads() != 1)
+    t << " -z:threads," << csetup_repp->chain_threads();
+
+  if (csetup_repp->pipeline_frames() != 0)
+    t << " -z:pipeline," << csetup_repp->pipeline_frames();
+
+  if (csetup_repp->db_threads() != 1)
+    t << " -z:dbthreads," << csetup_repp->db_threads();
+
+  if (csetup_repp->audio_cache_size() != 0)
+    t << " -z:cache," << csetup_repp->audio_cache_size();
+
   t.setprecision(3);
   if (csetup_repp->max_length_set()) {
     t << " -t:" << csetup_repp->max_length_in_seconds_exact();
@@ -74,6 +74,7 @@
 #include "eca-object-factory.h"
 #include "eca-chainsetup-position.h"
 #include "sample-specs.h"
+#include "samplebuffer_cache.h"
 
 #include "eca-error.h"
 #include "eca-logger.h"
@@ -283,6 +284,10 @@ void ECA_CHAINSETUP::set_defaults(void)
     rtcaps_rep = false;
 
   db_clients_rep = 0;
+  chain_threads_rep = 1;
+  pipeline_frames_rep = 0;
+  db_threads_rep = 1;
+  audio_cache_size_rep = 0;
   multitrack_mode_rep = false;
   multitrack_mode_override_rep = false;
   memory_locked_rep = false;
@@ -607,6 +612,7 @@ void ECA_CHAINSETUP::enable_active_buffering_mode(void)
 		    "WARNING: Buffersize set to 0.");
       impl_repp->pserver_rep.set_buffer_defaults(0, 0);
     }
+    impl_repp->pserver_rep.set_io_threads(db_threads());
   }
   else {
     /* double_buffering() != true */
@@ -1824,6 +1830,9 @@ void ECA_CHAINSETUP::enable(void) throw(ECA_ERROR&)
       select_active_buffering_mode();
       enable_active_buffering_mode();
 
+      /* note: the cache is shared by all chainsetups */
+      SAMPLE_BUFFER_CACHE::instance().set_size_limit(static_cast<size_t>(audio_cache_size()) * 1024 * 1024);
+
       /* 3.1 open input devices */
       for(vector<AUDIO_IO*>::iterator q = inputs.begin(); q != inputs.end(); q++) {
 	enable_audio_object_helper(*q);
@@ -1979,9 +1988,9 @@ bool ECA_CHAINSETUP::execute_edit(const chainsetup_edit_t& edit)
 {
   bool retval = true;
 
-  ECA_LOG_MSG(ECA_LOGGER::user_objects,
-	      "Executing edit type of " +
-	      kvu_numtostr(static_cast<int>(edit.type)));
+  /* note: no logging of valid edits, as realtime edits
+   *       (see is_realtime_edit()) are executed from the 
+   *       engine's realtime context */
 
   if (edit.cs_ptr != this) {
     ECA_LOG_MSG(ECA_LOGGER::errors, 
@@ -2100,6 +2109,51 @@ bool ECA_CHAINSETUP::execute_edit(const chainsetup_edit_t& edit)
   return retval;
 }
 
+/**
+ * Whether 'edit' can be executed without allocating or 
+ * freeing memory, i.e. from a realtime context while 
+ * the chainsetup is running. This is the case for chain
+ * and chain operator bypass and muting, and for changes
+ * to chain operator parameters that are declared
+ * realtime-safe.
+ *
+ * @see CHAIN_OPERATOR::realtime_safe_set_parameter()
+ */
+bool ECA_CHAINSETUP::is_realtime_edit(const chainsetup_edit_t& edit) const
+{
+  if (edit.cs_ptr != this ||
+      edit.need_chain_reinit == true)
+    return false;
+
+  switch(edit.type)
+    {
+    case edit_c_bypass:
+    case edit_c_muting:
+    case edit_cop_bypass:
+      return true;
+
+    case edit_cop_set_param:
+      {
+	if (edit.m.cop_set_param.chain < 1 ||
+	    edit.m.cop_set_param.chain > static_cast<int>(chains.size()))
+	  return false;
+
+	/* note: the operator selection may change before 
+	 *       the edit is executed, so only explicitly
+	 *       addressed operators are considered */
+	const CHAIN *ch = chains[edit.m.cop_set_param.chain - 1];
+	int op = edit.m.cop_set_param.op;
+	if (op < 1 || op > ch->number_of_chain_operators())
+	  return false;
+
+	return ch->get_chain_operator(op - 1)->realtime_safe_set_parameter(edit.m.cop_set_param.param);
+      }
+
+    default:
+      return false;
+    }
+}
+
 /**
  * Updates the chainsetup processing length based on 
  * 1) requested length, 2) lengths of individual 
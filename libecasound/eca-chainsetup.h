@@ -189,6 +189,10 @@ class ECA_CHAINSETUP : public ECA_CHAINSETUP_POSITION {
   void set_buffering_mode(Buffering_mode_t value);
   void set_audio_io_manager_option(const string& mgrname, const string& optionstr);
   void set_mix_mode(Mix_mode_t value) { mix_mode_rep = value; }
+  void set_chain_threads(int value) { chain_threads_rep = value; }
+  void set_pipeline_frames(int value) { pipeline_frames_rep = value; }
+  void set_db_threads(int value) { db_threads_rep = value; }
+  void set_audio_cache_size(int value) { audio_cache_size_rep = value; }
 
   bool precise_sample_rates(void) const { return precise_sample_rates_rep; }
   bool ignore_xruns(void) const { return ignore_xruns_rep; }
@@ -200,6 +204,10 @@ class ECA_CHAINSETUP : public ECA_CHAINSETUP_POSITION {
   bool multitrack_mode(void) const { return multitrack_mode_rep; }
   long int multitrack_mode_offset(void) const { return multitrack_mode_offset_rep; } 
   Mix_mode_t mix_mode(void) const { return mix_mode_rep; }
+  int chain_threads(void) const { return chain_threads_rep; }
+  int pipeline_frames(void) const { return pipeline_frames_rep; }
+  int db_threads(void) const { return db_threads_rep; }
+  int audio_cache_size(void) const { return audio_cache_size_rep; }
 
   /*@}*/
 
@@ -238,6 +246,7 @@ class ECA_CHAINSETUP : public ECA_CHAINSETUP_POSITION {
   const string& filename(void) const { return setup_filename_rep; }
 
   bool execute_edit(const ECA::chainsetup_edit_t& edit);
+  bool is_realtime_edit(const ECA::chainsetup_edit_t& edit) const;
 
   /*@}*/
 
@@ -353,6 +362,10 @@ class ECA_CHAINSETUP : public ECA_CHAINSETUP_POSITION {
   int selected_ctrl_param_index_rep;
 
   int db_clients_rep;
+  int chain_threads_rep;
+  int pipeline_frames_rep;
+  int db_threads_rep;
+  int audio_cache_size_rep;
   long int multitrack_mode_offset_rep;
   string setup_name_rep;
   string setup_filename_rep;
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "eca-chainsetup.h"
+#include "eca-chainsetup-edit.h"
 #include "kvu_numtostr.h"
 
 #include "eca-logger.h"
@@ -49,12 +50,14 @@ public:
 private:
 
   void do_run_save_and_restore(void);
+  void do_run_realtime_edits(void);
 
 };
 
 void ECA_CHAINSETUP_TEST::do_run(void)
 {
   do_run_save_and_restore();
+  do_run_realtime_edits();
 }
 
 void ECA_CHAINSETUP_TEST::do_run_save_and_restore(void)
@@ -72,3 +75,58 @@ void ECA_CHAINSETUP_TEST::do_run_save_and_restore(void)
    *   save -> load -> save -> load' cycle)
    */
 }
+
+void ECA_CHAINSETUP_TEST::do_run_realtime_edits(void)
+{
+  ECA_CHAINSETUP csetup;
+  csetup.interpret_object_option("-a:1");
+  csetup.interpret_object_option("-ea:100");
+  csetup.interpret_object_option("-etd:100,0,1,50");
+  csetup.interpret_object_option("-eadb:0,1");
+  if (csetup.interpret_result() != true) {
+    ECA_TEST_FAILURE("Chain operator addition failed.");
+    return;
+  }
+
+  ECA::chainsetup_edit_t edit;
+  edit.cs_ptr = &csetup;
+  edit.need_chain_reinit = false;
+
+  edit.type = ECA::edit_c_bypass;
+  edit.m.c_bypass.chain = 1;
+  edit.m.c_bypass.val = 1;
+  if (csetup.is_realtime_edit(edit) != true)
+    ECA_TEST_FAILURE("Chain bypass not realtime-safe.");
+
+  edit.type = ECA::edit_cop_set_param;
+  edit.m.cop_set_param.chain = 1;
+  edit.m.cop_set_param.op = 1;
+  edit.m.cop_set_param.param = 1;
+  edit.m.cop_set_param.value = 50.0;
+  if (csetup.is_realtime_edit(edit) != true)
+    ECA_TEST_FAILURE("Amplifier parameter change not realtime-safe.");
+
+  /* note: -etd resizes its delay buffers in set_parameter() */
+  edit.m.cop_set_param.op = 2;
+  if (csetup.is_realtime_edit(edit) == true)
+    ECA_TEST_FAILURE("Delay parameter change realtime-safe.");
+
+  /* note: changing the -eadb channel reinitializes the operator */
+  edit.m.cop_set_param.op = 3;
+  if (csetup.is_realtime_edit(edit) != true)
+    ECA_TEST_FAILURE("Amplifier (dB) gain change not realtime-safe.");
+  edit.m.cop_set_param.param = 2;
+  if (csetup.is_realtime_edit(edit) == true)
+    ECA_TEST_FAILURE("Amplifier (dB) channel change realtime-safe.");
+  edit.m.cop_set_param.param = 1;
+
+  /* note: operator selection may change before execution */
+  edit.m.cop_set_param.op = -1;
+  if (csetup.is_realtime_edit(edit) == true)
+    ECA_TEST_FAILURE("Selected operator parameter change realtime-safe.");
+
+  edit.m.cop_set_param.op = 1;
+  edit.need_chain_reinit = true;
+  if (csetup.is_realtime_edit(edit) == true)
+    ECA_TEST_FAILURE("Edit requiring reinit realtime-safe.");
+}
@@ -2181,6 +2181,31 @@ bool ECA_CONTROL::chain_operator_is_bypassed(void) const
   return false;
 }
 
+/**
+ * Returns average processing load of selected chain op, 
+ * as percents of the buffer length.
+ *
+ * require:
+ *  is_selected() == true
+ *  selected_chains().size() == 1
+ *  get_chain_operator() != 0
+ */
+double ECA_CONTROL::chain_operator_load(void) const
+{
+  // --------
+  DBC_REQUIRE(is_selected() == true);
+  DBC_REQUIRE(selected_chains().size() == 1);
+  DBC_REQUIRE(get_chain_operator() != 0);
+  // --------
+
+  int op_index = selected_chain_operator();
+  CHAIN* c = get_chain_priv();
+  if (c != 0) {
+    return c->chain_operator_profile(op_index - 1).load_percent();
+  }
+  return 0.0;
+}
+
 /**
  * Returns true if selected chain is bypassed
  */
@@ -2215,6 +2240,48 @@ bool ECA_CONTROL::chain_is_muted(void) const
   return false;
 }
 
+/**
+ * Returns average processing load of selected chain, 
+ * as percents of the buffer length.
+ *
+ * require:
+ *  is_selected() == true
+ *  selected_chains().size() == 1
+ */
+double ECA_CONTROL::chain_load(void) const
+{
+  // --------
+  DBC_REQUIRE(is_selected() == true);
+  DBC_REQUIRE(selected_chains().size() == 1);
+  // --------
+
+  CHAIN* c = get_chain_priv();
+  if (c != 0) {
+    return c->profile().load_percent();
+  }
+  return 0.0;
+}
+
+/**
+ * Resets processing load statistics of all chains 
+ * and chain operators of the selected chainsetup.
+ *
+ * require:
+ *  is_selected() == true
+ */
+void ECA_CONTROL::reset_chain_profiles(void)
+{
+  // --------
+  DBC_REQUIRE(is_selected() == true);
+  // --------
+
+  for(vector<CHAIN*>::iterator p = selected_chainsetup_repp->chains.begin();
+      p != selected_chainsetup_repp->chains.end();
+      p++) {
+    (*p)->reset_profiles();
+  }
+}
+
 /**
  * Returns the selected chain operator parameter value
  *
@@ -535,6 +535,8 @@ void ECA_CONTROL::action(int action_id)
       }
       break;
     }
+  case ec_cs_profile: { set_last_string(chain_profile_status()); break; }
+  case ec_cs_profile_reset: { reset_chain_profiles(); break; }
 
   // ---
   // Chains
@@ -573,6 +575,16 @@ void ECA_CONTROL::action(int action_id)
     }
   case ec_c_is_bypassed: { set_last_integer(chain_is_bypassed()); break; }
   case ec_c_is_muted: { set_last_integer(chain_is_muted()); break; }
+  case ec_c_load:
+    {
+      if (selected_chains().size() != 1) {
+	set_last_error("Exactly one chain must be selected.");
+      }
+      else {
+	set_last_float(chain_load());
+      }
+      break;
+    }
 
     // ---
     // Actions common to audio inputs and outputs
@@ -734,6 +746,16 @@ void ECA_CONTROL::action(int action_id)
       set_last_string(chain_operator_status()); 
       break; 
     }
+  case ec_cop_load:
+    {
+      if (selected_chains().size() != 1 || get_chain_operator() == 0) {
+	set_last_error("Exactly one chain and a chain operator must be selected.");
+      }
+      else {
+	set_last_float(chain_operator_load());
+      }
+      break;
+    }
 
     // ---
     // Chain operator parameters
@@ -912,6 +934,10 @@ bool ECA_CONTROL::execute_edit_on_connected(const chainsetup_edit_t& edit)
   DBC_REQUIRE(is_connected() == true);
 
   bool retval = false;
+
+  ECA_LOG_MSG(ECA_LOGGER::user_objects,
+	      "Executing edit type of " +
+	      kvu_numtostr(static_cast<int>(edit.type)));
   
   if (is_engine_ready_for_commands() == true) {
     ECA_ENGINE::complex_command_t engine_cmd;
@@ -960,6 +986,9 @@ bool ECA_CONTROL::execute_edit_on_selected(const chainsetup_edit_t& edit, int in
       execute_edit_on_connected(edit);
     }
     else {
+      ECA_LOG_MSG(ECA_LOGGER::user_objects,
+		  "Executing edit type of " +
+		  kvu_numtostr(static_cast<int>(edit.type)));
       csetup->execute_edit(edit);
     }
   }
@@ -1151,6 +1180,32 @@ string ECA_CONTROL::chain_operator_status(void) const
   return msg.to_string();
 }
 
+string ECA_CONTROL::chain_profile_status(void) const
+{
+  // --------
+  DBC_REQUIRE(is_selected() == true);
+  // --------
+
+  MESSAGE_ITEM msg;
+  vector<CHAIN*>::const_iterator chain_citer = selected_chainsetup_repp->chains.begin();
+
+  msg << "### Processing load (chainsetup '" 
+      << selected_chainsetup() 
+      << "') ###\n";
+
+  while(chain_citer != selected_chainsetup_repp->chains.end()) {
+    const CHAIN* c = *chain_citer;
+    msg << "Chain \"" << c->name() << "\": " << c->profile().to_string();
+    for(int p = 0; p < c->number_of_chain_operators(); p++) {
+      msg << "\n\t" << p + 1 << ". " << c->get_chain_operator(p)->name();
+      msg << ": " << c->chain_operator_profile(p).to_string();
+    }
+    ++chain_citer;
+    if (chain_citer != selected_chainsetup_repp->chains.end()) msg << "\n";
+  }
+  return msg.to_string();
+}
+
 string ECA_CONTROL::controller_status(void) const
 {
   // --------
@@ -192,6 +192,8 @@ class ECA_CONTROL : public ECA_IAMODE_PARSER,
   const CHAIN* get_chain(void) const;
   bool chain_is_bypassed(void) const;
   bool chain_is_muted(void) const;
+  double chain_load(void) const;
+  void reset_chain_profiles(void);
 
   void clear_chains(void);
   void rename_chain(const std::string& name);
@@ -250,6 +252,7 @@ class ECA_CONTROL : public ECA_IAMODE_PARSER,
   void add_chain_operator(CHAIN_OPERATOR* cotmp);
   void bypass_chain_operator(const string& arg);
   bool chain_operator_is_bypassed(void) const;
+  double chain_operator_load(void) const;
   void remove_chain_operator(void);
   void select_chain_operator(int chainop_id);
   void select_chain_operator_parameter(int param);
@@ -329,6 +332,15 @@ class ECA_CONTROL : public ECA_IAMODE_PARSER,
    */
   std::string chain_operator_status(void) const;
 
+  /**
+   * Return info about processing load of chains and 
+   * chain operators (selected chainsetup)
+   *
+   * require:
+   *  is_selected() == true
+   */
+  std::string chain_profile_status(void) const;
+
   /**
    * Return info about controllers (selected chainsetup)
    *
@@ -21,6 +21,7 @@
 
 #include "kvu_utils.h" /* kvu_sleep() */
 
+#include "eca-chain.h"
 #include "eca-session.h"
 #include "eca-control.h"
 #include "eca-test-case.h"
@@ -46,6 +47,7 @@ public:
 private:
 
   void do_run_chainsetup_creation(void);
+  void do_run_profiling(void);
 
 };
 
@@ -53,6 +55,8 @@ void ECA_CONTROL_TEST::do_run(void)
 {
   cout << "libecasound_tester: eca-control - chainsetup creation stress test" << endl;
   do_run_chainsetup_creation();
+  cout << "libecasound_tester: eca-control - processing profiles" << endl;
+  do_run_profiling();
 }
 
 void ECA_CONTROL_TEST::do_run_chainsetup_creation(void)
@@ -92,3 +96,49 @@ void ECA_CONTROL_TEST::do_run_chainsetup_creation(void)
   delete ectrl;
   delete esession;
 }
+
+void ECA_CONTROL_TEST::do_run_profiling(void)
+{
+  ECA_SESSION *esession = new ECA_SESSION();
+  ECA_CONTROL *ectrl = new ECA_CONTROL(esession);
+  struct eci_return_value retval;
+
+  ectrl->add_chainsetup("default");
+  ectrl->add_chain("default");
+  ectrl->add_audio_input("null");
+  ectrl->add_audio_output("null");
+  ectrl->add_chain_operator("-ea:100");
+  ectrl->connect_chainsetup(0);
+  ectrl->start();
+  kvu_sleep(0, 200000000); /* 200ms */
+  ectrl->stop_on_condition();
+
+  if (ectrl->get_chain()->profile().events() <= 0 ||
+      ectrl->get_chain()->chain_operator_profile(0).events() <= 0)
+    ECA_TEST_FAILURE("No processing times recorded.");
+
+  ectrl->command("c-load", &retval);
+  if (retval.type != eci_return_value::retval_float ||
+      retval.m.float_val < 0.0) ECA_TEST_FAILURE("c-load failed.");
+
+  ectrl->command("cop-select 1", &retval);
+  ectrl->command("cop-load", &retval);
+  if (retval.type != eci_return_value::retval_float ||
+      retval.m.float_val < 0.0) ECA_TEST_FAILURE("cop-load failed.");
+
+  ectrl->command("cs-profile", &retval);
+  if (retval.type != eci_return_value::retval_string ||
+      retval.string_val.find("Chain \"default\"") == string::npos)
+    ECA_TEST_FAILURE("cs-profile failed.");
+
+  ectrl->command("cs-profile-reset", &retval);
+  if (ectrl->get_chain()->profile().events() != 0 ||
+      ectrl->get_chain()->chain_operator_profile(0).events() != 0)
+    ECA_TEST_FAILURE("cs-profile-reset failed.");
+
+  ectrl->disconnect_chainsetup();
+  ectrl->remove_chainsetup();
+
+  delete ectrl;
+  delete esession;
+}
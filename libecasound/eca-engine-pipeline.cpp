@@ -0,0 +1,488 @@
+// ------------------------------------------------------------------------
+// eca-engine-pipeline.cpp: Reader and writer threads for pipelined
+//                          batch processing
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include <kvu_dbc.h>
+#include <kvu_numtostr.h>
+
+#include "audioio.h"
+#include "samplebuffer.h"
+#include "eca-logger.h"
+#include "eca-engine-pipeline.h"
+
+/**
+ * Blocks SIGINT for the calling thread, so that the
+ * signal is delivered to the main thread.
+ */
+static void priv_block_sigint(void)
+{
+  sigset_t sigset;
+  sigemptyset(&sigset);
+  sigaddset(&sigset, SIGINT);
+  sigprocmask(SIG_BLOCK, &sigset, 0);
+}
+
+/**
+ * Helper function for waiting on a semaphore. Retries
+ * if the wait is interrupted by a signal.
+ */
+static void priv_sem_wait(sem_t* sem)
+{
+  while(sem_wait(sem) != 0 && errno == EINTR)
+    ;
+}
+
+/**
+ * Helper function for starting the reader thread.
+ */
+void* start_engine_pipeline_reader(void *ptr)
+{
+  priv_block_sigint();
+  static_cast<ECA_ENGINE_PIPELINE*>(ptr)->reader_thread();
+  return 0;
+}
+
+/**
+ * Helper function for starting the writer thread.
+ */
+void* start_engine_pipeline_writer(void *ptr)
+{
+  priv_block_sigint();
+  static_cast<ECA_ENGINE_PIPELINE*>(ptr)->writer_thread();
+  return 0;
+}
+
+/**
+ * Constructor.
+ */
+ECA_ENGINE_PIPELINE::ECA_ENGINE_PIPELINE(void)
+  : inputs_repp(0),
+    outputs_repp(0),
+    inputs_read_rep(0),
+    inputs_acquired_rep(0),
+    inputs_consumed_rep(0),
+    outputs_submitted_rep(0),
+    outputs_written_rep(0),
+    buffersize_rep(0),
+    read_position_rep(0),
+    max_length_rep(-1),
+    running_rep(false)
+{
+  sem_init(&input_free_sem_rep, 0, 0);
+  sem_init(&input_ready_sem_rep, 0, 0);
+  sem_init(&output_free_sem_rep, 0, 0);
+  sem_init(&output_ready_sem_rep, 0, 0);
+  exit_request_rep.set(0);
+  outputs_finished_rep.set(0);
+}
+
+/**
+ * Destructor. Stops the threads and frees all frames.
+ */
+ECA_ENGINE_PIPELINE::~ECA_ENGINE_PIPELINE(void)
+{
+  stop();
+  release_frames();
+  sem_destroy(&input_free_sem_rep);
+  sem_destroy(&input_ready_sem_rep);
+  sem_destroy(&output_free_sem_rep);
+  sem_destroy(&output_ready_sem_rep);
+}
+
+/**
+ * Allocates 'frames' frames for both inputs and outputs,
+ * and creates the reader and writer threads.
+ *
+ * Inputs are read in blocks of 'buffersize' samples.
+ * 'position' is the current chainsetup position, and
+ * 'max_length' the chainsetup length, or -1 if not set.
+ * The last block before 'max_length' is shortened
+ * exactly as ECA_ENGINE does when reading serially.
+ *
+ * Note: allocates memory; must not be called
+ *       while the engine is running
+ *
+ * @pre inputs != 0 && outputs != 0
+ * @pre frames > 1
+ * @pre is_running() != true
+ */
+void ECA_ENGINE_PIPELINE::start(std::vector<AUDIO_IO*>* inputs,
+				std::vector<AUDIO_IO*>* outputs,
+				long int buffersize,
+				SAMPLE_SPECS::sample_pos_t position,
+				SAMPLE_SPECS::sample_pos_t max_length,
+				int frames)
+{
+  // --
+  DBC_REQUIRE(inputs != 0 && outputs != 0);
+  DBC_REQUIRE(frames > 1);
+  DBC_REQUIRE(is_running() != true);
+  // --
+
+  release_frames();
+
+  inputs_repp = inputs;
+  outputs_repp = outputs;
+  buffersize_rep = buffersize;
+  read_position_rep = position;
+  max_length_rep = max_length;
+
+  input_frames_rep.resize(frames);
+  output_frames_rep.resize(frames);
+  for(int n = 0; n < frames; n++) {
+    for(size_t m = 0; m < inputs->size(); m++) {
+      input_frames_rep[n].buffers.push_back(new SAMPLE_BUFFER(buffersize, (*inputs)[m]->channels()));
+    }
+    input_frames_rep[n].inputs_not_finished = 0;
+    input_frames_rep[n].shortened = false;
+    for(size_t m = 0; m < outputs->size(); m++) {
+      output_frames_rep[n].buffers.push_back(new SAMPLE_BUFFER(buffersize, (*outputs)[m]->channels()));
+    }
+    output_frames_rep[n].active.resize(outputs->size(), false);
+  }
+
+  inputs_read_rep = 0;
+  inputs_acquired_rep = 0;
+  inputs_consumed_rep = 0;
+  outputs_submitted_rep = 0;
+  outputs_written_rep = 0;
+
+  sem_destroy(&input_free_sem_rep);
+  sem_destroy(&input_ready_sem_rep);
+  sem_destroy(&output_free_sem_rep);
+  sem_destroy(&output_ready_sem_rep);
+  sem_init(&input_free_sem_rep, 0, frames);
+  sem_init(&input_ready_sem_rep, 0, 0);
+  sem_init(&output_free_sem_rep, 0, frames);
+  sem_init(&output_ready_sem_rep, 0, 0);
+
+  exit_request_rep.set(0);
+  outputs_finished_rep.set(0);
+
+  if (pthread_create(&reader_thread_rep, 0,
+		     start_engine_pipeline_reader,
+		     static_cast<void *>(this)) != 0) {
+    ECA_LOG_MSG(ECA_LOGGER::info,
+		"WARNING: Unable to create pipeline reader thread.");
+    return;
+  }
+  if (pthread_create(&writer_thread_rep, 0,
+		     start_engine_pipeline_writer,
+		     static_cast<void *>(this)) != 0) {
+    ECA_LOG_MSG(ECA_LOGGER::info,
+		"WARNING: Unable to create pipeline writer thread.");
+    exit_request_rep.set(1);
+    sem_post(&input_free_sem_rep);
+    pthread_join(reader_thread_rep, 0);
+    rewind_inputs();
+    return;
+  }
+
+  running_rep = true;
+
+  ECA_LOG_MSG(ECA_LOGGER::user_objects,
+	      "Pipelined processing with " +
+	      kvu_numtostr(frames) +
+	      " frames per stage.");
+}
+
+/**
+ * Stops both threads. All frames submitted with
+ * submit_outputs() are written before the writer
+ * thread exits. Inputs that were read ahead are
+ * seeked back to the position of the last frame
+ * consumed by the engine.
+ *
+ * @post is_running() != true
+ */
+void ECA_ENGINE_PIPELINE::stop(void)
+{
+  if (running_rep != true)
+    return;
+
+  exit_request_rep.set(1);
+
+  /* note: wakes up the reader if it is waiting for a free frame */
+  sem_post(&input_free_sem_rep);
+  pthread_join(reader_thread_rep, 0);
+
+  /* note: the writer exits when it is woken up without
+   *       a submitted frame to write */
+  sem_post(&output_ready_sem_rep);
+  pthread_join(writer_thread_rep, 0);
+
+  /* note: all acquired frames have been processed */
+  inputs_consumed_rep = inputs_acquired_rep;
+  rewind_inputs();
+
+  running_rep = false;
+
+  ECA_LOG_MSG(ECA_LOGGER::system_objects, "pipeline stopped");
+
+  // --
+  DBC_ENSURE(is_running() != true);
+  // --
+}
+
+/**
+ * Blocks until the next input frame has been read.
+ * Returns number of inputs that have not finished
+ * after reading the frame.
+ *
+ * The previously acquired frame is not returned to
+ * the reader until release_inputs() is called.
+ *
+ * context: J-level-2
+ *          does not allocate memory
+ *
+ * @pre is_running() == true
+ */
+int ECA_ENGINE_PIPELINE::acquire_inputs(void)
+{
+  priv_sem_wait(&input_ready_sem_rep);
+  ++inputs_acquired_rep;
+  return input_frames_rep[(inputs_acquired_rep - 1) % input_frames_rep.size()].inputs_not_finished;
+}
+
+/**
+ * Returns data read from input 'input' for the frame
+ * acquired with acquire_inputs(). Contents stay valid
+ * until the next frame has been acquired and 
+ * release_inputs() is called.
+ */
+const SAMPLE_BUFFER* ECA_ENGINE_PIPELINE::input_buffer(int input) const
+{
+  return input_frames_rep[(inputs_acquired_rep - 1) % input_frames_rep.size()].buffers[input];
+}
+
+/**
+ * Returns input frames acquired before the current
+ * one to the reader. Must be called only when no
+ * buffer shares data of the earlier frames anymore
+ * (see SAMPLE_BUFFER::share_content()).
+ *
+ * context: J-level-2
+ */
+void ECA_ENGINE_PIPELINE::release_inputs(void)
+{
+  while(inputs_consumed_rep + 1 < inputs_acquired_rep) {
+    ++inputs_consumed_rep;
+    sem_post(&input_free_sem_rep);
+  }
+}
+
+/**
+ * Blocks until an output frame is free. Initially
+ * no output of the frame is marked for writing.
+ *
+ * context: J-level-2
+ *          does not allocate memory
+ */
+void ECA_ENGINE_PIPELINE::acquire_outputs(void)
+{
+  priv_sem_wait(&output_free_sem_rep);
+
+  struct frame_t* frame = &output_frames_rep[outputs_submitted_rep % output_frames_rep.size()];
+  for(size_t n = 0; n < frame->active.size(); n++) {
+    frame->active[n] = false;
+  }
+}
+
+/**
+ * Returns buffer for output 'output' of the frame
+ * acquired with acquire_outputs(), and marks the
+ * output to be written.
+ */
+SAMPLE_BUFFER* ECA_ENGINE_PIPELINE::output_buffer(int output)
+{
+  struct frame_t* frame = &output_frames_rep[outputs_submitted_rep % output_frames_rep.size()];
+  frame->active[output] = true;
+  return frame->buffers[output];
+}
+
+/**
+ * Passes the acquired output frame to the writer.
+ *
+ * context: J-level-2
+ */
+void ECA_ENGINE_PIPELINE::submit_outputs(void)
+{
+  ++outputs_submitted_rep;
+  sem_post(&output_ready_sem_rep);
+}
+
+/**
+ * Main loop of the reader thread.
+ */
+void ECA_ENGINE_PIPELINE::reader_thread(void)
+{
+  while(true) {
+    priv_sem_wait(&input_free_sem_rep);
+    if (exit_request_rep.get() != 0)
+      break;
+    read_frame(&input_frames_rep[inputs_read_rep % input_frames_rep.size()]);
+    ++inputs_read_rep;
+    sem_post(&input_ready_sem_rep);
+  }
+}
+
+/**
+ * Main loop of the writer thread.
+ */
+void ECA_ENGINE_PIPELINE::writer_thread(void)
+{
+  while(true) {
+    priv_sem_wait(&output_ready_sem_rep);
+    if (outputs_written_rep == outputs_submitted_rep)
+      break;
+    write_frame(&output_frames_rep[outputs_written_rep % output_frames_rep.size()]);
+    ++outputs_written_rep;
+    sem_post(&output_free_sem_rep);
+  }
+}
+
+/**
+ * Reads one block from all inputs to 'frame'.
+ *
+ * @see ECA_ENGINE::prehandle_control_position()
+ * @see ECA_ENGINE::inputs_to_chains()
+ */
+void ECA_ENGINE_PIPELINE::read_frame(struct frame_t* frame)
+{
+  /* step: shorten the last block before max length */
+  read_position_rep += buffersize_rep;
+  frame->shortened = false;
+  if (max_length_rep >= 0 &&
+      read_position_rep > max_length_rep) {
+    frame->shortened = true;
+    SAMPLE_SPECS::sample_pos_t buffer_remain =
+      buffersize_rep - (read_position_rep - max_length_rep);
+    if (buffer_remain < 0)
+      buffer_remain = 0;
+    else if (buffer_remain > buffersize_rep)
+      buffer_remain = buffersize_rep;
+    for(size_t n = 0; n < inputs_repp->size(); n++) {
+      (*inputs_repp)[n]->set_buffersize(buffer_remain);
+    }
+  }
+
+  /* step: read data */
+  frame->inputs_not_finished = 0;
+  for(size_t n = 0; n < inputs_repp->size(); n++) {
+    AUDIO_IO* input = (*inputs_repp)[n];
+    SAMPLE_BUFFER* sbuf = frame->buffers[n];
+
+    sbuf->length_in_samples(buffersize_rep);
+    if (input->finished() != true) {
+      input->read_buffer(sbuf);
+      if (input->finished() != true)
+	frame->inputs_not_finished++;
+    }
+    else {
+      sbuf->make_empty();
+    }
+
+    /* note: silence is detected here, off the engine thread */
+    sbuf->event_tag_set(SAMPLE_BUFFER::tag_silent, sbuf->is_silent());
+  }
+}
+
+/**
+ * Writes all active outputs of 'frame'.
+ */
+void ECA_ENGINE_PIPELINE::write_frame(struct frame_t* frame)
+{
+  for(size_t n = 0; n < outputs_repp->size(); n++) {
+    if (frame->active[n] != true)
+      continue;
+
+    AUDIO_IO* output = (*outputs_repp)[n];
+    output->write_buffer(frame->buffers[n]);
+    if (output->finished() == true)
+      outputs_finished_rep.add(1);
+  }
+}
+
+/**
+ * Seeks inputs back by the amount of data in frames
+ * that were read but not consumed by the engine.
+ */
+void ECA_ENGINE_PIPELINE::rewind_inputs(void)
+{
+  if (inputs_read_rep == inputs_consumed_rep)
+    return;
+
+  for(size_t n = 0; n < inputs_repp->size(); n++) {
+    SAMPLE_SPECS::sample_pos_t unused = 0;
+    for(long int m = inputs_consumed_rep; m < inputs_read_rep; m++) {
+      unused += input_frames_rep[m % input_frames_rep.size()].buffers[n]->length_in_samples();
+    }
+
+    AUDIO_IO* input = (*inputs_repp)[n];
+    if (unused > 0 && input->supports_seeking() == true) {
+      input->seek_position_in_samples(input->position_in_samples() - unused);
+    }
+
+    /* note: undo shortening done for a discarded frame */
+    if (input_frames_rep[inputs_consumed_rep % input_frames_rep.size()].shortened == true)
+      input->set_buffersize(buffersize_rep);
+  }
+
+  ECA_LOG_MSG(ECA_LOGGER::system_objects,
+	      "discarded " +
+	      kvu_numtostr(inputs_read_rep - inputs_consumed_rep) +
+	      " frames read ahead");
+
+  inputs_consumed_rep = inputs_read_rep;
+}
+
+/**
+ * Frees all frames.
+ *
+ * @pre is_running() != true
+ */
+void ECA_ENGINE_PIPELINE::release_frames(void)
+{
+  for(size_t n = 0; n < input_frames_rep.size(); n++) {
+    for(size_t m = 0; m < input_frames_rep[n].buffers.size(); m++) {
+      delete input_frames_rep[n].buffers[m];
+    }
+  }
+  input_frames_rep.clear();
+
+  for(size_t n = 0; n < output_frames_rep.size(); n++) {
+    for(size_t m = 0; m < output_frames_rep[n].buffers.size(); m++) {
+      delete output_frames_rep[n].buffers[m];
+    }
+  }
+  output_frames_rep.clear();
+}
@@ -0,0 +1,159 @@
+// ------------------------------------------------------------------------
+// eca-engine-pipeline.h: Reader and writer threads for pipelined
+//                        batch processing
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDED_ECA_ENGINE_PIPELINE_H
+#define INCLUDED_ECA_ENGINE_PIPELINE_H
+
+#include <vector>
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include <kvu_locks.h>
+
+#include "sample-specs.h"
+
+class AUDIO_IO;
+class SAMPLE_BUFFER;
+
+/**
+ * Reader and writer threads used by ECA_ENGINE to
+ * overlap input, processing and output in batch mode.
+ *
+ * The reader thread reads inputs ahead of the engine
+ * thread, and the writer thread writes outputs behind
+ * it. Stages are connected with rings of preallocated
+ * frames, one buffer per input or output in each frame.
+ * Frames are passed in order, so the audio data is
+ * identical to serial processing.
+ *
+ * Only usable with non-realtime objects, as inputs are
+ * read, and outputs written, at a different time than
+ * the engine iteration that processes the data.
+ *
+ * The engine keeps the most recently acquired input
+ * frame until it acquires the next one, so one frame
+ * of each input ring is not available to the reader.
+ *
+ * The threads are created in start() and destroyed in
+ * stop(). Engine-side functions do not allocate memory.
+ */
+class ECA_ENGINE_PIPELINE {
+
+  friend void* start_engine_pipeline_reader(void *ptr);
+  friend void* start_engine_pipeline_writer(void *ptr);
+
+ public:
+
+  /** @name Constructors and dtors */
+  /*@{*/
+
+  ECA_ENGINE_PIPELINE(void);
+  ~ECA_ENGINE_PIPELINE(void);
+
+  /*@}*/
+
+  /** @name Public functions for transport control */
+  /*@{*/
+
+  void start(std::vector<AUDIO_IO*>* inputs,
+	     std::vector<AUDIO_IO*>* outputs,
+	     long int buffersize,
+	     SAMPLE_SPECS::sample_pos_t position,
+	     SAMPLE_SPECS::sample_pos_t max_length,
+	     int frames);
+  void stop(void);
+
+  /*@}*/
+
+  /** @name Public functions for the engine thread */
+  /*@{*/
+
+  int acquire_inputs(void);
+  const SAMPLE_BUFFER* input_buffer(int input) const;
+  void release_inputs(void);
+
+  void acquire_outputs(void);
+  SAMPLE_BUFFER* output_buffer(int output);
+  void submit_outputs(void);
+
+  /*@}*/
+
+  /** @name Public functions for acquiring status information */
+  /*@{*/
+
+  bool is_running(void) const { return running_rep; }
+  int outputs_finished(void) const { return outputs_finished_rep.get(); }
+
+  /*@}*/
+
+ private:
+
+  struct frame_t {
+    std::vector<SAMPLE_BUFFER*> buffers;
+    std::vector<bool> active;
+    int inputs_not_finished;
+    bool shortened;
+  };
+
+  std::vector<AUDIO_IO*>* inputs_repp;
+  std::vector<AUDIO_IO*>* outputs_repp;
+
+  std::vector<struct frame_t> input_frames_rep;
+  std::vector<struct frame_t> output_frames_rep;
+
+  /* note: frame counters, modified only by the thread
+   *       named in the comment */
+  long int inputs_read_rep;      // reader
+  long int inputs_acquired_rep;  // engine
+  long int inputs_consumed_rep;  // engine
+  long int outputs_submitted_rep; // engine
+  long int outputs_written_rep;  // writer
+
+  sem_t input_free_sem_rep;
+  sem_t input_ready_sem_rep;
+  sem_t output_free_sem_rep;
+  sem_t output_ready_sem_rep;
+
+  pthread_t reader_thread_rep;
+  pthread_t writer_thread_rep;
+
+  ATOMIC_INTEGER exit_request_rep;
+  ATOMIC_INTEGER outputs_finished_rep;
+
+  long int buffersize_rep;
+  SAMPLE_SPECS::sample_pos_t read_position_rep;
+  SAMPLE_SPECS::sample_pos_t max_length_rep;
+  bool running_rep;
+
+  void reader_thread(void);
+  void writer_thread(void);
+  void read_frame(struct frame_t* frame);
+  void write_frame(struct frame_t* frame);
+  void rewind_inputs(void);
+  void release_frames(void);
+
+  ECA_ENGINE_PIPELINE& operator=(const ECA_ENGINE_PIPELINE& x) { return *this; }
+  ECA_ENGINE_PIPELINE(const ECA_ENGINE_PIPELINE& x) { }
+};
+
+#endif /* INCLUDED_ECA_ENGINE_PIPELINE_H */
@@ -0,0 +1,226 @@
+// ------------------------------------------------------------------------
+// eca-engine-workers.cpp: Worker thread pool for parallel chain processing
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include <kvu_dbc.h>
+#include <kvu_numtostr.h>
+#include <kvu_rtcaps.h>
+
+#include "eca-chain.h"
+#include "eca-logger.h"
+#include "eca-engine-workers.h"
+
+/**
+ * Helper function for starting the worker threads.
+ */
+void* start_engine_worker_thread(void *ptr)
+{
+  sigset_t sigset;
+  sigemptyset(&sigset);
+  sigaddset(&sigset, SIGINT);
+  sigprocmask(SIG_BLOCK, &sigset, 0);
+
+  ECA_ENGINE_WORKERS* workers =
+    static_cast<ECA_ENGINE_WORKERS*>(ptr);
+  workers->worker_thread();
+
+  return 0;
+}
+
+/**
+ * Helper function for waiting on a semaphore. Retries
+ * if the wait is interrupted by a signal.
+ */
+static void priv_sem_wait(sem_t* sem)
+{
+  while(sem_wait(sem) != 0 && errno == EINTR)
+    ;
+}
+
+/**
+ * Constructor.
+ */
+ECA_ENGINE_WORKERS::ECA_ENGINE_WORKERS(void)
+  : chains_repp(0),
+    schedpriority_rep(0)
+{
+  sem_init(&start_sem_rep, 0, 0);
+  sem_init(&done_sem_rep, 0, 0);
+  next_chain_rep.set(0);
+  exit_request_rep.set(0);
+}
+
+/**
+ * Destructor. Stops all worker threads.
+ */
+ECA_ENGINE_WORKERS::~ECA_ENGINE_WORKERS(void)
+{
+  stop();
+  sem_destroy(&start_sem_rep);
+  sem_destroy(&done_sem_rep);
+}
+
+/**
+ * Creates 'threads-1' worker threads for processing
+ * chains in 'chains'. If 'schedpriority' is larger
+ * than zero, workers are run with SCHED_FIFO
+ * scheduling using the given priority.
+ *
+ * Note: may allocate memory; must not be called
+ *       while the engine is running
+ *
+ * @pre chains != 0
+ * @pre is_running() != true
+ */
+void ECA_ENGINE_WORKERS::start(std::vector<CHAIN*>* chains, int threads, int schedpriority)
+{
+  // --
+  DBC_REQUIRE(chains != 0);
+  DBC_REQUIRE(is_running() != true);
+  // --
+
+  chains_repp = chains;
+  schedpriority_rep = schedpriority;
+  exit_request_rep.set(0);
+
+  /* note: no point in having more threads than chains */
+  if (threads > static_cast<int>(chains->size()))
+    threads = chains->size();
+
+  for(int n = 0; n < threads - 1; n++) {
+    pthread_t thread;
+    int ret = pthread_create(&thread,
+			     0,
+			     start_engine_worker_thread,
+			     static_cast<void *>(this));
+    if (ret != 0) {
+      ECA_LOG_MSG(ECA_LOGGER::info,
+		  "WARNING: Unable to create chain worker thread, "
+		  "continuing with " + kvu_numtostr(n + 1) + " threads.");
+      break;
+    }
+    workers_rep.push_back(thread);
+  }
+
+  if (workers_rep.size() > 0)
+    ECA_LOG_MSG(ECA_LOGGER::user_objects,
+		"Processing chains with " +
+		kvu_numtostr(number_of_threads()) +
+		" threads.");
+}
+
+/**
+ * Stops and joins all worker threads.
+ *
+ * @post is_running() != true
+ */
+void ECA_ENGINE_WORKERS::stop(void)
+{
+  if (workers_rep.size() == 0)
+    return;
+
+  exit_request_rep.set(1);
+  for(size_t n = 0; n < workers_rep.size(); n++) {
+    sem_post(&start_sem_rep);
+  }
+  for(size_t n = 0; n < workers_rep.size(); n++) {
+    pthread_join(workers_rep[n], 0);
+  }
+  workers_rep.clear();
+
+  ECA_LOG_MSG(ECA_LOGGER::system_objects, "chain workers stopped");
+
+  // --
+  DBC_ENSURE(is_running() != true);
+  // --
+}
+
+/**
+ * Processes all chains once. Returns after all chains
+ * have been processed.
+ *
+ * context: J-level-2
+ *          realtime-safe, does not allocate memory
+ *          or take locks
+ */
+void ECA_ENGINE_WORKERS::process_chains(void)
+{
+  size_t workers = workers_rep.size();
+
+  next_chain_rep.set(0);
+
+  /* step: wake up the workers */
+  for(size_t n = 0; n < workers; n++) {
+    sem_post(&start_sem_rep);
+  }
+
+  /* step: participate in processing */
+  process_available_chains();
+
+  /* step: wait until all workers have completed */
+  for(size_t n = 0; n < workers; n++) {
+    priv_sem_wait(&done_sem_rep);
+  }
+}
+
+/**
+ * Processes chains until there are no more
+ * unclaimed chains left for this iteration.
+ */
+void ECA_ENGINE_WORKERS::process_available_chains(void)
+{
+  int chains = chains_repp->size();
+  int n;
+  while((n = next_chain_rep.add(1) - 1) < chains) {
+    (*chains_repp)[n]->process();
+  }
+}
+
+/**
+ * Main loop of the worker threads.
+ */
+void ECA_ENGINE_WORKERS::worker_thread(void)
+{
+  if (schedpriority_rep > 0) {
+    if (kvu_set_thread_scheduling(SCHED_FIFO, schedpriority_rep) != 0)
+      ECA_LOG_MSG(ECA_LOGGER::system_objects,
+		  "Unable to change scheduling policy for chain worker!");
+  }
+
+  while(true) {
+    priv_sem_wait(&start_sem_rep);
+    if (exit_request_rep.get() != 0)
+      break;
+    process_available_chains();
+    sem_post(&done_sem_rep);
+  }
+}
@@ -0,0 +1,108 @@
+// ------------------------------------------------------------------------
+// eca-engine-workers.h: Worker thread pool for parallel chain processing
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDED_ECA_ENGINE_WORKERS_H
+#define INCLUDED_ECA_ENGINE_WORKERS_H
+
+#include <vector>
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include <kvu_locks.h>
+
+class CHAIN;
+
+/**
+ * Pool of worker threads used by ECA_ENGINE to process
+ * chains concurrently.
+ *
+ * Chains are independent of each other during the
+ * process step of an engine iteration (each chain has
+ * its own buffer), so they can be run in any order
+ * and on any thread. The engine thread takes part in
+ * processing, so a pool of N threads creates N-1
+ * additional worker threads.
+ *
+ * The worker threads are created in start() and
+ * destroyed in stop(). process_chains() does not
+ * allocate memory nor take any locks. Workers are woken
+ * up with semaphores and chains are handed out with
+ * an atomic counter.
+ */
+class ECA_ENGINE_WORKERS {
+
+  friend void* start_engine_worker_thread(void *ptr);
+
+ public:
+
+  /** @name Constructors and dtors */
+  /*@{*/
+
+  ECA_ENGINE_WORKERS(void);
+  ~ECA_ENGINE_WORKERS(void);
+
+  /*@}*/
+
+  /** @name Public functions for transport control */
+  /*@{*/
+
+  void start(std::vector<CHAIN*>* chains, int threads, int schedpriority);
+  void stop(void);
+
+  /*@}*/
+
+  /** @name Public functions for processing */
+  /*@{*/
+
+  void process_chains(void);
+
+  /*@}*/
+
+  /** @name Public functions for acquiring status information */
+  /*@{*/
+
+  bool is_running(void) const { return workers_rep.size() > 0; }
+  int number_of_threads(void) const { return workers_rep.size() + 1; }
+
+  /*@}*/
+
+ private:
+
+  std::vector<CHAIN*>* chains_repp;
+  std::vector<pthread_t> workers_rep;
+
+  sem_t start_sem_rep;
+  sem_t done_sem_rep;
+
+  ATOMIC_INTEGER next_chain_rep;
+  ATOMIC_INTEGER exit_request_rep;
+
+  int schedpriority_rep;
+
+  void worker_thread(void);
+  void process_available_chains(void);
+
+  ECA_ENGINE_WORKERS& operator=(const ECA_ENGINE_WORKERS& x) { return *this; }
+  ECA_ENGINE_WORKERS(const ECA_ENGINE_WORKERS& x) { }
+};
+
+#endif /* INCLUDED_ECA_ENGINE_WORKERS_H */
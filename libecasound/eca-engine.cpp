@@ -39,6 +39,7 @@
 #include <kvu_procedure_timer.h>
 #include <kvu_rtcaps.h>
 #include <kvu_threads.h>
+#include <kvu_utils.h>
 
 #include "samplebuffer.h"
 #include "audioio.h"
@@ -242,6 +243,12 @@ ECA_ENGINE::~ECA_ENGINE(void)
     delete cslots_rep[n];
   }
 
+  /* note: deleted after 'cslots_rep' as chain slots may 
+   *       share data with the input slots */
+  for(size_t n = 0; n < islots_rep.size(); n++) {
+    delete islots_rep[n];
+  }
+
   delete mixslot_repp;
   delete impl_repp;
 
@@ -337,7 +344,7 @@ void ECA_ENGINE::command(Engine_command_t cmd, double arg)
   ECA_ENGINE::complex_command_t item;
   item.type = cmd;
   item.m.legacy.value = arg;
-  impl_repp->command_queue_rep.push_back(item);
+  command(item);
 }
 
 /**
@@ -345,14 +352,19 @@ void ECA_ENGINE::command(Engine_command_t cmd, double arg)
  * processed in the server's main loop. Passing a complex
  * command allows to address objects regardless of
  * the state of ECA_CHAINSETUP iterators (i.e. currently
- * selected objects).
+ * selected objects). If the queue is full, waits until
+ * the engine has processed commands.
  *
  * context: C-level-0
  *          must no be called from exec() context
  */
 void ECA_ENGINE::command(complex_command_t ccmd)
 {
-  impl_repp->command_queue_rep.push_back(ccmd);
+  while(impl_repp->command_queue_rep.push_back(ccmd) != true) {
+    /* note: queue is full, wait for the engine to 
+     *       process commands (1ms) */
+    kvu_sleep(0, 1000000);
+  }
 }
 
 /**
@@ -486,7 +498,9 @@ ECA_ENGINE::Engine_status_t ECA_ENGINE::status(void) const
 /**
  * Processes available new commands. If no
  * messages are available, function will return
- * immediately without blocking.
+ * immediately without blocking. The command queue
+ * is lock-free, so commands sent by the control
+ * thread are never delayed to the next iteration.
  *
  * context: E-level-1
  *          can be run at the same time as engine_iteration(); 
@@ -495,82 +509,153 @@ ECA_ENGINE::Engine_status_t ECA_ENGINE::status(void) const
  */
 void ECA_ENGINE::check_command_queue(void)
 {
-  while(impl_repp->command_queue_rep.is_empty() != true) {
-    ECA_ENGINE::complex_command_t item;
-    int popres = impl_repp->command_queue_rep.pop_front(&item);
-
-    if (popres <= 0) {
-      /* queue is empty or temporarily unavailable, unable to continue 
-       * processing messages without blocking */
-      break;
+  ECA_ENGINE::complex_command_t* itemp;
+  while((itemp = impl_repp->command_queue_rep.front()) != 0) {
+    /* note: command is accessed in place and removed from the
+     *       queue once processed, so no copies are made */
+    if (itemp->type == ep_exit) {
+      // FIXME: is clear the right thing or should remaining cmds
+      //        be still processed? OTOH, client app should know...
+      impl_repp->command_queue_rep.clear();
+      ECA_LOG_MSG(ECA_LOGGER::system_objects,"ecasound_queue: exit!");
+      driver_repp->exit();
+      return;
     }
 
-    switch(item.type) 
+    execute_command(*itemp);
+    impl_repp->command_queue_rep.pop_front(0);
+  }
+}
+
+/**
+ * Returns the next command in the queue without removing 
+ * it, or 0 if the queue is empty. The command stays valid 
+ * until pop_command() is called.
+ *
+ * Drivers that need to dispatch commands themselves 
+ * use this instead of check_command_queue().
+ *
+ * context: E-level-1
+ *          must be called from the same thread 
+ *          as check_command_queue()
+ */
+ECA_ENGINE::complex_command_t* ECA_ENGINE::front_command(void)
+{
+  return impl_repp->command_queue_rep.front();
+}
+
+/**
+ * Removes the next command from the queue.
+ *
+ * context: E-level-1
+ *          must be called from the same thread 
+ *          as check_command_queue()
+ *
+ * @see front_command()
+ */
+void ECA_ENGINE::pop_command(void)
+{
+  impl_repp->command_queue_rep.pop_front(0);
+}
+
+/**
+ * Executes command 'item'.
+ *
+ * context: E-level-1
+ *          must not be run at the same 
+ *          time as engine_iteration(); commands
+ *          for which is_realtime_command() is true
+ *          can be executed from the driver's 
+ *          realtime context
+ */
+void ECA_ENGINE::execute_command(const complex_command_t& item)
+{
+  switch(item.type) 
+    {
+      // ---
+      // Basic commands.
+      // ---            
+    case ep_exit:
       {
-        // ---
-        // Basic commands.
-        // ---            
-      case ep_exit:
-        {
-          // FIXME: is clear the right thing or should remaining cmds
-          //        be still processed? OTOH, client app should know...
-          impl_repp->command_queue_rep.clear();
-          ECA_LOG_MSG(ECA_LOGGER::system_objects,"ecasound_queue: exit!");
-          driver_repp->exit();
-          return;
-        }
+        ECA_LOG_MSG(ECA_LOGGER::system_objects,"ecasound_queue: exit!");
+        driver_repp->exit();
+        break;
+      }
 
-        // ---
-        // Chain operators (stateless addressing)
-        // ---
-      case ep_exec_edit:
-        {
-          csetup_repp->execute_edit(item.cs);
-          if (item.cs.need_chain_reinit) {
-            reinit_chains(true);
-          }
-          break;
-        }
-      case ep_prepare:
-        {
-          if (is_prepared() != true)
-            prepare_operation();
-          break;
-        }
-      case ep_start:
-        {
-          if (status() != engine_status_running)
-            request_start();
-          break;
-        }
-      case ep_stop:
-        {
-          if (status() == engine_status_running ||
-              status() == engine_status_finished) request_stop(false);
-          break;
-        }
-      case ep_stop_with_drain:
-        {
-          if (status() == engine_status_running ||
-              status() == engine_status_finished)
-            request_stop(true);
-          break;
+      // ---
+      // Chain operators (stateless addressing)
+      // ---
+    case ep_exec_edit:
+      {
+        csetup_repp->execute_edit(item.cs);
+        if (item.cs.need_chain_reinit) {
+          reinit_chains(true);
         }
+        break;
+      }
+    case ep_prepare:
+      {
+        if (is_prepared() != true)
+          prepare_operation();
+        break;
+      }
+    case ep_start:
+      {
+        if (status() != engine_status_running)
+          request_start();
+        break;
+      }
+    case ep_stop:
+      {
+        if (status() == engine_status_running ||
+            status() == engine_status_finished) request_stop(false);
+        break;
+      }
+    case ep_stop_with_drain:
+      {
+        if (status() == engine_status_running ||
+            status() == engine_status_finished)
+          request_stop(true);
+        break;
+      }
 
-        // ---
-        // Global position
-        // ---
-      case ep_rewind: { change_position(- item.m.legacy.value); break; }
-      case ep_forward: { change_position(item.m.legacy.value); break; }
-      case ep_setpos: { set_position(item.m.legacy.value); break; }
-      case ep_setpos_samples: { set_position_samples(static_cast<SAMPLE_SPECS::sample_pos_t>(item.m.legacy.value)); break; }
-      case ep_setpos_live_samples: { set_position_samples_live(static_cast<SAMPLE_SPECS::sample_pos_t>(item.m.legacy.value)); break; }
+      // ---
+      // Global position
+      // ---
+    case ep_rewind: { change_position(- item.m.legacy.value); break; }
+    case ep_forward: { change_position(item.m.legacy.value); break; }
+    case ep_setpos: { set_position(item.m.legacy.value); break; }
+    case ep_setpos_samples: { set_position_samples(static_cast<SAMPLE_SPECS::sample_pos_t>(item.m.legacy.value)); break; }
+    case ep_setpos_live_samples: { set_position_samples_live(static_cast<SAMPLE_SPECS::sample_pos_t>(item.m.legacy.value)); break; }
 
-      case ep_debug: break;
+    case ep_debug: break;
 
-      } /* switch */
-    
-  }
+    } /* switch */
+}
+
+/**
+ * Whether command 'item' can be executed without 
+ * allocating memory or changing the engine state, i.e.
+ * from within a realtime callback. This is the case 
+ * for chainsetup edits for which 
+ * ECA_CHAINSETUP::is_realtime_edit() is true, for example
+ * bypassing chains and changing parameters of simple 
+ * chain operators.
+ *
+ * context: E-level-1
+ *          must not be run at the same time
+ *          with commands that modify the chainsetup
+ */
+bool ECA_ENGINE::is_realtime_command(const complex_command_t& item) const
+{
+  if (item.type == ep_exec_edit &&
+      csetup_repp->is_realtime_edit(item.cs) == true)
+    return true;
+
+  if (item.type == ep_debug)
+    return true;
+
+  return false;
 }
 
 /**
@@ -605,6 +690,10 @@ void ECA_ENGINE::init_engine_state(void)
   for(size_t n = 0; n < cslots_rep.size(); n++) {
     cslots_rep[n]->event_tag_set(SAMPLE_BUFFER::tag_end_of_stream, false);
   }
+  for(size_t n = 0; n < islots_rep.size(); n++) {
+    if (islots_rep[n] != 0)
+      islots_rep[n]->event_tag_set(SAMPLE_BUFFER::tag_end_of_stream, false);
+  }
 }
 
 /**
@@ -733,9 +822,17 @@ void ECA_ENGINE::prepare_operation(void)
   /* 1. acquire rt-lock for chainsetup and samplebuffers */
   csetup_repp->toggle_locked_state(true);
 
+  /* note: must be done before chains are reinitialized, as 
+   *       audio data of the samplebuffers may be moved */
+  init_buffer_pool();
+
   for(size_t n = 0; n < cslots_rep.size(); n++) {
     cslots_rep[n]->set_rt_lock(true);
   }
+  for(size_t n = 0; n < islots_rep.size(); n++) {
+    if (islots_rep[n] != 0)
+      islots_rep[n]->set_rt_lock(true);
+  }
   mixslot_repp->set_rt_lock(true);
 
   /* 2. reinitialize chains if necessary */
@@ -748,6 +845,10 @@ void ECA_ENGINE::prepare_operation(void)
   /* 4. prepare rt objects */
   prepare_realtime_objects();
 
+  /* 5. start chain worker threads and pipeline threads */
+  start_workers();
+  start_pipeline();
+
   /* ... initial offset is needed because preroll is 
    * incremented only after checking whether we are 
    * still in preroll mode */
@@ -834,6 +935,9 @@ void ECA_ENGINE::stop_operation(bool drain)
 
   ECA_LOG_MSG(ECA_LOGGER::system_objects, "stopping engine operation!");
 
+  /* note: writes all processed data to outputs */
+  stop_pipeline();
+
   /* stop realtime devices */
   for (unsigned int adev_sizet = 0; adev_sizet != realtime_objects_rep.size(); adev_sizet++) {
     if (realtime_objects_rep[adev_sizet]->is_running() == true)
@@ -842,10 +946,16 @@ void ECA_ENGINE::stop_operation(bool drain)
 
   prepared_rep = false;
 
+  stop_workers();
+
   /* release samplebuffer rt-locks */
   for(size_t n = 0; n < cslots_rep.size(); n++) {
     cslots_rep[n]->set_rt_lock(false);
   }
+  for(size_t n = 0; n < islots_rep.size(); n++) {
+    if (islots_rep[n] != 0)
+      islots_rep[n]->set_rt_lock(false);
+  }
   mixslot_repp->set_rt_lock(false);
 
   stop_servers();
@@ -1085,6 +1195,137 @@ static void priv_toggle_forked_objects(bool start, std::vector<AUDIO_IO*>* vec)
   }
 }
 
+/**
+ * Starts the worker threads used for parallel chain
+ * processing (see '-z:threads').
+ */
+void ECA_ENGINE::start_workers(void)
+{
+  int threads = csetup_repp->chain_threads();
+  if (threads == 0) {
+    /* note: auto-mode, one thread per online CPU */
+    threads = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+  }
+
+  if (threads > 1 && chains_repp->size() > 1) {
+    int prio = 0;
+    if (csetup_repp->raised_priority() == true)
+      prio = csetup_repp->get_sched_priority();
+    impl_repp->workers_rep.start(chains_repp, threads, prio);
+  }
+}
+
+void ECA_ENGINE::stop_workers(void)
+{
+  impl_repp->workers_rep.stop();
+}
+
+/**
+ * Starts the reader and writer threads used for
+ * pipelined batch processing (see '-z:pipeline').
+ *
+ * The pipeline is only used in batch mode, and only
+ * if the chainsetup has no realtime objects, no loop
+ * devices, and looping is disabled.
+ */
+void ECA_ENGINE::start_pipeline(void)
+{
+  int frames = csetup_repp->pipeline_frames();
+  if (frames < 2 || batch_mode() != true)
+    return;
+
+  bool loops = false;
+  for(size_t n = 0; n < output_is_loop_rep.size(); n++) {
+    if (output_is_loop_rep[n] == true)
+      loops = true;
+  }
+
+  if (realtime_objects_rep.size() > 0 ||
+      loops == true ||
+      csetup_repp->looping_enabled() == true) {
+    ECA_LOG_MSG(ECA_LOGGER::info,
+		"NOTE: Pipelined processing disabled, only supported "
+		"with non-realtime objects and without looping.");
+    return;
+  }
+
+  SAMPLE_SPECS::sample_pos_t max_length = -1;
+  if (csetup_repp->max_length_set() == true)
+    max_length = csetup_repp->max_length_in_samples();
+
+  impl_repp->pipeline_rep.start(inputs_repp,
+				outputs_repp,
+				buffersize(),
+				csetup_repp->position_in_samples(),
+				max_length,
+				frames);
+}
+
+void ECA_ENGINE::stop_pipeline(void)
+{
+  if (impl_repp->pipeline_rep.is_running() != true)
+    return;
+
+  impl_repp->pipeline_rep.stop();
+
+  /* note: chain slots may still share data of the 
+   *       pipeline's input frames */
+  for(size_t n = 0; n < cslots_rep.size(); n++) {
+    cslots_rep[n]->unshare_content();
+  }
+}
+
+/**
+ * Moves audio data of engine's samplebuffers to a 
+ * preallocated pool. Each block of the pool has room for
+ * the largest channel count used, so that channel count
+ * changes during processing do not allocate memory.
+ *
+ * Called only from prepare_operation().
+ */
+void ECA_ENGINE::init_buffer_pool(void)
+{
+  std::vector<SAMPLE_BUFFER*> sbufs (cslots_rep);
+  for(size_t n = 0; n < islots_rep.size(); n++) {
+    if (islots_rep[n] != 0)
+      sbufs.push_back(islots_rep[n]);
+  }
+  sbufs.push_back(mixslot_repp);
+
+  int channels = max_channels();
+  for(size_t n = 0; n < sbufs.size(); n++) {
+    if (sbufs[n]->number_of_channels() > channels)
+      channels = sbufs[n]->number_of_channels();
+  }
+
+  size_t block_size = 0;
+  for(size_t n = 0; n < sbufs.size(); n++) {
+    if (sbufs[n]->storage_size(channels) > block_size)
+      block_size = sbufs[n]->storage_size(channels);
+  }
+
+  SAMPLE_BUFFER_POOL* pool = &impl_repp->bufferpool_rep;
+  if (pool->number_of_blocks() < sbufs.size() ||
+      pool->block_size() < block_size) {
+    /* note: all blocks must be returned before resizing */
+    for(size_t n = 0; n < sbufs.size(); n++) {
+      sbufs[n]->set_pool(0);
+    }
+    pool->reserve(sbufs.size(), block_size);
+
+    ECA_LOG_MSG(ECA_LOGGER::system_objects,
+		"Samplebuffer pool: " +
+		kvu_numtostr(pool->number_of_blocks()) +
+		" blocks of " +
+		kvu_numtostr(pool->block_size()) +
+		" bytes.");
+  }
+
+  for(size_t n = 0; n < sbufs.size(); n++) {
+    sbufs[n]->set_pool(pool);
+  }
+}
+
 void ECA_ENGINE::start_forked_objects(void)
 {
   priv_toggle_forked_objects(true, inputs_repp);
@@ -1266,6 +1507,12 @@ void ECA_ENGINE::change_position(double seconds)
 void ECA_ENGINE::prehandle_control_position(void)
 {
   csetup_repp->change_position_in_samples(buffersize());
+
+  /* note: when pipelined, the reader thread sets the 
+   *       input buffersize (see ECA_ENGINE_PIPELINE) */
+  if (impl_repp->pipeline_rep.is_running() == true)
+    return;
+
   if (csetup_repp->max_length_set() == true &&
       csetup_repp->is_over_max_length() == true) {
     int extra_tail = csetup_repp->position_in_samples() -
@@ -1449,20 +1696,78 @@ void ECA_ENGINE::cleanup(void)
 
 /**
  * Updates 'input_chain_count_rep' and
- * 'output_chain_count_rep'.
+ * 'output_chain_count_rep', and compiles the routing
+ * plan used by inputs_to_chains() and mix_to_outputs().
+ *
+ * With the plan, per-iteration routing cost depends
+ * only on the number of actual connections, not on 
+ * the number of inputs, outputs and chains.
  */
 void ECA_ENGINE::update_cache_chain_connections(void)
 {
-  input_chain_count_rep.resize(inputs_repp->size());
-  for(unsigned int n = 0; n < inputs_repp->size(); n++) {
-    input_chain_count_rep[n] =
-      csetup_repp->number_of_attached_chains_to_input(csetup_repp->inputs[n]);
+  size_t inputs = inputs_repp->size();
+  size_t outputs = outputs_repp->size();
+
+  input_chain_count_rep.assign(inputs, 0);
+  output_chain_count_rep.assign(outputs, 0);
+
+  /* step: count connections */
+  for(size_t c = 0; c < chains_repp->size(); c++) {
+    int in = (*chains_repp)[c]->connected_input();
+    int out = (*chains_repp)[c]->connected_output();
+    if (in >= 0 && in < static_cast<int>(inputs))
+      ++input_chain_count_rep[in];
+    if (out >= 0 && out < static_cast<int>(outputs))
+      ++output_chain_count_rep[out];
   }
-  
-  output_chain_count_rep.resize(outputs_repp->size());
-  for(unsigned int n = 0; n < outputs_repp->size(); n++) {
-    output_chain_count_rep[n] =
-      csetup_repp->number_of_attached_chains_to_output(csetup_repp->outputs[n]);
+
+  /* step: compute table offsets */
+  input_route_begin_rep.resize(inputs + 1);
+  input_route_begin_rep[0] = 0;
+  for(size_t n = 0; n < inputs; n++) {
+    input_route_begin_rep[n + 1] = input_route_begin_rep[n] + input_chain_count_rep[n];
+  }
+  output_route_begin_rep.resize(outputs + 1);
+  output_route_begin_rep[0] = 0;
+  for(size_t n = 0; n < outputs; n++) {
+    output_route_begin_rep[n + 1] = output_route_begin_rep[n] + output_chain_count_rep[n];
+  }
+
+  /* step: fill the tables, chains are stored in chainsetup order */
+  input_route_chains_rep.resize(input_route_begin_rep[inputs]);
+  output_route_chains_rep.resize(output_route_begin_rep[outputs]);
+  vector<int> in_fill (input_route_begin_rep.begin(), input_route_begin_rep.end() - 1);
+  vector<int> out_fill (output_route_begin_rep.begin(), output_route_begin_rep.end() - 1);
+  for(size_t c = 0; c < chains_repp->size(); c++) {
+    int in = (*chains_repp)[c]->connected_input();
+    int out = (*chains_repp)[c]->connected_output();
+    if (in >= 0 && in < static_cast<int>(inputs))
+      input_route_chains_rep[in_fill[in]++] = c;
+    if (out >= 0 && out < static_cast<int>(outputs))
+      output_route_chains_rep[out_fill[out]++] = c;
+  }
+
+  /* step: cache per-output attributes */
+  output_is_loop_rep.resize(outputs);
+  output_is_rt_target_rep.resize(outputs);
+  for(size_t n = 0; n < outputs; n++) {
+    output_is_loop_rep[n] = 
+      (dynamic_cast<LOOP_DEVICE*>((*outputs_repp)[n]) != 0);
+    output_is_rt_target_rep[n] = 
+      csetup_repp->is_realtime_target_output(n);
+  }
+
+  /* step: allocate slots for inputs connected to multiple
+   *       chains; chains share the slot contents */
+  for(size_t n = 0; n < islots_rep.size(); n++) {
+    delete islots_rep[n];
+  }
+  islots_rep.assign(inputs, 0);
+  for(size_t n = 0; n < inputs; n++) {
+    if (input_chain_count_rep[n] > 1) {
+      islots_rep[n] = new SAMPLE_BUFFER(buffersize(), max_channels());
+      islots_rep[n]->event_tag_set(SAMPLE_BUFFER::tag_var_length, false);
+    }
   }
 }
 
@@ -1636,52 +1941,72 @@ void ECA_ENGINE::inputs_to_chains(void)
    *   directly to a per-chain slot
    */
 
+  if (impl_repp->pipeline_rep.is_running() == true) {
+    /* note: inputs were read by the pipeline reader thread, so
+     *       just share the data with all connected chains */
+    inputs_not_finished_rep = impl_repp->pipeline_rep.acquire_inputs();
+    for(size_t inputnum = 0; inputnum < inputs_repp->size(); inputnum++) {
+      const SAMPLE_BUFFER* ibuf = impl_repp->pipeline_rep.input_buffer(inputnum);
+      for(int m = input_route_begin_rep[inputnum]; m < input_route_begin_rep[inputnum + 1]; m++) {
+        cslots_rep[input_route_chains_rep[m]]->share_content(*ibuf);
+      }
+    }
+    /* note: chain slots no longer share data of the previous 
+     *       frame, so it can be returned to the reader */
+    impl_repp->pipeline_rep.release_inputs();
+    return;
+  }
+
   for(size_t inputnum = 0; inputnum < inputs_repp->size(); inputnum++) {
+    int begin = input_route_begin_rep[inputnum];
+    int end = input_route_begin_rep[inputnum + 1];
+    AUDIO_IO* input = (*inputs_repp)[inputnum];
+
+    if (end - begin == 1) {
+      /* case-1: read buffer from input 'inputnum' to chain 'c' */
+      SAMPLE_BUFFER* cslot = cslots_rep[input_route_chains_rep[begin]];
+      cslot->length_in_samples(buffersize());
+
+      if (input->finished() != true) {
+        input->read_buffer(cslot);
+        if (input->finished() != true) {
+          inputs_not_finished_rep++;
+        }
+      }
+      else {
+        /* note: no more input data for this change (1:1 input-chain case) */
+        cslot->make_empty();
+      }
 
-    if (input_chain_count_rep[inputnum] > 1) {
-      /* case-1a: read buffer from input 'inputnum' to 'mixslot';
-       *          later (1b) the data is copied to each per-chain slow
+      /* note: lets chains skip processing of silent input */
+      cslot->event_tag_set(SAMPLE_BUFFER::tag_silent, cslot->is_silent());
+    }
+    else if (end - begin > 1) {
+      /* case-2a: read buffer from input 'inputnum' to its input slot;
+       *          later (2b) the data is shared with each per-chain slot
        *          to which input is connected to */
+      SAMPLE_BUFFER* islot = islots_rep[inputnum];
 
-      mixslot_repp->length_in_samples(buffersize());
+      islot->length_in_samples(buffersize());
 
-      if ((*inputs_repp)[inputnum]->finished() != true) {
-        (*inputs_repp)[inputnum]->read_buffer(mixslot_repp);
-        if ((*inputs_repp)[inputnum]->finished() != true) {
+      if (input->finished() != true) {
+        input->read_buffer(islot);
+        if (input->finished() != true) {
           inputs_not_finished_rep++;
         }
       }
       else {
         /* note: no more input data for this change (N:1 input-chain case) */
-        mixslot_repp->make_empty();
+        islot->make_empty();
       }
-    }
-    for (size_t c = 0; c != chains_repp->size(); c++) {
-      if ((*chains_repp)[c]->connected_input() == static_cast<int>(inputnum)) {
-        if (input_chain_count_rep[inputnum] == 1) {
-          /* case-2: read buffer from input 'inputnum' to chain 'c' */
-          cslots_rep[c]->length_in_samples(buffersize());
-
-          if ((*inputs_repp)[inputnum]->finished() != true) {
-            (*inputs_repp)[inputnum]->read_buffer(cslots_rep[c]);
-            if ((*inputs_repp)[inputnum]->finished() != true) {
-              inputs_not_finished_rep++;
-            }
-          }
-          else {
-            /* note: no more input data for this change (1:1 input-chain case) */
-            cslots_rep[c]->make_empty();
-          }
 
-          /* note: input connected to only one chain, so no need to
-             iterate through the other chains */
-          break; 
-        }
-        else {
-          /* case-1b: input connected to chain 'n', copy 'mixslot' to 
-           *          the matching per-chain slot */
-          cslots_rep[c]->copy_all_content(*mixslot_repp);
-        }
+      islot->event_tag_set(SAMPLE_BUFFER::tag_silent, islot->is_silent());
+
+      /* case-2b: share input slot contents with the connected 
+       *          per-chain slots; data is copied only for chains 
+       *          that modify it (copy-on-write) */
+      for(int m = begin; m < end; m++) {
+        cslots_rep[input_route_chains_rep[m]]->share_content(*islot);
       }
     }
   }
@@ -1692,6 +2017,13 @@ void ECA_ENGINE::inputs_to_chains(void)
  */
 void ECA_ENGINE::process_chains(void)
 {
+  if (impl_repp->workers_rep.is_running() == true) {
+    /* note: chains are independent, so they can be processed
+     *       in parallel by the worker pool */
+    impl_repp->workers_rep.process_chains();
+    return;
+  }
+
   vector<CHAIN*>::const_iterator p = chains_repp->begin();
   while(p != chains_repp->end()) {
     (*p)->process();
@@ -1709,6 +2041,11 @@ void mix_to_outputs_divide_helper(const SAMPLE_BUFFER *from, SAMPLE_BUFFER *to,
     to->copy_matching_channels(*from);
     to->divide_by(divide_by);
   }
+  else if (from->event_tag_test(SAMPLE_BUFFER::tag_silent) == true) {
+    /* note: adding silence only extends the length */
+    if (from->length_in_samples() > to->length_in_samples())
+      to->length_in_samples(from->length_in_samples());
+  }
   else {
     to->add_with_weight(*from, divide_by);
   }
@@ -1723,83 +2060,98 @@ void mix_to_outputs_sum_helper(const SAMPLE_BUFFER *from, SAMPLE_BUFFER *to, boo
     }
     to->copy_matching_channels(*from);
   }
+  else if (from->event_tag_test(SAMPLE_BUFFER::tag_silent) == true) {
+    /* note: adding silence only extends the length */
+    if (from->length_in_samples() > to->length_in_samples())
+      to->length_in_samples(from->length_in_samples());
+  }
   else {
     to->add_matching_channels(*from);
   }
 }
 
 /**
+ * Writes the output of a chain, or a mix of multiple chains,
+ * to output objects.
+ *
  * context: J-level-1
  */
 void ECA_ENGINE::mix_to_outputs(bool skip_realtime_target_outputs)
 {
+  ECA_ENGINE_PIPELINE* pipeline = 0;
+  if (impl_repp->pipeline_rep.is_running() == true) {
+    /* note: outputs are written by the pipeline writer thread */
+    pipeline = &impl_repp->pipeline_rep;
+    pipeline->acquire_outputs();
+  }
+
   for(size_t outputnum = 0; outputnum < outputs_repp->size(); outputnum++) {
-    if (skip_realtime_target_outputs == true) {
-      if (csetup_repp->is_realtime_target_output(outputnum) == true) {
-        ECA_LOG_MSG(ECA_LOGGER::system_objects,
-                    "Skipping rt-target output " +
-                    (*outputs_repp)[outputnum]->label() + ".");
-        continue;
-      }
+    if (skip_realtime_target_outputs == true &&
+        output_is_rt_target_rep[outputnum] == true) {
+      ECA_LOG_MSG(ECA_LOGGER::system_objects,
+                  "Skipping rt-target output " +
+                  (*outputs_repp)[outputnum]->label() + ".");
+      continue;
     }
 
-    int count = 0;
+    int begin = output_route_begin_rep[outputnum];
+    int end = output_route_begin_rep[outputnum + 1];
+    AUDIO_IO* output = (*outputs_repp)[outputnum];
 
-    /* FIXME: number_of_channels() may end up allocating memory! */
-    mixslot_repp->number_of_channels((*outputs_repp)[outputnum]->channels());
-    
-    for(size_t n = 0; n != chains_repp->size(); n++) {
+    if (end - begin == 0) {
+      /* note: no chains connected to this output */
+      continue;
+    }
+    else if (end - begin == 1) {
       // --
-      // if chain is already released, skip
+      // there's only one chain connected to this output,
+      // so we don't need to mix anything
       // --
-      if ((*chains_repp)[n]->connected_output() == -1) {
-        // --
-        // skip, if chain is not connected
-        // --
-        continue;
-      }
+      if (pipeline != 0)
+        pipeline->output_buffer(outputnum)->copy_all_content(*cslots_rep[output_route_chains_rep[begin]]);
+      else
+        output->write_buffer(cslots_rep[output_route_chains_rep[begin]]);
+    }
+    else {
+      /* note: does not allocate memory, as space for all
+       *       channels is reserved in init_buffer_pool() */
+      mixslot_repp->number_of_channels(output->channels());
 
-      if ((*chains_repp)[n]->connected_output() == static_cast<int>(outputnum)) {
-        // --
-        // output is connected to this chain
-        // --
-        if (output_chain_count_rep[outputnum] == 1) {
-          // --
-          // there's only one output connected to this chain,
-          // so we don't need to mix anything
-          // --
-          (*outputs_repp)[outputnum]->write_buffer(cslots_rep[n]);
-          if ((*outputs_repp)[outputnum]->finished() == true) 
-            /* note: loop devices always connected both as inputs as
-             *       outputs, so their finished status must not be
-             *       counted as an error (like for other output types) */
-            if (dynamic_cast<LOOP_DEVICE*>((*outputs_repp)[outputnum]) == 0)
-              outputs_finished_rep++;
-          break;
-        }
-        else {
-          ++count;
-
-          if (csetup_repp->mix_mode() == ECA_CHAINSETUP::cs_mmode_avg)
-            mix_to_outputs_divide_helper(cslots_rep[n], mixslot_repp, output_chain_count_rep[outputnum], (count == 1));
-          else
-            mix_to_outputs_sum_helper(cslots_rep[n], mixslot_repp, (count == 1));
-
-          mixslot_repp->event_tags_add(*cslots_rep[n]);
-
-          if (count == output_chain_count_rep[outputnum]) {
-            (*outputs_repp)[outputnum]->write_buffer(mixslot_repp);
-            if ((*outputs_repp)[outputnum]->finished() == true) 
-              /* note: loop devices always connected both as inputs as
-               *       outputs, so their finished status must not be
-               *       counted as an error (like for other output types) */
-              if (dynamic_cast<LOOP_DEVICE*>((*outputs_repp)[outputnum]) == 0)
-                outputs_finished_rep++;
-          }
-        }
+      for(int m = begin; m < end; m++) {
+        SAMPLE_BUFFER* cslot = cslots_rep[output_route_chains_rep[m]];
+
+        if (csetup_repp->mix_mode() == ECA_CHAINSETUP::cs_mmode_avg)
+          mix_to_outputs_divide_helper(cslot, mixslot_repp, end - begin, (m == begin));
+        else
+          mix_to_outputs_sum_helper(cslot, mixslot_repp, (m == begin));
+
+        /* note: the mix is silent only if all chains are */
+        bool silent = mixslot_repp->event_tag_test(SAMPLE_BUFFER::tag_silent);
+        mixslot_repp->event_tags_add(*cslot);
+        mixslot_repp->event_tag_set(SAMPLE_BUFFER::tag_silent, silent);
       }
+
+      if (pipeline != 0)
+        pipeline->output_buffer(outputnum)->copy_all_content(*mixslot_repp);
+      else
+        output->write_buffer(mixslot_repp);
     }
+
+    if (pipeline != 0)
+      continue;
+
+    /* note: loop devices always connected both as inputs as
+     *       outputs, so their finished status must not be
+     *       counted as an error (like for other output types) */
+    if (output->finished() == true &&
+        output_is_loop_rep[outputnum] != true)
+      outputs_finished_rep++;
   } 
+
+  if (pipeline != 0) {
+    pipeline->submit_outputs();
+    outputs_finished_rep = pipeline->outputs_finished();
+  }
 }
 
 /**********************************************************************
@@ -152,6 +152,10 @@ class ECA_ENGINE {
 
   void check_command_queue(void);
   void wait_for_commands(void);
+  complex_command_t* front_command(void);
+  void pop_command(void);
+  void execute_command(const complex_command_t& item);
+  bool is_realtime_command(const complex_command_t& item) const;
   void init_engine_state(void);
   void update_engine_state(void);
   void engine_iteration(void);
@@ -226,6 +230,7 @@ private:
 
   SAMPLE_BUFFER* mixslot_repp;
   std::vector<SAMPLE_BUFFER*> cslots_rep;
+  std::vector<SAMPLE_BUFFER*> islots_rep; /* for inputs connected to multiple chains */
 
   /*@}*/
 
@@ -254,6 +259,28 @@ private:
   std::vector<int> input_chain_count_rep;
   std::vector<int> output_chain_count_rep;
 
+  /*@}*/
+
+  /** 
+   * @name Routing plan
+   *
+   * Flat tables compiled in update_cache_chain_connections().
+   * Chains connected to input 'n' are stored in 
+   * 'input_route_chains_rep' at indices 
+   * [input_route_begin_rep[n], input_route_begin_rep[n+1]),
+   * and similarly for outputs.
+   */
+  /*@{*/
+
+  std::vector<int> input_route_begin_rep;
+  std::vector<int> input_route_chains_rep;
+  std::vector<int> output_route_begin_rep;
+  std::vector<int> output_route_chains_rep;
+  std::vector<bool> output_is_loop_rep;
+  std::vector<bool> output_is_rt_target_rep;
+
+  /*@}*/
+
   /** @name Attribute functions */
   /*@{*/
 
@@ -283,6 +310,13 @@ private:
   void start_forked_objects(void);
   void stop_forked_objects(void);
 
+  void start_workers(void);
+  void stop_workers(void);
+  void start_pipeline(void);
+  void stop_pipeline(void);
+
+  void init_buffer_pool(void);
+
   void state_change_to_finished(void);
 
   /*@}*/
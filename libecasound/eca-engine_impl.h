@@ -6,10 +6,13 @@
 #include <unistd.h>
 #include <sys/time.h>
 
-#include <kvu_message_queue.h>
+#include <kvu_spsc_queue.h>
 #include <kvu_procedure_timer.h>
 
 #include "eca-chainsetup.h"
+#include "eca-engine-workers.h"
+#include "eca-engine-pipeline.h"
+#include "samplebuffer_pool.h"
 
 /**
  * Private class used in ECA_ENGINE 
@@ -28,7 +31,11 @@ class ECA_ENGINE_impl {
   double looptimer_mid_rep;
   double looptimer_high_rep;
 
-  MESSAGE_QUEUE_RT_C<ECA_ENGINE::complex_command_t> command_queue_rep;
+  MPSC_QUEUE_RT_C<ECA_ENGINE::complex_command_t> command_queue_rep;
+
+  ECA_ENGINE_WORKERS workers_rep;
+  ECA_ENGINE_PIPELINE pipeline_rep;
+  SAMPLE_BUFFER_POOL bufferpool_rep;
 
   pthread_cond_t editlock_cond_repp;
   pthread_mutex_t editlock_mutex_repp;
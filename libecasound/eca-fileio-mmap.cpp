@@ -35,50 +35,72 @@
 #include "eca-fileio.h"
 #include "eca-fileio-mmap.h"
 
-ECA_FILE_IO_MMAP::ECA_FILE_IO_MMAP(void) { }
-ECA_FILE_IO_MMAP::~ECA_FILE_IO_MMAP(void) { }
+const off_t ECA_FILE_IO_MMAP::window_size = 4 * 1024 * 1024;
+
+ECA_FILE_IO_MMAP::ECA_FILE_IO_MMAP(void)
+  : fd_rep(-1),
+    mmapflags_rep(0),
+    buffer_repp(0),
+    window_start_rep(0),
+    window_length_rep(0),
+    prefetched_rep(false),
+    bytes_rep(0),
+    fposition_rep(0),
+    flength_rep(0),
+    file_ready_rep(false),
+    file_ended_rep(false)
+{ 
+}
+
+ECA_FILE_IO_MMAP::~ECA_FILE_IO_MMAP(void) 
+{ 
+  if (fd_rep >= 0) close_file();
+}
 
 void ECA_FILE_IO_MMAP::open_file(const std::string& fname, 
 				 const std::string& fmode)
 {
 #ifdef HAVE_MMAP
   int openflags = O_RDWR;
-  int mmapflags = PROT_READ | PROT_WRITE;
+  mmapflags_rep = PROT_READ | PROT_WRITE;
   fname_rep = fname;
   
   if (fmode == "rb") {
     openflags = O_RDONLY;
-    mmapflags = PROT_READ;
+    mmapflags_rep = PROT_READ;
   }
   else if (fmode == "wb") {
     openflags = O_WRONLY;
-    mmapflags = PROT_WRITE;
+    mmapflags_rep = PROT_WRITE;
   }
 
   fd_rep = ::open(fname.c_str(), openflags);
-  if (!fd_rep) {
+  if (fd_rep < 0) {
     file_ready_rep = false;
     mode_rep = "";
+    return;
   }
-  else {
-    file_ready_rep = true;
-    file_ended_rep = false;
-    mode_rep = fmode;
-    fposition_rep = 0;
-    flength_rep = get_file_length();
-//      cerr << fname_rep << ": mmaping region from 0 to " <<
-//        flength_rep << "." << endl;
-    buffer_repp = (caddr_t)::mmap(0,
-				  flength_rep,
-				  mmapflags,
-				  MAP_SHARED,
-				  fd_rep,
-				  0);
-    
-    if (buffer_repp == MAP_FAILED) {
-      file_ready_rep = false;
-      mode_rep = "";
-    }
+
+  struct stat stattemp;
+  if (fstat(fd_rep, &stattemp) != 0 ||
+      S_ISREG(stattemp.st_mode) == 0) {
+    /* note: only regular files can be mapped */
+    ::close(fd_rep);
+    fd_rep = -1;
+    file_ready_rep = false;
+    mode_rep = "";
+    return;
+  }
+
+  file_ready_rep = true;
+  file_ended_rep = false;
+  mode_rep = fmode;
+  fposition_rep = 0;
+  flength_rep = stattemp.st_size;
+
+  if (map_window(0) != true) {
+    close_file();
+    file_ready_rep = false;
   }
 #else /* HAVE_MMAP */
   file_ready_rep = false;
@@ -87,13 +109,124 @@ void ECA_FILE_IO_MMAP::open_file(const std::string& fname,
 }
 
 void ECA_FILE_IO_MMAP::close_file(void) {
-//    cerr << fname_rep << ": munmaping region." << endl;
 #ifdef HAVE_MMAP
-  ::munmap(buffer_repp, flength_rep);
-  ::close(fd_rep);
+  unmap_window();
+  if (fd_rep >= 0) ::close(fd_rep);
+  fd_rep = -1;
+  mode_rep = "";
 #endif
 }
 
+/**
+ * Maps the window containing file position 'pos'.
+ *
+ * @return false if mapping failed
+ */
+bool ECA_FILE_IO_MMAP::map_window(off_t pos)
+{
+#ifdef HAVE_MMAP
+  unmap_window();
+
+  off_t pagesize = ::sysconf(_SC_PAGESIZE);
+  off_t start = pos - (pos % pagesize);
+  off_t length = window_size;
+  if (start + length > flength_rep) length = flength_rep - start;
+  if (length <= 0) return false;
+
+  caddr_t ptr = (caddr_t)::mmap(0,
+				length,
+				mmapflags_rep,
+				MAP_SHARED,
+				fd_rep,
+				start);
+  if (ptr == MAP_FAILED) return false;
+
+#ifdef MADV_SEQUENTIAL
+  ::madvise(ptr, length, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_WILLNEED
+  ::madvise(ptr, length, MADV_WILLNEED);
+#endif
+
+  buffer_repp = ptr;
+  window_start_rep = start;
+  window_length_rep = length;
+  prefetched_rep = false;
+
+  return true;
+#else /* HAVE_MMAP */
+  return false;
+#endif
+}
+
+/**
+ * Unmaps the current window, if any.
+ */
+void ECA_FILE_IO_MMAP::unmap_window(void)
+{
+#ifdef HAVE_MMAP
+  if (buffer_repp != 0) {
+    ::munmap(buffer_repp, window_length_rep);
+    buffer_repp = 0;
+    window_length_rep = 0;
+  }
+#endif
+}
+
+/**
+ * Copies 'bytes' bytes between 'buf' and the file, starting
+ * from the current position, and mapping new windows as 
+ * needed.
+ */
+void ECA_FILE_IO_MMAP::copy_data(void* buf, off_t bytes, bool write)
+{
+  if (fposition_rep + bytes > flength_rep)
+    bytes = flength_rep - fposition_rep;
+
+  off_t pos = fposition_rep;
+  off_t done = 0;
+  while(done < bytes) {
+    if (buffer_repp == 0 ||
+	pos < window_start_rep ||
+	pos >= window_start_rep + window_length_rep) {
+      if (map_window(pos) != true) {
+	bytes_rep = done;
+	fposition_rep = pos;
+	file_ready_rep = false;
+	file_ended_rep = false;
+	return;
+      }
+    }
+
+    off_t offset = pos - window_start_rep;
+    off_t count = window_length_rep - offset;
+    if (count > bytes - done) count = bytes - done;
+
+    if (write == true)
+      std::memcpy(buffer_repp + offset, static_cast<char*>(buf) + done, count);
+    else
+      std::memcpy(static_cast<char*>(buf) + done, buffer_repp + offset, count);
+
+    done += count;
+    pos += count;
+  }
+
+#if defined(POSIX_FADV_WILLNEED) && defined(HAVE_MMAP)
+  /* note: start reading in the next window once half of
+   *       the current one has been used */
+  if (prefetched_rep != true &&
+      pos - window_start_rep > window_length_rep / 2) {
+    off_t next = window_start_rep + window_length_rep;
+    if (next < flength_rep)
+      ::posix_fadvise(fd_rep, next, window_size, POSIX_FADV_WILLNEED);
+    prefetched_rep = true;
+  }
+#endif
+
+  set_file_position(pos, false);
+  bytes_rep = done;
+}
+
 void ECA_FILE_IO_MMAP::read_to_buffer(void* obuf, off_t bytes) {
   if (is_file_ready() == false) {
     bytes_rep = 0;
@@ -101,14 +234,7 @@ void ECA_FILE_IO_MMAP::read_to_buffer(void* obuf, off_t bytes) {
     return;
   }
 
-  if (fposition_rep + bytes > flength_rep)
-    bytes = flength_rep - fposition_rep;
-
-//    cerr << fname_rep << ": mmap read " << fposition_rep << " -> ";
-  std::memcpy(obuf, buffer_repp + fposition_rep, bytes);
-//    cerr <<  fposition_rep + bytes << "." << endl;
-  set_file_position(fposition_rep + bytes, false);
-  bytes_rep = bytes;
+  copy_data(obuf, bytes, false);
 }
 
 void ECA_FILE_IO_MMAP::write_from_buffer(void* obuf, off_t bytes) { 
@@ -118,12 +244,7 @@ void ECA_FILE_IO_MMAP::write_from_buffer(void* obuf, off_t bytes) {
     return;
   }
   
-  if (fposition_rep + bytes > flength_rep)
-    bytes = flength_rep - fposition_rep;
-
-  std::memcpy(buffer_repp + fposition_rep, obuf, bytes);
-  set_file_position(fposition_rep + bytes, false);
-  bytes_rep = bytes;
+  copy_data(obuf, bytes, true);
 }
 
 off_t ECA_FILE_IO_MMAP::file_bytes_processed(void) const { return(bytes_rep); }
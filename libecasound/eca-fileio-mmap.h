@@ -16,11 +16,21 @@ typedef char* caddr_t;
 
 /**
  * File-io and buffering using mmap for data transfers.
+ *
+ * Instead of mapping the whole file, a window of 
+ * 'window_size' bytes around the current position is 
+ * mapped, so files of any size can be accessed. The 
+ * kernel is advised that windows are accessed sequentially,
+ * and the next window is prefetched once the position has
+ * passed the middle of the current one. Windows are 
+ * unmapped as soon as the position leaves them.
  */
 class ECA_FILE_IO_MMAP : public ECA_FILE_IO {
 
  public:
 
+  static const off_t window_size;
+
   ECA_FILE_IO_MMAP(void);
   virtual ~ECA_FILE_IO_MMAP(void);
 
@@ -57,8 +67,16 @@ class ECA_FILE_IO_MMAP : public ECA_FILE_IO {
 
  private:
 
+  bool map_window(off_t pos);
+  void unmap_window(void);
+  void copy_data(void* buf, off_t bytes, bool write);
+
   int fd_rep;
+  int mmapflags_rep;
   caddr_t buffer_repp;
+  off_t window_start_rep;
+  off_t window_length_rep;
+  bool prefetched_rep;
   off_t bytes_rep;
   off_t fposition_rep;
   off_t flength_rep;
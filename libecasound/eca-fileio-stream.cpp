@@ -26,6 +26,7 @@
 #include <cstring>
 #include <climits> /* LONG_MAX */
 #include <errno.h>
+#include <fcntl.h> /* fallocate() */
 #include <unistd.h> /* stat() */
 #include <sys/stat.h> /* stat() */
 #ifdef HAVE_SYS_TYPES_H
@@ -56,6 +57,7 @@ void ECA_FILE_IO_STREAM::open_file(const std::string& fname,
   }
   standard_mode = false;
   curpos_rep = 0;
+  prealloc_end_rep = 0;
 }
 
 void ECA_FILE_IO_STREAM::open_stdin(void) { 
@@ -83,7 +85,17 @@ void ECA_FILE_IO_STREAM::open_stderr(void)
 
 void ECA_FILE_IO_STREAM::close_file(void)
 {
-  if (standard_mode != true) std::fclose(f1);
+  if (standard_mode != true) {
+    if (prealloc_end_rep > 0) {
+      /* note: release space preallocated past the end of file */
+      struct stat temp;
+      std::fflush(f1);
+      if (::fstat(fileno(f1), &temp) == 0 &&
+	  prealloc_end_rep > temp.st_size)
+	::ftruncate(fileno(f1), temp.st_size);
+    }
+    std::fclose(f1);
+  }
   mode_rep = "";
 }
 
@@ -101,6 +113,7 @@ void ECA_FILE_IO_STREAM::read_to_buffer(void* obuf, off_t bytes)
 void ECA_FILE_IO_STREAM::write_from_buffer(void* obuf, off_t bytes)
 {
   if (is_file_ready() == true) {
+    if (prealloc_rep > 0) preallocate(curpos_rep + bytes);
     last_rep = std::fwrite(obuf, 1, bytes, f1);
     curpos_rep += last_rep;
   }
@@ -199,3 +212,33 @@ off_t ECA_FILE_IO_STREAM::get_file_length(void) const
 
   return(lentemp); 
 }
+
+void ECA_FILE_IO_STREAM::set_preallocation(off_t bytes)
+{
+  if (standard_mode != true) prealloc_rep = bytes;
+}
+
+/**
+ * Makes sure file space is allocated up to 'end'. Space is
+ * allocated in chunks of 'prealloc_rep' bytes, without changing
+ * the file length, so that long recordings are not fragmented
+ * and writes do not block on block allocation.
+ */
+void ECA_FILE_IO_STREAM::preallocate(off_t end)
+{
+  if (end <= prealloc_end_rep) return;
+
+#ifdef FALLOC_FL_KEEP_SIZE
+  off_t newend = (end / prealloc_rep + 1) * prealloc_rep;
+  if (::fallocate(fileno(f1), FALLOC_FL_KEEP_SIZE, 
+		  prealloc_end_rep, newend - prealloc_end_rep) == 0) {
+    prealloc_end_rep = newend;
+    return;
+  }
+  ECA_LOG_MSG(ECA_LOGGER::user_objects, 
+	      "(eca-fileio-stream) unable to preallocate space for \"" + 
+	      fname_rep + "\": " + std::string(std::strerror(errno)));
+#endif
+
+  prealloc_rep = 0;
+}
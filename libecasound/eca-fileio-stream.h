@@ -13,7 +13,7 @@ class ECA_FILE_IO_STREAM : public ECA_FILE_IO {
 
  public:
 
-  ECA_FILE_IO_STREAM (void) { }
+  ECA_FILE_IO_STREAM (void) : prealloc_rep(0), prealloc_end_rep(0) { }
   virtual ~ECA_FILE_IO_STREAM(void);
 
   // --
@@ -36,6 +36,7 @@ class ECA_FILE_IO_STREAM : public ECA_FILE_IO {
   virtual void set_file_position_end(void);
   virtual off_t get_file_position(void) const;
   virtual off_t get_file_length(void) const;
+  virtual void set_preallocation(off_t bytes);
 
   // --
   // Status
@@ -47,9 +48,13 @@ class ECA_FILE_IO_STREAM : public ECA_FILE_IO {
 
  private:
 
+  void preallocate(off_t end);
+
   FILE *f1;
   off_t curpos_rep;
   off_t last_rep;
+  off_t prealloc_rep;
+  off_t prealloc_end_rep;
 
   std::string mode_rep;
   std::string fname_rep;
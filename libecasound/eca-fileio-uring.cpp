@@ -0,0 +1,618 @@
+// ------------------------------------------------------------------------
+// eca-fileio-uring.cpp: File-I/O using Linux io_uring for data
+//                       transfers.
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <cstring> /* memcpy(), memset() */
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h> /* pread(), pwrite() */
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h> /* struct iovec */
+
+#if defined(HAVE_LINUX_IO_URING_H) && defined(HAVE_SYS_MMAN_H)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define ECA_FILE_IO_URING_ENABLED
+#endif
+#endif
+
+#include <kvu_dbc.h>
+
+#include "eca-logger.h"
+#include "eca-fileio.h"
+#include "eca-fileio-uring.h"
+
+const int ECA_FILE_IO_URING::block_count = 4;
+const long int ECA_FILE_IO_URING::block_size = 65536;
+
+#ifdef ECA_FILE_IO_URING_ENABLED
+
+/**
+ * Submission and completion queues of one io_uring
+ * instance, mapped from the kernel.
+ */
+class ECA_FILE_IO_URING_ring {
+
+ public:
+
+  ECA_FILE_IO_URING_ring(void);
+  ~ECA_FILE_IO_URING_ring(void);
+
+  bool init(unsigned int entries);
+  bool queue(int fd, bool write, void* data, long int bytes, off_t offset, int user_data);
+  int enter(unsigned int min_complete);
+  bool reap(int* user_data, long int* result);
+
+ private:
+
+  int fd_rep;
+  unsigned int to_submit_rep;
+
+  unsigned int* sq_head_repp;
+  unsigned int* sq_tail_repp;
+  unsigned int* sq_mask_repp;
+  unsigned int* sq_entries_repp;
+  unsigned int* sq_array_repp;
+  struct io_uring_sqe* sqes_repp;
+
+  unsigned int* cq_head_repp;
+  unsigned int* cq_tail_repp;
+  unsigned int* cq_mask_repp;
+  struct io_uring_cqe* cqes_repp;
+
+  void* sq_ptr_repp;
+  size_t sq_size_rep;
+  void* cq_ptr_repp;
+  size_t cq_size_rep;
+  size_t sqes_size_rep;
+
+  std::vector<struct iovec> iovecs_rep;
+};
+
+ECA_FILE_IO_URING_ring::ECA_FILE_IO_URING_ring(void)
+  : fd_rep(-1),
+    to_submit_rep(0),
+    sqes_repp(0),
+    sq_ptr_repp(MAP_FAILED),
+    sq_size_rep(0),
+    cq_ptr_repp(MAP_FAILED),
+    cq_size_rep(0),
+    sqes_size_rep(0)
+{
+}
+
+ECA_FILE_IO_URING_ring::~ECA_FILE_IO_URING_ring(void)
+{
+  if (sqes_repp != 0)
+    ::munmap(sqes_repp, sqes_size_rep);
+  if (cq_ptr_repp != MAP_FAILED && cq_ptr_repp != sq_ptr_repp)
+    ::munmap(cq_ptr_repp, cq_size_rep);
+  if (sq_ptr_repp != MAP_FAILED)
+    ::munmap(sq_ptr_repp, sq_size_rep);
+  if (fd_rep >= 0)
+    ::close(fd_rep);
+}
+
+/**
+ * Sets up the ring with room for 'entries' requests.
+ *
+ * @return false if io_uring is not supported
+ */
+bool ECA_FILE_IO_URING_ring::init(unsigned int entries)
+{
+  struct io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+
+  fd_rep = ::syscall(__NR_io_uring_setup, entries, &params);
+  if (fd_rep < 0) return false;
+
+  sq_size_rep = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+  cq_size_rep = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+  bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+  if (params.features & IORING_FEAT_SINGLE_MMAP) {
+    single_mmap = true;
+    if (cq_size_rep > sq_size_rep) sq_size_rep = cq_size_rep;
+    cq_size_rep = sq_size_rep;
+  }
+#endif
+
+  sq_ptr_repp = ::mmap(0, sq_size_rep, PROT_READ | PROT_WRITE,
+		       MAP_SHARED | MAP_POPULATE, fd_rep, IORING_OFF_SQ_RING);
+  if (sq_ptr_repp == MAP_FAILED) return false;
+
+  if (single_mmap == true) {
+    cq_ptr_repp = sq_ptr_repp;
+  }
+  else {
+    cq_ptr_repp = ::mmap(0, cq_size_rep, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_POPULATE, fd_rep, IORING_OFF_CQ_RING);
+    if (cq_ptr_repp == MAP_FAILED) return false;
+  }
+
+  sqes_size_rep = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes = ::mmap(0, sqes_size_rep, PROT_READ | PROT_WRITE,
+		      MAP_SHARED | MAP_POPULATE, fd_rep, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) return false;
+  sqes_repp = static_cast<struct io_uring_sqe*>(sqes);
+
+  char* sq = static_cast<char*>(sq_ptr_repp);
+  sq_head_repp = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+  sq_tail_repp = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+  sq_mask_repp = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+  sq_entries_repp = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_entries);
+  sq_array_repp = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+
+  char* cq = static_cast<char*>(cq_ptr_repp);
+  cq_head_repp = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+  cq_tail_repp = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+  cq_mask_repp = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+  cqes_repp = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  iovecs_rep.resize(entries);
+
+  return true;
+}
+
+/**
+ * Queues a read or write request. The request is passed
+ * to the kernel on the next call to enter().
+ *
+ * @return false if the submission queue is full
+ */
+bool ECA_FILE_IO_URING_ring::queue(int fd, bool write, void* data, long int bytes, off_t offset, int user_data)
+{
+  DBC_CHECK(user_data >= 0 && user_data < static_cast<int>(iovecs_rep.size()));
+
+  unsigned int tail = *sq_tail_repp;
+  unsigned int head = *const_cast<volatile unsigned int*>(sq_head_repp);
+  __sync_synchronize();
+  if (tail - head >= *sq_entries_repp) return false;
+
+  unsigned int index = tail & *sq_mask_repp;
+  struct io_uring_sqe* sqe = &sqes_repp[index];
+
+  iovecs_rep[user_data].iov_base = data;
+  iovecs_rep[user_data].iov_len = bytes;
+
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = (write == true) ? IORING_OP_WRITEV : IORING_OP_READV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<unsigned long>(&iovecs_rep[user_data]);
+  sqe->len = 1;
+  sqe->off = offset;
+  sqe->user_data = user_data;
+  sq_array_repp[index] = index;
+
+  /* note: the entry must be visible to the kernel before
+   *       the new tail */
+  __sync_synchronize();
+  *const_cast<volatile unsigned int*>(sq_tail_repp) = tail + 1;
+  ++to_submit_rep;
+
+  return true;
+}
+
+/**
+ * Submits all queued requests, and waits until at least
+ * 'min_complete' requests have completed.
+ *
+ * @return negative errno on error
+ */
+int ECA_FILE_IO_URING_ring::enter(unsigned int min_complete)
+{
+  if (to_submit_rep == 0 && min_complete == 0) return 0;
+
+  unsigned int flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+  int ret = ::syscall(__NR_io_uring_enter, fd_rep, to_submit_rep, min_complete, flags, 0, 0);
+  if (ret < 0) return -errno;
+
+  to_submit_rep -= ret;
+  return 0;
+}
+
+/**
+ * Fetches one completed request, if any.
+ */
+bool ECA_FILE_IO_URING_ring::reap(int* user_data, long int* result)
+{
+  unsigned int head = *cq_head_repp;
+  unsigned int tail = *const_cast<volatile unsigned int*>(cq_tail_repp);
+  __sync_synchronize();
+  if (head == tail) return false;
+
+  struct io_uring_cqe* cqe = &cqes_repp[head & *cq_mask_repp];
+  *user_data = static_cast<int>(cqe->user_data);
+  *result = cqe->res;
+
+  /* note: the entry must be read before it is released */
+  __sync_synchronize();
+  *const_cast<volatile unsigned int*>(cq_head_repp) = head + 1;
+
+  return true;
+}
+
+#else /* ECA_FILE_IO_URING_ENABLED */
+
+class ECA_FILE_IO_URING_ring { };
+
+#endif /* ECA_FILE_IO_URING_ENABLED */
+
+ECA_FILE_IO_URING::ECA_FILE_IO_URING(void)
+  : ring_repp(0),
+    blocks_rep(block_count),
+    fd_rep(-1),
+    head_rep(0),
+    reading_rep(false),
+    fill_rep(0),
+    next_offset_rep(0),
+    curpos_rep(0),
+    last_rep(0),
+    write_end_rep(0),
+    file_ended_rep(false),
+    file_error_rep(false)
+{
+  for(int n = 0; n < block_count; n++) {
+    blocks_rep[n].data = 0;
+    blocks_rep[n].offset = 0;
+    blocks_rep[n].bytes = 0;
+    blocks_rep[n].result = 0;
+    blocks_rep[n].pending = false;
+    blocks_rep[n].write = false;
+  }
+}
+
+ECA_FILE_IO_URING::~ECA_FILE_IO_URING(void)
+{
+  if (mode_rep != "") close_file();
+
+  for(int n = 0; n < block_count; n++) {
+    delete[] blocks_rep[n].data;
+  }
+}
+
+void ECA_FILE_IO_URING::open_file(const std::string& fname,
+				  const std::string& fmode)
+{
+  int openflags = O_RDONLY;
+  if (fmode == "wb")
+    openflags = O_WRONLY | O_CREAT | O_TRUNC;
+  else if (fmode == "w+b")
+    openflags = O_RDWR | O_CREAT | O_TRUNC;
+  else if (fmode == "r+b")
+    openflags = O_RDWR;
+
+  fname_rep = fname;
+  fd_rep = ::open(fname.c_str(), openflags, 0666);
+  if (fd_rep < 0) {
+    mode_rep = "";
+    return;
+  }
+  mode_rep = fmode;
+
+  for(int n = 0; n < block_count; n++) {
+    if (blocks_rep[n].data == 0)
+      blocks_rep[n].data = new char [block_size];
+    blocks_rep[n].pending = false;
+  }
+
+#ifdef ECA_FILE_IO_URING_ENABLED
+  ring_repp = new ECA_FILE_IO_URING_ring();
+  if (ring_repp->init(block_count) != true) {
+    delete ring_repp;
+    ring_repp = 0;
+  }
+#endif
+  if (ring_repp == 0)
+    ECA_LOG_MSG(ECA_LOGGER::user_objects,
+		"io_uring not available, using synchronous i/o for \"" + fname + "\"");
+
+  head_rep = 0;
+  reading_rep = false;
+  fill_rep = 0;
+  curpos_rep = 0;
+  last_rep = 0;
+  write_end_rep = 0;
+  file_ended_rep = false;
+  file_error_rep = false;
+}
+
+void ECA_FILE_IO_URING::close_file(void)
+{
+  if (mode_rep == "") return;
+
+  flush_writes();
+  stop_readahead();
+
+#ifdef ECA_FILE_IO_URING_ENABLED
+  delete ring_repp;
+#endif
+  ring_repp = 0;
+
+  ::close(fd_rep);
+  fd_rep = -1;
+  mode_rep = "";
+}
+
+/**
+ * Starts a read (write == false) or write of block 'index'.
+ * The request is passed to the kernel on the next call
+ * to submit_pending() or wait_for_block().
+ */
+void ECA_FILE_IO_URING::submit_block(int index, bool write)
+{
+  block_t& b = blocks_rep[index];
+
+  DBC_CHECK(b.pending != true);
+
+  b.write = write;
+  b.pending = true;
+
+#ifdef ECA_FILE_IO_URING_ENABLED
+  if (ring_repp != 0 &&
+      ring_repp->queue(fd_rep, write, b.data, b.bytes, b.offset, index) == true)
+    return;
+#endif
+
+  /* note: io_uring not available, transfer synchronously */
+  ssize_t res;
+  do {
+    if (write == true)
+      res = ::pwrite(fd_rep, b.data, b.bytes, b.offset);
+    else
+      res = ::pread(fd_rep, b.data, b.bytes, b.offset);
+  }
+  while(res < 0 && errno == EINTR);
+
+  b.result = (res < 0) ? -errno : res;
+  b.pending = false;
+}
+
+/**
+ * Passes queued requests to the kernel without waiting.
+ */
+void ECA_FILE_IO_URING::submit_pending(void)
+{
+#ifdef ECA_FILE_IO_URING_ENABLED
+  if (ring_repp != 0) ring_repp->enter(0);
+#endif
+}
+
+/**
+ * Waits until the transfer of block 'index' has completed.
+ * Queued requests are submitted before waiting.
+ */
+void ECA_FILE_IO_URING::wait_for_block(int index)
+{
+  block_t& b = blocks_rep[index];
+
+#ifdef ECA_FILE_IO_URING_ENABLED
+  while(b.pending == true) {
+    int done;
+    long int result;
+    while(ring_repp->reap(&done, &result) == true) {
+      blocks_rep[done].result = result;
+      blocks_rep[done].pending = false;
+    }
+    if (b.pending != true) break;
+
+    int ret = ring_repp->enter(1);
+    if (ret < 0 && ret != -EINTR) {
+      ECA_LOG_MSG(ECA_LOGGER::info,
+		  "io_uring_enter() failed for \"" + fname_rep + "\"");
+      b.result = ret;
+      b.pending = false;
+    }
+  }
+#endif
+
+  if (b.write == true && b.result != b.bytes)
+    file_error_rep = true;
+}
+
+/**
+ * Starts reading ahead from the current position.
+ */
+void ECA_FILE_IO_URING::start_readahead(void)
+{
+  DBC_CHECK(reading_rep != true);
+  DBC_CHECK(fill_rep == 0);
+
+  head_rep = 0;
+  next_offset_rep = curpos_rep;
+  for(int n = 0; n < block_count; n++) {
+    blocks_rep[n].offset = next_offset_rep;
+    blocks_rep[n].bytes = block_size;
+    submit_block(n, false);
+    next_offset_rep += block_size;
+  }
+  reading_rep = true;
+}
+
+/**
+ * Stops reading ahead, discarding any data read
+ * ahead of the current position.
+ */
+void ECA_FILE_IO_URING::stop_readahead(void)
+{
+  if (reading_rep == true) {
+    for(int n = 0; n < block_count; n++) {
+      wait_for_block(n);
+    }
+    reading_rep = false;
+  }
+}
+
+/**
+ * Writes out a partially filled block, and waits until
+ * all writes have completed.
+ */
+void ECA_FILE_IO_URING::flush_writes(void)
+{
+  if (reading_rep == true) return;
+
+  if (fill_rep > 0) {
+    blocks_rep[head_rep].bytes = fill_rep;
+    submit_block(head_rep, true);
+    head_rep = (head_rep + 1) % block_count;
+    fill_rep = 0;
+  }
+  for(int n = 0; n < block_count; n++) {
+    wait_for_block(n);
+  }
+}
+
+void ECA_FILE_IO_URING::read_to_buffer(void* obuf, off_t bytes)
+{
+  last_rep = 0;
+  if (is_file_ready() != true) return;
+
+  if (reading_rep != true) {
+    flush_writes();
+    start_readahead();
+  }
+
+  char* target = static_cast<char*>(obuf);
+  while(last_rep < bytes) {
+    block_t& b = blocks_rep[head_rep];
+    wait_for_block(head_rep);
+    if (b.result < 0) {
+      ECA_LOG_MSG(ECA_LOGGER::info, "read error from \"" + fname_rep + "\"");
+      file_error_rep = true;
+      break;
+    }
+
+    off_t avail = b.offset + b.result - curpos_rep;
+    if (avail <= 0) {
+      file_ended_rep = true;
+      break;
+    }
+    if (avail > bytes - last_rep) avail = bytes - last_rep;
+
+    std::memcpy(target + last_rep, b.data + (curpos_rep - b.offset), avail);
+    last_rep += avail;
+    curpos_rep += avail;
+
+    if (curpos_rep == b.offset + b.bytes) {
+      /* block consumed, reuse it for reading ahead */
+      b.offset = next_offset_rep;
+      b.bytes = block_size;
+      submit_block(head_rep, false);
+      next_offset_rep += block_size;
+      head_rep = (head_rep + 1) % block_count;
+    }
+  }
+
+  submit_pending();
+}
+
+void ECA_FILE_IO_URING::write_from_buffer(void* obuf, off_t bytes)
+{
+  last_rep = 0;
+  if (mode_rep == "" || file_error_rep == true) return;
+
+  if (reading_rep == true) {
+    stop_readahead();
+    head_rep = 0;
+  }
+
+  const char* source = static_cast<const char*>(obuf);
+  while(last_rep < bytes) {
+    block_t& b = blocks_rep[head_rep];
+    if (fill_rep == 0) {
+      wait_for_block(head_rep);
+      b.offset = curpos_rep;
+    }
+
+    long int count = block_size - fill_rep;
+    if (count > bytes - last_rep) count = bytes - last_rep;
+
+    std::memcpy(b.data + fill_rep, source + last_rep, count);
+    fill_rep += count;
+    last_rep += count;
+    curpos_rep += count;
+
+    if (fill_rep == block_size) {
+      b.bytes = fill_rep;
+      submit_block(head_rep, true);
+      head_rep = (head_rep + 1) % block_count;
+      fill_rep = 0;
+    }
+  }
+  if (curpos_rep > write_end_rep) write_end_rep = curpos_rep;
+
+  submit_pending();
+}
+
+void ECA_FILE_IO_URING::set_file_position(off_t newpos)
+{
+  if (mode_rep == "") return;
+
+  if (newpos != curpos_rep) {
+    flush_writes();
+    stop_readahead();
+    curpos_rep = newpos;
+  }
+  file_ended_rep = false;
+}
+
+void ECA_FILE_IO_URING::set_file_position_advance(off_t fw)
+{
+  set_file_position(curpos_rep + fw);
+}
+
+void ECA_FILE_IO_URING::set_file_position_end(void)
+{
+  set_file_position(get_file_length());
+}
+
+off_t ECA_FILE_IO_URING::get_file_position(void) const { return(curpos_rep); }
+
+off_t ECA_FILE_IO_URING::get_file_length(void) const
+{
+  if (fd_rep < 0) return(0);
+
+  struct stat temp;
+  ::fstat(fd_rep, &temp);
+
+  /* note: data may still be queued for writing */
+  if (write_end_rep > temp.st_size) return(write_end_rep);
+  return(temp.st_size);
+}
+
+bool ECA_FILE_IO_URING::is_file_ready(void) const
+{
+  if (mode_rep == "" ||
+      file_ended_rep == true ||
+      file_error_rep == true) return(false);
+  return(true);
+}
+
+bool ECA_FILE_IO_URING::is_file_error(void) const { return(file_error_rep); }
+off_t ECA_FILE_IO_URING::file_bytes_processed(void) const { return(last_rep); }
@@ -0,0 +1,129 @@
+// ------------------------------------------------------------------------
+// eca-fileio-uring.h: File-I/O using Linux io_uring for data
+//                     transfers.
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDED_FILEIO_URING_H
+#define INCLUDED_FILEIO_URING_H
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "eca-fileio.h"
+
+class ECA_FILE_IO_URING_ring;
+
+/**
+ * File-I/O using Linux io_uring for data transfers.
+ *
+ * Data is transferred in blocks of 'block_size' bytes, and
+ * up to 'block_count' blocks per file are kept in flight.
+ * When reading, blocks following the current position are
+ * read ahead. When writing, full blocks are queued and the
+ * caller only blocks if all blocks are still in flight.
+ * Requests are submitted in batches, together with the
+ * next wait for a completion.
+ *
+ * If io_uring is not available (at build time or at
+ * runtime), blocks are transferred synchronously
+ * with pread() and pwrite().
+ */
+class ECA_FILE_IO_URING : public ECA_FILE_IO {
+
+ public:
+
+  static const int block_count;
+  static const long int block_size;
+
+  ECA_FILE_IO_URING(void);
+  virtual ~ECA_FILE_IO_URING(void);
+
+  // --
+  // Open/close routines
+  // ---
+  virtual void open_file(const std::string& fname, const std::string& fmode);
+  virtual void open_stdin(void) { mode_rep = ""; }
+  virtual void open_stdout(void) { mode_rep = ""; }
+  virtual void open_stderr(void) { mode_rep = ""; }
+  virtual void close_file(void);
+
+  // --
+  // Normal file operations
+  // ---
+  virtual void read_to_buffer(void* obuf, off_t bytes);
+  virtual void write_from_buffer(void* obuf, off_t bytes);
+
+  virtual void set_file_position(off_t newpos);
+  virtual void set_file_position_advance(off_t fw);
+  virtual void set_file_position_end(void);
+  virtual off_t get_file_position(void) const;
+  virtual off_t get_file_length(void) const;
+
+  // --
+  // Status
+  // ---
+  virtual bool is_file_ready(void) const;
+  virtual bool is_file_error(void) const;
+  virtual off_t file_bytes_processed(void) const;
+  virtual const std::string& file_mode(void) const { return(mode_rep); }
+
+  bool is_async(void) const { return(ring_repp != 0); }
+
+ private:
+
+  struct block_t {
+    char* data;
+    off_t offset;
+    long int bytes;
+    long int result;
+    bool pending;
+    bool write;
+  };
+
+  void submit_block(int index, bool write);
+  void submit_pending(void);
+  void wait_for_block(int index);
+  void start_readahead(void);
+  void stop_readahead(void);
+  void flush_writes(void);
+
+  ECA_FILE_IO_URING_ring* ring_repp;
+  std::vector<block_t> blocks_rep;
+
+  int fd_rep;
+  int head_rep;
+  bool reading_rep;
+  long int fill_rep;
+  off_t next_offset_rep;
+  off_t curpos_rep;
+  off_t last_rep;
+  off_t write_end_rep;
+  bool file_ended_rep;
+  bool file_error_rep;
+
+  std::string mode_rep;
+  std::string fname_rep;
+
+  ECA_FILE_IO_URING& operator=(const ECA_FILE_IO_URING& x) { return *this; }
+  ECA_FILE_IO_URING (const ECA_FILE_IO_URING& x) { }
+};
+
+#endif
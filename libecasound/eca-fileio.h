@@ -36,6 +36,13 @@ class ECA_FILE_IO {
   virtual off_t get_file_position(void) const = 0;
   virtual off_t get_file_length(void) const = 0;
 
+  /**
+   * Preallocates file space in chunks of 'bytes' when writing
+   * past the current end of file. Zero disables preallocation.
+   * Ignored if not supported by the implementation.
+   */
+  virtual void set_preallocation(off_t bytes) { }
+
   // -----
   // Status
 
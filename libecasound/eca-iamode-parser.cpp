@@ -184,6 +184,8 @@ void ECA_IAMODE_PARSER::register_commands_cs(void)
   (*cmd_map_repp)["cs-set-length-samples"] = ec_cs_set_length_samples;
   (*cmd_map_repp)["cs-toggle-loop"] = ec_cs_toggle_loop;
   (*cmd_map_repp)["cs-option"] = ec_cs_option;
+  (*cmd_map_repp)["cs-profile"] = ec_cs_profile;
+  (*cmd_map_repp)["cs-profile-reset"] = ec_cs_profile_reset;
 }
 
 void ECA_IAMODE_PARSER::register_commands_c(void)
@@ -207,6 +209,7 @@ void ECA_IAMODE_PARSER::register_commands_c(void)
   (*cmd_map_repp)["c-status"] = ec_c_status;
   (*cmd_map_repp)["c-is-muted"] = ec_c_is_muted;
   (*cmd_map_repp)["c-is-bypassed"] = ec_c_is_bypassed;
+  (*cmd_map_repp)["c-load"] = ec_c_load;
 }
 
 void ECA_IAMODE_PARSER::register_commands_aio(void)
@@ -284,6 +287,7 @@ void ECA_IAMODE_PARSER::register_commands_cop(void)
   (*cmd_map_repp)["cop-set"] = ec_cop_set;
   (*cmd_map_repp)["cop-get"] = ec_cop_get;
   (*cmd_map_repp)["cop-status"] = ec_cop_status;
+  (*cmd_map_repp)["cop-load"] = ec_cop_load;
 }
 
 void ECA_IAMODE_PARSER::register_commands_copp(void)
@@ -465,6 +469,8 @@ bool ECA_IAMODE_PARSER::action_requires_selected(int id)
   case ec_cs_set_length_samples:
   case ec_cs_toggle_loop:
   case ec_cs_option:
+  case ec_cs_profile:
+  case ec_cs_profile_reset:
 
   case ec_c_remove:
   case ec_c_clear:
@@ -475,6 +481,7 @@ bool ECA_IAMODE_PARSER::action_requires_selected(int id)
   case ec_c_list:
   case ec_c_select:
   case ec_c_selected:
+  case ec_c_load:
 
   case ec_aio_status:
 
@@ -524,6 +531,7 @@ bool ECA_IAMODE_PARSER::action_requires_selected(int id)
   case ec_cop_set:
   case ec_cop_get:
   case ec_cop_status:
+  case ec_cop_load:
 
   case ec_copp_list:
   case ec_copp_select:
@@ -660,6 +668,7 @@ void show_controller_help(void)
   mitem << "\n'cs-status', 'st' - Chainsetup status";
   mitem << "\n'c-status', 'cs' - Chain status";
   mitem << "\n'cop-status', 'es' - Chain operator status";
+  mitem << "\n'cs-profile' - Processing load of chains and chain operators";
   mitem << "\n'ctrl-status' - Controller status"; 
   mitem << "\n'aio-status', 'fs' - Audio input/output status";
 
@@ -50,6 +50,8 @@ class ECA_IAMODE_PARSER_COMMANDS {
     ec_cs_set_length_samples,
     ec_cs_toggle_loop,
     ec_cs_option,
+    ec_cs_profile,
+    ec_cs_profile_reset,
     // --
     ec_c_add,
     ec_c_remove,
@@ -67,6 +69,7 @@ class ECA_IAMODE_PARSER_COMMANDS {
     ec_c_status,
     ec_c_is_bypassed,
     ec_c_is_muted,
+    ec_c_load,
     // --
     ec_aio_register,
     ec_aio_status,
@@ -123,6 +126,7 @@ class ECA_IAMODE_PARSER_COMMANDS {
     ec_cop_set,
     ec_cop_get,
     ec_cop_status,
+    ec_cop_load,
     ec_cop_register,
     ec_copp_list,
     ec_copp_select,
@@ -0,0 +1,224 @@
+// ------------------------------------------------------------------------
+// eca-processing-profile.cpp: Rolling statistics of processing times
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+
+#include <kvu_dbc.h>
+#include <kvu_message_item.h>
+#include <kvu_numtostr.h>
+
+#include "eca-processing-profile.h"
+
+/**
+ * Upper limits of the load histogram buckets, in
+ * percents of the period. The last bucket has no
+ * upper limit.
+ */
+static const double priv_histogram_limits[ECA_PROCESSING_PROFILE::histogram_buckets] =
+  { 5.0, 10.0, 25.0, 50.0, 75.0, 100.0, 200.0, 0.0 };
+
+const int ECA_PROCESSING_PROFILE::histogram_buckets;
+
+ECA_PROCESSING_PROFILE::ECA_PROCESSING_PROFILE(void)
+  : period_rep(0.0),
+    window_length_rep(1),
+    current_rep(0),
+    reset_rep(0)
+{
+  clear_window(&windows_rep[0]);
+  clear_window(&windows_rep[1]);
+}
+
+void ECA_PROCESSING_PROFILE::clear_window(struct window_t* window)
+{
+  window->events = 0;
+  window->total = 0.0;
+  window->peak = 0.0;
+  for(int n = 0; n < histogram_buckets; n++)
+    window->buckets[n] = 0;
+}
+
+/**
+ * Sets the time available for processing one
+ * buffer. Previous statistics are discarded.
+ *
+ * Not realtime-safe. Must not be called at the
+ * same time as record().
+ */
+void ECA_PROCESSING_PROFILE::set_period(double seconds)
+{
+  period_rep = seconds;
+
+  /* note: window switches after about one second of audio */
+  window_length_rep = 1;
+  if (seconds > 0.0 && seconds < 1.0)
+    window_length_rep = static_cast<long int>(1.0 / seconds);
+
+  clear_window(&windows_rep[0]);
+  clear_window(&windows_rep[1]);
+  current_rep = 0;
+  reset_rep = 0;
+}
+
+/**
+ * Records one processing time of 'seconds'.
+ *
+ * Realtime-safe.
+ */
+void ECA_PROCESSING_PROFILE::record(double seconds)
+{
+  if (reset_rep != 0) {
+    clear_window(&windows_rep[0]);
+    clear_window(&windows_rep[1]);
+    current_rep = 0;
+    reset_rep = 0;
+  }
+
+  struct window_t* window = &windows_rep[current_rep];
+  if (window->events >= window_length_rep) {
+    /* note: oldest window is discarded */
+    current_rep = 1 - current_rep;
+    window = &windows_rep[current_rep];
+    clear_window(window);
+  }
+
+  double load = 0.0;
+  if (period_rep > 0.0)
+    load = seconds / period_rep * 100.0;
+
+  int bucket = 0;
+  while(bucket < histogram_buckets - 1 &&
+	load >= priv_histogram_limits[bucket])
+    ++bucket;
+
+  ++window->buckets[bucket];
+  window->total += seconds;
+  if (seconds > window->peak)
+    window->peak = seconds;
+  ++window->events;
+}
+
+/**
+ * Discards all statistics. The request is
+ * carried out by the processing thread, but
+ * queries made after this call will not
+ * report old statistics.
+ *
+ * Can be called from any thread.
+ */
+void ECA_PROCESSING_PROFILE::request_reset(void)
+{
+  reset_rep = 1;
+}
+
+/**
+ * Returns the number of processing times
+ * included in the statistics.
+ */
+long int ECA_PROCESSING_PROFILE::events(void) const
+{
+  if (reset_rep != 0)
+    return 0;
+  return windows_rep[0].events + windows_rep[1].events;
+}
+
+/**
+ * Returns average processing time as percents of
+ * the period.
+ */
+double ECA_PROCESSING_PROFILE::load_percent(void) const
+{
+  long int count = events();
+  if (count == 0 || period_rep <= 0.0)
+    return 0.0;
+  double total = windows_rep[0].total + windows_rep[1].total;
+  return total / count / period_rep * 100.0;
+}
+
+/**
+ * Returns longest processing time as percents of
+ * the period.
+ */
+double ECA_PROCESSING_PROFILE::peak_load_percent(void) const
+{
+  if (events() == 0 || period_rep <= 0.0)
+    return 0.0;
+  double peak = windows_rep[0].peak;
+  if (windows_rep[1].peak > peak)
+    peak = windows_rep[1].peak;
+  return peak / period_rep * 100.0;
+}
+
+/**
+ * Returns the number of processing times that
+ * fall into histogram bucket 'bucket'.
+ *
+ * @pre bucket >= 0 && bucket < histogram_buckets
+ */
+long int ECA_PROCESSING_PROFILE::histogram(int bucket) const
+{
+  // --
+  DBC_REQUIRE(bucket >= 0 && bucket < histogram_buckets);
+  // --
+
+  if (reset_rep != 0)
+    return 0;
+  return windows_rep[0].buckets[bucket] + windows_rep[1].buckets[bucket];
+}
+
+/**
+ * Returns upper limit of histogram bucket 'bucket'
+ * as percents of the period. Zero is returned
+ * for the last bucket, which has no upper limit.
+ *
+ * @pre bucket >= 0 && bucket < histogram_buckets
+ */
+double ECA_PROCESSING_PROFILE::histogram_limit(int bucket)
+{
+  // --
+  DBC_REQUIRE(bucket >= 0 && bucket < histogram_buckets);
+  // --
+
+  return priv_histogram_limits[bucket];
+}
+
+/**
+ * Returns the statistics formatted as a string.
+ */
+std::string ECA_PROCESSING_PROFILE::to_string(void) const
+{
+  MESSAGE_ITEM msg;
+  msg << "load " << kvu_numtostr(load_percent(), 1) << "%";
+  msg << ", peak " << kvu_numtostr(peak_load_percent(), 1) << "%";
+  msg << ", histogram";
+  for(int n = 0; n < histogram_buckets; n++) {
+    if (n + 1 < histogram_buckets)
+      msg << " <" << kvu_numtostr(priv_histogram_limits[n], 0) << "%:";
+    else
+      msg << " >=" << kvu_numtostr(priv_histogram_limits[n - 1], 0) << "%:";
+    msg << kvu_numtostr(histogram(n));
+  }
+  return msg.to_string();
+}
@@ -0,0 +1,112 @@
+// ------------------------------------------------------------------------
+// eca-processing-profile.h: Rolling statistics of processing times
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDED_ECA_PROCESSING_PROFILE_H
+#define INCLUDED_ECA_PROCESSING_PROFILE_H
+
+#include <string>
+
+#include <kvu_timestamp.h>
+
+/**
+ * Rolling statistics of processing times.
+ *
+ * Each recorded processing time is compared to the
+ * period (the time available for processing one buffer)
+ * and counted into a load histogram. Statistics cover
+ * the most recent one to two seconds of processing.
+ *
+ * record() is realtime-safe and is called from the
+ * processing thread. The query functions and
+ * request_reset() can be called from other threads.
+ * Results of queries made while processing is running
+ * are approximate.
+ */
+class ECA_PROCESSING_PROFILE {
+
+ public:
+
+  /** @name Public constants */
+  /*@{*/
+
+  /** number of load histogram buckets */
+  static const int histogram_buckets = 8;
+
+  /*@}*/
+
+  /** @name Constructors and dtors */
+  /*@{*/
+
+  ECA_PROCESSING_PROFILE(void);
+
+  /*@}*/
+
+  /** @name Functions for recording */
+  /*@{*/
+
+  void set_period(double seconds);
+  void record(double seconds);
+  void request_reset(void);
+
+  /**
+   * Returns current time in seconds, for calculating
+   * durations passed to record().
+   */
+  static double now(void) {
+    struct timespec tp;
+    kvu_clock_gettime(&tp);
+    return kvu_timespec_seconds(&tp);
+  }
+
+  /*@}*/
+
+  /** @name Functions for querying statistics */
+  /*@{*/
+
+  double period(void) const { return period_rep; }
+  long int events(void) const;
+  double load_percent(void) const;
+  double peak_load_percent(void) const;
+  long int histogram(int bucket) const;
+  static double histogram_limit(int bucket);
+  std::string to_string(void) const;
+
+  /*@}*/
+
+ private:
+
+  struct window_t {
+    long int events;
+    double total;
+    double peak;
+    long int buckets[histogram_buckets];
+  };
+
+  void clear_window(struct window_t* window);
+
+  double period_rep;
+  long int window_length_rep;
+  volatile int current_rep;
+  volatile int reset_rep;
+  struct window_t windows_rep[2];
+};
+
+#endif
@@ -202,6 +202,8 @@ void ECA_STATIC_OBJECT_MAPS::register_audio_io_nonrt_objects(ECA_OBJECT_MAP* obj
   ECA_LOG_MSG(ECA_LOGGER::system_objects, "register_audio_io_nonrt_objects()");
 
   bool native_flac = false;
+  bool native_ogg = false;
+  bool native_mp3 = false;
 
   objmap->register_object("wav", "wav$", new WAVEFILE());
   objmap->register_object("ewf", "ewf$", new EWFFILE());
@@ -210,13 +212,6 @@ void ECA_STATIC_OBJECT_MAPS::register_audio_io_nonrt_objects(ECA_OBJECT_MAP* obj
   AUDIO_IO* raw = new RAWFILE();
   objmap->register_object("raw", "raw$", raw);
 
-  AUDIO_IO* mp3 = new MP3FILE();
-  objmap->register_object("mp3", "mp3$", mp3);
-  objmap->register_object("mp2", "mp2$", mp3);
-
-  AUDIO_IO* ogg = new OGG_VORBIS_INTERFACE();
-  objmap->register_object("ogg", "ogg$", ogg);
-
   AUDIO_IO* mikmod = new MIKMOD_INTERFACE();
   objmap->register_object("mikmod", 
 			  "(^mikmod$)|(xm$)|(669$)|(amf$)|(dsm$)|(far$)|(gdm$)|(imf$)|"
@@ -263,6 +258,18 @@ void ECA_STATIC_OBJECT_MAPS::register_audio_io_nonrt_objects(ECA_OBJECT_MAP* obj
     sf_types += "|(flac$)";
     native_flac = true;
   }
+  /* note: Ogg Vorbis and MP3 are decoded in-process if 
+   *       libsndfile supports them */
+  if (sndfile->supports_major_format(SF_FORMAT_OGG) == true) {
+    sf_types += "|(ogg$)|(oga$)";
+    native_ogg = true;
+  }
+#if HAVE_DECL_SF_FORMAT_MPEG
+  if (sndfile->supports_major_format(SF_FORMAT_MPEG) == true) {
+    sf_types += "|(mp3$)|(mp2$)";
+    native_mp3 = true;
+  }
+#endif
   if (find(el.begin(), el.end(), "avr") != el.end()) sf_types += "|(avr$)";
   if (find(el.begin(), el.end(), "caf") != el.end()) sf_types += "|(caf$)";
   if (find(el.begin(), el.end(), "htk") != el.end()) sf_types += "|(htk$)";
@@ -316,6 +323,17 @@ void ECA_STATIC_OBJECT_MAPS::register_audio_io_nonrt_objects(ECA_OBJECT_MAP* obj
     AUDIO_IO* forkedflac = new FLAC_FORKED_INTERFACE();
     objmap->register_object("flac", "flac$", forkedflac);
   }
+
+  if (native_mp3 != true) {
+    AUDIO_IO* mp3 = new MP3FILE();
+    objmap->register_object("mp3", "mp3$", mp3);
+    objmap->register_object("mp2", "mp2$", mp3);
+  }
+
+  if (native_ogg != true) {
+    AUDIO_IO* ogg = new OGG_VORBIS_INTERFACE();
+    objmap->register_object("ogg", "ogg$", ogg);
+  }
 }
 
 void ECA_STATIC_OBJECT_MAPS::register_chain_operator_objects(ECA_OBJECT_MAP* objmap)
@@ -108,6 +108,8 @@ AUDIO_IO_ALSA_PCM::AUDIO_IO_ALSA_PCM (int card,
   device_number_rep = device;
   subdevice_number_rep = subdevice;
   trigger_request_rep = false;
+  mmap_rep = false;
+  access_mode_rep = "rw";
   overruns_rep = underruns_rep = 0;
   nbufs_repp = 0;
   allocate_structs();
@@ -253,7 +255,25 @@ void AUDIO_IO_ALSA_PCM::fill_and_set_hw_params(void)
   else
     ECA_LOG_MSG(ECA_LOGGER::user_objects, "Using noninterleaved stream format.");
 
-  if (interleaved_channels() == true)
+  mmap_rep = false;
+  if (access_mode_rep == "mmap") {
+    if (interleaved_channels() == true)
+      err = snd_pcm_hw_params_set_access(audio_fd_repp, pcm_hw_params_repp,
+					 SND_PCM_ACCESS_MMAP_INTERLEAVED);
+    else
+      err = snd_pcm_hw_params_set_access(audio_fd_repp, pcm_hw_params_repp,
+					 SND_PCM_ACCESS_MMAP_NONINTERLEAVED);
+    if (err < 0)
+      ECA_LOG_MSG(ECA_LOGGER::info, "mmap access not supported by device, using read/write access.");
+    else {
+      ECA_LOG_MSG(ECA_LOGGER::user_objects, "Using mmap access.");
+      mmap_rep = true;
+    }
+  }
+
+  if (mmap_rep == true)
+    err = 0;
+  else if (interleaved_channels() == true)
     err = snd_pcm_hw_params_set_access(audio_fd_repp, pcm_hw_params_repp,
 					 SND_PCM_ACCESS_RW_INTERLEAVED);
   else
@@ -688,6 +708,207 @@ void AUDIO_IO_ALSA_PCM::handle_xrun_playback(void)
   }
 }
 
+/**
+ * Address of the first sample at 'offset' in 'area'.
+ */
+static inline unsigned char* alsa_area_ptr(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset)
+{
+  return reinterpret_cast<unsigned char*>(area.addr) + (area.first + offset * area.step) / 8;
+}
+
+/**
+ * Waits until data can be transferred to/from the
+ * memory-mapped device buffer. A running device wakes
+ * up the caller at least once per period, so the wait
+ * is limited to four period times (at least 100ms). A
+ * device that has stopped processing data would 
+ * otherwise block the engine forever.
+ *
+ * @return number of frames available, or a negative 
+ *         error code (-ETIMEDOUT on timeout)
+ */
+int AUDIO_IO_ALSA_PCM::mmap_wait(void)
+{
+  int timeout_ms = 100;
+  if (samples_per_second() > 0) {
+    long int period_ms = static_cast<long int>(period_size_rep) * 1000 / samples_per_second();
+    if (4 * period_ms > timeout_ms)
+      timeout_ms = static_cast<int>(4 * period_ms);
+  }
+
+  for(;;) {
+    snd_pcm_sframes_t avail = snd_pcm_avail_update(audio_fd_repp);
+    if (avail != 0)
+      return avail;
+    int err = snd_pcm_wait(audio_fd_repp, timeout_ms);
+    if (err < 0)
+      return err;
+    if (err == 0)
+      return -ETIMEDOUT;
+  }
+}
+
+/**
+ * Handles error 'err' from a mmap transfer. A timeout
+ * while waiting for the device is handled as an xrun.
+ *
+ * @return true if the transfer can be retried
+ */
+bool AUDIO_IO_ALSA_PCM::mmap_handle_error(int err)
+{
+  if (err == -ETIMEDOUT) {
+    if (ignore_xruns() == true) {
+      /* note: the device state is not XRUN, so the stream
+       *       is restarted here instead of in handle_xrun_*() */
+      cerr << "WARNING: ALSA device timed out, restarting!" << endl;
+      stop();
+      prepare();
+      if (io_mode() == io_read) {
+	overruns_rep++;
+	start();
+      }
+      else {
+	underruns_rep++;
+	trigger_request_rep = true;
+      }
+      return is_open();
+    }
+    cerr << "ALSA: Device timed out! Stopping operation!" << endl;
+  }
+  /* Note! ALSA versions <=0.9.1 sometimes return -EIO in xrun-state;
+   *       EPIPE=xrun, ESTRPIPE=xrun) */
+  else if (err == -EPIPE || err == -ESTRPIPE || err == -EIO) {
+    if (ignore_xruns() == true) {
+      if (io_mode() == io_read)
+	handle_xrun_capture();
+      else
+	handle_xrun_playback();
+      return is_open();
+    }
+    cerr << "ALSA: Overrun! Stopping operation!" << endl;
+  }
+  else {
+    cerr << "ALSA: Transfer error! Stopping operation (" << err << ")." << endl;
+  }
+  stop();
+  close();
+  return false;
+}
+
+/**
+ * Reads one buffer of audio, converting directly from the
+ * memory-mapped device buffer if mmap access is used.
+ */
+void AUDIO_IO_ALSA_PCM::read_buffer(SAMPLE_BUFFER* sbuf)
+{
+  if (mmap_rep != true) {
+    AUDIO_IO_DEVICE::read_buffer(sbuf);
+    return;
+  }
+
+  const int max_retries = 3;
+  int retries = 0;
+  long int done = 0;
+
+  sbuf->number_of_channels(channels());
+  sbuf->length_in_samples(buffersize());
+
+  while(done < buffersize() && retries < max_retries) {
+    const snd_pcm_channel_area_t* areas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t frames = buffersize() - done;
+
+    int err = mmap_wait();
+    if (err >= 0)
+      err = snd_pcm_mmap_begin(audio_fd_repp, &areas, &offset, &frames);
+    if (err >= 0) {
+      for(int c = 0; c < channels(); c++) {
+	sbuf->import_channel(alsa_area_ptr(areas[c], offset),
+			     areas[c].step / 8,
+			     done,
+			     frames,
+			     sample_format(),
+			     c);
+      }
+      snd_pcm_sframes_t res = snd_pcm_mmap_commit(audio_fd_repp, offset, frames);
+      if (res >= 0)
+	done += res;
+      else
+	err = res;
+    }
+    if (err < 0) {
+      ++retries;
+      if (mmap_handle_error(err) != true)
+	break;
+    }
+  }
+
+  sbuf->length_in_samples(done);
+  change_position_in_samples(done);
+}
+
+/**
+ * Writes one buffer of audio, converting directly to the
+ * memory-mapped device buffer if mmap access is used.
+ */
+void AUDIO_IO_ALSA_PCM::write_buffer(SAMPLE_BUFFER* sbuf)
+{
+  if (mmap_rep != true) {
+    AUDIO_IO_DEVICE::write_buffer(sbuf);
+    return;
+  }
+
+  /* note: see AUDIO_IO_DEVICE::write_buffer() */
+  if (sbuf->length_in_samples() != buffersize() &&
+      sbuf->event_tag_test(SAMPLE_BUFFER::tag_var_length) != true)
+    sbuf->length_in_samples(buffersize());
+  if (sbuf->number_of_channels() < channels())
+    sbuf->number_of_channels(channels());
+
+  if (trigger_request_rep == true) {
+    trigger_request_rep = false;
+    start();
+  }
+
+  const int max_retries = 3;
+  int retries = 0;
+  long int done = 0;
+
+  while(done < sbuf->length_in_samples() && retries < max_retries) {
+    const snd_pcm_channel_area_t* areas;
+    snd_pcm_uframes_t offset;
+    snd_pcm_uframes_t frames = sbuf->length_in_samples() - done;
+
+    int err = mmap_wait();
+    if (err >= 0)
+      err = snd_pcm_mmap_begin(audio_fd_repp, &areas, &offset, &frames);
+    if (err >= 0) {
+      for(int c = 0; c < channels(); c++) {
+	sbuf->export_channel(alsa_area_ptr(areas[c], offset),
+			     areas[c].step / 8,
+			     done,
+			     frames,
+			     sample_format(),
+			     sample_coding(),
+			     c);
+      }
+      snd_pcm_sframes_t res = snd_pcm_mmap_commit(audio_fd_repp, offset, frames);
+      if (res >= 0)
+	done += res;
+      else
+	err = res;
+    }
+    if (err < 0) {
+      ++retries;
+      if (mmap_handle_error(err) != true)
+	break;
+    }
+  }
+
+  change_position_in_samples(sbuf->length_in_samples());
+  extend_position();
+}
+
 long int AUDIO_IO_ALSA_PCM::delay(void) const
 {
   snd_pcm_sframes_t delay = 0;
@@ -723,6 +944,10 @@ void AUDIO_IO_ALSA_PCM::set_parameter(int param,
   case 4: 
     subdevice_number_rep = atoi(value.c_str());
     break;
+
+  case 5: 
+    access_mode_rep = value;
+    break;
   }
 
   if (using_plugin_rep)
@@ -757,6 +982,9 @@ string AUDIO_IO_ALSA_PCM::get_parameter(int param) const
 
   case 4: 
     return kvu_numtostr(subdevice_number_rep);
+
+  case 5: 
+    return access_mode_rep;
   }
   return "";
 }
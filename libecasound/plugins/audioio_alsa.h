@@ -20,6 +20,11 @@ using namespace std;
 
 /**
  * Class for handling ALSA pcm-devices (Advanced Linux Sound Architecture).
+ *
+ * With access mode 'mmap', audio data is converted directly 
+ * between the memory-mapped device buffer and SAMPLE_BUFFER 
+ * objects, without the intermediate i/o buffer used with 
+ * the default 'rw' mode (snd_pcm_readi()/writei() etc).
  */
 class AUDIO_IO_ALSA_PCM : public AUDIO_IO_DEVICE {
 
@@ -40,7 +45,7 @@ class AUDIO_IO_ALSA_PCM : public AUDIO_IO_DEVICE {
   /*@{*/
 
   virtual int supported_io_modes(void) const { return(io_read | io_write); }
-  virtual string parameter_names(void) const { return("label,card,device,subdevice"); }
+  virtual string parameter_names(void) const { return("label,card,device,subdevice,access"); }
 
   virtual void open(void) throw(AUDIO_IO::SETUP_ERROR&);
   virtual void close(void);
@@ -48,6 +53,9 @@ class AUDIO_IO_ALSA_PCM : public AUDIO_IO_DEVICE {
   virtual long int read_samples(void* target_buffer, long int samples);
   virtual void write_samples(void* target_buffer, long int samples);
 
+  virtual void read_buffer(SAMPLE_BUFFER* sbuf);
+  virtual void write_buffer(SAMPLE_BUFFER* sbuf);
+
   /*@}*/
 
   /** @name Function reimplemented from AUDIO_IO_DEVICE */
@@ -77,6 +85,8 @@ private:
   void handle_xrun_print_gap_duration(snd_pcm_status_t *status);
   void handle_xrun_capture(void);
   void handle_xrun_playback(void);
+  int mmap_wait(void);
+  bool mmap_handle_error(int err);
 
 private:
 
@@ -99,11 +109,15 @@ private:
 
   bool using_plugin_rep;
   bool trigger_request_rep;
+  bool mmap_rep;
+  string access_mode_rep;
 
  protected:
 
   void set_pcm_device_name(const string& n);
   const string& pcm_device_name(void) const { return(pcm_device_name_rep); }
+  void set_access_mode(const string& v) { access_mode_rep = v; }
+  const string& access_mode(void) const { return(access_mode_rep); }
   
  private:
 
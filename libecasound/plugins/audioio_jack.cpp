@@ -233,6 +233,21 @@ long int AUDIO_IO_JACK::read_samples(void* target_buffer, long int samples)
   return 0;
 }
 
+void AUDIO_IO_JACK::read_buffer(SAMPLE_BUFFER* sbuf)
+{
+  /* note: bypasses the i/o buffer of AUDIO_IO_BUFFERED, port
+   *       buffers are copied directly to 'sbuf' */
+
+  if (jackmgr_rep != 0) {
+    jackmgr_rep->read_buffer(myid_rep, sbuf);
+  }
+  else {
+    sbuf->length_in_samples(0);
+  }
+
+  change_position_in_samples(sbuf->length_in_samples());
+}
+
 void AUDIO_IO_JACK::write_buffer(SAMPLE_BUFFER* sbuf)
 {
   /* note: this is reimplemented only to catch errors with unsupported
@@ -247,7 +262,21 @@ void AUDIO_IO_JACK::write_buffer(SAMPLE_BUFFER* sbuf)
 		"This can happen e.g. with a 'resample' input object.");
   }
 
-  AUDIO_IO_DEVICE::write_buffer(sbuf);
+  /* note: bypasses the i/o buffer of AUDIO_IO_BUFFERED, 'sbuf'
+   *       is copied directly to the port buffers; padding
+   *       as done in AUDIO_IO_DEVICE::write_buffer() */
+
+  if (sbuf->length_in_samples() != buffersize() &&
+      sbuf->event_tag_test(SAMPLE_BUFFER::tag_var_length) != true) {
+    sbuf->length_in_samples(buffersize());
+  }
+
+  if (jackmgr_rep != 0) {
+    jackmgr_rep->write_buffer(myid_rep, sbuf);
+  }
+
+  change_position_in_samples(sbuf->length_in_samples());
+  extend_position();
 }
 
 void AUDIO_IO_JACK::write_samples(void* target_buffer, long int samples)
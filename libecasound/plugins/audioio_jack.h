@@ -13,6 +13,12 @@ class AUDIO_IO_JACK_MANAGER;
 /**
  * Interface to JACK audio framework.
  *
+ * Audio is copied directly between JACK port buffers
+ * and the engine's sample buffers, without intermediate 
+ * i/o buffers. This requires that the object is accessed
+ * only from the JACK process callback, and that the engine
+ * buffersize matches the JACK period size.
+ *
  * @author Kai Vehmanen
  */
 class AUDIO_IO_JACK : public AUDIO_IO_DEVICE {
@@ -41,6 +47,7 @@ class AUDIO_IO_JACK : public AUDIO_IO_DEVICE {
 
   virtual bool finished(void) const;
 
+  virtual void read_buffer(SAMPLE_BUFFER* sbuf);
   virtual void write_buffer(SAMPLE_BUFFER* sbuf);
 
   virtual long int read_samples(void* target_buffer, long int samples);
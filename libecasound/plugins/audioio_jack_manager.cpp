@@ -27,8 +27,9 @@
 #include <config.h>
 #endif
 
-#include <algorithm> /* std::count() */
+#include <cstdlib> /* free() */
 #include <iostream>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -42,6 +43,7 @@
 #include <kvu_threads.h>
 
 #include "audioio.h"
+#include "samplebuffer.h"
 #include "eca-engine.h"
 #include "eca-chainsetup.h"
 #include "eca-logger.h"
@@ -375,10 +377,18 @@ static int eca_jack_process_callback(jack_nframes_t nframes, void *arg)
   }
 
   /* try to get the driver lock; if it fails or connection 
-   * is not fully establish, skip this processing cycle */
+   * is not fully establish, skip this processing cycle 
+   *
+   * note: exec() holds the lock only while executing commands
+   *       that are not realtime-safe (see dispatch_commands()),
+   *       e.g. start/stop, seeks and controller parameter 
+   *       changes, so only these can still mute a cycle */
   int ret = pthread_mutex_trylock(&current->engine_mod_lock_rep);
   if (ret == 0) {
     // DEBUG_CFLOW_STATEMENT(cerr << "eca_jack_PROCESS: got lock" << endl);
+
+    /* 0. execute edits passed from exec() */
+    current->execute_realtime_commands();
     
     /* 1. transport control processing in "notransport" and "transport" mode */
     if (current->mode_rep == AUDIO_IO_JACK_MANAGER::Transport_none ||
@@ -435,46 +445,24 @@ static void eca_jack_process_engine_iteration(jack_nframes_t nframes, void* arg)
 
   if (current->engine_repp->status() != ECA_ENGINE::engine_status_finished) {
 
-    /* 1. copy audio data from port input buffers to ecasound buffers */
-    for(size_t n = 0; n < current->inports_rep.size(); n++) {
-      if (current->inports_rep[n]->cb_buffer != 0) {
-	jack_default_audio_sample_t* in_cb_buffer = 
-	  static_cast<jack_default_audio_sample_t*>
-	  (jack_port_get_buffer(current->inports_rep[n]->jackport, nframes));
-	
-	memcpy(current->inports_rep[n]->cb_buffer, 
-	       in_cb_buffer, 
-	       current->buffersize_rep * sizeof(jack_default_audio_sample_t));
-      }
-    }
-    
     // DEBUG_CFLOW_STATEMENT(cerr << endl << "eca_jack_PROCESS: engine_iter_in");
   
-    /* 2. execute one engine iteration */
+    /* 1. execute one engine iteration; JACK objects access
+     *    the port buffers directly (see read_buffer() and
+     *    write_buffer()), so no copying is needed here */
+    current->cycle_nframes_rep = nframes;
     current->engine_repp->engine_iteration(); 
+    current->cycle_nframes_rep = 0;
     
     // DEBUG_CFLOW_STATEMENT(cerr << endl << "eca_jack_PROCESS: engine_iter_out");
-    
-    /* 3. copy data from ecasound buffers to port output buffers */
-    for(size_t n = 0; n < current->outports_rep.size(); n++) {
-      if (current->outports_rep[n]->cb_buffer != 0) {
-	jack_default_audio_sample_t* out_cb_buffer = 
-	  static_cast<jack_default_audio_sample_t*>
-	  (jack_port_get_buffer(current->outports_rep[n]->jackport, nframes));
-	
-	memcpy(out_cb_buffer, 
-	       current->outports_rep[n]->cb_buffer, 
-	       current->buffersize_rep * sizeof(jack_default_audio_sample_t));
-      }
-    }
   }
   else {
-    /* 4. chainsetup finished, mute */
+    /* 2. chainsetup finished, mute */
     DEBUG_CFLOW_STATEMENT(cerr << "eca_jack_PROCESS: chainsetup finished, muting\n");
     eca_jack_process_mute(nframes, current);
   }
   
-  /* 5. update engine status based on the last iteration */
+  /* 3. update engine status based on the last iteration */
   current->engine_repp->update_engine_state();
 }
 
@@ -488,14 +476,14 @@ static void eca_jack_process_mute(jack_nframes_t nframes, void* arg)
   AUDIO_IO_JACK_MANAGER* current = static_cast<AUDIO_IO_JACK_MANAGER*>(arg);
 
   for(size_t n = 0; n < current->outports_rep.size(); n++) {
-    if (current->outports_rep[n]->cb_buffer != 0) {
-      jack_default_audio_sample_t* out_cb_buffer = 
+    if (current->outports_rep[n]->jackport != 0) {
+      jack_default_audio_sample_t* out_buffer = 
 	static_cast<jack_default_audio_sample_t*>
 	(jack_port_get_buffer(current->outports_rep[n]->jackport, nframes));
 
-      memset(out_cb_buffer, 
+      memset(out_buffer, 
 	     0, 
-	     current->buffersize_rep * sizeof(jack_default_audio_sample_t));
+	     nframes * sizeof(jack_default_audio_sample_t));
     }
   }
 }
@@ -704,8 +692,8 @@ AUDIO_IO_JACK_MANAGER::AUDIO_IO_JACK_MANAGER(void)
   mode_rep = AUDIO_IO_JACK_MANAGER::Transport_invalid;
 
   shutdown_request_rep = false;
-  cb_allocated_frames_rep = 0;
   buffersize_rep = 0;
+  cycle_nframes_rep = 0;
 }
 
 /**
@@ -723,30 +711,20 @@ AUDIO_IO_JACK_MANAGER::~AUDIO_IO_JACK_MANAGER(void)
   /* 2. clear input ports */
   vector<eca_jack_port_data_t*>::iterator q = inports_rep.begin();
   while(q != inports_rep.end()) {
-    if ((*q)->cb_buffer != 0) {
-      delete[] (*q)->cb_buffer;
-      (*q)->cb_buffer = 0;
-    }
     delete *q;
     ++q;
   }
 
   /* 3. clear output ports */
-  q = inports_rep.begin();
-  while(q != inports_rep.end()) {
-    if ((*q)->cb_buffer != 0) {
-      delete[] (*q)->cb_buffer;
-      (*q)->cb_buffer = 0;
-    }
+  q = outports_rep.begin();
+  while(q != outports_rep.end()) {
     delete *q;
     ++q;
   }
 
   /* 4. clear objects */
-  list<eca_jack_node_t*>::iterator p = node_list_rep.begin();
-  while(p != node_list_rep.end()) {
-    delete *p;
-    ++p;
+  for(size_t n = 0; n < nodes_rep.size(); n++) {
+    delete nodes_rep[n];
   }
 }
 
@@ -786,7 +764,13 @@ void AUDIO_IO_JACK_MANAGER::register_object(AUDIO_IO* aobj)
   tmp->aobj = jobj;
   tmp->origptr = aobj;
   tmp->client_id = last_node_id_rep;
-  node_list_rep.push_back(tmp);
+
+  /* note: client ids are not reused, so the table 
+   *       grows by one slot per registered object */
+  if (static_cast<int>(nodes_rep.size()) <= tmp->client_id)
+    nodes_rep.resize(tmp->client_id + 1, 0);
+  nodes_rep[tmp->client_id] = tmp;
+  object_ids_rep[aobj] = tmp->client_id;
 
   jobj->set_manager(this, tmp->client_id);
 
@@ -806,15 +790,12 @@ int AUDIO_IO_JACK_MANAGER::get_object_id(const AUDIO_IO* aobj) const
   DBC_REQUIRE(is_managed_type(aobj) == true);
   // ---
 
-  list<eca_jack_node_t*>::const_iterator p = node_list_rep.begin();
-  while(p != node_list_rep.end()) {
-    if ((*p)->origptr == aobj) {
-      ECA_LOG_MSG(ECA_LOGGER::system_objects, 
-		  "found object id for aobj " +
-		  aobj->name() + ": " + kvu_numtostr((*p)->client_id));
-      return (*p)->client_id;
-    }
-    ++p;
+  std::map<const AUDIO_IO*, int>::const_iterator p = object_ids_rep.find(aobj);
+  if (p != object_ids_rep.end()) {
+    ECA_LOG_MSG(ECA_LOGGER::system_objects, 
+		"found object id for aobj " +
+		aobj->name() + ": " + kvu_numtostr(p->second));
+    return p->second;
   }
   return -1;
 }
@@ -825,10 +806,9 @@ int AUDIO_IO_JACK_MANAGER::get_object_id(const AUDIO_IO* aobj) const
 list<int> AUDIO_IO_JACK_MANAGER::get_object_list(void) const
 {
   list<int> object_list;
-  list<eca_jack_node_t*>::const_iterator p = node_list_rep.begin();
-  while(p != node_list_rep.end()) {
-    object_list.push_back((*p)->client_id);
-    ++p;
+  for(size_t n = 0; n < nodes_rep.size(); n++) {
+    if (nodes_rep[n] != 0)
+      object_list.push_back(nodes_rep[n]->client_id);
   }
   return object_list;
 }
@@ -845,31 +825,23 @@ list<int> AUDIO_IO_JACK_MANAGER::get_object_list(void) const
 void AUDIO_IO_JACK_MANAGER::unregister_object(int id)
 {
   // ---
-  DBC_DECLARE(unsigned int old_total_nodes = node_list_rep.size());
+  DBC_REQUIRE(has_node(id) == true);
   // ---
 
   ECA_LOG_MSG(ECA_LOGGER::system_objects, 
 		"unregister object ");
 
-  list<eca_jack_node_t*>::iterator p = node_list_rep.begin();
-  while(p != node_list_rep.end()) {
-    if ((*p)->client_id == id) {
-      ECA_LOG_MSG(ECA_LOGGER::system_objects,
-		  "removing object " + (*p)->aobj->label());
-      (*p)->aobj->set_manager(0, -1);
-
-      delete *p;
-      node_list_rep.erase(p);
+  eca_jack_node_t* node = nodes_rep[id];
+  ECA_LOG_MSG(ECA_LOGGER::system_objects,
+	      "removing object " + node->aobj->label());
+  node->aobj->set_manager(0, -1);
 
-      break;
-    }
-    ++p;
-  }
+  object_ids_rep.erase(node->origptr);
+  nodes_rep[id] = 0;
+  delete node;
 
   // ---
-  DBC_ENSURE(node_list_rep.size() == old_total_nodes - 1);
-  DBC_DECLARE(list<int> ol = get_object_list());
-  DBC_ENSURE(std::count(ol.begin(), ol.end(), id) == 0);
+  DBC_ENSURE(has_node(id) != true);
   // ---
 }
 
@@ -1102,33 +1074,7 @@ int AUDIO_IO_JACK_MANAGER::exec(ECA_ENGINE* engine, ECA_CHAINSETUP* csetup)
 
     DEBUG_CFLOW_STATEMENT(cerr << "jack_exec: wakes up; commands available" << endl);
 
-    /* we must take the lock to ensure that 
-     * process callback does not run at the same time 
-     *
-     * note: the RT-optimized command queue (VALUE_QUEUE_RT_C) is not
-     * safe when accessed from more than 2 threads, but here it is ok
-     * as we limit concurrent threads to two with engine_mod_lock_rep
-     **/
-
-    SAMPLE_SPECS::sample_pos_t enginepos = engine_repp->current_position_in_samples();
-    pthread_mutex_lock(&engine_mod_lock_rep);
-    engine_repp->check_command_queue();
-    if (exit_request_rep != true &&
-	enginepos != engine_repp->current_position_in_samples()) {
-      /* seek requested */
-#if ECA_JACK_TRANSPORT_API >= 3
-      if (mode_rep == AUDIO_IO_JACK_MANAGER::Transport_send ||
-	  mode_rep == AUDIO_IO_JACK_MANAGER::Transport_send_receive) {
-	if (engine_repp->current_position_in_samples() != 
-	    jackslave_seekahead_target_rep) {
-	  DEBUG_CFLOW_STATEMENT(cerr << "jack_exec: seek requested to pos=" 
-				<< engine_repp->current_position_in_samples() << "." << endl);
-	  jack_transport_locate(client_repp, engine_repp->current_position_in_samples());
-	}
-      }
-#endif
-    }
-    pthread_mutex_unlock(&engine_mod_lock_rep);
+    dispatch_commands();
 
     DEBUG_CFLOW_STATEMENT(cerr << "jack_exec: check_commands finished" << endl);
 
@@ -1169,6 +1115,7 @@ int AUDIO_IO_JACK_MANAGER::exec(ECA_ENGINE* engine, ECA_CHAINSETUP* csetup)
   DEBUG_CFLOW_STATEMENT(cerr << "jack_exec: deactivated" << endl);
 
   pthread_mutex_lock(&engine_mod_lock_rep);
+  execute_realtime_commands();
   exit_request_rep = 0;
   engine_repp = 0;
   pthread_mutex_unlock(&engine_mod_lock_rep);
@@ -1181,6 +1128,85 @@ int AUDIO_IO_JACK_MANAGER::exec(ECA_ENGINE* engine, ECA_CHAINSETUP* csetup)
   return result;
 }
 
+/**
+ * Dispatches commands from the engine command queue.
+ * Commands that can be run in realtime context (see
+ * ECA_ENGINE::is_realtime_command()) are passed to the
+ * process callback without taking 'engine_mod_lock_rep',
+ * so the callback is never blocked by them. Other 
+ * commands are executed directly with the lock held,
+ * and the process callback mutes any cycle that 
+ * overlaps with them.
+ *
+ * context: E-level-1
+ */
+void AUDIO_IO_JACK_MANAGER::dispatch_commands(void)
+{
+  ECA_ENGINE::complex_command_t* item;
+
+  while((item = engine_repp->front_command()) != 0) {
+
+    /* 1. pass realtime-safe commands to the process callback */
+    if (engine_repp->is_realtime_command(*item) == true &&
+	is_connection_active() == true &&
+	shutdown_request_rep != true &&
+	rt_commands_rep.push_back(*item) == true) {
+      engine_repp->pop_command();
+      continue;
+    }
+
+    /* 2. we must take the lock to ensure that process 
+     *    callback does not run at the same time; pending
+     *    realtime commands are executed first to keep the
+     *    commands in order (also used if the callback 
+     *    is not running or has fallen behind)
+     *
+     * note: engine commands are consumed only by this 
+     *       thread, and 'rt_commands_rep' only with
+     *       the lock held
+     */
+
+    SAMPLE_SPECS::sample_pos_t enginepos = engine_repp->current_position_in_samples();
+    pthread_mutex_lock(&engine_mod_lock_rep);
+    execute_realtime_commands();
+    engine_repp->check_command_queue();
+    if (exit_request_rep != true &&
+	enginepos != engine_repp->current_position_in_samples()) {
+      /* seek requested */
+#if ECA_JACK_TRANSPORT_API >= 3
+      if (mode_rep == AUDIO_IO_JACK_MANAGER::Transport_send ||
+	  mode_rep == AUDIO_IO_JACK_MANAGER::Transport_send_receive) {
+	if (engine_repp->current_position_in_samples() != 
+	    jackslave_seekahead_target_rep) {
+	  DEBUG_CFLOW_STATEMENT(cerr << "jack_exec: seek requested to pos=" 
+				<< engine_repp->current_position_in_samples() << "." << endl);
+	  jack_transport_locate(client_repp, engine_repp->current_position_in_samples());
+	}
+      }
+#endif
+    }
+    pthread_mutex_unlock(&engine_mod_lock_rep);
+    break;
+  }
+}
+
+/**
+ * Executes commands passed to the process callback
+ * by dispatch_commands().
+ *
+ * context: J-level-1 or E-level-1
+ *          caller must hold 'engine_mod_lock_rep'
+ */
+void AUDIO_IO_JACK_MANAGER::execute_realtime_commands(void)
+{
+  ECA_ENGINE::complex_command_t* item;
+
+  while((item = rt_commands_rep.front()) != 0) {
+    engine_repp->execute_command(*item);
+    rt_commands_rep.pop_front(0);
+  }
+}
+
 /**
  * Activate connection to the JACK server.
  *
@@ -1341,25 +1367,16 @@ void AUDIO_IO_JACK_MANAGER::exit(void)
  * Returns a pointer to a 'eca_jack_node_t' structure 
  * matching client 'client_id'.
  *
- * @pre list<int> l = get_object_list(); std::count(l.begin(), l.end(), client_id) == 1
+ * @pre has_node(client_id) == true
  * @return non-zero pointer
  */
 AUDIO_IO_JACK_MANAGER::eca_jack_node_t* AUDIO_IO_JACK_MANAGER::get_node(int client_id)
 {
   // --
-  DBC_DECLARE(list<int> ol = get_object_list());
-  DBC_REQUIRE(std::count(ol.begin(), ol.end(), client_id) == 1);
+  DBC_REQUIRE(has_node(client_id) == true);
   // --
 
-  eca_jack_node_t* node = 0;
-  list<eca_jack_node_t*>::iterator p = node_list_rep.begin();
-  while(p != node_list_rep.end()) {
-    if ((*p)->client_id == client_id) { 
-      node = *p;
-      break;
-    }
-    ++p;
-  }
+  eca_jack_node_t* node = nodes_rep[client_id];
 
   // --
   DBC_ENSURE(node != 0);
@@ -1368,6 +1385,17 @@ AUDIO_IO_JACK_MANAGER::eca_jack_node_t* AUDIO_IO_JACK_MANAGER::get_node(int clie
   return node;
 }
 
+/**
+ * Whether an object with client id 'client_id' is
+ * registered.
+ */
+bool AUDIO_IO_JACK_MANAGER::has_node(int client_id) const
+{
+  return client_id > 0 && 
+    client_id < static_cast<int>(nodes_rep.size()) &&
+    nodes_rep[client_id] != 0;
+}
+
 /**
  * Sets up automatic port connection for client_id's port
  * 'portnum'. When jack client is activated, this port
@@ -1375,15 +1403,14 @@ AUDIO_IO_JACK_MANAGER::eca_jack_node_t* AUDIO_IO_JACK_MANAGER::get_node(int clie
  * direction of the connection is based on audio objects I/O mode 
  * (@see AUDIO_IO::io_mode()).
  *
- * @pre list<int> l = get_object_list(); std::count(l.begin(), l.end(), client_id) == 1
+ * @pre has_node(client_id) == true
  * @pre is_open() == true
  @ @pre portnum > 0
  */
 void AUDIO_IO_JACK_MANAGER::auto_connect_jack_port(int client_id, int portnum, const string& portname)
 {
   // ---
-  DBC_DECLARE(list<int> ol = get_object_list());
-  DBC_REQUIRE(std::count(ol.begin(), ol.end(), client_id) == 1);
+  DBC_REQUIRE(has_node(client_id) == true);
   DBC_REQUIRE(is_open() == true);
   DBC_REQUIRE(portnum > 0);
   // ---
@@ -1393,16 +1420,8 @@ void AUDIO_IO_JACK_MANAGER::auto_connect_jack_port(int client_id, int portnum, c
 
   eca_jack_node_t* node = get_node(client_id);
 
-  list<eca_jack_port_data*>::const_iterator p = node->ports.begin();
-  int n = 1;
-  while(p != node->ports.end()) {
-    if (n == portnum) {
-      (*p)->autoconnect_string = portname;
-      break;
-    }
-    ++n;
-    ++p;
-  }
+  if (portnum <= static_cast<int>(node->ports.size()))
+    node->ports[portnum - 1]->autoconnect_string = portname;
 }
 
 static std::string eca_get_jack_port_item(const char **ports, int item)
@@ -1415,19 +1434,33 @@ static std::string eca_get_jack_port_item(const char **ports, int item)
   return string("");
 }
 
+/**
+ * Removes all items of 'removed' from 'ports', keeping
+ * the order of remaining items.
+ */
+static void eca_remove_jack_ports(vector<AUDIO_IO_JACK_MANAGER::eca_jack_port_data_t*>* ports, 
+				  const std::set<AUDIO_IO_JACK_MANAGER::eca_jack_port_data_t*>& removed)
+{
+  size_t m = 0;
+  for(size_t n = 0; n < ports->size(); n++) {
+    if (removed.find((*ports)[n]) == removed.end()) 
+      (*ports)[m++] = (*ports)[n];
+  }
+  ports->resize(m);
+}
+
 /**
  * Sets up automatic port connections to matching ports of
  * client 'dst'.
  *
- * @pre list<int> l = get_object_list(); std::count(l.begin(), l.end(), client_id) == 1
+ * @pre has_node(client_id) == true
  * @pre is_open() == true
  @ @pre portnum > 0
  */
 void AUDIO_IO_JACK_MANAGER::auto_connect_jack_port_client(int client_id, const string& dst, int channels)
 {
   // ---
-  DBC_DECLARE(list<int> ol = get_object_list());
-  DBC_REQUIRE(std::count(ol.begin(), ol.end(), client_id) == 1);
+  DBC_REQUIRE(has_node(client_id) == true);
   DBC_REQUIRE(is_open() == true);
   DBC_REQUIRE(channels > 0);
   // ---
@@ -1438,30 +1471,28 @@ void AUDIO_IO_JACK_MANAGER::auto_connect_jack_port_client(int client_id, const s
 	      "Making autoconnection to ports matching: " + dst);
   
   eca_jack_node_t* node = get_node(client_id);
-  list<eca_jack_port_data*>::const_iterator p = node->ports.begin();
+
+  /* note: query the port list once for all channels */
+  if (node->aobj->io_mode() == AUDIO_IO::io_read) {
+    ports = jack_get_ports (client_repp, dst.c_str(), NULL, JackPortIsOutput);
+  }
+  else {
+    ports = jack_get_ports (client_repp, dst.c_str(), NULL, JackPortIsInput);
+  }
+
+  vector<eca_jack_port_data*>::const_iterator p = node->ports.begin();
   int n = 1;
-  while(p != node->ports.end()) {
-    if (n <= channels) {
-      ports = 0;
-      if (node->aobj->io_mode() == AUDIO_IO::io_read) {
-	ports = jack_get_ports (client_repp, dst.c_str(), NULL, JackPortIsOutput);
-      }
-      else {
-	ports = jack_get_ports (client_repp, dst.c_str(), NULL, JackPortIsInput);
-      }
-      (*p)->autoconnect_string = eca_get_jack_port_item(ports, n);
-      ECA_LOG_MSG(ECA_LOGGER::user_objects,
-		  "Making autoconnection to terminal port: " + 
-		  (*p)->autoconnect_string +
-		  ", channel " + kvu_numtostr(n));
-      if (ports != NULL) free(ports);
-    }
-    else {
-      break;
-    }
+  while(p != node->ports.end() && n <= channels) {
+    (*p)->autoconnect_string = eca_get_jack_port_item(ports, n);
+    ECA_LOG_MSG(ECA_LOGGER::user_objects,
+		"Making autoconnection to terminal port: " + 
+		(*p)->autoconnect_string +
+		", channel " + kvu_numtostr(n));
     ++n;
     ++p;
   }
+
+  if (ports != NULL) free(ports);
 }
 
 /**
@@ -1474,7 +1505,7 @@ long int AUDIO_IO_JACK_MANAGER::client_latency(int client_id)
   eca_jack_node_t* node = get_node(client_id);
   long int latency = -1;
 
-  list<eca_jack_port_data*>::const_iterator p = node->ports.begin();
+  vector<eca_jack_port_data*>::const_iterator p = node->ports.begin();
   while(p != node->ports.end()) {
     if (latency == -1) {
       latency = (*p)->total_latency;
@@ -1502,14 +1533,13 @@ long int AUDIO_IO_JACK_MANAGER::client_latency(int client_id)
  * The final port names are of the form 'clientname:portprefix_N', 
  * where N is 1...max_port.
  *
- * @pre list<int> l = get_object_list(); std::count(l.begin(), l.end(), client_id) == 1
+ * @pre has_node(client_id) == true
  * @pre is_open() == true
  */
 void AUDIO_IO_JACK_MANAGER::register_jack_ports(int client_id, int ports, const string& portprefix)
 {
   // ---
-  DBC_DECLARE(list<int> ol = get_object_list());
-  DBC_REQUIRE(std::count(ol.begin(), ol.end(), client_id) == 1);
+  DBC_REQUIRE(has_node(client_id) == true);
   DBC_REQUIRE(is_open() == true);
   DBC_DECLARE(unsigned int old_port_count_vectors = inports_rep.size() + outports_rep.size());
   // ---
@@ -1518,6 +1548,16 @@ void AUDIO_IO_JACK_MANAGER::register_jack_ports(int client_id, int ports, const
 	      "register jack ports for client " + kvu_numtostr(client_id));
 
   eca_jack_node_t* node = get_node(client_id);
+  vector<eca_jack_port_data_t*>* portvec = 
+    (node->aobj->io_mode() == AUDIO_IO::io_read) ? &inports_rep : &outports_rep;
+
+  node->ports.reserve(node->ports.size() + ports);
+  portvec->reserve(portvec->size() + ports);
+
+  std::map<string, int>::iterator it = port_numbers_rep.find(portprefix);
+  if (it == port_numbers_rep.end()) {
+    it = port_numbers_rep.insert(std::make_pair(portprefix, 0)).first;
+  }
 
   for(int n = 0; n < ports; n++) {
     eca_jack_port_data_t* portdata = new eca_jack_port_data_t;
@@ -1525,12 +1565,7 @@ void AUDIO_IO_JACK_MANAGER::register_jack_ports(int client_id, int ports, const
     portdata->jackport = 0;
     portdata->autoconnect_string = "";
     portdata->total_latency = 0;
-    portdata->cb_buffer = new jack_default_audio_sample_t [cb_allocated_frames_rep];
 
-    std::map<string, int>::iterator it = port_numbers_rep.find(portprefix);
-    if (it == port_numbers_rep.end()) {
-      it = port_numbers_rep.insert(std::make_pair(portprefix, 0)).first;
-    }
     string tport = portprefix + "_" + kvu_numtostr(++it->second);
 
     if (node->aobj->io_mode() == AUDIO_IO::io_read) {
@@ -1539,7 +1574,6 @@ void AUDIO_IO_JACK_MANAGER::register_jack_ports(int client_id, int ports, const
 					      JACK_DEFAULT_AUDIO_TYPE, 
 					      JackPortIsInput, 
 					      0);
-      inports_rep.push_back(portdata);
     }
     else {
       portdata->jackport = jack_port_register(client_repp, 
@@ -1547,9 +1581,9 @@ void AUDIO_IO_JACK_MANAGER::register_jack_ports(int client_id, int ports, const
 					      JACK_DEFAULT_AUDIO_TYPE, 
 					      JackPortIsOutput, 
 					      0);
-      outports_rep.push_back(portdata);
     }
 
+    portvec->push_back(portdata);
     node->ports.push_back(portdata);
   }
 
@@ -1562,15 +1596,14 @@ void AUDIO_IO_JACK_MANAGER::register_jack_ports(int client_id, int ports, const
 /**
  * Unregisters all JACK ports for client 'client_id'.
  *
- * @pre list<int> l = get_object_list(); std::count(l.begin(), l.end(), client_id) == 1
+ * @pre has_node(client_id) == true
  * @pre is_open() == true
  * @post node->in_ports == 0 &&node->out_ports == 0
  */
 void AUDIO_IO_JACK_MANAGER::unregister_jack_ports(int client_id)
 {
   // ---
-  DBC_DECLARE(list<int> ol = get_object_list());
-  DBC_REQUIRE(std::count(ol.begin(), ol.end(), client_id) == 1);
+  DBC_REQUIRE(has_node(client_id) == true);
   DBC_REQUIRE(is_open() == true);
   DBC_DECLARE(unsigned int old_node_port_count = get_node(client_id)->ports.size());
   DBC_DECLARE(unsigned int old_port_count_vectors = inports_rep.size() + outports_rep.size());
@@ -1581,44 +1614,25 @@ void AUDIO_IO_JACK_MANAGER::unregister_jack_ports(int client_id)
 
   eca_jack_node_t* node = get_node(client_id);
 
-  list<eca_jack_port_data_t*>::iterator p = node->ports.begin();
+  /* 1. delete the ports from inports and outports vectors */
+  std::set<eca_jack_port_data_t*> removed (node->ports.begin(), node->ports.end());
+  eca_remove_jack_ports(&inports_rep, removed);
+  eca_remove_jack_ports(&outports_rep, removed);
+
+  vector<eca_jack_port_data_t*>::iterator p = node->ports.begin();
   while(p != node->ports.end()) {
-    /* 1. unregister port from JACK */
+    /* 2. unregister port from JACK */
     if (open_rep == true && (*p)->jackport != 0) {
       jack_port_unregister(client_repp, (*p)->jackport);
     }
 
-    /* 2. delete the port from inports and outports vectors */
-    vector<eca_jack_port_data_t*>::iterator q = inports_rep.begin();
-    while(q != inports_rep.end()) {
-      if (*p == *q) {
-	inports_rep.erase(q);
-	break;
-      }
-      ++q;
-    }
-    
-    q = outports_rep.begin();
-    while(q != outports_rep.end()) {
-      if (*p == *q) {
-	outports_rep.erase(q);
-	break;
-      }
-      ++q;
-    }
-    
-    /* 3. delete sub-structures */
-      
-    delete[] (*p)->cb_buffer;
-    (*p)->cb_buffer = 0;
-
-    /* 4. delete the actual port_data object */
+    /* 3. delete the actual port_data object */
     delete *p;
 
     ++p;
   }
 
-  /* 5. clear the whole node port list */
+  /* 4. clear the whole node port list */
   node->ports.clear();
 
   // ---
@@ -1694,20 +1708,30 @@ SAMPLE_SPECS::sample_rate_t AUDIO_IO_JACK_MANAGER::samples_per_second(void) cons
 }
 
 /**
- * context: J-E-C-level-3
+ * Copies samples of client 'client_id' ports to 
+ * 'target_buffer' (non-interleaved). Must only be called
+ * from within the process callback.
+ *
+ * context: J-level-3
  */
 long int AUDIO_IO_JACK_MANAGER::read_samples(int client_id, void* target_buffer, long int samples)
 {
   // DEBUG_CFLOW_STATEMENT(cerr << endl << "read_samples:" << client_id);
 
+  jack_nframes_t nframes = cycle_nframes_rep;
   jack_default_audio_sample_t* ptr = 
     static_cast<jack_default_audio_sample_t*>(target_buffer);
   eca_jack_node_t* node = get_node(client_id);
 
-  list<eca_jack_port_data*>::const_iterator p = node->ports.begin();
+  DBC_CHECK(nframes > 0);
+
+  vector<eca_jack_port_data*>::const_iterator p = node->ports.begin();
   while(p != node->ports.end()) {
-    if ((*p)->cb_buffer != 0) {
-      memcpy(ptr, (*p)->cb_buffer, buffersize_rep * sizeof(jack_default_audio_sample_t));
+    if ((*p)->jackport != 0) {
+      if (nframes > 0) 
+	memcpy(ptr, jack_port_get_buffer((*p)->jackport, nframes), buffersize_rep * sizeof(jack_default_audio_sample_t));
+      else
+	memset(ptr, 0, buffersize_rep * sizeof(jack_default_audio_sample_t));
       ptr += buffersize_rep;
     }
     ++p;
@@ -1717,24 +1741,35 @@ long int AUDIO_IO_JACK_MANAGER::read_samples(int client_id, void* target_buffer,
 }
 
 /**
- * context: J-E-C-level-3
+ * Copies samples from 'target_buffer' (non-interleaved) 
+ * to ports of client 'client_id'. Must only be called
+ * from within the process callback.
+ *
+ * context: J-level-3
  */
 void AUDIO_IO_JACK_MANAGER::write_samples(int client_id, void* target_buffer, long int samples)
 {
   // DEBUG_CFLOW_STATEMENT(cerr << endl << "write_samples:" << client_id);
   size_t sample_size = sizeof(jack_default_audio_sample_t);
   long int writesamples = (samples <= buffersize_rep) ? samples : buffersize_rep;
+  jack_nframes_t nframes = cycle_nframes_rep;
   jack_default_audio_sample_t* ptr =
     static_cast<jack_default_audio_sample_t*>(target_buffer);
 
+  DBC_CHECK(nframes > 0);
+  if (nframes == 0)
+    return;
+
   eca_jack_node_t* node = get_node(client_id);
-  list<eca_jack_port_data*>::const_iterator p = node->ports.begin();
+  vector<eca_jack_port_data*>::const_iterator p = node->ports.begin();
   while(p != node->ports.end()) {
-    if ((*p)->cb_buffer != 0) {
-      /* note: cb_buffer points to jack_default_audio_sample_t* */
-      memcpy((*p)->cb_buffer, ptr, writesamples * sample_size);
+    if ((*p)->jackport != 0) {
+      jack_default_audio_sample_t* out_buffer = 
+	static_cast<jack_default_audio_sample_t*>
+	(jack_port_get_buffer((*p)->jackport, nframes));
+      memcpy(out_buffer, ptr, writesamples * sample_size);
       ptr += writesamples;
-      memset((*p)->cb_buffer + writesamples,
+      memset(out_buffer + writesamples,
 	     0,
 	     (buffersize_rep - writesamples) * sample_size);
     }
@@ -1742,6 +1777,106 @@ void AUDIO_IO_JACK_MANAGER::write_samples(int client_id, void* target_buffer, lo
   }
 }
 
+/**
+ * Copies audio from ports of client 'client_id' directly
+ * to 'sbuf', one port per channel. Must only be called
+ * from within the process callback. Outside the callback,
+ * 'sbuf' is muted.
+ *
+ * Space for all ports and a full period must have been
+ * reserved in 'sbuf' before-hand (the engine does this
+ * when the chainsetup is connected), so that no memory
+ * is allocated here. If not, nothing is read and 'sbuf'
+ * is left empty.
+ *
+ * context: J-level-3
+ */
+void AUDIO_IO_JACK_MANAGER::read_buffer(int client_id, SAMPLE_BUFFER* sbuf)
+{
+  // --
+  DBC_CHECK(sizeof(SAMPLE_BUFFER::sample_t) == sizeof(jack_default_audio_sample_t));
+  // --
+
+  jack_nframes_t nframes = cycle_nframes_rep;
+  eca_jack_node_t* node = get_node(client_id);
+  SAMPLE_BUFFER::channel_size_t channels = node->ports.size();
+
+  DBC_CHECK(nframes > 0);
+  DBC_CHECK(sbuf->reserved_channels() >= channels);
+  DBC_CHECK(sbuf->reserved_length_in_samples() >= buffersize_rep);
+
+  if (sbuf->reserved_channels() < channels ||
+      sbuf->reserved_length_in_samples() < buffersize_rep) {
+    sbuf->length_in_samples(0);
+    return;
+  }
+
+  sbuf->number_of_channels(channels);
+  sbuf->length_in_samples(buffersize_rep);
+
+  if (nframes == 0) {
+    sbuf->make_silent();
+    return;
+  }
+
+  int ch = 0;
+  vector<eca_jack_port_data*>::const_iterator p = node->ports.begin();
+  while(p != node->ports.end()) {
+    SAMPLE_BUFFER::channel_span_t span = sbuf->channel_span(ch);
+    if ((*p)->jackport != 0) 
+      memcpy(span.data, 
+	     jack_port_get_buffer((*p)->jackport, nframes), 
+	     span.length * sizeof(jack_default_audio_sample_t));
+    else
+      memset(span.data, 0, span.length * sizeof(jack_default_audio_sample_t));
+    ++ch;
+    ++p;
+  }
+}
+
+/**
+ * Copies audio from 'sbuf' directly to ports of client 
+ * 'client_id', one channel per port. Ports without a 
+ * matching channel, and samples beyond the length of 
+ * 'sbuf', are muted. Must only be called from within the
+ * process callback.
+ *
+ * context: J-level-3
+ */
+void AUDIO_IO_JACK_MANAGER::write_buffer(int client_id, const SAMPLE_BUFFER* sbuf)
+{
+  // --
+  DBC_CHECK(sizeof(SAMPLE_BUFFER::sample_t) == sizeof(jack_default_audio_sample_t));
+  // --
+
+  size_t sample_size = sizeof(jack_default_audio_sample_t);
+  jack_nframes_t nframes = cycle_nframes_rep;
+  long int writesamples = (sbuf->length_in_samples() <= buffersize_rep) ? sbuf->length_in_samples() : buffersize_rep;
+
+  DBC_CHECK(nframes > 0);
+  if (nframes == 0)
+    return;
+
+  eca_jack_node_t* node = get_node(client_id);
+  int ch = 0;
+  vector<eca_jack_port_data*>::const_iterator p = node->ports.begin();
+  while(p != node->ports.end()) {
+    if ((*p)->jackport != 0) {
+      jack_default_audio_sample_t* out_buffer = 
+	static_cast<jack_default_audio_sample_t*>
+	(jack_port_get_buffer((*p)->jackport, nframes));
+      long int copied = 0;
+      if (ch < sbuf->number_of_channels()) {
+	memcpy(out_buffer, sbuf->const_channel_span(ch).data, writesamples * sample_size);
+	copied = writesamples;
+      }
+      memset(out_buffer + copied, 0, (buffersize_rep - copied) * sample_size);
+    }
+    ++ch;
+    ++p;
+  }
+}
+
 /**
  * Opens connection to the JACK server. Sets
  * is_open() to 'true' if connection is 
@@ -1769,7 +1904,7 @@ void AUDIO_IO_JACK_MANAGER::open_server_connection(void)
   if (n != AUDIO_IO_JACK_MANAGER::instance_limit) {
     srate_rep = static_cast<long int>(jack_get_sample_rate(client_repp));
     /* FIXME: add better control of allocated memory */
-    cb_allocated_frames_rep = buffersize_rep = static_cast<long int>(jack_get_buffer_size(client_repp));
+    buffersize_rep = static_cast<long int>(jack_get_buffer_size(client_repp));
     shutdown_request_rep = false;
     jackslave_seekahead_rep = 4096 / buffersize_rep + 1;
 
@@ -1879,9 +2014,9 @@ void AUDIO_IO_JACK_MANAGER::get_total_port_latency(jack_client_t* client, eca_ja
  */
 void AUDIO_IO_JACK_MANAGER::set_node_connection(eca_jack_node_t* node, bool connect)
 {
-  list<eca_jack_port_data*>::iterator p = node->ports.begin();
+  vector<eca_jack_port_data*>::iterator p = node->ports.begin();
   while(p != node->ports.end()) {
-    if ((*p)->cb_buffer != 0) {
+    if ((*p)->jackport != 0) {
       string ecaport = (*p)->autoconnect_string;
       if (ecaport.size() > 0) {
 	string jackport (jack_port_name((*p)->jackport));
@@ -1904,9 +2039,6 @@ void AUDIO_IO_JACK_MANAGER::set_node_connection(eca_jack_node_t* node, bool conn
 			"Error! Cannot make connection " + 
 			*fromport + " -> " + *toport + ".");
 	  }
-	  else {
-	    AUDIO_IO_JACK_MANAGER::get_total_port_latency(client_repp, *p, node->aobj->io_mode());
-	  }
 	}
 	else {
 	  ECA_LOG_MSG(ECA_LOGGER::system_objects, "jack_port_disconnect()");
@@ -1927,7 +2059,10 @@ void AUDIO_IO_JACK_MANAGER::set_node_connection(eca_jack_node_t* node, bool conn
 }
 
 /**
- * Connects ports of all registered nodes.
+ * Connects ports of all registered nodes. Port latencies 
+ * are fetched once all connections have been made, as 
+ * each new connection may change the latency of 
+ * previously connected ports.
  *
  * @see set_node_connection()
  *
@@ -1936,10 +2071,20 @@ void AUDIO_IO_JACK_MANAGER::set_node_connection(eca_jack_node_t* node, bool conn
 void AUDIO_IO_JACK_MANAGER::connect_all_nodes(void)
 { 
   if (shutdown_request_rep != true) {
-    list<eca_jack_node_t*>::iterator p = node_list_rep.begin();
-    while(p != node_list_rep.end()) {
-      set_node_connection(*p, true);
-      ++p;
+    for(size_t n = 0; n < nodes_rep.size(); n++) {
+      if (nodes_rep[n] != 0) 
+	set_node_connection(nodes_rep[n], true);
+    }
+
+    for(size_t n = 0; n < nodes_rep.size(); n++) {
+      eca_jack_node_t* node = nodes_rep[n];
+      if (node == 0) continue;
+      for(size_t m = 0; m < node->ports.size(); m++) {
+	if (node->ports[m]->jackport != 0 &&
+	    jack_port_connected(node->ports[m]->jackport) > 0) {
+	  AUDIO_IO_JACK_MANAGER::get_total_port_latency(client_repp, node->ports[m], node->aobj->io_mode());
+	}
+      }
     }
   }
   else {
@@ -1956,10 +2101,9 @@ void AUDIO_IO_JACK_MANAGER::connect_all_nodes(void)
  */
 void AUDIO_IO_JACK_MANAGER::disconnect_all_nodes(void)
 {
-  list<eca_jack_node_t*>::iterator p = node_list_rep.begin();
-  while(p != node_list_rep.end()) {
-    set_node_connection(*p, false);
-    ++p;
+  for(size_t n = 0; n < nodes_rep.size(); n++) {
+    if (nodes_rep[n] != 0) 
+      set_node_connection(nodes_rep[n], false);
   }
 }
 
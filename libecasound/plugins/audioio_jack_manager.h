@@ -9,13 +9,17 @@
 #include <pthread.h>
 #include <jack/jack.h>
 
+#include <kvu_spsc_queue.h>
+
 #include "sample-specs.h"
 #include "dynamic-object.h"
 #include "audioio-manager.h"
+#include "eca-engine.h"
 #include "eca-engine-driver.h"
 #include "audioio_jack.h"
 
 class AUDIO_IO;
+class SAMPLE_BUFFER;
 
 using std::list;
 using std::string;
@@ -24,6 +28,17 @@ using std::vector;
 /**
  * Manager class for JACK client objects.
  *
+ * Engine commands that can be executed in realtime context
+ * (see ECA_ENGINE::is_realtime_command()) are passed from 
+ * exec() to the JACK process callback via a wait-free 
+ * queue, and executed at the start of the next cycle. Other
+ * commands are executed by exec() with 'engine_mod_lock_rep'
+ * held, during which the callback outputs silence.
+ *
+ * Client nodes are stored in a table indexed by client id,
+ * so per-cycle lookups do not depend on the number of 
+ * objects.
+ *
  * Related design patterns:
  *     - Mediator (GoF273)
  *
@@ -55,13 +70,12 @@ public:
     jack_port_t* jackport;
     string autoconnect_string;
     jack_nframes_t total_latency;
-    jack_default_audio_sample_t* cb_buffer;
   } eca_jack_port_data_t;
 
   typedef struct eca_jack_node {
     AUDIO_IO_JACK* aobj;
     AUDIO_IO* origptr;
-    list<eca_jack_port_data*> ports;
+    vector<eca_jack_port_data*> ports;
     int client_id;
   } eca_jack_node_t;
 
@@ -147,6 +161,8 @@ public:
   
   long int read_samples(int client_id, void* target_buffer, long int samples);
   void write_samples(int client_id, void* target_buffer, long int samples);
+  void read_buffer(int client_id, SAMPLE_BUFFER* sbuf);
+  void write_buffer(int client_id, const SAMPLE_BUFFER* sbuf);
 
   bool is_open(void) const { return(open_rep); }
   bool is_connection_active(void) const { return(activated_rep); }
@@ -180,6 +196,10 @@ private:
   void connect_all_nodes(void);
   void disconnect_all_nodes(void);
   eca_jack_node_t* get_node(int client_id);
+  bool has_node(int client_id) const;
+
+  void dispatch_commands(void);
+  void execute_realtime_commands(void);
 
   void wait_for_exit(void);
   void signal_exit(void);
@@ -191,6 +211,8 @@ private:
   pthread_cond_t stop_cond_rep;
   pthread_mutex_t stop_mutex_rep;
   pthread_mutex_t engine_mod_lock_rep;
+  SPSC_QUEUE_RT_C<ECA_ENGINE::complex_command_t> rt_commands_rep;  /**< exec->callback commands; 
+								       consumed with engine_mod_lock_rep held */
 
   Operation_mode_t mode_rep;
 
@@ -207,7 +229,8 @@ private:
   int j_stopped_rounds_rep;   /**< number of iterations that JACK state has been stopped;
 				   accessed only from proces thread */
 
-  list<eca_jack_node_t*> node_list_rep;
+  vector<eca_jack_node_t*> nodes_rep;           /**< indexed by client id, 0 if unregistered */
+  std::map<const AUDIO_IO*, int> object_ids_rep; /**< client ids of registered objects */
   vector<eca_jack_port_data_t*> inports_rep;
   vector<eca_jack_port_data_t*> outports_rep;
 
@@ -222,7 +245,8 @@ private:
 
   SAMPLE_SPECS::sample_rate_t srate_rep;
   long int buffersize_rep;
-  long int cb_allocated_frames_rep;
+  jack_nframes_t cycle_nframes_rep;   /**< length of the current process cycle, 
+					   0 outside the process callback */
 };
 
 #endif
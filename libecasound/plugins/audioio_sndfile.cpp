@@ -33,6 +33,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 
 #include <kvu_message_item.h>
@@ -150,6 +151,27 @@ std::list<std::string> SNDFILE_INTERFACE::supported_extensions(void) const
   return exts;
 }
 
+/**
+ * Whether the libsndfile major format 'format' (for 
+ * instance SF_FORMAT_OGG) is supported by the library.
+ */
+bool SNDFILE_INTERFACE::supports_major_format(int format) const
+{
+  int i, count;
+  SF_FORMAT_INFO format_info;
+
+  sf_command (0, SFC_GET_FORMAT_MAJOR_COUNT, &count, sizeof (int));
+
+  for (i = 0 ; i < count ; i++) {
+    format_info.format = i;
+    sf_command (0, SFC_GET_FORMAT_MAJOR, &format_info, sizeof (format_info)) ;
+    if (format_info.format == format)
+      return true;
+  }
+
+  return false;
+}
+
 /**
  * Discovers a matching libsndfile file format for the filename
  * 'fname'. The filename extension is used to find a matching
@@ -171,6 +193,16 @@ int SNDFILE_INTERFACE::find_file_format(const std::string& fname)
               string("Searching for fileformat matching extension '") +
               fext + "'.");
 
+  /* note: libsndfile lists Ogg and MPEG audio with
+   *       extensions 'oga' and 'm1a' */
+  if (fext == "ogg" && supports_major_format(SF_FORMAT_OGG) == true)
+    return SF_FORMAT_OGG;
+#if HAVE_DECL_SF_FORMAT_MPEG
+  if ((fext == "mp3" || fext == "mp2") &&
+      supports_major_format(SF_FORMAT_MPEG) == true)
+    return SF_FORMAT_MPEG;
+#endif
+
   sf_command (0, SFC_GET_FORMAT_MAJOR_COUNT, &count, sizeof (int));
   
   for (i = 0 ; i < count ; i++) {
@@ -195,6 +227,55 @@ int SNDFILE_INTERFACE::find_file_format(const std::string& fname)
   return file_format;
 }
 
+/**
+ * Returns the libsndfile compression level that gives
+ * a constant bitrate of 'kbps' for MPEG layer III at
+ * sample rate 'srate', or -1 if not in the valid range.
+ *
+ * Note: libsndfile maps the compression level linearly
+ *       to the bitrate range of the MPEG version used
+ *       at 'srate'
+ */
+static double priv_mpeg_compression_level(long int kbps, long int srate)
+{
+  double max = 64.0, min = 8.0;
+  if (srate >= 32000) { max = 320.0; min = 32.0; }
+  else if (srate >= 16000) { max = 160.0; min = 8.0; }
+
+  if (kbps < min || kbps > max)
+    return -1.0;
+
+  return (max - kbps) / (max - min);
+}
+
+/**
+ * Returns the libsndfile compression level of the Ogg 
+ * Vorbis quality whose nominal bitrate (for 44.1kHz
+ * stereo) is closest to 'kbps', or -1 if not in the
+ * valid range.
+ *
+ * Note: libsndfile sets the Vorbis quality to 
+ *       one minus the compression level
+ */
+static double priv_vorbis_compression_level(long int kbps)
+{
+  /* note: nominal bitrates of quality levels 0...10 */
+  static const long int nominal[] = 
+    { 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 500 };
+  static const int levels = sizeof(nominal) / sizeof(nominal[0]);
+
+  if (kbps < nominal[0] || kbps > nominal[levels - 1])
+    return -1.0;
+
+  int q = 0;
+  for(int n = 1; n < levels; n++) {
+    if (std::labs(nominal[n] - kbps) < std::labs(nominal[q] - kbps))
+      q = n;
+  }
+
+  return 1.0 - q / 10.0;
+}
+
 void SNDFILE_INTERFACE::open(void) throw(AUDIO_IO::SETUP_ERROR&)
 {
   SF_INFO sfinfo;
@@ -239,7 +320,17 @@ void SNDFILE_INTERFACE::open(void) throw(AUDIO_IO::SETUP_ERROR&)
 
     file_format = find_file_format(mod_filename);    
     
-    if (format_string()[0] == 'u' && bits() == 8)
+    if ((file_format & SF_FORMAT_TYPEMASK) == SF_FORMAT_OGG) {
+      /* note: compressed formats have a fixed subtype, and 
+       *       are encoded from floating point samples */
+      file_format |= SF_FORMAT_VORBIS;
+    }
+#if HAVE_DECL_SF_FORMAT_MPEG
+    else if ((file_format & SF_FORMAT_TYPEMASK) == SF_FORMAT_MPEG) {
+      file_format |= SF_FORMAT_MPEG_LAYER_III;
+    }
+#endif
+    else if (format_string()[0] == 'u' && bits() == 8)
       file_format |= SF_FORMAT_PCM_S8;
     else if (format_string()[0] == 's') {
       if (bits() == 8) { file_format |= SF_FORMAT_PCM_S8; }
@@ -260,7 +351,15 @@ void SNDFILE_INTERFACE::open(void) throw(AUDIO_IO::SETUP_ERROR&)
     }
 
     // set endianess
-    if (sample_endianess() == se_little) {
+    if ((file_format & SF_FORMAT_SUBMASK) == SF_FORMAT_VORBIS) {
+      /* no endianess for compressed formats */
+    }
+#if HAVE_DECL_SF_FORMAT_MPEG
+    else if ((file_format & SF_FORMAT_SUBMASK) == SF_FORMAT_MPEG_LAYER_III) {
+      /* no endianess for compressed formats */
+    }
+#endif
+    else if (sample_endianess() == se_little) {
       file_format |= SF_ENDIAN_LITTLE;
     }
     else if (sample_endianess() == se_big) {
@@ -282,6 +381,7 @@ void SNDFILE_INTERFACE::open(void) throw(AUDIO_IO::SETUP_ERROR&)
         throw(SETUP_ERROR(SETUP_ERROR::io_mode, "AUDIOIO-SNDFILE: Can't open file \"" + real_filename
                           + "\" for writing."));
       }
+      set_output_bitrate(file_format);
     }
     else if (io_mode() == io_read) {
       ECA_LOG_MSG(ECA_LOGGER::info, "Using libsndfile to open file \"" +
@@ -316,6 +416,7 @@ void SNDFILE_INTERFACE::open(void) throw(AUDIO_IO::SETUP_ERROR&)
         else {
           set_io_mode(io_write);
           open_parse_info(&sfinfo);
+          set_output_bitrate(file_format);
         }
       }
       else {
@@ -331,6 +432,56 @@ void SNDFILE_INTERFACE::open(void) throw(AUDIO_IO::SETUP_ERROR&)
   AUDIO_IO::open();
 }
 
+/**
+ * Sets the bitrate of a compressed file opened for 
+ * writing. With a filename as the label, the second 
+ * parameter is the bitrate in kbps, as with the forked
+ * mp3 and ogg objects (for example '-o:foo.mp3,192').
+ *
+ * MP3 files are encoded at a constant bitrate. Ogg
+ * Vorbis files are encoded with a variable bitrate, at
+ * the quality with the closest nominal bitrate.
+ */
+void SNDFILE_INTERFACE::set_output_bitrate(int file_format) throw(AUDIO_IO::SETUP_ERROR&)
+{
+  if (label() == "sndfile" || opt_filename_rep.empty() == true)
+    return;
+
+  int subtype = file_format & SF_FORMAT_SUBMASK;
+  long int kbps = std::atol(opt_filename_rep.c_str());
+  double level = -1.0;
+
+  if (subtype == SF_FORMAT_VORBIS) {
+    level = priv_vorbis_compression_level(kbps);
+  }
+#if HAVE_DECL_SF_FORMAT_MPEG
+  else if (subtype == SF_FORMAT_MPEG_LAYER_III) {
+    /* note: libsndfile does not report success of setting
+     *       the bitrate mode consistently, so the mode
+     *       is read back */
+    int mode = SF_BITRATE_MODE_CONSTANT;
+    sf_command(snd_repp, SFC_SET_BITRATE_MODE, &mode, sizeof(mode));
+    if (sf_command(snd_repp, SFC_GET_BITRATE_MODE, 0, 0) == SF_BITRATE_MODE_CONSTANT)
+      level = priv_mpeg_compression_level(kbps, samples_per_second());
+  }
+#endif
+  else {
+    /* note: other formats have no bitrate */
+    return;
+  }
+
+  if (level < 0.0 ||
+      sf_command(snd_repp, SFC_SET_COMPRESSION_LEVEL, &level, sizeof(level)) != SF_TRUE) {
+    sf_close(snd_repp);
+    snd_repp = 0;
+    throw(SETUP_ERROR(SETUP_ERROR::unexpected, "AUDIOIO-SNDFILE: Bitrate \"" + opt_filename_rep
+                      + "\" not supported for file \"" + label() + "\"."));
+  }
+
+  ECA_LOG_MSG(ECA_LOGGER::user_objects, 
+              "Encoding \"" + label() + "\" at " + kvu_numtostr(kbps) + " kbps.");
+}
+
 void SNDFILE_INTERFACE::close(void)
 {
   if (is_open() == true) {
@@ -90,6 +90,7 @@ class SNDFILE_INTERFACE : public AUDIO_IO_BUFFERED {
   /*@{*/
 
   std::list<std::string> supported_extensions(void) const;
+  bool supports_major_format(int format) const;
 
   /*@}*/
     
@@ -104,6 +105,7 @@ private:
   bool seek_supported_rep;
 
   void open_parse_info(const SF_INFO* sfinfo) throw(AUDIO_IO::SETUP_ERROR&);
+  void set_output_bitrate(int file_format) throw(AUDIO_IO::SETUP_ERROR&);
   int find_file_format(const std::string& filename);
 
   SNDFILE_INTERFACE& operator=(const SNDFILE_INTERFACE& x) { return *this; }
@@ -32,6 +32,7 @@
 #endif
 
 #include <iostream>
+#include <algorithm>
 #include <vector>
 
 #include <cmath>    /* ceil(), floor() */
@@ -56,6 +57,7 @@ extern "C" {
 #include "eca-sample-conversion.h"
 #include "samplebuffer.h"
 #include "samplebuffer_impl.h"
+#include "samplebuffer_kernels.h"
 #include "eca-logger.h"
 
 /* Debug resampling operations */ 
@@ -67,32 +69,49 @@ extern "C" {
 #define DEBUG_RESAMPLING_STATEMENT(x) ((void)0)
 #endif
 
-#ifdef WORDS_BIGENDIAN
-static const bool is_system_littleendian = false;
-#else
-static const bool is_system_littleendian = true;
-#endif
-
 using namespace std;
 
+/* note: set when the first buffer is created */
+static const SAMPLE_BUFFER_KERNELS* priv_kernels = 0;
+
+/* note: channel length is rounded up to a multiple of this, 
+ *       so that all channels start at an aligned address */
+static const SAMPLE_BUFFER::buf_size_t priv_align_samples = 
+  SAMPLE_BUFFER_POOL::alignment / sizeof(SAMPLE_SPECS::sample_t);
+
 static void priv_alloc_sample_buf(SAMPLE_SPECS::sample_t **memptr, size_t size)
 {
 #ifdef HAVE_POSIX_MEMALIGN
-  /* align buffers to 128bit/16octet boundary */
-  posix_memalign(reinterpret_cast<void**>(memptr), 16, size);
+  /* align buffers to cache line boundary */
+  if (posix_memalign(reinterpret_cast<void**>(memptr), SAMPLE_BUFFER_POOL::alignment, size) != 0)
+    *memptr = 0;
 #else
   *memptr = reinterpret_cast<SAMPLE_SPECS::sample_t*>(malloc(size));
 #endif
 
 }
 
+/**
+ * Makes sure the buffer owns its audio data before
+ * the data is modified. If 'keep_content' is false, 
+ * caller will overwrite the contents and the shared
+ * data is not copied.
+ *
+ * @see share_content()
+ */
+inline void SAMPLE_BUFFER::make_writable(bool keep_content)
+{
+  if (impl_repp->shared_source_repp != 0)
+    release_shared_content(keep_content);
+}
+
 /**
  * Constructs a new sample buffer object.
  */
 SAMPLE_BUFFER::SAMPLE_BUFFER (buf_size_t buffersize, channel_size_t channels)
   : channel_count_rep(channels),
     buffersize_rep(buffersize),
-    reserved_samples_rep(buffersize) 
+    reserved_samples_rep(0) 
 {
   // ---
   DBC_REQUIRE(buffersize >= 0);
@@ -106,16 +125,19 @@ SAMPLE_BUFFER::SAMPLE_BUFFER (buf_size_t buffersize, channel_size_t channels)
 
   impl_repp = new SAMPLE_BUFFER_impl;
 
-  buffer.resize(channels);
-  for(size_t n = 0; n < buffer.size(); n++) {
-    priv_alloc_sample_buf(&buffer[n], 
-			  sizeof(sample_t) * reserved_samples_rep);
-  }
-  make_silent();
-
   impl_repp->rt_lock_rep = false;
-  impl_repp->lockref_rep = 0;
+  impl_repp->lockref_rep.set(0);
   impl_repp->old_buffer_repp = 0;
+  impl_repp->shared_source_repp = 0;
+  impl_repp->shared_channels_rep = 0;
+  impl_repp->slab_repp = 0;
+  impl_repp->slab_pool_repp = 0;
+  impl_repp->pool_repp = 0;
+  impl_repp->event_tags_rep = 0;
+
+  reallocate_storage(channels, buffersize);
+
+  make_silent();
 #ifdef ECA_COMPILE_SAMPLERATE
   impl_repp->quality_rep = 50;
   impl_repp->src_state_rep.resize(channels);
@@ -126,6 +148,7 @@ SAMPLE_BUFFER::SAMPLE_BUFFER (buf_size_t buffersize, channel_size_t channels)
 #ifdef ECA_USE_LIBOIL
   oil_init();
 #endif
+  priv_kernels = SAMPLE_BUFFER_KERNELS::active();
  
   ECA_LOG_MSG(ECA_LOGGER::functions, 
 		"Buffer created, channels: " +
@@ -142,14 +165,11 @@ SAMPLE_BUFFER::SAMPLE_BUFFER (buf_size_t buffersize, channel_size_t channels)
  */
 SAMPLE_BUFFER::~SAMPLE_BUFFER (void)
 {
-  DBC_CHECK(impl_repp->lockref_rep == 0);
+  DBC_CHECK(impl_repp->lockref_rep.get() == 0);
 
-  for(size_t n = 0; n < buffer.size(); n++) {
-    if (buffer[n] != 0) {
-      ::free(buffer[n]);
-      buffer[n] = 0;
-    }
-  }
+  make_writable(false);
+
+  release_storage();
 
   if (impl_repp->old_buffer_repp != 0) {
     ::free(impl_repp->old_buffer_repp);
@@ -173,12 +193,15 @@ SAMPLE_BUFFER::~SAMPLE_BUFFER (void)
  * Only channels, that are present in both source and destination, are 
  * modified.
  *
- * Note: event tags are not copied!
+ * Note: event tags are not copied! Tag 'tag_silent'
+ * is cleared if 'x' is not silent.
  * 
  * @post length_in_samples() >= x.length_in_samples()
  */
 void SAMPLE_BUFFER::add_matching_channels(const SAMPLE_BUFFER& x)
 {
+  make_writable();
+
 #ifdef ECA_USE_LIBOIL 
   if (x.length_in_samples() > length_in_samples()) {
     length_in_samples(x.length_in_samples());
@@ -191,8 +214,17 @@ void SAMPLE_BUFFER::add_matching_channels(const SAMPLE_BUFFER& x)
 		x.length_in_samples());
   }
 #else
-  add_matching_channels_ref(x);
+  if (x.length_in_samples() > length_in_samples()) {
+    length_in_samples(x.length_in_samples());
+  }
+  int min_c_count = (channel_count_rep <= x.channel_count_rep) ? channel_count_rep : x.channel_count_rep;
+  for(channel_size_t q = 0; q < min_c_count; q++) {
+    priv_kernels->add(buffer[q], x.buffer[q], x.length_in_samples());
+  }
 #endif
+
+  if (x.event_tag_test(tag_silent) != true)
+    event_tag_set(tag_silent, false);
 }
 
 /**
@@ -200,6 +232,8 @@ void SAMPLE_BUFFER::add_matching_channels(const SAMPLE_BUFFER& x)
  */
 void SAMPLE_BUFFER::add_matching_channels_ref(const SAMPLE_BUFFER& x)
 {
+  make_writable();
+
   if (x.length_in_samples() > length_in_samples()) {
     length_in_samples(x.length_in_samples());
   }
@@ -209,6 +243,9 @@ void SAMPLE_BUFFER::add_matching_channels_ref(const SAMPLE_BUFFER& x)
       buffer[q][t] += x.buffer[q][t];
     }
   }
+
+  if (x.event_tag_test(tag_silent) != true)
+    event_tag_set(tag_silent, false);
 }
 
 /**
@@ -217,7 +254,8 @@ void SAMPLE_BUFFER::add_matching_channels_ref(const SAMPLE_BUFFER& x)
  * Only channels, that are present in both source and destination, are 
  * modified.
  *
- * Note: event tags are not copied!
+ * Note: event tags are not copied! Tag 'tag_silent'
+ * is cleared if 'x' is not silent.
  * 
  * @pre weight != 0
  * @post length_in_samples() >= x.length_in_samples()
@@ -228,29 +266,61 @@ void SAMPLE_BUFFER::add_with_weight(const SAMPLE_BUFFER& x, int weight)
   DBC_REQUIRE(weight != 0);
   // ---
 
-  /* note: gcc does a suprisingly good job for this function,
-   *       so additional optimizations don't seem worthwhile */
+  make_writable();
 
   if (x.length_in_samples() > length_in_samples()) {
     length_in_samples(x.length_in_samples());
   }
+  sample_t factor = 1.0f / weight;
+  int min_c_count = (channel_count_rep <= x.channel_count_rep) ? channel_count_rep : x.channel_count_rep;
+  for(channel_size_t q = 0; q < min_c_count; q++) {
+    priv_kernels->add_scaled(buffer[q], x.buffer[q], factor, x.length_in_samples());
+  }
+
+  if (x.event_tag_test(tag_silent) != true)
+    event_tag_set(tag_silent, false);
+}
+
+/**
+ * Unoptimized version of add_with_weight().
+ */
+void SAMPLE_BUFFER::add_with_weight_ref(const SAMPLE_BUFFER& x, int weight)
+{
+  // ---
+  DBC_REQUIRE(weight != 0);
+  // ---
+
+  make_writable();
+
+  if (x.length_in_samples() > length_in_samples()) {
+    length_in_samples(x.length_in_samples());
+  }
+  /* note: multiply with the reciprocal explicitly, as 
+   *       the compiler may do so anyway with -ffast-math */
+  sample_t factor = 1.0f / weight;
   int min_c_count = (channel_count_rep <= x.channel_count_rep) ? channel_count_rep : x.channel_count_rep;
   for(channel_size_t q = 0; q < min_c_count; q++) {
     for(buf_size_t t = 0; t < x.length_in_samples(); t++) {
-      buffer[q][t] += (x.buffer[q][t] / weight);
+      buffer[q][t] += (x.buffer[q][t] * factor);
     }
   }
+
+  if (x.event_tag_test(tag_silent) != true)
+    event_tag_set(tag_silent, false);
 }
 
 /**
  * Channel-wise copy. Buffer length is adjusted if necessary.
  *
- * Note: event tags are not copied!
+ * Note: event tags are not copied! Tag 'tag_silent'
+ * is updated to match the result.
  * 
  * @post length_in_samples() == x.length_in_samples()
  */
 void SAMPLE_BUFFER::copy_matching_channels(const SAMPLE_BUFFER& x)
 {
+  make_writable();
+
   length_in_samples(x.length_in_samples());
   
   int min_c_count = (channel_count_rep <= x.channel_count_rep) ? channel_count_rep : x.channel_count_rep;
@@ -265,6 +335,12 @@ void SAMPLE_BUFFER::copy_matching_channels(const SAMPLE_BUFFER& x)
      * }
      */ 
   }
+
+  /* note: channels not present in 'x' are left untouched */
+  event_tag_set(tag_silent,
+		x.event_tag_test(tag_silent) == true &&
+		(event_tag_test(tag_silent) == true ||
+		 channel_count_rep <= x.channel_count_rep));
 }
 
 /**
@@ -277,6 +353,8 @@ void SAMPLE_BUFFER::copy_matching_channels(const SAMPLE_BUFFER& x)
  */
 void SAMPLE_BUFFER::copy_all_content(const SAMPLE_BUFFER& x)
 {
+  make_writable(false);
+
   length_in_samples(x.length_in_samples());
   number_of_channels(x.number_of_channels());
   
@@ -296,13 +374,130 @@ void SAMPLE_BUFFER::copy_all_content(const SAMPLE_BUFFER& x)
   event_tags_set(x);
 }
 
+/**
+ * Makes the buffer share audio content of 'x' without
+ * copying it. After the call, length, channel count and
+ * event tag set match to those of 'x', exactly as with
+ * copy_all_content().
+ *
+ * The data is copied (copy-on-write) when the buffer is
+ * next modified, or when a pointer reflock is taken 
+ * with get_pointer_reflock(). Contents of 'x' must not
+ * be modified while they are shared. Sharing can be
+ * ended explicitly with unshare_content().
+ *
+ * A pointer reflock is held on 'x' for as long as 
+ * the data is shared.
+ * 
+ * If the buffer cannot share data with 'x' (pointer
+ * reflock held, 'x' is itself sharing data, or space 
+ * reserved for the buffer is smaller than 'x'),
+ * contents are copied with copy_all_content().
+ *
+ * Realtime-safe if copy_all_content() would be.
+ *
+ * @pre &x != this
+ * @post length_in_samples() == x.length_in_samples()
+ * @post number_of_channels() == number_of_channels()
+ * @post for all I: event_tag_test(I) == x.event_tag_test(I)
+ */
+void SAMPLE_BUFFER::share_content(const SAMPLE_BUFFER& x)
+{
+  // ---
+  DBC_REQUIRE(&x != this);
+  // ---
+
+  make_writable(false);
+
+  if (impl_repp->lockref_rep.get() > 0 ||
+      x.is_content_shared() == true ||
+      x.channel_count_rep > static_cast<channel_size_t>(buffer.size()) ||
+      x.buffersize_rep > reserved_samples_rep) {
+    copy_all_content(x);
+    return;
+  }
+
+  for(channel_size_t q = 0; q < x.channel_count_rep; q++) {
+    buffer[q] = x.buffer[q];
+  }
+
+  x.impl_repp->lockref_rep.add(1);
+  impl_repp->shared_source_repp = &x;
+  impl_repp->shared_channels_rep = x.channel_count_rep;
+
+  channel_count_rep = x.channel_count_rep;
+  buffersize_rep = x.buffersize_rep;
+
+  event_tags_set(x);
+
+  // ---
+  DBC_ENSURE(is_content_shared() == true);
+  // ---
+}
+
+/**
+ * Ends copy-on-write sharing started with share_content().
+ * Shared audio data is copied to buffer's own storage.
+ * Does nothing if data is not shared.
+ *
+ * Realtime-safe.
+ *
+ * @post is_content_shared() != true
+ */
+void SAMPLE_BUFFER::unshare_content(void)
+{
+  make_writable();
+
+  // ---
+  DBC_ENSURE(is_content_shared() != true);
+  // ---
+}
+
+/**
+ * Whether the buffer shares its audio data with
+ * another buffer.
+ * 
+ * @see share_content()
+ */
+bool SAMPLE_BUFFER::is_content_shared(void) const
+{
+  return impl_repp->shared_source_repp != 0;
+}
+
+/**
+ * Restores buffer's own storage and releases the 
+ * reflock held on the shared source buffer. If 
+ * 'keep_content' is true, shared data is copied
+ * to own storage.
+ *
+ * Note: may be called concurrently for buffers sharing
+ *       the same source
+ */
+void SAMPLE_BUFFER::release_shared_content(bool keep_content)
+{
+  for(channel_size_t q = 0; q < impl_repp->shared_channels_rep; q++) {
+    sample_t* shared = buffer[q];
+    buffer[q] = impl_repp->slab_repp + q * reserved_samples_rep;
+    if (keep_content == true && q < channel_count_rep) {
+      std::memcpy(buffer[q], 
+		  shared,
+		  sizeof(sample_t) * buffersize_rep);
+    }
+  }
+
+  impl_repp->shared_source_repp->impl_repp->lockref_rep.add(-1);
+  impl_repp->shared_source_repp = 0;
+  impl_repp->shared_channels_rep = 0;
+}
+
 /**
  * Ranged channel-wise copy. Copies samples in range 
  * 'start_pos' - 'end_pos-1' from buffer 'x' to current 
  * buffer position 'to_pos'. The 'src' object must have
  * equal number of channels as the current object.
  *
- * Note: event tags are not copied!
+ * Note: event tags are not copied! Tag 'tag_silent'
+ * is cleared if 'x' is not silent.
  * 
  * @pre start_pos <= end_pos
  * @pre 
@@ -319,6 +514,8 @@ void SAMPLE_BUFFER::copy_range(const SAMPLE_BUFFER& src,
   DBC_REQUIRE(number_of_channels() == src.number_of_channels());
   // ---
 
+  make_writable();
+
   if (src_end_pos > src.length_in_samples())
     src_end_pos = src.length_in_samples();
 
@@ -339,17 +536,22 @@ void SAMPLE_BUFFER::copy_range(const SAMPLE_BUFFER& src,
 #endif
     }
   }
+
+  if (src.event_tag_test(tag_silent) != true)
+    event_tag_set(tag_silent, false);
 }
 
 void SAMPLE_BUFFER::multiply_by(SAMPLE_BUFFER::sample_t factor, int channel)
 {
+  make_writable();
+
 #ifdef ECA_USE_LIBOIL 
   oil_scalarmultiply_f32_ns(reinterpret_cast<float*>(buffer[channel]), 
 			    reinterpret_cast<const float*>(buffer[channel]), 
 			    reinterpret_cast<const float*>(&factor), 
 			    buffersize_rep);
 #else
-  multiply_by_ref(factor, channel);
+  priv_kernels->multiply(buffer[channel], factor, buffersize_rep);
 #endif
 }
 
@@ -362,6 +564,8 @@ void SAMPLE_BUFFER::multiply_by(SAMPLE_BUFFER::sample_t factor)
 
 void SAMPLE_BUFFER::multiply_by_ref(SAMPLE_BUFFER::sample_t factor)
 {
+  make_writable();
+
   for(channel_size_t n = 0; n < channel_count_rep; n++) {
     for(buf_size_t m = 0; m < buffersize_rep; m++) {
       buffer[n][m] *= factor;
@@ -371,6 +575,8 @@ void SAMPLE_BUFFER::multiply_by_ref(SAMPLE_BUFFER::sample_t factor)
 
 void SAMPLE_BUFFER::multiply_by_ref(SAMPLE_BUFFER::sample_t factor, int channel)
 {
+  make_writable();
+
   for(buf_size_t m = 0; m < buffersize_rep; m++) {
     buffer[channel][m] *= factor;
   }
@@ -409,6 +615,8 @@ void SAMPLE_BUFFER::make_silent(int channel)
   DBC_REQUIRE(channel >= 0);
   DBC_REQUIRE(channel < number_of_channels());
 
+  make_writable();
+
   std::memset(buffer[channel], 0, buffersize_rep * sizeof(SAMPLE_SPECS::silent_value));
 
   /* - the generic version: */
@@ -424,6 +632,8 @@ void SAMPLE_BUFFER::make_silent(int channel)
  */
 void SAMPLE_BUFFER::make_silent_ref(int channel)
 {
+  make_writable();
+
   for(buf_size_t s = 0; s < buffersize_rep; s++) {
     buffer[channel][s] = SAMPLE_SPECS::silent_value;
   }
@@ -434,9 +644,43 @@ void SAMPLE_BUFFER::make_silent_ref(int channel)
  */
 void SAMPLE_BUFFER::make_silent(void)
 {
+  make_writable(false);
+
   for(channel_size_t n = 0; n < channel_count_rep; n++) {
     make_silent(n);
   }
+
+  event_tag_set(tag_silent);
+}
+
+/**
+ * Whether all samples of the buffer are zero. Unlike
+ * testing the 'tag_silent' event tag, this examines
+ * the sample data, so it can be used to set the tag
+ * for data written directly to the buffer.
+ *
+ * Realtime-safe.
+ */
+bool SAMPLE_BUFFER::is_silent(void) const
+{
+  for(channel_size_t q = 0; q < channel_count_rep; q++) {
+    const sample_t* data = buffer[q];
+    buf_size_t t = 0;
+    while(t < buffersize_rep) {
+      /* note: samples are checked in blocks, without 
+       *       branching per sample */
+      buf_size_t end = t + 64;
+      if (end > buffersize_rep)
+	end = buffersize_rep;
+      bool nonzero = false;
+      for(; t < end; t++) {
+	nonzero |= (data[t] != SAMPLE_SPECS::silent_value);
+      }
+      if (nonzero == true)
+	return false;
+    }
+  }
+  return true;
 }
 
 /**
@@ -452,11 +696,19 @@ void SAMPLE_BUFFER::make_silent_range(buf_size_t start_pos,
   DBC_REQUIRE(end_pos >= 0);
   // --
 
+  make_writable();
+
+  /* note: the range is clipped to buffer length, as 
+   *       in make_silent_range_ref() */
+  if (end_pos > buffersize_rep)
+    end_pos = buffersize_rep;
+  if (start_pos >= end_pos)
+    return;
+
   for(channel_size_t n = 0; n < channel_count_rep; n++) {
     std::memset(buffer[n] + start_pos, 
 		0,
-		sizeof(sample_t) * 
-		(end_pos < buffersize_rep ? end_pos : buffersize_rep));
+		sizeof(sample_t) * (end_pos - start_pos));
   }
 }
 
@@ -470,6 +722,8 @@ void SAMPLE_BUFFER::make_silent_range_ref(buf_size_t start_pos,
   DBC_REQUIRE(end_pos >= 0);
   // --
 
+  make_writable();
+
   for(channel_size_t n = 0; n < channel_count_rep; n++) {
     for(buf_size_t s = start_pos; s < end_pos && s < buffersize_rep; s++) {
       buffer[n][s] = SAMPLE_SPECS::silent_value;
@@ -482,13 +736,13 @@ void SAMPLE_BUFFER::make_silent_range_ref(buf_size_t start_pos,
  */
 void SAMPLE_BUFFER::limit_values(void)
 {
+  make_writable();
+
   for(channel_size_t n = 0; n < channel_count_rep; n++) {
-    for(buf_size_t m = 0; m < buffersize_rep; m++) {
-      if (buffer[n][m] > SAMPLE_SPECS::impl_max_value) 
-	buffer[n][m] = SAMPLE_SPECS::impl_max_value;
-      else if (buffer[n][m] < SAMPLE_SPECS::impl_min_value) 
-	buffer[n][m] = SAMPLE_SPECS::impl_min_value;
-    }
+    priv_kernels->limit(buffer[n], 
+			SAMPLE_SPECS::impl_min_value,
+			SAMPLE_SPECS::impl_max_value,
+			buffersize_rep);
   }
   
 #if 0 /* slower than the naive implementation */
@@ -510,7 +764,16 @@ void SAMPLE_BUFFER::limit_values(void)
 /** Unoptimized version of limit_values() */
 void SAMPLE_BUFFER::limit_values_ref(void)
 {
-  limit_values();
+  make_writable();
+
+  for(channel_size_t n = 0; n < channel_count_rep; n++) {
+    for(buf_size_t m = 0; m < buffersize_rep; m++) {
+      if (buffer[n][m] > SAMPLE_SPECS::impl_max_value) 
+	buffer[n][m] = SAMPLE_SPECS::impl_max_value;
+      else if (buffer[n][m] < SAMPLE_SPECS::impl_min_value) 
+	buffer[n][m] = SAMPLE_SPECS::impl_min_value;
+    }
+  }
 }
 
 /**
@@ -526,6 +789,11 @@ void SAMPLE_BUFFER::resample(SAMPLE_SPECS::sample_rate_t from_rate,
   DBC_DECLARE(buf_size_t old_length_in_samples = length_in_samples());
 #endif
 
+  make_writable();
+
+  /* note: output depends on the previous buffers */
+  event_tag_set(tag_silent, false);
+
 #ifdef ECA_COMPILE_SAMPLERATE
   if (impl_repp->quality_rep > 5) {
     resample_secret_rabbit_code(from_rate, to_rate);
@@ -578,110 +846,502 @@ int SAMPLE_BUFFER::resample_get_quality(void) const
   return impl_repp->quality_rep;
 }
 
-void SAMPLE_BUFFER::export_helper(unsigned char* obuffer, 
-				  buf_size_t* optr,
-				  sample_t value,
-				  ECA_AUDIO_FORMAT::Sample_format fmt)
+/**
+ * Sample format traits for the block converters. Each 
+ * specialization provides the sample size in bytes, 
+ * whether the conversion loops are vectorized, whether
+ * the conversion is only a copy (floats in native byte 
+ * order), and functions to convert one sample from/to 
+ * raw data.
+ *
+ * 16 and 32bit samples are loaded and stored as words,
+ * and byte-swapped if the byte order differs from the 
+ * host byte order; unlike assembling the samples from 
+ * single bytes, this keeps the conversion loops 
+ * vectorizable.
+ */
+template<ECA_AUDIO_FORMAT::Sample_format FMT> struct SAMPLE_FORMAT_TRAITS;
 
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_u8> {
+  enum { bytes = 1, vectorizable = 1, copy_only = 0 };
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    return eca_sample_convert_u8_to_float(p[0]);
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    p[0] = eca_sample_convert_float_to_u8(v);
+  }
+};
+
+static inline uint16_t priv_swap_u16(uint16_t s)
 {
-  switch (fmt) {
-  case ECA_AUDIO_FORMAT::sfmt_u8:
-    {
-      obuffer[(*optr)++] = eca_sample_convert_float_to_u8(value);
-      break;
-    }
-    
-  case ECA_AUDIO_FORMAT::sfmt_s16_le:
-    {
-      int16_t s16temp = eca_sample_convert_float_to_s16(value);
+  return static_cast<uint16_t>((s >> 8) | (s << 8));
+}
 
-      // little endian: (LSB, MSB) (Intel).
-      obuffer[(*optr)++] = (unsigned char)(s16temp & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s16temp >> 8) & 0xff);
-      break;
-    }
-      
-  case ECA_AUDIO_FORMAT::sfmt_s16_be:
-    {
-      int16_t s16temp = eca_sample_convert_float_to_s16(value);
-      
-      // big endian: (MSB, LSB) (Motorola).
-      obuffer[(*optr)++] = (unsigned char)((s16temp >> 8) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)(s16temp & 0xff);
-      break;
+/* note: written with multiplications instead of left shifts, 
+ *       as gcc otherwise turns this into a scalar bswap 
+ *       instruction before vectorization, and the loop is
+ *       then not vectorized without SSSE3 */
+static inline uint32_t priv_swap_u32(uint32_t s)
+{
+  uint32_t t = ((s & 0x00ff00ffU) * 0x100U) | ((s >> 8) & 0x00ff00ffU);
+  return (t * 0x10000U) | (t >> 16);
+}
+
+static inline uint16_t priv_read_u16_le(const unsigned char* p)
+{
+  uint16_t s;
+  std::memcpy(&s, p, sizeof(s));
+#ifdef WORDS_BIGENDIAN
+  s = priv_swap_u16(s);
+#endif
+  return s;
+}
+
+static inline uint16_t priv_read_u16_be(const unsigned char* p)
+{
+  uint16_t s;
+  std::memcpy(&s, p, sizeof(s));
+#ifndef WORDS_BIGENDIAN
+  s = priv_swap_u16(s);
+#endif
+  return s;
+}
+
+static inline void priv_write_u16_le(unsigned char* p, uint16_t s)
+{
+#ifdef WORDS_BIGENDIAN
+  s = priv_swap_u16(s);
+#endif
+  std::memcpy(p, &s, sizeof(s));
+}
+
+static inline void priv_write_u16_be(unsigned char* p, uint16_t s)
+{
+#ifndef WORDS_BIGENDIAN
+  s = priv_swap_u16(s);
+#endif
+  std::memcpy(p, &s, sizeof(s));
+}
+
+static inline uint32_t priv_read_u32_le(const unsigned char* p)
+{
+  uint32_t s;
+  std::memcpy(&s, p, sizeof(s));
+#ifdef WORDS_BIGENDIAN
+  s = priv_swap_u32(s);
+#endif
+  return s;
+}
+
+static inline uint32_t priv_read_u32_be(const unsigned char* p)
+{
+  uint32_t s;
+  std::memcpy(&s, p, sizeof(s));
+#ifndef WORDS_BIGENDIAN
+  s = priv_swap_u32(s);
+#endif
+  return s;
+}
+
+static inline void priv_write_u32_le(unsigned char* p, uint32_t s)
+{
+#ifdef WORDS_BIGENDIAN
+  s = priv_swap_u32(s);
+#endif
+  std::memcpy(p, &s, sizeof(s));
+}
+
+static inline void priv_write_u32_be(unsigned char* p, uint32_t s)
+{
+#ifndef WORDS_BIGENDIAN
+  s = priv_swap_u32(s);
+#endif
+  std::memcpy(p, &s, sizeof(s));
+}
+
+static inline SAMPLE_SPECS::sample_t priv_u32_to_float_bits(uint32_t s)
+{
+  SAMPLE_SPECS::sample_t v;
+  std::memcpy(&v, &s, sizeof(v));
+  return v;
+}
+
+static inline uint32_t priv_float_bits_to_u32(SAMPLE_SPECS::sample_t v)
+{
+  uint32_t s;
+  std::memcpy(&s, &v, sizeof(s));
+  return s;
+}
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_s16_le> {
+  enum { bytes = 2, vectorizable = 1, copy_only = 0 };
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    return eca_sample_convert_s16_to_float(static_cast<int16_t>(priv_read_u16_le(p)));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    priv_write_u16_le(p, static_cast<uint16_t>(eca_sample_convert_float_to_s16(v)));
+  }
+};
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_s16_be> {
+  enum { bytes = 2, vectorizable = 1, copy_only = 0 };
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    return eca_sample_convert_s16_to_float(static_cast<int16_t>(priv_read_u16_be(p)));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    priv_write_u16_be(p, static_cast<uint16_t>(eca_sample_convert_float_to_s16(v)));
+  }
+};
+
+/* note: 24bit samples are converted via 32bit integers,
+ *       with the LSB-byte set to zero */
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_s24_le> {
+  enum { bytes = 3, vectorizable = 0, copy_only = 0 };
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    uint32_t s = (static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 24);
+    return eca_sample_convert_s32_to_float(static_cast<int32_t>(s));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    uint32_t s = static_cast<uint32_t>(eca_sample_convert_float_to_s32(v));
+    p[0] = (s >> 8) & 0xff;
+    p[1] = (s >> 16) & 0xff;
+    p[2] = (s >> 24) & 0xff;
+  }
+};
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_s24_be> {
+  enum { bytes = 3, vectorizable = 0, copy_only = 0 };
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    uint32_t s = (static_cast<uint32_t>(p[2]) << 8) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[0]) << 24);
+    return eca_sample_convert_s32_to_float(static_cast<int32_t>(s));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    uint32_t s = static_cast<uint32_t>(eca_sample_convert_float_to_s32(v));
+    p[0] = (s >> 24) & 0xff;
+    p[1] = (s >> 16) & 0xff;
+    p[2] = (s >> 8) & 0xff;
+  }
+};
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_s32_le> {
+  enum { bytes = 4, vectorizable = 1, copy_only = 0 };
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    return eca_sample_convert_s32_to_float(static_cast<int32_t>(priv_read_u32_le(p)));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    priv_write_u32_le(p, static_cast<uint32_t>(eca_sample_convert_float_to_s32(v)));
+  }
+};
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_s32_be> {
+  enum { bytes = 4, vectorizable = 1, copy_only = 0 };
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    return eca_sample_convert_s32_to_float(static_cast<int32_t>(priv_read_u32_be(p)));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    priv_write_u32_be(p, static_cast<uint32_t>(eca_sample_convert_float_to_s32(v)));
+  }
+};
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_f32_le> {
+#ifdef WORDS_BIGENDIAN
+  enum { bytes = 4, vectorizable = 1, copy_only = 0 };
+#else
+  enum { bytes = 4, vectorizable = 1, copy_only = 1 };
+#endif
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    return priv_u32_to_float_bits(priv_read_u32_le(p));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    priv_write_u32_le(p, priv_float_bits_to_u32(v));
+  }
+};
+
+template<> struct SAMPLE_FORMAT_TRAITS<ECA_AUDIO_FORMAT::sfmt_f32_be> {
+#ifdef WORDS_BIGENDIAN
+  enum { bytes = 4, vectorizable = 1, copy_only = 1 };
+#else
+  enum { bytes = 4, vectorizable = 1, copy_only = 0 };
+#endif
+  static inline SAMPLE_SPECS::sample_t read(const unsigned char* p) {
+    return priv_u32_to_float_bits(priv_read_u32_be(p));
+  }
+  static inline void write(unsigned char* p, SAMPLE_SPECS::sample_t v) {
+    priv_write_u32_be(p, priv_float_bits_to_u32(v));
+  }
+};
+
+/* note: samples are converted in blocks of this size via a 
+ *       local buffer, in groups of 'priv_convert_group' 
+ *       samples; with these constant trip counts the 
+ *       conversion loops are vectorized also with -O2 */
+static const SAMPLE_BUFFER::buf_size_t priv_convert_samples = 256;
+static const SAMPLE_BUFFER::buf_size_t priv_convert_group = 16;
+
+/**
+ * Converts 'len' consecutive samples from raw data in 
+ * 'source' to 'target'.
+ *
+ * Note: 'target' should be a local array; the compiler
+ *       cannot otherwise rule out 'target' aliasing the 
+ *       raw data, and does not vectorize the loop
+ */
+template<ECA_AUDIO_FORMAT::Sample_format FMT>
+static inline void priv_import_samples(const unsigned char* source,
+				       SAMPLE_SPECS::sample_t* target,
+				       SAMPLE_BUFFER::buf_size_t len)
+{
+  typedef SAMPLE_FORMAT_TRAITS<FMT> traits;
+
+  SAMPLE_BUFFER::buf_size_t n = 0;
+  for(; n + priv_convert_group <= len; n += priv_convert_group)
+    for(SAMPLE_BUFFER::buf_size_t m = 0; m < priv_convert_group; m++)
+      target[n + m] = traits::read(source + (n + m) * traits::bytes);
+  for(; n < len; n++)
+    target[n] = traits::read(source + n * traits::bytes);
+}
+
+template<bool CLAMP>
+static inline SAMPLE_SPECS::sample_t priv_export_clamp(SAMPLE_SPECS::sample_t value)
+{
+  if (CLAMP == true) {
+    if (value > SAMPLE_SPECS::impl_max_value) value = SAMPLE_SPECS::impl_max_value;
+    else if (value < SAMPLE_SPECS::impl_min_value) value = SAMPLE_SPECS::impl_min_value;
+  }
+  return value;
+}
+
+/**
+ * Converts 'len' consecutive samples from 'source' to
+ * raw data in 'target'.
+ *
+ * @see priv_import_samples()
+ */
+template<ECA_AUDIO_FORMAT::Sample_format FMT, bool CLAMP>
+static inline void priv_export_samples(const SAMPLE_SPECS::sample_t* source,
+				       unsigned char* target,
+				       SAMPLE_BUFFER::buf_size_t len)
+{
+  typedef SAMPLE_FORMAT_TRAITS<FMT> traits;
+
+  SAMPLE_BUFFER::buf_size_t n = 0;
+  for(; n + priv_convert_group <= len; n += priv_convert_group)
+    for(SAMPLE_BUFFER::buf_size_t m = 0; m < priv_convert_group; m++)
+      traits::write(target + (n + m) * traits::bytes, priv_export_clamp<CLAMP>(source[n + m]));
+  for(; n < len; n++)
+    traits::write(target + n * traits::bytes, priv_export_clamp<CLAMP>(source[n]));
+}
+
+/**
+ * Converts 'frames' samples of 'chcount' channels from raw
+ * data in 'source' to 'target'. Sample 'n' of channel 'c' 
+ * is read from 'source + c * choffset + n * stride'.
+ *
+ * Contiguous raw data is converted in blocks to a local
+ * buffer. Interleaved data is converted in blocks of whole 
+ * frames, which are then transposed to the channels, so
+ * the raw data is read only once and sequentially. Other
+ * layouts, and formats for which the conversion is not 
+ * vectorized or is only a copy (where the transpose would
+ * cost more than it saves), are converted directly, one 
+ * block of frames at a time.
+ */
+template<ECA_AUDIO_FORMAT::Sample_format FMT>
+static void priv_import_block(const unsigned char* source,
+			      SAMPLE_SPECS::sample_t* const* target,
+			      SAMPLE_BUFFER::buf_size_t frames,
+			      SAMPLE_BUFFER::channel_size_t chcount,
+			      size_t stride,
+			      size_t choffset)
+{
+  typedef SAMPLE_FORMAT_TRAITS<FMT> traits;
+  SAMPLE_SPECS::sample_t tmp[priv_convert_samples];
+
+  if (traits::vectorizable == 1 && stride == traits::bytes) {
+    for(SAMPLE_BUFFER::channel_size_t c = 0; c < chcount; c++) {
+      const unsigned char* src = source + c * choffset;
+      for(SAMPLE_BUFFER::buf_size_t n = 0; n < frames; n += priv_convert_samples) {
+	SAMPLE_BUFFER::buf_size_t len = std::min(frames - n, priv_convert_samples);
+	priv_import_samples<FMT>(src + n * traits::bytes, tmp, len);
+	std::memcpy(target[c] + n, tmp, len * sizeof(SAMPLE_SPECS::sample_t));
+      }
     }
-    
-  case ECA_AUDIO_FORMAT::sfmt_s24_le:
-    {
-      int32_t s32temp = eca_sample_convert_float_to_s32(value);
-      
-      /* skip the LSB-byte of s32temp (s32temp & 0xff) */
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 8) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 16) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 24) & 0xff);	
-      break;
+  }
+  else if (traits::vectorizable == 1 &&
+	   traits::copy_only == 0 &&
+	   choffset == traits::bytes && 
+	   stride == traits::bytes * chcount &&
+	   chcount <= priv_convert_samples) {
+    SAMPLE_BUFFER::buf_size_t block = priv_convert_samples / chcount;
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < frames; n += block) {
+      SAMPLE_BUFFER::buf_size_t len = std::min(frames - n, block);
+      priv_import_samples<FMT>(source + n * stride, tmp, len * chcount);
+      if (chcount == 2) {
+	SAMPLE_SPECS::sample_t* dst0 = target[0] + n;
+	SAMPLE_SPECS::sample_t* dst1 = target[1] + n;
+	for(SAMPLE_BUFFER::buf_size_t m = 0; m < len; m++) {
+	  dst0[m] = tmp[m * 2];
+	  dst1[m] = tmp[m * 2 + 1];
+	}
+      }
+      else {
+	for(SAMPLE_BUFFER::channel_size_t c = 0; c < chcount; c++) {
+	  SAMPLE_SPECS::sample_t* dst = target[c] + n;
+	  for(SAMPLE_BUFFER::buf_size_t m = 0; m < len; m++)
+	    dst[m] = tmp[m * chcount + c];
+	}
+      }
     }
-    
-  case ECA_AUDIO_FORMAT::sfmt_s24_be:
-    {
-      int32_t s32temp = eca_sample_convert_float_to_s32(value);
-      
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 24) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 16) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 8) & 0xff);
-      /* skip the LSB-byte of s32temp (s32temp & 0xff) */
-      break;
+  }
+  else {
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < frames; n += priv_convert_samples) {
+      SAMPLE_BUFFER::buf_size_t len = std::min(frames - n, priv_convert_samples);
+      for(SAMPLE_BUFFER::channel_size_t c = 0; c < chcount; c++) {
+	const unsigned char* src = source + c * choffset + n * stride;
+	SAMPLE_SPECS::sample_t* dst = target[c] + n;
+	for(SAMPLE_BUFFER::buf_size_t m = 0; m < len; m++)
+	  dst[m] = traits::read(src + m * stride);
+      }
     }
-    
-  case ECA_AUDIO_FORMAT::sfmt_s32_le:
-    {
-      int32_t s32temp = eca_sample_convert_float_to_s32(value);
-      
-      obuffer[(*optr)++] = (unsigned char)(s32temp & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 8) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 16) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 24) & 0xff);
-      break;
+  }
+}
+
+/**
+ * Converts 'frames' samples of 'chcount' channels from 
+ * 'source' to raw data in 'target'. If 'CLAMP' is true,
+ * samples are limited to the nominal sample range 
+ * before conversion. Sample 'n' of channel 'c' is 
+ * written to 'target + c * choffset + n * stride'.
+ *
+ * @see priv_import_block()
+ */
+template<ECA_AUDIO_FORMAT::Sample_format FMT, bool CLAMP>
+static void priv_export_block(const SAMPLE_SPECS::sample_t* const* source,
+			      unsigned char* target,
+			      SAMPLE_BUFFER::buf_size_t frames,
+			      SAMPLE_BUFFER::channel_size_t chcount,
+			      size_t stride,
+			      size_t choffset)
+{
+  typedef SAMPLE_FORMAT_TRAITS<FMT> traits;
+  SAMPLE_SPECS::sample_t tmp[priv_convert_samples];
+
+  if (traits::vectorizable == 1 && stride == traits::bytes) {
+    for(SAMPLE_BUFFER::channel_size_t c = 0; c < chcount; c++) {
+      unsigned char* dst = target + c * choffset;
+      for(SAMPLE_BUFFER::buf_size_t n = 0; n < frames; n += priv_convert_samples) {
+	SAMPLE_BUFFER::buf_size_t len = std::min(frames - n, priv_convert_samples);
+	std::memcpy(tmp, source[c] + n, len * sizeof(SAMPLE_SPECS::sample_t));
+	priv_export_samples<FMT, CLAMP>(tmp, dst + n * traits::bytes, len);
+      }
     }
-    
-  case ECA_AUDIO_FORMAT::sfmt_s32_be:
-    {
-      int32_t s32temp = eca_sample_convert_float_to_s32(value);
-      
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 24) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 16) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((s32temp >> 8) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)(s32temp & 0xff);
-      break;
+  }
+  else if (traits::vectorizable == 1 &&
+	   traits::copy_only == 0 &&
+	   choffset == traits::bytes && 
+	   stride == traits::bytes * chcount &&
+	   chcount <= priv_convert_samples) {
+    SAMPLE_BUFFER::buf_size_t block = priv_convert_samples / chcount;
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < frames; n += block) {
+      SAMPLE_BUFFER::buf_size_t len = std::min(frames - n, block);
+      if (chcount == 2) {
+	const SAMPLE_SPECS::sample_t* src0 = source[0] + n;
+	const SAMPLE_SPECS::sample_t* src1 = source[1] + n;
+	for(SAMPLE_BUFFER::buf_size_t m = 0; m < len; m++) {
+	  tmp[m * 2] = src0[m];
+	  tmp[m * 2 + 1] = src1[m];
+	}
+      }
+      else {
+	for(SAMPLE_BUFFER::channel_size_t c = 0; c < chcount; c++) {
+	  const SAMPLE_SPECS::sample_t* src = source[c] + n;
+	  for(SAMPLE_BUFFER::buf_size_t m = 0; m < len; m++)
+	    tmp[m * chcount + c] = src[m];
+	}
+      }
+      priv_export_samples<FMT, CLAMP>(tmp, target + n * stride, len * chcount);
     }
-    
-  case ECA_AUDIO_FORMAT::sfmt_f32_le:
-    {
-      union { int32_t i; float f; } f32temp;
-      f32temp.f = (float)value;
-      obuffer[(*optr)++] = (unsigned char)(f32temp.i & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((f32temp.i >> 8) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((f32temp.i >> 16) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((f32temp.i >> 24) & 0xff);
-      break;
+  }
+  else {
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < frames; n += priv_convert_samples) {
+      SAMPLE_BUFFER::buf_size_t len = std::min(frames - n, priv_convert_samples);
+      for(SAMPLE_BUFFER::channel_size_t c = 0; c < chcount; c++) {
+	const SAMPLE_SPECS::sample_t* src = source[c] + n;
+	unsigned char* dst = target + c * choffset + n * stride;
+	for(SAMPLE_BUFFER::buf_size_t m = 0; m < len; m++)
+	  traits::write(dst + m * stride, priv_export_clamp<CLAMP>(src[m]));
+      }
     }
-    
-  case ECA_AUDIO_FORMAT::sfmt_f32_be:
-    {
-      union { int32_t i; float f; } f32temp;
-      f32temp.f = (float)value;
-      obuffer[(*optr)++] = (unsigned char)((f32temp.i >> 24) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((f32temp.i >> 16) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)((f32temp.i >> 8) & 0xff);
-      obuffer[(*optr)++] = (unsigned char)(f32temp.i & 0xff);
-      break;
+  }
+}
+
+typedef void (*priv_import_block_t)(const unsigned char*, SAMPLE_SPECS::sample_t* const*, SAMPLE_BUFFER::buf_size_t, SAMPLE_BUFFER::channel_size_t, size_t, size_t);
+typedef void (*priv_export_block_t)(const SAMPLE_SPECS::sample_t* const*, unsigned char*, SAMPLE_BUFFER::buf_size_t, SAMPLE_BUFFER::channel_size_t, size_t, size_t);
+
+/**
+ * Selects the import converter for 'fmt' and stores
+ * sample size to 'bytes'. Returns 0 if 'fmt' is not 
+ * supported.
+ */
+static priv_import_block_t priv_select_import_block(ECA_AUDIO_FORMAT::Sample_format fmt, size_t* bytes)
+{
+#define ECA_SELECT_IMPORT(f) \
+  case f: *bytes = SAMPLE_FORMAT_TRAITS<f>::bytes; return priv_import_block<f>
+
+  switch(fmt) {
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_u8);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_s16_le);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_s16_be);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_s24_le);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_s24_be);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_s32_le);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_s32_be);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_f32_le);
+    ECA_SELECT_IMPORT(ECA_AUDIO_FORMAT::sfmt_f32_be);
+  default: 
+    { 
+      ECA_LOG_MSG(ECA_LOGGER::info, "Unknown sample format! [4].");
     }
-    
+  }
+
+#undef ECA_SELECT_IMPORT
+
+  *bytes = 0;
+  return 0;
+}
+
+/**
+ * Selects the export converter for 'fmt' and stores
+ * sample size to 'bytes'. Returns 0 if 'fmt' is not 
+ * supported.
+ */
+static priv_export_block_t priv_select_export_block(ECA_AUDIO_FORMAT::Sample_format fmt, bool clamp, size_t* bytes)
+{
+#define ECA_SELECT_EXPORT(f) \
+  case f: *bytes = SAMPLE_FORMAT_TRAITS<f>::bytes; \
+    return (clamp == true) ? priv_export_block<f, true> : priv_export_block<f, false>
+
+  switch(fmt) {
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_u8);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_s16_le);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_s16_be);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_s24_le);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_s24_be);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_s32_le);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_s32_be);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_f32_le);
+    ECA_SELECT_EXPORT(ECA_AUDIO_FORMAT::sfmt_f32_be);
   default: 
     { 
       ECA_LOG_MSG(ECA_LOGGER::info, "Unknown sample format! [1].");
     }
   }
+
+#undef ECA_SELECT_EXPORT
+
+  *bytes = 0;
+  return 0;
 }
 
 /**
@@ -709,16 +1369,11 @@ void SAMPLE_BUFFER::export_interleaved(unsigned char* target,
 
   if (chcount > channel_count_rep) number_of_channels(chcount);
 
-  buf_size_t osize = 0;
-  for(buf_size_t isize = 0; isize < buffersize_rep; isize++) {
-    for(channel_size_t c = 0; c < chcount; c++) {
-      sample_t stemp = buffer[c][isize];
-      if (coding != ECA_AUDIO_FORMAT::sc_float) {
-        if (stemp > SAMPLE_SPECS::impl_max_value) stemp = SAMPLE_SPECS::impl_max_value;
-        else if (stemp < SAMPLE_SPECS::impl_min_value) stemp = SAMPLE_SPECS::impl_min_value;
-      }
-      SAMPLE_BUFFER::export_helper(target, &osize, stemp, fmt);
-    }
+  size_t bytes;
+  priv_export_block_t convert = 
+    priv_select_export_block(fmt, coding != ECA_AUDIO_FORMAT::sc_float, &bytes);
+  if (convert != 0 && chcount > 0) {
+    convert(&buffer[0], target, buffersize_rep, chcount, bytes * chcount, bytes);
   }
   
   // -------
@@ -749,16 +1404,11 @@ void SAMPLE_BUFFER::export_noninterleaved(unsigned char* target,
 
   if (chcount > channel_count_rep) number_of_channels(chcount);
 
-  buf_size_t osize = 0;
-  for(channel_size_t c = 0; c < chcount; c++) {
-    for(buf_size_t isize = 0; isize < buffersize_rep; isize++) {
-      sample_t stemp = buffer[c][isize];
-      if (coding != ECA_AUDIO_FORMAT::sc_float) {
-        if (stemp > SAMPLE_SPECS::impl_max_value) stemp = SAMPLE_SPECS::impl_max_value;
-        else if (stemp < SAMPLE_SPECS::impl_min_value) stemp = SAMPLE_SPECS::impl_min_value;
-      }
-      SAMPLE_BUFFER::export_helper(target, &osize, stemp, fmt);
-    }
+  size_t bytes;
+  priv_export_block_t convert = 
+    priv_select_export_block(fmt, coding != ECA_AUDIO_FORMAT::sc_float, &bytes);
+  if (convert != 0 && chcount > 0) {
+    convert(&buffer[0], target, buffersize_rep, chcount, bytes, bytes * buffersize_rep);
   }
 
   // -------
@@ -766,179 +1416,6 @@ void SAMPLE_BUFFER::export_noninterleaved(unsigned char* target,
   // -------
 }
 
-void SAMPLE_BUFFER::import_helper(const unsigned char *ibuffer,
-				  buf_size_t* iptr,
-				  sample_t* obuffer,
-				  buf_size_t optr,
-				  ECA_AUDIO_FORMAT::Sample_format fmt)
-{
-  unsigned char a[2];
-  unsigned char b[4];
-
-  switch (fmt) {
-  case ECA_AUDIO_FORMAT::sfmt_u8: 
-    {
-      obuffer[optr] = eca_sample_convert_u8_to_float(ibuffer[(*iptr)++]);
-    }
-    break;
-	
-  case ECA_AUDIO_FORMAT::sfmt_s16_le:
-    {
-      // little endian: (LSB, MSB) (Intel)
-      // big endian: (MSB, LSB) (Motorola)
-      if (is_system_littleendian) {
-	a[0] = ibuffer[(*iptr)++];
-	a[1] = ibuffer[(*iptr)++];
-      }
-      else {
-	a[1] = ibuffer[(*iptr)++];
-	a[0] = ibuffer[(*iptr)++];
-      }
-      int16_t tmp;
-      memcpy(&tmp, a, sizeof(tmp));
-      obuffer[optr] = eca_sample_convert_s16_to_float(tmp);
-    }
-    break;
-
-  case ECA_AUDIO_FORMAT::sfmt_s16_be:
-    {
-      if (!is_system_littleendian) {
-	a[0] = ibuffer[(*iptr)++];
-	a[1] = ibuffer[(*iptr)++];
-      }
-      else {
-	a[1] = ibuffer[(*iptr)++];
-	a[0] = ibuffer[(*iptr)++];
-      }
-      int16_t tmp;
-      memcpy(&tmp, a, sizeof(tmp));
-      obuffer[optr] = eca_sample_convert_s16_to_float(tmp);
-    }
-    break;
-
-  case ECA_AUDIO_FORMAT::sfmt_s24_le:
-    {
-      if (is_system_littleendian) {
-	b[0] = 0; /* LSB */
-	b[1] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[3] = ibuffer[(*iptr)++];
-      }
-      else {
-	b[3] = 0; /* LSB */
-	b[2] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[0] = ibuffer[(*iptr)++];
-      }
-      int32_t tmp;
-      memcpy(&tmp, b, sizeof(tmp));
-      obuffer[optr] = eca_sample_convert_s32_to_float(tmp);
-    }
-    break;
-
-  case ECA_AUDIO_FORMAT::sfmt_s24_be:
-    {
-      if (is_system_littleendian) {
-	b[3] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[0] = 0; /* LSB */
-      }
-      else {
-	b[0] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[3] = 0; /* LSB */
-      }
-      int32_t tmp;
-      memcpy(&tmp, b, sizeof(tmp));
-      obuffer[optr] = eca_sample_convert_s32_to_float(tmp);
-    }
-    break;
-
-  case ECA_AUDIO_FORMAT::sfmt_s32_le:
-    {
-      if (is_system_littleendian) {
-	b[0] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[3] = ibuffer[(*iptr)++];
-      }
-      else {
-	b[3] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[0] = ibuffer[(*iptr)++];
-      }
-      int32_t tmp;
-      memcpy(&tmp, b, sizeof(tmp));
-      obuffer[optr] = eca_sample_convert_s32_to_float(tmp);
-    }
-    break;
-
-  case ECA_AUDIO_FORMAT::sfmt_s32_be:
-    {
-      if (is_system_littleendian) {
-	b[3] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[0] = ibuffer[(*iptr)++];
-      }
-      else {
-	b[0] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[3] = ibuffer[(*iptr)++];
-      }
-      int32_t tmp;
-      memcpy(&tmp, b, sizeof(tmp));
-      obuffer[optr] = eca_sample_convert_s32_to_float(tmp);
-    }
-    break;
-
-  case ECA_AUDIO_FORMAT::sfmt_f32_le:
-    {
-      if (is_system_littleendian) {
-	b[0] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[3] = ibuffer[(*iptr)++];
-      }
-      else {
-	b[3] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[0] = ibuffer[(*iptr)++];
-      }
-      memcpy(&obuffer[optr], b, sizeof(obuffer[optr]));
-    }
-    break;
-
-  case ECA_AUDIO_FORMAT::sfmt_f32_be:
-    {
-      if (is_system_littleendian) {
-	b[3] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[0] = ibuffer[(*iptr)++];
-      }
-      else {
-	b[0] = ibuffer[(*iptr)++];
-	b[1] = ibuffer[(*iptr)++];
-	b[2] = ibuffer[(*iptr)++];
-	b[3] = ibuffer[(*iptr)++];
-      }
-      memcpy(&obuffer[optr], b, sizeof(obuffer[optr]));
-    }
-    break;
-
-  default: 
-    { 
-      ECA_LOG_MSG(ECA_LOGGER::info, "Unknown sample format! [4].");
-    }
-  }
-}
-
 /**
  * Import audio from external raw buffer. Sample data 
  * will be converted to internal sample format using the 
@@ -958,15 +1435,17 @@ void SAMPLE_BUFFER::import_interleaved(unsigned char* source,
   DBC_REQUIRE(samples_read >= 0);
   // --------
 
+  /* note: all samples are overwritten */
+  make_writable(false);
+  event_tag_set(tag_silent, false);
+
   if (channel_count_rep != chcount) number_of_channels(chcount);
   if (buffersize_rep != samples_read) length_in_samples(samples_read);
 
-  buf_size_t isize = 0;
-
-  for(buf_size_t osize = 0; osize < buffersize_rep; osize++) {
-    for(channel_size_t c = 0; c < chcount; c++) {
-      import_helper(source, &isize, buffer[c], osize, fmt);
-    }
+  size_t bytes;
+  priv_import_block_t convert = priv_select_import_block(fmt, &bytes);
+  if (convert != 0 && chcount > 0) {
+    convert(source, &buffer[0], buffersize_rep, chcount, bytes * chcount, bytes);
   }
 }
 
@@ -987,14 +1466,87 @@ void SAMPLE_BUFFER::import_noninterleaved(unsigned char* source,
   DBC_REQUIRE(samples_read >= 0);
   // --------
 
+  /* note: all samples are overwritten */
+  make_writable(false);
+  event_tag_set(tag_silent, false);
+
   if (channel_count_rep != chcount) number_of_channels(chcount);
   if (buffersize_rep != samples_read) length_in_samples(samples_read);
 
-  buf_size_t isize = 0;
-  for(channel_size_t c = 0; c < chcount; c++) {
-    for(buf_size_t osize = 0; osize < buffersize_rep; osize++) {
-      import_helper(source, &isize, buffer[c], osize, fmt);
-    }
+  size_t bytes;
+  priv_import_block_t convert = priv_select_import_block(fmt, &bytes);
+  if (convert != 0 && chcount > 0) {
+    convert(source, &buffer[0], buffersize_rep, chcount, bytes, bytes * buffersize_rep);
+  }
+}
+
+/**
+ * Imports 'samples' samples of channel 'channel' from 
+ * 'source', where consecutive samples are 'stride' bytes
+ * apart. Samples are written starting from position 'offset'.
+ * Other samples and channels are not modified, so a buffer
+ * can be filled piecewise, for instance directly from a
+ * memory-mapped device buffer.
+ *
+ * @pre source != 0
+ * @pre channel >= 0 && channel < number_of_channels()
+ * @pre offset >= 0 && offset + samples <= length_in_samples()
+ */
+void SAMPLE_BUFFER::import_channel(const unsigned char* source,
+				   size_t stride,
+				   buf_size_t offset,
+				   buf_size_t samples,
+				   ECA_AUDIO_FORMAT::Sample_format fmt,
+				   channel_size_t channel)
+{
+  // --------
+  DBC_REQUIRE(source != 0);
+  DBC_REQUIRE(channel >= 0 && channel < number_of_channels());
+  DBC_REQUIRE(offset >= 0 && offset + samples <= length_in_samples());
+  // --------
+
+  make_writable();
+  event_tag_set(tag_silent, false);
+
+  size_t bytes;
+  priv_import_block_t convert = priv_select_import_block(fmt, &bytes);
+  if (convert != 0) {
+    sample_t* target = buffer[channel] + offset;
+    convert(source, &target, samples, 1, stride, 0);
+  }
+}
+
+/**
+ * Exports 'samples' samples of channel 'channel', starting 
+ * from position 'offset', to 'target'. Consecutive samples 
+ * are written 'stride' bytes apart. 
+ *
+ * @see import_channel()
+ *
+ * @pre target != 0
+ * @pre channel >= 0 && channel < number_of_channels()
+ * @pre offset >= 0 && offset + samples <= length_in_samples()
+ */
+void SAMPLE_BUFFER::export_channel(unsigned char* target,
+				   size_t stride,
+				   buf_size_t offset,
+				   buf_size_t samples,
+				   ECA_AUDIO_FORMAT::Sample_format fmt,
+				   ECA_AUDIO_FORMAT::Sample_coding coding,
+				   channel_size_t channel) const
+{
+  // --------
+  DBC_REQUIRE(target != 0);
+  DBC_REQUIRE(channel >= 0 && channel < number_of_channels());
+  DBC_REQUIRE(offset >= 0 && offset + samples <= length_in_samples());
+  // --------
+
+  size_t bytes;
+  priv_export_block_t convert = 
+    priv_select_export_block(fmt, coding != ECA_AUDIO_FORMAT::sc_float, &bytes);
+  if (convert != 0) {
+    const sample_t* source = buffer[channel] + offset;
+    convert(&source, target, samples, 1, stride, 0);
   }
 }
 
@@ -1005,14 +1557,14 @@ void SAMPLE_BUFFER::number_of_channels(channel_size_t len)
 {
   // std::cerr << "(samplebuffer_impl) ch-count changes from " << channel_count_rep << " to " << len << ".\n";
 
+  if (len > channel_count_rep)
+    make_writable();
+
   if (len > static_cast<channel_size_t>(buffer.size())) {
     DBC_CHECK(impl_repp->rt_lock_rep != true);
+    DBC_CHECK(impl_repp->lockref_rep.get() == 0);
 
-    size_t old_size = buffer.size();
-    buffer.resize(len);
-    for(channel_size_t n = old_size; n < len; n++) {
-      priv_alloc_sample_buf(&buffer[n], sizeof(sample_t) * reserved_samples_rep);
-    }
+    reallocate_storage(len, reserved_samples_rep);
     ECA_LOG_MSG(ECA_LOGGER::functions, "Increasing channel-count (1).");    
   }
 
@@ -1032,6 +1584,61 @@ void SAMPLE_BUFFER::number_of_channels(channel_size_t len)
   channel_count_rep = len;
 }
 
+/**
+ * Returns the samples of 'channel' for reading and
+ * writing. Samples are stored contiguously, and the 
+ * first sample is aligned to SAMPLE_BUFFER_POOL::alignment 
+ * bytes. If audio data is shared with another buffer,
+ * sharing is ended.
+ *
+ * The returned span is valid until the channel count 
+ * or length of the buffer is changed. Objects that keep 
+ * the pointer for longer must hold a pointer reflock 
+ * (see get_pointer_reflock()).
+ *
+ * Realtime-safe.
+ *
+ * @pre channel >= 0 && channel < number_of_channels()
+ * @see const_channel_span()
+ */
+SAMPLE_BUFFER::channel_span_t SAMPLE_BUFFER::channel_span(channel_size_t channel)
+{
+  // ---
+  DBC_REQUIRE(channel >= 0 && channel < channel_count_rep);
+  // ---
+
+  make_writable();
+
+  /* note: caller may write to the samples */
+  event_tag_set(tag_silent, false);
+
+  channel_span_t span;
+  span.data = buffer[channel];
+  span.length = buffersize_rep;
+  return span;
+}
+
+/**
+ * Returns the samples of 'channel' for reading. Unlike 
+ * channel_span(), does not end sharing of audio data.
+ *
+ * Realtime-safe.
+ *
+ * @pre channel >= 0 && channel < number_of_channels()
+ * @see channel_span()
+ */
+SAMPLE_BUFFER::const_channel_span_t SAMPLE_BUFFER::const_channel_span(channel_size_t channel) const
+{
+  // ---
+  DBC_REQUIRE(channel >= 0 && channel < channel_count_rep);
+  // ---
+
+  const_channel_span_t span;
+  span.data = buffer[channel];
+  span.length = buffersize_rep;
+  return span;
+}
+
 /**
  * Sets the length of buffer in samples.
  *
@@ -1043,19 +1650,15 @@ void SAMPLE_BUFFER::length_in_samples(buf_size_t len)
   DBC_REQUIRE(len >= 0);
   DBC_CHECK(buffersize_rep <= reserved_samples_rep);
 
+  if (len > buffersize_rep)
+    make_writable();
+
   if (len > reserved_samples_rep) {
 
     DBC_CHECK(impl_repp->rt_lock_rep != true);
-    DBC_CHECK(impl_repp->lockref_rep == 0);
-
-    reserved_samples_rep = len * 2;
-    for(size_t n = 0; n < buffer.size(); n++) {
-      sample_t *prev_buffer = buffer[n];
-      priv_alloc_sample_buf(&buffer[n], sizeof(sample_t) * reserved_samples_rep);
-      for (buf_size_t m = 0; m < buffersize_rep; m++)
-	buffer[n][m] = prev_buffer[m];
-      ::free(prev_buffer);
-    }
+    DBC_CHECK(impl_repp->lockref_rep.get() == 0);
+
+    reallocate_storage(buffer.size(), len * 2);
 
     if (impl_repp->old_buffer_repp != 0) {
       ::free(impl_repp->old_buffer_repp);
@@ -1064,7 +1667,9 @@ void SAMPLE_BUFFER::length_in_samples(buf_size_t len)
   }
 
   if (len > buffersize_rep) {
-    for(size_t n = 0; n < buffer.size(); n++) {
+    /* note: unused channels are muted when taken 
+     *       into use in number_of_channels() */
+    for(channel_size_t n = 0; n < channel_count_rep; n++) {
       /* note: mute starting from 'buffersize_rep' */
       for(buf_size_t m = buffersize_rep; m < reserved_samples_rep; m++) {
 	buffer[n][m] = SAMPLE_SPECS::silent_value;
@@ -1086,6 +1691,8 @@ void SAMPLE_BUFFER::length_in_samples(buf_size_t len)
 void SAMPLE_BUFFER::resample_init_memory(SAMPLE_SPECS::sample_rate_t from_srate,
 					 SAMPLE_SPECS::sample_rate_t to_srate)
 {
+  make_writable();
+
 #ifdef ECA_COMPILE_SAMPLERATE
   ECA_LOG_MSG(ECA_LOGGER::system_objects, 
 		"Resampler selected: libsamplerate (Secret Rabbit Code).");
@@ -1101,17 +1708,12 @@ void SAMPLE_BUFFER::resample_init_memory(SAMPLE_SPECS::sample_rate_t from_srate,
   buf_size_t new_buffer_size = static_cast<buf_size_t>((step * buffersize_rep)) + sizeof(buf_size_t);
 
   if (new_buffer_size > reserved_samples_rep) {
-    reserved_samples_rep = new_buffer_size * 2;
-
 #ifdef ECA_DEBUG_MODE
     DBC_CHECK(impl_repp->rt_lock_rep != true);
-    DBC_CHECK(impl_repp->lockref_rep == 0);
+    DBC_CHECK(impl_repp->lockref_rep.get() == 0);
 #endif
 
-    for(int c = 0; c < channel_count_rep; c++) {
-      ::free(buffer[c]);
-      priv_alloc_sample_buf(&buffer[c], sizeof(sample_t) * reserved_samples_rep);
-    }
+    reallocate_storage(buffer.size(), new_buffer_size * 2);
   }
 
 #ifdef ECA_COMPILE_SAMPLERATE
@@ -1154,6 +1756,136 @@ void SAMPLE_BUFFER::reserve_length_in_samples(buf_size_t len)
   length_in_samples(oldlen);
 }
 
+/**
+ * Sets the pool used for storing audio data. If space 
+ * for all reserved channels fits into one block of 'pool',
+ * audio data is moved to the pool. Channels that fit into
+ * the block can then be taken into use without memory 
+ * allocations. Storage is taken from the pool also for 
+ * later reallocations, if possible.
+ *
+ * If 'pool' is 0, audio data is moved out of the pool 
+ * currently used.
+ *
+ * Note! Audio data is moved to a new location even if a
+ *       pointer reflock is held. Objects that hold a 
+ *       reflock must be reinitialized after this call.
+ *
+ * Not realtime-safe.
+ *
+ * @see storage_size()
+ */
+void SAMPLE_BUFFER::set_pool(SAMPLE_BUFFER_POOL* pool)
+{
+  DBC_CHECK(impl_repp->rt_lock_rep != true);
+
+  make_writable();
+
+  impl_repp->pool_repp = pool;
+  if (impl_repp->slab_pool_repp != pool) {
+    /* note: if data does not fit into 'pool', it is 
+     *       moved to the heap */
+    reallocate_storage(buffer.size(), reserved_samples_rep);
+  }
+}
+
+/**
+ * Returns the number of bytes needed to store 
+ * 'channels' channels of audio, with the space 
+ * currently reserved for each channel.
+ *
+ * @see set_pool()
+ */
+size_t SAMPLE_BUFFER::storage_size(channel_size_t channels) const
+{
+  buf_size_t len = reserved_samples_rep;
+  if (len < priv_align_samples)
+    len = priv_align_samples;
+  return sizeof(sample_t) * len * channels;
+}
+
+/**
+ * Moves audio data to newly allocated storage with space 
+ * for at least 'channels' channels of 'samples' samples.
+ * Contents of the channels in use are preserved.
+ *
+ * Storage is allocated from the pool, if one is set 
+ * and data fits into one block, and from the heap 
+ * otherwise. When using a pool block, all channels 
+ * that fit into the block are reserved.
+ *
+ * @pre is_content_shared() != true
+ * @post buffer.size() >= channels
+ * @post reserved_samples_rep >= samples
+ */
+void SAMPLE_BUFFER::reallocate_storage(channel_size_t channels, buf_size_t samples)
+{
+  // ---
+  DBC_REQUIRE(is_content_shared() != true);
+  // ---
+
+  /* note: round up so that every channel is aligned */
+  buf_size_t len = (samples + priv_align_samples - 1) / priv_align_samples * priv_align_samples;
+  if (len < priv_align_samples)
+    len = priv_align_samples;
+  size_t bytes = sizeof(sample_t) * len * channels;
+
+  sample_t* slab = 0;
+  SAMPLE_BUFFER_POOL* slab_pool = 0;
+  size_t capacity = channels;
+
+  SAMPLE_BUFFER_POOL* pool = impl_repp->pool_repp;
+  if (pool != 0 && bytes <= pool->block_size()) {
+    slab = static_cast<sample_t*>(pool->allocate());
+    if (slab != 0) {
+      slab_pool = pool;
+      capacity = pool->block_size() / (sizeof(sample_t) * len);
+    }
+  }
+  if (slab == 0 && bytes > 0) {
+    priv_alloc_sample_buf(&slab, bytes);
+  }
+
+  /* step: copy the channels in use */
+  buf_size_t copylen = (buffersize_rep < len) ? buffersize_rep : len;
+  for(channel_size_t c = 0; c < channel_count_rep; c++) {
+    if (static_cast<size_t>(c) >= capacity ||
+	static_cast<size_t>(c) >= buffer.size())
+      break;
+    std::memcpy(slab + c * len, buffer[c], sizeof(sample_t) * copylen);
+  }
+
+  release_storage();
+
+  impl_repp->slab_repp = slab;
+  impl_repp->slab_pool_repp = slab_pool;
+  reserved_samples_rep = len;
+  buffer.resize(capacity);
+  for(size_t c = 0; c < capacity; c++) {
+    buffer[c] = slab + c * len;
+  }
+
+  // ---
+  DBC_ENSURE(buffer.size() >= static_cast<size_t>(channels));
+  DBC_ENSURE(reserved_samples_rep >= samples);
+  // ---
+}
+
+/**
+ * Frees storage of audio data.
+ */
+void SAMPLE_BUFFER::release_storage(void)
+{
+  if (impl_repp->slab_repp != 0) {
+    if (impl_repp->slab_pool_repp != 0)
+      impl_repp->slab_pool_repp->release(impl_repp->slab_repp);
+    else
+      ::free(impl_repp->slab_repp);
+    impl_repp->slab_repp = 0;
+    impl_repp->slab_pool_repp = 0;
+  }
+}
+
 /**
  * Sets the realtime-lock state. When realtime-lock
  * is enabled, all non-rt-safe operations 
@@ -1181,7 +1913,8 @@ void SAMPLE_BUFFER::set_rt_lock(bool state)
  */
 void SAMPLE_BUFFER::get_pointer_reflock(void)
 {
-  impl_repp->lockref_rep++;
+  make_writable();
+  impl_repp->lockref_rep.add(1);
 }
 
 /** 
@@ -1192,8 +1925,8 @@ void SAMPLE_BUFFER::get_pointer_reflock(void)
  */
 void SAMPLE_BUFFER::release_pointer_reflock(void)
 {
-  impl_repp->lockref_rep--;
-  DBC_ENSURE(impl_repp->lockref_rep >= 0);
+  impl_repp->lockref_rep.add(-1);
+  DBC_ENSURE(impl_repp->lockref_rep.get() >= 0);
 }
 
 /**
@@ -1233,7 +1966,7 @@ void SAMPLE_BUFFER::event_tag_set(Tag_name tag, bool val)
     impl_repp->event_tags_rep &= ~tag;
 }
 
-bool SAMPLE_BUFFER::event_tag_test(Tag_name tag)
+bool SAMPLE_BUFFER::event_tag_test(Tag_name tag) const
 {
   return (impl_repp->event_tags_rep & tag) ? true : false;
 }
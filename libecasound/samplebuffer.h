@@ -7,6 +7,7 @@
 #include "sample-specs.h"
 
 class SAMPLE_BUFFER_FUNCTIONS;
+class SAMPLE_BUFFER_POOL;
 class SAMPLE_BUFFER_impl;
 
 /**
@@ -23,11 +24,14 @@ class SAMPLE_BUFFER_impl;
  *
  * Provided services:
  *  - copying from/to other samplebuffer objects
+ *  - copy-on-write sharing of audio data
  *  - basic audio operations
  *  - importing and exporting data from/to\n
  *    raw buffers of audio data
  *  - changing channel count and length
- *  - reserving space before-hand
+ *  - direct access to samples of one channel
+ *  - reserving space before-hand, optionally from
+ *    a preallocated pool
  *  - realtime-safety and pointer locking
  *  - access to event tags
  */
@@ -48,6 +52,22 @@ class SAMPLE_BUFFER {
   typedef long int buf_size_t;
   typedef SAMPLE_SPECS::sample_t sample_t;
 
+  /**
+   * Samples of one channel, see channel_span().
+   */
+  struct channel_span_t {
+    sample_t* data;
+    buf_size_t length;
+  };
+
+  /**
+   * Samples of one channel, see const_channel_span().
+   */
+  struct const_channel_span_t {
+    const sample_t* data;
+    buf_size_t length;
+  };
+
   enum Tag_name {
     /* buffer contains last samples of a stream */
     tag_end_of_stream = 1,
@@ -55,6 +75,10 @@ class SAMPLE_BUFFER {
     tag_mixed_content = (1 << 1),
     /* buffer length may vary from buffer to another */
     tag_var_length = (1 << 2),
+    /* all samples of the buffer are zero; cleared by 
+     * operations that may write non-zero samples, code
+     * writing to the samples directly must clear it */
+    tag_silent = (1 << 3),
     /* internal: placeholder */
     tag_last =  (1 << 30),
     /* internal: matches all tags */
@@ -81,12 +105,22 @@ class SAMPLE_BUFFER {
   void add_matching_channels(const SAMPLE_BUFFER& x);
   void add_matching_channels_ref(const SAMPLE_BUFFER& x);
   void add_with_weight(const SAMPLE_BUFFER& x, int weight);
+  void add_with_weight_ref(const SAMPLE_BUFFER& x, int weight);
   void copy_matching_channels(const SAMPLE_BUFFER& x);
   void copy_all_content(const SAMPLE_BUFFER& x);
   void copy_range(const SAMPLE_BUFFER& x, buf_size_t start_pos, buf_size_t end_pos, buf_size_t to_pos);
 
   /*@}*/
 
+  /** @name Copy-on-write sharing of audio data */
+  /*@{*/
+
+  void share_content(const SAMPLE_BUFFER& x);
+  void unshare_content(void);
+  bool is_content_shared(void) const;
+
+  /*@}*/
+
   /** @name Basic audio operations */
   /*@{*/ 
 
@@ -100,6 +134,7 @@ class SAMPLE_BUFFER {
   void limit_values_ref(void);
   void make_empty(void);
   bool is_empty(void) const { return buffersize_rep == 0; }
+  bool is_silent(void) const;
   void make_silent(void);
   void make_silent(int channel);
   void make_silent_ref(int channel);
@@ -119,6 +154,8 @@ class SAMPLE_BUFFER {
   void import_noninterleaved(unsigned char* source, buf_size_t samples, ECA_AUDIO_FORMAT::Sample_format fmt, channel_size_t ch);
   void export_interleaved(unsigned char* target, ECA_AUDIO_FORMAT::Sample_format fmt, ECA_AUDIO_FORMAT::Sample_coding coding, channel_size_t ch);
   void export_noninterleaved(unsigned char* target, ECA_AUDIO_FORMAT::Sample_format fmt, ECA_AUDIO_FORMAT::Sample_coding coding, channel_size_t ch);
+  void import_channel(const unsigned char* source, size_t stride, buf_size_t offset, buf_size_t samples, ECA_AUDIO_FORMAT::Sample_format fmt, channel_size_t channel);
+  void export_channel(unsigned char* target, size_t stride, buf_size_t offset, buf_size_t samples, ECA_AUDIO_FORMAT::Sample_format fmt, ECA_AUDIO_FORMAT::Sample_coding coding, channel_size_t channel) const;
   
   /*@}*/
         
@@ -135,12 +172,24 @@ class SAMPLE_BUFFER {
 
   /*@}*/
 
+  /** @name Access to audio data of one channel */
+  /*@{*/
+
+  channel_span_t channel_span(channel_size_t channel);
+  const_channel_span_t const_channel_span(channel_size_t channel) const;
+
+  /*@}*/
+
   /**@name Reserving space before-hand */
   /*@{*/
 
   void resample_init_memory(SAMPLE_SPECS::sample_rate_t from_rate, SAMPLE_SPECS::sample_rate_t to_rate);
   void reserve_channels(channel_size_t num);
   void reserve_length_in_samples(buf_size_t len);
+  inline channel_size_t reserved_channels(void) const { return(static_cast<channel_size_t>(buffer.size())); }
+  inline buf_size_t reserved_length_in_samples(void) const { return(reserved_samples_rep); }
+  void set_pool(SAMPLE_BUFFER_POOL* pool);
+  size_t storage_size(channel_size_t channels) const;
 
   /*@}*/
 
@@ -160,7 +209,7 @@ class SAMPLE_BUFFER {
   void event_tags_set(const SAMPLE_BUFFER& sbuf);
   void event_tags_clear(Tag_name tagmask = tag_all);
   void event_tag_set(Tag_name tag, bool val = true);
-  bool event_tag_test(Tag_name tag);
+  bool event_tag_test(Tag_name tag) const;
 
   /*@}*/
 
@@ -172,15 +221,12 @@ class SAMPLE_BUFFER {
   void resample_nofilter(SAMPLE_SPECS::sample_rate_t from_rate, SAMPLE_SPECS::sample_rate_t to_rate);
   void resample_with_memory(SAMPLE_SPECS::sample_rate_t from_rate, SAMPLE_SPECS::sample_rate_t to_rate);
 
-  static void import_helper(const unsigned char *ibuffer,
-			    buf_size_t* iptr,
-			    sample_t* obuffer,
-			    buf_size_t optr,
-			    ECA_AUDIO_FORMAT::Sample_format fmt);
-  static void export_helper(unsigned char* obuffer, 
-			    buf_size_t* optr,
-			    sample_t value,
-			    ECA_AUDIO_FORMAT::Sample_format fmt);
+  void make_writable(bool keep_content = true);
+  void release_shared_content(bool keep_content);
+
+  void reallocate_storage(channel_size_t channels, buf_size_t samples);
+  void release_storage(void);
+
 
  public:
 
@@ -195,7 +241,14 @@ class SAMPLE_BUFFER {
    *
    * If you do use direct access, then you must also 
    * use the get_pointer_reflock() and release_pointer_reflock()
-   * calls so that reference counting is possible.
+   * calls so that reference counting is possible. Taking
+   * a reflock also ends copy-on-write sharing, so that 
+   * writes through 'buffer' do not modify the shared data
+   * (see share_content()).
+   *
+   * All channels are stored in one memory area, aligned to
+   * SAMPLE_BUFFER_POOL::alignment bytes. 'buffer.size()' is
+   * the number of channels space is reserved for.
    */
   std::vector<sample_t*> buffer;
 
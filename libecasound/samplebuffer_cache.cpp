@@ -0,0 +1,243 @@
+// ------------------------------------------------------------------------
+// samplebuffer_cache.cpp: Memory-bounded cache of decoded audio
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <kvu_dbc.h>
+#include <kvu_locks.h>
+
+#include "samplebuffer.h"
+#include "samplebuffer_cache.h"
+
+const size_t SAMPLE_BUFFER_CACHE::default_size_limit = 32 * 1024 * 1024;
+
+SAMPLE_BUFFER_CACHE* SAMPLE_BUFFER_CACHE::instance_repp = 0;
+pthread_mutex_t SAMPLE_BUFFER_CACHE::instance_lock_rep = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Returns the process-wide cache.
+ */
+SAMPLE_BUFFER_CACHE& SAMPLE_BUFFER_CACHE::instance(void)
+{
+  //
+  // Note! Below we use the Double-Checked Locking Pattern
+  //       to protect against concurrent access
+
+  if (instance_repp == 0) {
+    KVU_GUARD_LOCK guard(&SAMPLE_BUFFER_CACHE::instance_lock_rep);
+    if (instance_repp == 0) {
+      instance_repp = new SAMPLE_BUFFER_CACHE();
+    }
+  }
+  return *instance_repp;
+}
+
+bool SAMPLE_BUFFER_CACHE::key_t::operator<(const key_t& x) const
+{
+  if (pos != x.pos) return pos < x.pos;
+  if (length != x.length) return length < x.length;
+  return source < x.source;
+}
+
+SAMPLE_BUFFER_CACHE::SAMPLE_BUFFER_CACHE(void)
+  : size_limit_rep(0),
+    size_rep(0),
+    hits_rep(0),
+    misses_rep(0)
+{
+  pthread_mutex_init(&lock_rep, NULL);
+}
+
+SAMPLE_BUFFER_CACHE::~SAMPLE_BUFFER_CACHE(void)
+{
+  clear();
+  pthread_mutex_destroy(&lock_rep);
+}
+
+/**
+ * Sets the maximum amount of memory used for cached
+ * audio data. Blocks are dropped if necessary. A limit
+ * of zero disables caching.
+ */
+void SAMPLE_BUFFER_CACHE::set_size_limit(size_t bytes)
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+  size_limit_rep = bytes;
+  drop_blocks(size_limit_rep);
+}
+
+/**
+ * Copies the block of 'length' samples starting at
+ * position 'pos' of 'source' to 'sbuf'.
+ *
+ * @return true if the block was found
+ */
+bool SAMPLE_BUFFER_CACHE::lookup(const std::string& source, SAMPLE_SPECS::sample_pos_t pos, long int length, SAMPLE_BUFFER* sbuf)
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+
+  key_t key;
+  key.source = source;
+  key.pos = pos;
+  key.length = length;
+
+  std::map<key_t,block_list_t::iterator>::iterator p = index_rep.find(key);
+  if (p == index_rep.end()) {
+    ++misses_rep;
+    return false;
+  }
+
+  /* note: move to the front of the LRU list */
+  blocks_rep.splice(blocks_rep.begin(), blocks_rep, p->second);
+  sbuf->copy_all_content(*p->second->sbuf);
+  ++hits_rep;
+
+  return true;
+}
+
+/**
+ * Stores a copy of 'sbuf' as the block starting at
+ * position 'pos' of 'source'. The least recently used
+ * blocks are dropped to keep the cache within its size
+ * limit.
+ */
+void SAMPLE_BUFFER_CACHE::store(const std::string& source, SAMPLE_SPECS::sample_pos_t pos, const SAMPLE_BUFFER& sbuf)
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+
+  size_t bytes = sizeof(SAMPLE_BUFFER::sample_t) *
+    sbuf.number_of_channels() * sbuf.length_in_samples();
+  if (bytes == 0 || bytes > size_limit_rep)
+    return;
+
+  key_t key;
+  key.source = source;
+  key.pos = pos;
+  key.length = sbuf.length_in_samples();
+
+  std::map<key_t,block_list_t::iterator>::iterator p = index_rep.find(key);
+  if (p != index_rep.end())
+    drop_block(p->second);
+
+  drop_blocks(size_limit_rep - bytes);
+
+  block_t block;
+  block.key = key;
+  block.sbuf = new SAMPLE_BUFFER(sbuf.length_in_samples(), sbuf.number_of_channels());
+  block.sbuf->copy_all_content(sbuf);
+  block.bytes = bytes;
+
+  blocks_rep.push_front(block);
+  index_rep[key] = blocks_rep.begin();
+  size_rep += bytes;
+
+  // --
+  DBC_ENSURE(size_rep <= size_limit_rep);
+  // --
+}
+
+/**
+ * Drops all blocks whose source starts with 'prefix'.
+ */
+void SAMPLE_BUFFER_CACHE::forget(const std::string& prefix)
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+
+  block_list_t::iterator p = blocks_rep.begin();
+  while(p != blocks_rep.end()) {
+    block_list_t::iterator next = p;
+    ++next;
+    if (p->key.source.compare(0, prefix.size(), prefix) == 0)
+      drop_block(p);
+    p = next;
+  }
+}
+
+/**
+ * Drops all blocks.
+ */
+void SAMPLE_BUFFER_CACHE::clear(void)
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+  drop_blocks(0);
+}
+
+/**
+ * Registers an object reading 'source'.
+ */
+void SAMPLE_BUFFER_CACHE::add_reader(const std::string& source)
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+  ++readers_rep[source];
+}
+
+/**
+ * Unregisters an object registered with add_reader().
+ */
+void SAMPLE_BUFFER_CACHE::remove_reader(const std::string& source)
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+
+  std::map<std::string,int>::iterator p = readers_rep.find(source);
+  DBC_CHECK(p != readers_rep.end());
+  if (p != readers_rep.end() && --p->second == 0)
+    readers_rep.erase(p);
+}
+
+/**
+ * Returns the number of objects registered as
+ * reading 'source'.
+ */
+int SAMPLE_BUFFER_CACHE::readers(const std::string& source) const
+{
+  KVU_GUARD_LOCK guard(&lock_rep);
+
+  std::map<std::string,int>::const_iterator p = readers_rep.find(source);
+  if (p == readers_rep.end())
+    return 0;
+  return p->second;
+}
+
+/**
+ * Drops block 'p'. Caller must hold the lock.
+ */
+void SAMPLE_BUFFER_CACHE::drop_block(block_list_t::iterator p)
+{
+  size_rep -= p->bytes;
+  delete p->sbuf;
+  index_rep.erase(p->key);
+  blocks_rep.erase(p);
+}
+
+/**
+ * Drops least recently used blocks until at most
+ * 'limit' bytes are used. Caller must hold the lock.
+ */
+void SAMPLE_BUFFER_CACHE::drop_blocks(size_t limit)
+{
+  while(size_rep > limit) {
+    block_list_t::iterator p = blocks_rep.end();
+    --p;
+    drop_block(p);
+  }
+}
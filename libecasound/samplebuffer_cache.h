@@ -0,0 +1,150 @@
+// ------------------------------------------------------------------------
+// samplebuffer_cache.h: Memory-bounded cache of decoded audio
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDED_SAMPLEBUFFER_CACHE_H
+#define INCLUDED_SAMPLEBUFFER_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+
+#include <pthread.h>
+
+#include "sample-specs.h"
+
+class SAMPLE_BUFFER;
+
+/**
+ * Memory-bounded cache of decoded audio.
+ *
+ * Blocks of decoded audio are stored as SAMPLE_BUFFER
+ * objects, keyed by source, position and length. The
+ * source is a string identifying the file and the
+ * decoding parameters (see AUDIO_IO_BUFFERED). When
+ * the size limit is reached, least recently used
+ * blocks are dropped.
+ *
+ * The cache is disabled (size limit of zero) until a
+ * size limit is set.
+ *
+ * Objects reading a source register themselves with
+ * add_reader(), so that the number of objects reading
+ * the same source can be queried with readers().
+ *
+ * A process-wide cache is returned by instance(). All
+ * public functions lock the cache, so they may be called
+ * from multiple threads, but are not realtime-safe.
+ */
+class SAMPLE_BUFFER_CACHE {
+
+ public:
+
+  /** @name Public constants */
+  /*@{*/
+
+  /** size limit in bytes used when caching is enabled without
+   *  an explicit size */
+  static const size_t default_size_limit;
+
+  /*@}*/
+
+  /** @name Constructors and dtors */
+  /*@{*/
+
+  static SAMPLE_BUFFER_CACHE& instance(void);
+
+  SAMPLE_BUFFER_CACHE(void);
+  ~SAMPLE_BUFFER_CACHE(void);
+
+  /*@}*/
+
+  /** @name Public functions for configuration */
+  /*@{*/
+
+  void set_size_limit(size_t bytes);
+  size_t size_limit(void) const { return size_limit_rep; }
+
+  /*@}*/
+
+  /** @name Public functions for accessing cached audio */
+  /*@{*/
+
+  bool lookup(const std::string& source, SAMPLE_SPECS::sample_pos_t pos, long int length, SAMPLE_BUFFER* sbuf);
+  void store(const std::string& source, SAMPLE_SPECS::sample_pos_t pos, const SAMPLE_BUFFER& sbuf);
+  void forget(const std::string& prefix);
+  void clear(void);
+
+  void add_reader(const std::string& source);
+  void remove_reader(const std::string& source);
+  int readers(const std::string& source) const;
+
+  /*@}*/
+
+  /** @name Public functions for acquiring status information */
+  /*@{*/
+
+  size_t size(void) const { return size_rep; }
+  size_t number_of_blocks(void) const { return blocks_rep.size(); }
+  long int hits(void) const { return hits_rep; }
+  long int misses(void) const { return misses_rep; }
+
+  /*@}*/
+
+ private:
+
+  struct key_t {
+    std::string source;
+    SAMPLE_SPECS::sample_pos_t pos;
+    long int length;
+    bool operator<(const key_t& x) const;
+  };
+
+  struct block_t {
+    key_t key;
+    SAMPLE_BUFFER* sbuf;
+    size_t bytes;
+  };
+
+  typedef std::list<block_t> block_list_t;
+
+  void drop_block(block_list_t::iterator p);
+  void drop_blocks(size_t limit);
+
+  static SAMPLE_BUFFER_CACHE* instance_repp;
+  static pthread_mutex_t instance_lock_rep;
+
+  /* note: most recently used block first */
+  block_list_t blocks_rep;
+  std::map<key_t,block_list_t::iterator> index_rep;
+  std::map<std::string,int> readers_rep;
+
+  mutable pthread_mutex_t lock_rep;
+  size_t size_limit_rep;
+  size_t size_rep;
+  long int hits_rep;
+  long int misses_rep;
+
+  SAMPLE_BUFFER_CACHE& operator=(const SAMPLE_BUFFER_CACHE& x) { return *this; }
+  SAMPLE_BUFFER_CACHE(const SAMPLE_BUFFER_CACHE& x) { }
+};
+
+#endif
@@ -53,6 +53,7 @@ void SAMPLE_BUFFER_FUNCTIONS::fill_with_random_samples(SAMPLE_BUFFER *sbuf)
       std::memcpy(buf, &foo, sizeof(SAMPLE_BUFFER::sample_t));
     }
   }
+  sbuf->event_tag_set(SAMPLE_BUFFER::tag_silent, false);
 }
 
 /**
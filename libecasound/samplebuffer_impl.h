@@ -2,7 +2,11 @@
 #define INCLUDED_SAMPLEBUFFER_IMPL_H
 
 #include <vector>
+
+#include <kvu_locks.h>
+
 #include "samplebuffer.h" 
+#include "samplebuffer_pool.h"
 
 #ifdef HAVE_CONFIG_H
 #include <config.h>
@@ -24,7 +28,7 @@ class SAMPLE_BUFFER_impl {
   /*@{*/
   
   bool rt_lock_rep;
-  int lockref_rep;
+  ATOMIC_INTEGER lockref_rep;
   int quality_rep;
   int event_tags_rep;
 
@@ -36,6 +40,23 @@ class SAMPLE_BUFFER_impl {
 #endif
 
   /*@}*/
+
+  /** @name Copy-on-write sharing, see SAMPLE_BUFFER::share_content() */
+  /*@{*/
+
+  const SAMPLE_BUFFER* shared_source_repp;
+  SAMPLE_BUFFER::channel_size_t shared_channels_rep;
+
+  /*@}*/
+
+  /** @name Audio data storage, see SAMPLE_BUFFER::set_pool() */
+  /*@{*/
+
+  SAMPLE_BUFFER::sample_t* slab_repp;
+  SAMPLE_BUFFER_POOL* slab_pool_repp; // pool owning 'slab_repp', or 0
+  SAMPLE_BUFFER_POOL* pool_repp;
+
+  /*@}*/
 };
 
 #endif
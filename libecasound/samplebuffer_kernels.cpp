@@ -0,0 +1,303 @@
+// ------------------------------------------------------------------------
+// samplebuffer_kernels.cpp: Runtime-selected inner loops for SAMPLE_BUFFER
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string>
+
+#ifdef ECA_USE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#ifdef ECA_USE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#include "samplebuffer_kernels.h"
+#include "eca-logger.h"
+
+typedef SAMPLE_BUFFER_KERNELS::sample_t sample_t;
+typedef SAMPLE_BUFFER_KERNELS::buf_size_t buf_size_t;
+
+/**
+ * Prevents the compiler from contracting a multiply and 
+ * a following add into a fused multiply-add (allowed 
+ * with -ffast-math), which would make the results 
+ * depend on the instruction set used.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ECA_NO_CONTRACT(x) __asm__("" : "+v"(x))
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define ECA_NO_CONTRACT(x) __asm__("" : "+w"(x))
+#else
+#define ECA_NO_CONTRACT(x) ((void)0)
+#endif
+
+/**
+ * Generic implementation. Also used for processing
+ * the samples left over by the vectorized loops.
+ */
+
+static void generic_add(sample_t* dst, const sample_t* src, buf_size_t len)
+{
+  for(buf_size_t n = 0; n < len; n++)
+    dst[n] += src[n];
+}
+
+static void generic_add_scaled(sample_t* dst, const sample_t* src, sample_t factor, buf_size_t len)
+{
+  for(buf_size_t n = 0; n < len; n++) {
+    sample_t p = src[n] * factor;
+    ECA_NO_CONTRACT(p);
+    dst[n] += p;
+  }
+}
+
+static void generic_multiply(sample_t* dst, sample_t factor, buf_size_t len)
+{
+  for(buf_size_t n = 0; n < len; n++)
+    dst[n] *= factor;
+}
+
+static void generic_limit(sample_t* dst, sample_t min, sample_t max, buf_size_t len)
+{
+  for(buf_size_t n = 0; n < len; n++) {
+    if (dst[n] > max)
+      dst[n] = max;
+    else if (dst[n] < min)
+      dst[n] = min;
+  }
+}
+
+static const SAMPLE_BUFFER_KERNELS priv_generic_kernels = {
+  generic_add, generic_add_scaled, generic_multiply, generic_limit, "generic"
+};
+
+#ifdef ECA_USE_SIMD_X86
+
+/**
+ * Generates the x86 kernels for one instruction set.
+ *
+ * Note: there are no division kernels, as with -ffast-math 
+ *       the compiler may replace vector divisions with
+ *       reciprocal approximations that are not bit-exact
+ *
+ * Note: max(min,x) and min(max,x) return 'x' if it is NaN,
+ *       so limit matches the generic version also for NaNs
+ */
+#define ECA_X86_KERNELS(prefix, isa, width, vec, loadu, storeu, set1, add, mul, vmin, vmax) \
+  __attribute__((target(isa)))					\
+  static void prefix##_add(sample_t* dst, const sample_t* src, buf_size_t len) \
+  {									\
+    buf_size_t n = 0;							\
+    for(; n + width <= len; n += width)					\
+      storeu(dst + n, add(loadu(dst + n), loadu(src + n)));		\
+    generic_add(dst + n, src + n, len - n);				\
+  }									\
+  __attribute__((target(isa)))					\
+  static void prefix##_add_scaled(sample_t* dst, const sample_t* src, sample_t factor, buf_size_t len) \
+  {									\
+    vec f = set1(factor);						\
+    buf_size_t n = 0;							\
+    for(; n + width <= len; n += width) {				\
+      vec p = mul(loadu(src + n), f);					\
+      ECA_NO_CONTRACT(p);						\
+      storeu(dst + n, add(loadu(dst + n), p));				\
+    }									\
+    generic_add_scaled(dst + n, src + n, factor, len - n);		\
+  }									\
+  __attribute__((target(isa)))					\
+  static void prefix##_multiply(sample_t* dst, sample_t factor, buf_size_t len) \
+  {									\
+    vec f = set1(factor);						\
+    buf_size_t n = 0;							\
+    for(; n + width <= len; n += width)					\
+      storeu(dst + n, mul(loadu(dst + n), f));				\
+    generic_multiply(dst + n, factor, len - n);				\
+  }									\
+  __attribute__((target(isa)))					\
+  static void prefix##_limit(sample_t* dst, sample_t min, sample_t max, buf_size_t len) \
+  {									\
+    vec lo = set1(min);							\
+    vec hi = set1(max);							\
+    buf_size_t n = 0;							\
+    for(; n + width <= len; n += width)					\
+      storeu(dst + n, vmin(hi, vmax(lo, loadu(dst + n))));		\
+    generic_limit(dst + n, min, max, len - n);				\
+  }									\
+  static const SAMPLE_BUFFER_KERNELS priv_##prefix##_kernels = {	\
+    prefix##_add, prefix##_add_scaled, prefix##_multiply, prefix##_limit, isa \
+  };
+
+ECA_X86_KERNELS(sse2, "sse2", 4, __m128,
+		_mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps,
+		_mm_add_ps, _mm_mul_ps, _mm_min_ps, _mm_max_ps)
+ECA_X86_KERNELS(avx, "avx", 8, __m256,
+		_mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps,
+		_mm256_add_ps, _mm256_mul_ps, _mm256_min_ps, _mm256_max_ps)
+/**
+ * Note: the unmasked AVX-512 min/max intrinsics pass an
+ *       undefined vector as the merge source, which
+ *       triggers -Wmaybe-uninitialized warnings; the zero-masked
+ *       variants with a full mask are used instead
+ */
+__attribute__((target("avx512f")))
+static inline __m512 avx512_min_ps(__m512 a, __m512 b)
+{
+  return _mm512_maskz_min_ps(0xffff, a, b);
+}
+
+__attribute__((target("avx512f")))
+static inline __m512 avx512_max_ps(__m512 a, __m512 b)
+{
+  return _mm512_maskz_max_ps(0xffff, a, b);
+}
+
+ECA_X86_KERNELS(avx512, "avx512f", 16, __m512,
+		_mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps,
+		_mm512_add_ps, _mm512_mul_ps, avx512_min_ps, avx512_max_ps)
+
+#endif /* ECA_USE_SIMD_X86 */
+
+#ifdef ECA_USE_SIMD_NEON
+
+/**
+ * NEON implementation. NEON availability is decided at
+ * build time.
+ *
+ * Note: multiply-accumulate instructions are not used, 
+ *       as fused variants would not be bit-exact
+ */
+
+static void neon_add(sample_t* dst, const sample_t* src, buf_size_t len)
+{
+  buf_size_t n = 0;
+  for(; n + 4 <= len; n += 4)
+    vst1q_f32(dst + n, vaddq_f32(vld1q_f32(dst + n), vld1q_f32(src + n)));
+  generic_add(dst + n, src + n, len - n);
+}
+
+static void neon_add_scaled(sample_t* dst, const sample_t* src, sample_t factor, buf_size_t len)
+{
+  buf_size_t n = 0;
+  for(; n + 4 <= len; n += 4) {
+    float32x4_t p = vmulq_n_f32(vld1q_f32(src + n), factor);
+    ECA_NO_CONTRACT(p);
+    vst1q_f32(dst + n, vaddq_f32(vld1q_f32(dst + n), p));
+  }
+  generic_add_scaled(dst + n, src + n, factor, len - n);
+}
+
+static void neon_multiply(sample_t* dst, sample_t factor, buf_size_t len)
+{
+  buf_size_t n = 0;
+  for(; n + 4 <= len; n += 4)
+    vst1q_f32(dst + n, vmulq_n_f32(vld1q_f32(dst + n), factor));
+  generic_multiply(dst + n, factor, len - n);
+}
+
+static void neon_limit(sample_t* dst, sample_t min, sample_t max, buf_size_t len)
+{
+  float32x4_t lo = vdupq_n_f32(min);
+  float32x4_t hi = vdupq_n_f32(max);
+  buf_size_t n = 0;
+  for(; n + 4 <= len; n += 4) {
+    /* note: select with compares, so that NaNs are passed
+     *       through as in the generic version */
+    float32x4_t v = vld1q_f32(dst + n);
+    v = vbslq_f32(vcgtq_f32(v, hi), hi, v);
+    v = vbslq_f32(vcltq_f32(v, lo), lo, v);
+    vst1q_f32(dst + n, v);
+  }
+  generic_limit(dst + n, min, max, len - n);
+}
+
+static const SAMPLE_BUFFER_KERNELS priv_neon_kernels = {
+  neon_add, neon_add_scaled, neon_multiply, neon_limit, "neon"
+};
+
+#endif /* ECA_USE_SIMD_NEON */
+
+static const SAMPLE_BUFFER_KERNELS* priv_active_kernels = 0;
+
+/**
+ * Returns kernel implementations supported by the
+ * CPU, fastest first. At most 'max' items are stored
+ * to 'sets'. The generic implementation is always
+ * included.
+ *
+ * @return number of items stored
+ *
+ * @pre max > 0
+ */
+int SAMPLE_BUFFER_KERNELS::supported(const SAMPLE_BUFFER_KERNELS** sets, int max)
+{
+  int count = 0;
+
+#ifdef ECA_USE_SIMD_X86
+  __builtin_cpu_init();
+  if (count < max && __builtin_cpu_supports("avx512f"))
+    sets[count++] = &priv_avx512_kernels;
+  if (count < max && __builtin_cpu_supports("avx"))
+    sets[count++] = &priv_avx_kernels;
+  if (count < max && __builtin_cpu_supports("sse2"))
+    sets[count++] = &priv_sse2_kernels;
+#endif
+
+#ifdef ECA_USE_SIMD_NEON
+  if (count < max)
+    sets[count++] = &priv_neon_kernels;
+#endif
+
+  if (count < max)
+    sets[count++] = &priv_generic_kernels;
+
+  return count;
+}
+
+/**
+ * Returns the generic implementation.
+ */
+const SAMPLE_BUFFER_KERNELS* SAMPLE_BUFFER_KERNELS::generic(void)
+{
+  return &priv_generic_kernels;
+}
+
+/**
+ * Returns the fastest kernel implementation supported
+ * by the CPU. The implementation is selected on first
+ * call.
+ *
+ * Note: not realtime-safe on first call
+ */
+const SAMPLE_BUFFER_KERNELS* SAMPLE_BUFFER_KERNELS::active(void)
+{
+  if (priv_active_kernels == 0) {
+    const SAMPLE_BUFFER_KERNELS* best;
+    SAMPLE_BUFFER_KERNELS::supported(&best, 1);
+    ECA_LOG_MSG(ECA_LOGGER::system_objects,
+		std::string("Sample buffer kernels selected: ") + best->name + ".");
+    priv_active_kernels = best;
+  }
+  return priv_active_kernels;
+}
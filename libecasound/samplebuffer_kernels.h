@@ -0,0 +1,78 @@
+// ------------------------------------------------------------------------
+// samplebuffer_kernels.h: Runtime-selected inner loops for SAMPLE_BUFFER
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDED_SAMPLEBUFFER_KERNELS_H
+#define INCLUDED_SAMPLEBUFFER_KERNELS_H
+
+#include "sample-specs.h"
+
+/**
+ * Inner loops used by SAMPLE_BUFFER arithmetic.
+ *
+ * Several implementations of the kernels are compiled
+ * in (generic C++, and depending on the platform SSE2,
+ * AVX, AVX-512 and NEON). The fastest implementation
+ * supported by the CPU is selected at runtime.
+ *
+ * All implementations produce bit-exact results
+ * compared to the generic version.
+ *
+ * Kernels do not require aligned pointers.
+ */
+class SAMPLE_BUFFER_KERNELS {
+
+ public:
+
+  /** @name Public type definitions */
+  /*@{*/
+
+  typedef SAMPLE_SPECS::sample_t sample_t;
+  typedef long int buf_size_t;
+
+  /*@}*/
+
+  /** @name Kernels */
+  /*@{*/
+
+  /** dst[n] += src[n] */
+  void (*add)(sample_t* dst, const sample_t* src, buf_size_t len);
+  /** dst[n] += src[n] * factor */
+  void (*add_scaled)(sample_t* dst, const sample_t* src, sample_t factor, buf_size_t len);
+  /** dst[n] *= factor */
+  void (*multiply)(sample_t* dst, sample_t factor, buf_size_t len);
+  /** limits dst[n] to range [min,max] */
+  void (*limit)(sample_t* dst, sample_t min, sample_t max, buf_size_t len);
+
+  /*@}*/
+
+  /** @name Public functions for selecting the kernels */
+  /*@{*/
+
+  const char* name;
+
+  static const SAMPLE_BUFFER_KERNELS* active(void);
+  static const SAMPLE_BUFFER_KERNELS* generic(void);
+  static int supported(const SAMPLE_BUFFER_KERNELS** sets, int max);
+
+  /*@}*/
+};
+
+#endif
@@ -0,0 +1,178 @@
+// ------------------------------------------------------------------------
+// samplebuffer_pool.cpp: Preallocated memory for SAMPLE_BUFFER audio data
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h> /* posix_memalign(), free() */
+
+#include <kvu_dbc.h>
+
+#include "samplebuffer_pool.h"
+
+/* note: block index is stored in the low bits of the
+ *       free list head */
+static const int priv_index_mask = 0xffff;
+static const size_t priv_max_blocks = 0xfffe;
+
+/**
+ * Returns new free list head with 'index' as the first
+ * block and the modification counter of 'head' incremented.
+ */
+static inline int priv_next_head(int head, int index)
+{
+  unsigned int counter = static_cast<unsigned int>(head) & ~static_cast<unsigned int>(priv_index_mask);
+  return static_cast<int>((counter + priv_index_mask + 1) | static_cast<unsigned int>(index));
+}
+
+const size_t SAMPLE_BUFFER_POOL::alignment;
+
+SAMPLE_BUFFER_POOL::SAMPLE_BUFFER_POOL(void)
+  : arena_repp(0),
+    block_size_rep(0),
+    head_rep(0),
+    free_count_rep(0)
+{
+}
+
+SAMPLE_BUFFER_POOL::~SAMPLE_BUFFER_POOL(void)
+{
+  DBC_CHECK(free_blocks() == number_of_blocks());
+
+  if (arena_repp != 0) {
+    ::free(arena_repp);
+    arena_repp = 0;
+  }
+}
+
+/**
+ * Allocates memory for 'blocks' blocks of at least
+ * 'block_size' bytes. Any previously reserved memory
+ * is freed.
+ *
+ * Not realtime-safe.
+ *
+ * @pre free_blocks() == number_of_blocks()
+ * @pre blocks <= 65534
+ * @post number_of_blocks() == blocks
+ * @post block_size() >= block_size
+ */
+void SAMPLE_BUFFER_POOL::reserve(size_t blocks, size_t block_size)
+{
+  // --
+  DBC_REQUIRE(free_blocks() == number_of_blocks());
+  DBC_REQUIRE(blocks <= priv_max_blocks);
+  // --
+
+  if (arena_repp != 0) {
+    ::free(arena_repp);
+    arena_repp = 0;
+  }
+
+  /* note: round up so that all blocks are aligned */
+  block_size_rep = (block_size + alignment - 1) / alignment * alignment;
+
+  void* arena = 0;
+  if (blocks > 0 && block_size_rep > 0 &&
+      posix_memalign(&arena, alignment, blocks * block_size_rep) != 0) {
+    arena = 0;
+    blocks = 0;
+  }
+  arena_repp = static_cast<unsigned char*>(arena);
+
+  next_rep.resize(blocks);
+  for(size_t n = 0; n < blocks; n++) {
+    next_rep[n] = (n + 1 < blocks) ? static_cast<int>(n + 2) : 0;
+  }
+  head_rep = (blocks > 0) ? 1 : 0;
+  free_count_rep = blocks;
+
+  // --
+  DBC_ENSURE(block_size_rep >= block_size);
+  // --
+}
+
+/**
+ * Returns a free block, or 0 if all blocks are in use.
+ *
+ * Realtime-safe and lock-free.
+ */
+void* SAMPLE_BUFFER_POOL::allocate(void)
+{
+  while(true) {
+    int head = head_rep;
+    int index = head & priv_index_mask;
+    if (index == 0)
+      return 0;
+
+    int newhead = priv_next_head(head, next_rep[index - 1]);
+    if (__sync_bool_compare_and_swap(&head_rep, head, newhead) == true) {
+      __sync_add_and_fetch(&free_count_rep, -1);
+      return arena_repp + (index - 1) * block_size_rep;
+    }
+  }
+}
+
+/**
+ * Returns 'block' back to the pool.
+ *
+ * Realtime-safe and lock-free.
+ *
+ * @pre owns(block) == true
+ */
+void SAMPLE_BUFFER_POOL::release(void* block)
+{
+  // --
+  DBC_REQUIRE(owns(block) == true);
+  // --
+
+  int index = static_cast<int>((static_cast<unsigned char*>(block) - arena_repp) / block_size_rep) + 1;
+
+  while(true) {
+    int head = head_rep;
+    next_rep[index - 1] = head & priv_index_mask;
+    int newhead = priv_next_head(head, index);
+    if (__sync_bool_compare_and_swap(&head_rep, head, newhead) == true) {
+      __sync_add_and_fetch(&free_count_rep, 1);
+      return;
+    }
+  }
+}
+
+/**
+ * Returns number of blocks not in use.
+ */
+size_t SAMPLE_BUFFER_POOL::free_blocks(void) const
+{
+  return free_count_rep;
+}
+
+/**
+ * Whether 'ptr' points to a block in this pool.
+ */
+bool SAMPLE_BUFFER_POOL::owns(const void* ptr) const
+{
+  const unsigned char* p = static_cast<const unsigned char*>(ptr);
+  return (arena_repp != 0 &&
+	  p >= arena_repp &&
+	  p < arena_repp + next_rep.size() * block_size_rep);
+}
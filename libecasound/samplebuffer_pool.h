@@ -0,0 +1,103 @@
+// ------------------------------------------------------------------------
+// samplebuffer_pool.h: Preallocated memory for SAMPLE_BUFFER audio data
+//
+// Attributes:
+//     eca-style-version: 3
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+// ------------------------------------------------------------------------
+
+#ifndef INCLUDED_SAMPLEBUFFER_POOL_H
+#define INCLUDED_SAMPLEBUFFER_POOL_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Preallocated memory for SAMPLE_BUFFER audio data.
+ *
+ * The pool is one contiguous memory area that is
+ * divided into equally sized blocks. Blocks are
+ * aligned to SAMPLE_BUFFER_POOL::alignment bytes.
+ *
+ * Memory is allocated in reserve(). allocate() and
+ * release() are realtime-safe and lock-free, and
+ * can be called from multiple threads concurrently.
+ *
+ * @see SAMPLE_BUFFER::set_pool()
+ */
+class SAMPLE_BUFFER_POOL {
+
+ public:
+
+  /** @name Public constants */
+  /*@{*/
+
+  /** alignment of blocks in bytes (cache line size) */
+  static const size_t alignment = 64;
+
+  /*@}*/
+
+  /** @name Constructors and dtors */
+  /*@{*/
+
+  SAMPLE_BUFFER_POOL(void);
+  ~SAMPLE_BUFFER_POOL(void);
+
+  /*@}*/
+
+  /** @name Public functions for reserving memory */
+  /*@{*/
+
+  void reserve(size_t blocks, size_t block_size);
+
+  /*@}*/
+
+  /** @name Public functions for allocating blocks */
+  /*@{*/
+
+  void* allocate(void);
+  void release(void* block);
+
+  /*@}*/
+
+  /** @name Public functions for acquiring status information */
+  /*@{*/
+
+  size_t block_size(void) const { return block_size_rep; }
+  size_t number_of_blocks(void) const { return next_rep.size(); }
+  size_t free_blocks(void) const;
+  bool owns(const void* ptr) const;
+
+  /*@}*/
+
+ private:
+
+  unsigned char* arena_repp;
+  size_t block_size_rep;
+
+  /* note: free list; 'head_rep' holds index of the first
+   *       free block plus one (zero if no free blocks) in
+   *       the low 16 bits, and a modification counter in
+   *       the high bits to avoid ABA problems */
+  std::vector<int> next_rep;
+  volatile int head_rep;
+  volatile int free_count_rep;
+
+  SAMPLE_BUFFER_POOL& operator=(const SAMPLE_BUFFER_POOL& x) { return *this; }
+  SAMPLE_BUFFER_POOL(const SAMPLE_BUFFER_POOL& x) { }
+};
+
+#endif
@@ -18,13 +18,19 @@
 // ------------------------------------------------------------------------
 
 #include <string>
+#include <vector>
 #include <cstdio>
+#include <cstring>
 
 #include "kvu_dbc.h"
 #include "kvu_inttypes.h"
+#include "kvu_numtostr.h"
 
 #include "samplebuffer.h"
 #include "samplebuffer_functions.h"
+#include "samplebuffer_kernels.h"
+#include "samplebuffer_pool.h"
+#include "samplebuffer_cache.h"
 #include "eca-test-case.h"
 
 using namespace std;
@@ -45,8 +51,24 @@ public:
 
 private:
 
+  static void fill_with_test_signal(SAMPLE_BUFFER* sbuf);
 };
 
+/**
+ * Fills 'sbuf' with a deterministic signal that
+ * exceeds the nominal sample range.
+ */
+void SAMPLE_BUFFER_TEST::fill_with_test_signal(SAMPLE_BUFFER* sbuf)
+{
+  for(int c = 0; c < sbuf->number_of_channels(); c++) {
+    for(int n = 0; n < sbuf->length_in_samples(); n++) {
+      sbuf->buffer[c][n] = 
+	static_cast<SAMPLE_BUFFER::sample_t>(((n * 7919 + c * 104729) % 4001) - 2000) / 999.7f;
+    }
+  }
+  sbuf->event_tag_set(SAMPLE_BUFFER::tag_silent, false);
+}
+
 void SAMPLE_BUFFER_TEST::do_run(void)
 {
   const int bufsize = 1024;
@@ -122,4 +144,459 @@ void SAMPLE_BUFFER_TEST::do_run(void)
       ECA_TEST_FAILURE("optimized add_matching_channels");
     }
   }
+
+  /* case: add_with_weight */
+  {
+    std::fprintf(stdout, "%s: add_with_weight\n",
+		 __FILE__);
+    SAMPLE_BUFFER sbuf_orig (bufsize, channels);
+    SAMPLE_BUFFER sbuf_ref (bufsize, channels);
+    SAMPLE_BUFFER sbuf_test (bufsize, channels);
+
+    fill_with_test_signal(&sbuf_orig);
+
+    sbuf_test.copy_all_content(sbuf_orig);
+    sbuf_ref.copy_all_content(sbuf_orig);
+
+    sbuf_test.add_with_weight(sbuf_orig, 3);
+    sbuf_ref.add_with_weight_ref(sbuf_orig, 3);
+    
+    if (SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_ref, sbuf_test) != true) { 
+      ECA_TEST_FAILURE("optimized add_with_weight");
+    }
+  }
+
+  /* case: limit_values */
+  {
+    std::fprintf(stdout, "%s: limit_values\n",
+		 __FILE__);
+    SAMPLE_BUFFER sbuf_ref (bufsize, channels);
+    SAMPLE_BUFFER sbuf_test (bufsize, channels);
+
+    fill_with_test_signal(&sbuf_test);
+    sbuf_ref.copy_all_content(sbuf_test);
+
+    sbuf_test.limit_values();
+    sbuf_ref.limit_values_ref();
+    
+    if (SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_ref, sbuf_test) != true) { 
+      ECA_TEST_FAILURE("optimized limit_values");
+    }
+  }
+
+  /* case: make_silent_range */
+  {
+    std::fprintf(stdout, "%s: make_silent_range\n",
+		 __FILE__);
+    SAMPLE_BUFFER sbuf_ref (bufsize, channels);
+    SAMPLE_BUFFER sbuf_test (bufsize, channels);
+
+    fill_with_test_signal(&sbuf_test);
+    sbuf_ref.copy_all_content(sbuf_test);
+
+    sbuf_test.make_silent_range(bufsize / 2, bufsize * 2);
+    sbuf_ref.make_silent_range_ref(bufsize / 2, bufsize * 2);
+    sbuf_test.make_silent_range(3, 17);
+    sbuf_ref.make_silent_range_ref(3, 17);
+    
+    if (SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_ref, sbuf_test) != true) { 
+      ECA_TEST_FAILURE("optimized make_silent_range");
+    }
+  }
+
+  /* case: all kernel implementations supported by the CPU
+   *       must be bit-exact with the generic version */
+  {
+    std::fprintf(stdout, "%s: SAMPLE_BUFFER_KERNELS\n",
+		 __FILE__);
+    const SAMPLE_BUFFER_KERNELS* sets[16];
+    int count = SAMPLE_BUFFER_KERNELS::supported(sets, 16);
+    const SAMPLE_BUFFER_KERNELS* generic = SAMPLE_BUFFER_KERNELS::generic();
+
+    SAMPLE_BUFFER src (bufsize, 1);
+    SAMPLE_BUFFER dst_orig (bufsize, 1);
+    SAMPLE_BUFFER dst_ref (bufsize, 1);
+    SAMPLE_BUFFER dst_test (bufsize, 1);
+    fill_with_test_signal(&src);
+    fill_with_test_signal(&dst_orig);
+    dst_orig.multiply_by_ref(-0.5f);
+
+    /* note: odd offset and length to test unaligned 
+     *       access and leftover samples */
+    const int off = 1, len = bufsize - 6;
+    SAMPLE_BUFFER::sample_t* s = src.buffer[0] + off;
+    SAMPLE_BUFFER::sample_t* r = dst_ref.buffer[0] + off;
+    SAMPLE_BUFFER::sample_t* t = dst_test.buffer[0] + off;
+    size_t bytes = sizeof(SAMPLE_BUFFER::sample_t) * bufsize;
+
+    for(int n = 0; n < count; n++) {
+      std::fprintf(stdout, "%s: kernels '%s'\n", __FILE__, sets[n]->name);
+
+      dst_ref.copy_all_content(dst_orig);
+      dst_test.copy_all_content(dst_orig);
+      generic->add(r, s, len);
+      sets[n]->add(t, s, len);
+      if (std::memcmp(dst_ref.buffer[0], dst_test.buffer[0], bytes) != 0)
+	ECA_TEST_FAILURE(std::string("kernel add, ") + sets[n]->name);
+
+      dst_ref.copy_all_content(dst_orig);
+      dst_test.copy_all_content(dst_orig);
+      generic->add_scaled(r, s, 1.0f / 3, len);
+      sets[n]->add_scaled(t, s, 1.0f / 3, len);
+      if (std::memcmp(dst_ref.buffer[0], dst_test.buffer[0], bytes) != 0)
+	ECA_TEST_FAILURE(std::string("kernel add_scaled, ") + sets[n]->name);
+
+      dst_ref.copy_all_content(dst_orig);
+      dst_test.copy_all_content(dst_orig);
+      generic->multiply(r, multiplier, len);
+      sets[n]->multiply(t, multiplier, len);
+      if (std::memcmp(dst_ref.buffer[0], dst_test.buffer[0], bytes) != 0)
+	ECA_TEST_FAILURE(std::string("kernel multiply, ") + sets[n]->name);
+
+      dst_ref.copy_all_content(dst_orig);
+      dst_test.copy_all_content(dst_orig);
+      generic->limit(r, -1.0f, 1.0f, len);
+      sets[n]->limit(t, -1.0f, 1.0f, len);
+      if (std::memcmp(dst_ref.buffer[0], dst_test.buffer[0], bytes) != 0)
+	ECA_TEST_FAILURE(std::string("kernel limit, ") + sets[n]->name);
+    }
+  }
+
+  /* case: share_content */
+  {
+    std::fprintf(stdout, "%s: share_content\n",
+		 __FILE__);
+    SAMPLE_BUFFER sbuf_orig (bufsize, channels);
+    SAMPLE_BUFFER sbuf_ref (bufsize, channels);
+    SAMPLE_BUFFER sbuf_test (bufsize, channels);
+
+    for(int c = 0; c < channels; c++) {
+      for(int n = 0; n < bufsize; n++) {
+	sbuf_orig.buffer[c][n] = static_cast<SAMPLE_BUFFER::sample_t>(c * bufsize + n) / (channels * bufsize);
+      }
+    }
+    sbuf_ref.copy_all_content(sbuf_orig);
+
+    /* note: shared buffer must read the source data */
+    sbuf_test.share_content(sbuf_orig);
+    if (sbuf_test.is_content_shared() != true ||
+	sbuf_test.buffer[0] != sbuf_orig.buffer[0]) {
+      ECA_TEST_FAILURE("share_content not shared");
+    }
+    if (SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_orig, sbuf_test) != true) { 
+      ECA_TEST_FAILURE("share_content data");
+    }
+
+    /* note: modifications must not affect the source */
+    sbuf_test.multiply_by(multiplier);
+    sbuf_ref.multiply_by(multiplier);
+    if (sbuf_test.is_content_shared() == true ||
+	SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_ref, sbuf_test) != true) { 
+      ECA_TEST_FAILURE("share_content copy-on-write");
+    }
+    sbuf_ref.copy_all_content(sbuf_orig);
+    sbuf_test.share_content(sbuf_orig);
+    sbuf_test.make_silent();
+    if (SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_ref, sbuf_orig) != true) { 
+      ECA_TEST_FAILURE("share_content source modified");
+    }
+
+    /* note: unsharing copies the data */
+    sbuf_test.share_content(sbuf_orig);
+    sbuf_test.unshare_content();
+    if (sbuf_test.buffer[0] == sbuf_orig.buffer[0] ||
+	SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_orig, sbuf_test) != true) { 
+      ECA_TEST_FAILURE("unshare_content");
+    }
+  }
+
+  /* case: import and export in all sample formats */
+  {
+    std::fprintf(stdout, "%s: import/export\n",
+		 __FILE__);
+    static const ECA_AUDIO_FORMAT::Sample_format fmts[] = {
+      ECA_AUDIO_FORMAT::sfmt_u8,
+      ECA_AUDIO_FORMAT::sfmt_s16_le, ECA_AUDIO_FORMAT::sfmt_s16_be,
+      ECA_AUDIO_FORMAT::sfmt_s24_le, ECA_AUDIO_FORMAT::sfmt_s24_be,
+      ECA_AUDIO_FORMAT::sfmt_s32_le, ECA_AUDIO_FORMAT::sfmt_s32_be,
+      ECA_AUDIO_FORMAT::sfmt_f32_le, ECA_AUDIO_FORMAT::sfmt_f32_be };
+    static const int fmtbytes[] = { 1, 2, 2, 3, 3, 4, 4, 4, 4 };
+    const int fmtcount = sizeof(fmtbytes) / sizeof(fmtbytes[0]);
+    const int ch = 3;
+    const size_t maxbytes = bufsize * ch * 4;
+
+    SAMPLE_BUFFER sbuf_orig (bufsize, ch);
+    SAMPLE_BUFFER sbuf_test (bufsize, ch);
+    fill_with_test_signal(&sbuf_orig);
+    std::vector<unsigned char> raw1 (maxbytes), raw2 (maxbytes);
+
+    for(int f = 0; f < fmtcount; f++) {
+      ECA_AUDIO_FORMAT::Sample_coding coding = 
+	(f >= fmtcount - 2) ? ECA_AUDIO_FORMAT::sc_float : ECA_AUDIO_FORMAT::sc_signed;
+      size_t bytes = fmtbytes[f] * bufsize * ch;
+
+      /* note: after the first conversion, values are
+       *       representable in the format, so a second 
+       *       round must produce identical data */
+      for(int interleaved = 0; interleaved < 2; interleaved++) {
+	std::memset(&raw1[0], 0, maxbytes);
+	std::memset(&raw2[0], 0, maxbytes);
+	if (interleaved) {
+	  sbuf_orig.export_interleaved(&raw1[0], fmts[f], coding, ch);
+	  sbuf_test.import_interleaved(&raw1[0], bufsize, fmts[f], ch);
+	  sbuf_test.export_interleaved(&raw2[0], fmts[f], coding, ch);
+	}
+	else {
+	  sbuf_orig.export_noninterleaved(&raw1[0], fmts[f], coding, ch);
+	  sbuf_test.import_noninterleaved(&raw1[0], bufsize, fmts[f], ch);
+	  sbuf_test.export_noninterleaved(&raw2[0], fmts[f], coding, ch);
+	}
+	if (std::memcmp(&raw1[0], &raw2[0], maxbytes) != 0 ||
+	    (bytes < maxbytes && raw1[bytes] != 0)) {
+	  ECA_TEST_FAILURE(std::string("import/export round-trip, format ") + kvu_numtostr(f) +
+			   (interleaved ? ", interleaved" : ", noninterleaved"));
+	}
+      }
+    }
+
+    /* note: per-channel conversion in two pieces, as done
+     *       with wrapping memory-mapped device buffers, must 
+     *       match whole-buffer interleaved conversion */
+    for(int f = 0; f < fmtcount; f++) {
+      ECA_AUDIO_FORMAT::Sample_coding coding = 
+	(f >= fmtcount - 2) ? ECA_AUDIO_FORMAT::sc_float : ECA_AUDIO_FORMAT::sc_signed;
+      size_t stride = fmtbytes[f] * ch;
+      const int split = bufsize / 3;
+
+      sbuf_orig.export_interleaved(&raw1[0], fmts[f], coding, ch);
+      sbuf_test.make_silent();
+      for(int c = 0; c < ch; c++) {
+	sbuf_test.import_channel(&raw1[c * fmtbytes[f]], stride, 0, split, fmts[f], c);
+	sbuf_test.import_channel(&raw1[split * stride + c * fmtbytes[f]], stride, 
+				 split, bufsize - split, fmts[f], c);
+      }
+      std::memset(&raw2[0], 0, maxbytes);
+      for(int c = 0; c < ch; c++) {
+	sbuf_test.export_channel(&raw2[c * fmtbytes[f]], stride, 0, split, fmts[f], coding, c);
+	sbuf_test.export_channel(&raw2[split * stride + c * fmtbytes[f]], stride, 
+				 split, bufsize - split, fmts[f], coding, c);
+      }
+      if (std::memcmp(&raw1[0], &raw2[0], stride * bufsize) != 0) {
+	ECA_TEST_FAILURE(std::string("import/export_channel, format ") + kvu_numtostr(f));
+      }
+    }
+
+    /* note: check byte order of the raw data; the last
+     *       channel is interleaved as the second sample */
+    SAMPLE_BUFFER sbuf_half (1, 2);
+    sbuf_half.buffer[0][0] = 0.0f;
+    sbuf_half.buffer[1][0] = 0.5f;
+    static const unsigned char s16_le[] = { 0x00, 0x00, 0x00, 0x40 };
+    static const unsigned char s24_be[] = { 0x00, 0x00, 0x00, 0x40, 0x00, 0x00 };
+    static const unsigned char f32_le[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f };
+    sbuf_half.export_interleaved(&raw1[0], ECA_AUDIO_FORMAT::sfmt_s16_le, ECA_AUDIO_FORMAT::sc_signed, 2);
+    if (std::memcmp(&raw1[0], s16_le, sizeof(s16_le)) != 0)
+      ECA_TEST_FAILURE("export byte order, s16_le");
+    sbuf_half.export_interleaved(&raw1[0], ECA_AUDIO_FORMAT::sfmt_s24_be, ECA_AUDIO_FORMAT::sc_signed, 2);
+    if (std::memcmp(&raw1[0], s24_be, sizeof(s24_be)) != 0)
+      ECA_TEST_FAILURE("export byte order, s24_be");
+    sbuf_half.export_interleaved(&raw1[0], ECA_AUDIO_FORMAT::sfmt_f32_le, ECA_AUDIO_FORMAT::sc_float, 2);
+    if (std::memcmp(&raw1[0], f32_le, sizeof(f32_le)) != 0)
+      ECA_TEST_FAILURE("export byte order, f32_le");
+  }
+
+  /* case: storage alignment and the buffer pool */
+  {
+    std::fprintf(stdout, "%s: set_pool\n",
+		 __FILE__);
+    SAMPLE_BUFFER_POOL pool;
+    SAMPLE_BUFFER sbuf_orig (bufsize - 3, 2);
+    fill_with_test_signal(&sbuf_orig);
+
+    for(int c = 0; c < sbuf_orig.number_of_channels(); c++) {
+      if (reinterpret_cast<size_t>(sbuf_orig.buffer[c]) % SAMPLE_BUFFER_POOL::alignment != 0)
+	ECA_TEST_FAILURE("storage alignment");
+    }
+
+    pool.reserve(2, sbuf_orig.storage_size(channels));
+    {
+      SAMPLE_BUFFER sbuf_test (bufsize - 3, 2);
+      sbuf_test.copy_all_content(sbuf_orig);
+      sbuf_test.set_pool(&pool);
+      if (pool.free_blocks() != 1 ||
+	  pool.owns(sbuf_test.buffer[0]) != true ||
+	  SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_orig, sbuf_test) != true) {
+	ECA_TEST_FAILURE("set_pool");
+      }
+
+      /* note: channels that fit into the pool block must not
+       *       cause reallocation */
+      SAMPLE_BUFFER::sample_t* first = sbuf_test.buffer[0];
+      sbuf_test.number_of_channels(channels);
+      if (sbuf_test.buffer[0] != first ||
+	  sbuf_test.buffer[channels - 1][0] != SAMPLE_SPECS::silent_value) {
+	ECA_TEST_FAILURE("set_pool, number_of_channels");
+      }
+      for(int c = 0; c < channels; c++) {
+	if (reinterpret_cast<size_t>(sbuf_test.buffer[c]) % SAMPLE_BUFFER_POOL::alignment != 0)
+	  ECA_TEST_FAILURE("set_pool, alignment");
+      }
+
+      sbuf_test.set_pool(0);
+      if (pool.free_blocks() != 2 ||
+	  pool.owns(sbuf_test.buffer[0]) == true) {
+	ECA_TEST_FAILURE("set_pool, detach");
+      }
+      sbuf_test.set_pool(&pool);
+    }
+    if (pool.free_blocks() != 2)
+      ECA_TEST_FAILURE("set_pool, block not released");
+  }
+
+  {
+    std::fprintf(stdout, "%s: reserve_channels\n",
+		 __FILE__);
+    SAMPLE_BUFFER sbuf_test (bufsize, 1);
+    sbuf_test.reserve_channels(channels);
+    sbuf_test.reserve_length_in_samples(bufsize * 2);
+    if (sbuf_test.number_of_channels() != 1 ||
+	sbuf_test.length_in_samples() != bufsize ||
+	sbuf_test.reserved_channels() < channels ||
+	sbuf_test.reserved_length_in_samples() < bufsize * 2) {
+      ECA_TEST_FAILURE("reserve_channels");
+    }
+  }
+
+  /* case: cache of decoded audio */
+  {
+    std::fprintf(stdout, "%s: SAMPLE_BUFFER_CACHE\n",
+		 __FILE__);
+    SAMPLE_BUFFER_CACHE cache;
+    SAMPLE_BUFFER sbuf_orig (bufsize, 2);
+    SAMPLE_BUFFER sbuf_test (bufsize, 2);
+    fill_with_test_signal(&sbuf_orig);
+    const size_t bytes = sizeof(SAMPLE_BUFFER::sample_t) * 2 * bufsize;
+
+    cache.set_size_limit(2 * bytes);
+    cache.store("a:1:", 0, sbuf_orig);
+    cache.store("a:1:", bufsize, sbuf_orig);
+    if (cache.lookup("a:1:", 0, bufsize, &sbuf_test) != true ||
+	SAMPLE_BUFFER_FUNCTIONS::is_almost_equal(sbuf_orig, sbuf_test) != true) {
+      ECA_TEST_FAILURE("cache lookup");
+    }
+    if (cache.lookup("a:1:", 0, bufsize - 1, &sbuf_test) == true ||
+	cache.lookup("b:1:", 0, bufsize, &sbuf_test) == true) {
+      ECA_TEST_FAILURE("cache lookup, wrong key");
+    }
+
+    /* note: the block at 'bufsize' is now least recently used */
+    cache.store("b:1:", 0, sbuf_orig);
+    if (cache.size() != 2 * bytes ||
+	cache.lookup("a:1:", bufsize, bufsize, &sbuf_test) == true ||
+	cache.lookup("a:1:", 0, bufsize, &sbuf_test) != true) {
+      ECA_TEST_FAILURE("cache LRU");
+    }
+
+    cache.forget("a:");
+    if (cache.number_of_blocks() != 1 ||
+	cache.lookup("b:1:", 0, bufsize, &sbuf_test) != true) {
+      ECA_TEST_FAILURE("cache forget");
+    }
+
+    cache.add_reader("a:1:");
+    cache.add_reader("a:1:");
+    cache.remove_reader("a:1:");
+    if (cache.readers("a:1:") != 1 || cache.readers("b:1:") != 0)
+      ECA_TEST_FAILURE("cache readers");
+    cache.remove_reader("a:1:");
+
+    cache.set_size_limit(0);
+    if (cache.size() != 0 || cache.number_of_blocks() != 0)
+      ECA_TEST_FAILURE("cache size limit");
+  }
+
+  /* case: channel spans */
+  {
+    std::fprintf(stdout, "%s: channel_span\n",
+		 __FILE__);
+    SAMPLE_BUFFER sbuf_orig (bufsize, channels);
+    SAMPLE_BUFFER sbuf_test (bufsize, channels);
+    fill_with_test_signal(&sbuf_orig);
+
+    /* note: read-only access must not break sharing */
+    sbuf_test.share_content(sbuf_orig);
+    SAMPLE_BUFFER::const_channel_span_t cspan = sbuf_test.const_channel_span(channels - 1);
+    if (sbuf_test.is_content_shared() != true ||
+	cspan.data != sbuf_orig.buffer[channels - 1] ||
+	cspan.length != bufsize) {
+      ECA_TEST_FAILURE("const_channel_span");
+    }
+
+    /* note: write access makes a private copy */
+    SAMPLE_BUFFER::channel_span_t span = sbuf_test.channel_span(channels - 1);
+    if (sbuf_test.is_content_shared() == true ||
+	span.data == sbuf_orig.buffer[channels - 1] ||
+	span.data != sbuf_test.buffer[channels - 1] ||
+	span.length != bufsize ||
+	reinterpret_cast<size_t>(span.data) % SAMPLE_BUFFER_POOL::alignment != 0) {
+      ECA_TEST_FAILURE("channel_span");
+    }
+    for(SAMPLE_BUFFER::buf_size_t n = 0; n < span.length; n++)
+      span.data[n] = SAMPLE_SPECS::silent_value;
+    if (sbuf_orig.buffer[channels - 1][0] == SAMPLE_SPECS::silent_value &&
+	sbuf_orig.buffer[channels - 1][1] == SAMPLE_SPECS::silent_value) {
+      ECA_TEST_FAILURE("channel_span, source modified");
+    }
+  }
+
+  /* case: silent tag */
+  {
+    std::fprintf(stdout, "%s: silent tag\n",
+		 __FILE__);
+    SAMPLE_BUFFER sbuf_silent (bufsize, channels);
+    SAMPLE_BUFFER sbuf_signal (bufsize, channels);
+    SAMPLE_BUFFER sbuf_test (bufsize, channels);
+    fill_with_test_signal(&sbuf_signal);
+
+    if (sbuf_silent.event_tag_test(SAMPLE_BUFFER::tag_silent) != true ||
+	sbuf_silent.is_silent() != true) {
+      ECA_TEST_FAILURE("silent tag, new buffer");
+    }
+    if (sbuf_signal.is_silent() == true) {
+      ECA_TEST_FAILURE("silent tag, is_silent");
+    }
+
+    /* note: silence is kept by gain changes and by
+     *       adding silence */
+    sbuf_test.multiply_by(multiplier);
+    sbuf_test.add_matching_channels(sbuf_silent);
+    if (sbuf_test.event_tag_test(SAMPLE_BUFFER::tag_silent) != true) {
+      ECA_TEST_FAILURE("silent tag, kept");
+    }
+
+    sbuf_test.add_with_weight(sbuf_signal, 2);
+    if (sbuf_test.event_tag_test(SAMPLE_BUFFER::tag_silent) == true) {
+      ECA_TEST_FAILURE("silent tag, add_with_weight");
+    }
+
+    sbuf_test.copy_matching_channels(sbuf_silent);
+    if (sbuf_test.event_tag_test(SAMPLE_BUFFER::tag_silent) != true ||
+	sbuf_test.is_silent() != true) {
+      ECA_TEST_FAILURE("silent tag, copy_matching_channels");
+    }
+
+    /* note: channels beyond the source are not overwritten */
+    sbuf_test.copy_all_content(sbuf_signal);
+    sbuf_silent.number_of_channels(channels - 1);
+    sbuf_test.copy_matching_channels(sbuf_silent);
+    if (sbuf_test.event_tag_test(SAMPLE_BUFFER::tag_silent) == true) {
+      ECA_TEST_FAILURE("silent tag, copy_matching_channels, extra channels");
+    }
+
+    sbuf_test.make_silent();
+    sbuf_test.channel_span(0);
+    if (sbuf_test.event_tag_test(SAMPLE_BUFFER::tag_silent) == true) {
+      ECA_TEST_FAILURE("silent tag, channel_span");
+    }
+  }
 }